@@ -2255,6 +2255,7 @@ void sbnd::AnalysisTree::analyze(const art::Event& evt)
   int nGeniePrimaries = 0, nGEANTparticles = 0, nMCNeutrinos = 0;
   
   auto const clockData = art::ServiceHandle<detinfo::DetectorClocksService const>()->DataFor(evt);
+  RecoUtils::TruthMatchCache truthMatch(clockData);
 
   art::Ptr<simb::MCTruth> mctruth;
 
@@ -2941,9 +2942,9 @@ void sbnd::AnalysisTree::analyze(const art::Event& evt)
           }
           
           for (size_t ipl = 0; ipl < 3; ++ipl){
-            TrackerData.trkidtruth_recoutils_totaltrueenergy[iTrk][ipl] = RecoUtils::TrueParticleIDFromTotalTrueEnergy(clockData, hits[ipl]);
-            TrackerData.trkidtruth_recoutils_totalrecocharge[iTrk][ipl] = RecoUtils::TrueParticleIDFromTotalRecoCharge(clockData, hits[ipl]);
-            TrackerData.trkidtruth_recoutils_totalrecohits[iTrk][ipl] = RecoUtils::TrueParticleIDFromTotalRecoHits(clockData, hits[ipl]);
+            TrackerData.trkidtruth_recoutils_totaltrueenergy[iTrk][ipl] = truthMatch.TrueParticleIDFromTotalTrueEnergy(hits[ipl]);
+            TrackerData.trkidtruth_recoutils_totalrecocharge[iTrk][ipl] = truthMatch.TrueParticleIDFromTotalRecoCharge(hits[ipl]);
+            TrackerData.trkidtruth_recoutils_totalrecohits[iTrk][ipl] = truthMatch.TrueParticleIDFromTotalRecoHits(hits[ipl]);
             double maxe = 0;
             HitsPurity(clockData, hits[ipl],TrackerData.trkidtruth[iTrk][ipl],TrackerData.trkpurtruth[iTrk][ipl],maxe);
           //std::cout<<"\n"<<iTracker<<"\t"<<iTrk<<"\t"<<ipl<<"\t"<<trkidtruth[iTracker][iTrk][ipl]<<"\t"<<trkpurtruth[iTracker][iTrk][ipl]<<"\t"<<maxe;
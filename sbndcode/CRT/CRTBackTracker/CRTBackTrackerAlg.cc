@@ -35,7 +35,7 @@ namespace sbnd::crt {
     fMCPIDEsEnergyMap.clear();
     fMCPStripHitsMap.clear();
     fTrackIDMotherMap.clear();
-    fStripHitMCPMap.clear();
+    fStripHitMCPVec.clear();
 
     art::Handle<std::vector<sim::ParticleAncestryMap>> droppedTrackIDMapVecHandle;
     event.getByLabel(fSimModuleLabel, droppedTrackIDMapVecHandle);
@@ -253,17 +253,21 @@ namespace sbnd::crt {
         fMCPIDEsEnergyMap[rollUpID]          += ide->energyDeposited;
       }
 
+    BuildStripHitIndex(event);
+
     art::Handle<std::vector<CRTStripHit>> stripHitHandle;
     event.getByLabel(fStripHitModuleLabel, stripHitHandle);
     std::vector<art::Ptr<CRTStripHit>> stripHitVec;
     art::fill_ptr_vector(stripHitVec, stripHitHandle);
 
+    fStripHitMCPVec.assign(stripHitVec.size(), -99999);
+
     for(auto const stripHit : stripHitVec)
       {
         const CRTTagger tagger = fCRTGeoAlg.ChannelToTaggerEnum(stripHit->Channel());
         TruthMatchMetrics truthMatch = TruthMatching(event, stripHit);
 
-        fStripHitMCPMap[stripHit.key()] = truthMatch.trackid;
+        fStripHitMCPVec[stripHit.key()] = truthMatch.trackid;
 
         Category category(truthMatch.trackid, tagger);
         if(fMCPStripHitsMap.find(category) == fMCPStripHitsMap.end())
@@ -273,6 +277,152 @@ namespace sbnd::crt {
       }
   }
 
+  void CRTBackTrackerAlg::BuildStripHitIndex(const art::Event &event)
+  {
+    // Walk strip hit -> FEBData -> IDEs once per event and keep only the IDEs
+    // on each strip hit's own channel, rolled up to their saved ancestor
+    fStripHitIDEOffsets.clear();
+    fStripHitIDEs.clear();
+    fClusterIndexBuilt = false;
+    fTrackIndexBuilt   = false;
+
+    art::Handle<std::vector<FEBData>> febDataHandle;
+    event.getByLabel(fFEBDataModuleLabel, febDataHandle);
+
+    art::Handle<std::vector<CRTStripHit>> stripHitHandle;
+    event.getByLabel(fStripHitModuleLabel, stripHitHandle);
+
+    art::FindManyP<sim::AuxDetIDE, FEBTruthInfo> febDataToIDEs(febDataHandle, event, fFEBDataModuleLabel);
+    art::FindOneP<FEBData> stripHitToFEBData(stripHitHandle, event, fStripHitModuleLabel);
+
+    fStripHitIDEOffsets.reserve(stripHitHandle->size() + 1);
+    fStripHitIDEOffsets.push_back(0);
+
+    for(unsigned i = 0; i < stripHitHandle->size(); ++i)
+      {
+        const CRTStripHit &stripHit = stripHitHandle->at(i);
+        auto const  febData    = stripHitToFEBData.at(i);
+        auto const& assnIDEVec = febDataToIDEs.at(febData.key());
+        auto const& truthVec   = febDataToIDEs.data(febData.key());
+
+        for(unsigned j = 0; j < assnIDEVec.size(); ++j)
+          {
+            if((uint) truthVec[j]->GetChannel() != (stripHit.Channel() % 32))
+              continue;
+
+            const art::Ptr<sim::AuxDetIDE> ide = assnIDEVec[j];
+            fStripHitIDEs.push_back({RollUpID(ide->trackID), ide->energyDeposited,
+                                     (ide->entryX + ide->exitX) / 2., (ide->entryY + ide->exitY) / 2.,
+                                     (ide->entryZ + ide->exitZ) / 2., (ide->entryT + ide->exitT) / 2.});
+          }
+
+        fStripHitIDEOffsets.push_back(fStripHitIDEs.size());
+      }
+  }
+
+  void CRTBackTrackerAlg::BuildClusterIndex(const art::Event &event)
+  {
+    fClusterStripHitOffsets.clear();
+    fClusterStripHitKeys.clear();
+
+    art::Handle<std::vector<CRTCluster>> clusterHandle;
+    event.getByLabel(fClusterModuleLabel, clusterHandle);
+
+    art::FindManyP<CRTStripHit> clusterToStripHits(clusterHandle, event, fClusterModuleLabel);
+
+    fClusterStripHitOffsets.reserve(clusterHandle->size() + 1);
+    fClusterStripHitOffsets.push_back(0);
+
+    for(unsigned i = 0; i < clusterHandle->size(); ++i)
+      {
+        for(auto const& stripHit : clusterToStripHits.at(i))
+          fClusterStripHitKeys.push_back(stripHit.key());
+
+        fClusterStripHitOffsets.push_back(fClusterStripHitKeys.size());
+      }
+
+    fClusterIndexBuilt = true;
+  }
+
+  void CRTBackTrackerAlg::BuildTrackIndex(const art::Event &event)
+  {
+    if(!fClusterIndexBuilt)
+      BuildClusterIndex(event);
+
+    fTrackStripHitOffsets.clear();
+    fTrackStripHitKeys.clear();
+
+    art::Handle<std::vector<CRTSpacePoint>> spacePointHandle;
+    event.getByLabel(fSpacePointModuleLabel, spacePointHandle);
+
+    art::Handle<std::vector<CRTTrack>> trackHandle;
+    event.getByLabel(fTrackModuleLabel, trackHandle);
+
+    art::FindOneP<CRTCluster> spacePointToCluster(spacePointHandle, event, fSpacePointModuleLabel);
+    art::FindManyP<CRTSpacePoint> trackToSpacePoints(trackHandle, event, fTrackModuleLabel);
+
+    fTrackStripHitOffsets.reserve(trackHandle->size() + 1);
+    fTrackStripHitOffsets.push_back(0);
+
+    for(unsigned i = 0; i < trackHandle->size(); ++i)
+      {
+        for(auto const& spacePoint : trackToSpacePoints.at(i))
+          {
+            const size_t clusterKey = spacePointToCluster.at(spacePoint.key()).key();
+
+            fTrackStripHitKeys.insert(fTrackStripHitKeys.end(),
+                                      fClusterStripHitKeys.begin() + fClusterStripHitOffsets[clusterKey],
+                                      fClusterStripHitKeys.begin() + fClusterStripHitOffsets[clusterKey + 1]);
+          }
+
+        fTrackStripHitOffsets.push_back(fTrackStripHitKeys.size());
+      }
+
+    fTrackIndexBuilt = true;
+  }
+
+  void CRTBackTrackerAlg::AddStripHitEnergies(const size_t stripHitKey, std::vector<std::pair<int, double>> &idToEnergy,
+                                              double &totalEnergy) const
+  {
+    for(size_t i = fStripHitIDEOffsets[stripHitKey]; i < fStripHitIDEOffsets[stripHitKey + 1]; ++i)
+      {
+        const StripHitIDE &ide = fStripHitIDEs[i];
+
+        auto it = std::find_if(idToEnergy.begin(), idToEnergy.end(),
+                               [&ide](const std::pair<int, double> &entry)
+                               { return entry.first == ide.trackid; });
+
+        if(it == idToEnergy.end())
+          idToEnergy.emplace_back(ide.trackid, ide.energy);
+        else
+          it->second += ide.energy;
+
+        totalEnergy += ide.energy;
+      }
+  }
+
+  int CRTBackTrackerAlg::BestPurityID(const std::vector<std::pair<int, double>> &idToEnergy, const double totalEnergy,
+                                      double &bestPur, double &bestEnergy) const
+  {
+    // Ties go to the lowest ID, as when iterating an ordered map
+    int trackid = -99999;
+    bestPur = 0.;
+    bestEnergy = 0.;
+
+    for(auto const [id, en] : idToEnergy)
+      {
+        double pur = en / totalEnergy;
+        if(pur > bestPur || (pur == bestPur && trackid != -99999 && id < trackid))
+          {
+            trackid    = id;
+            bestPur    = pur;
+            bestEnergy = en;
+          }
+      }
+
+    return trackid;
+  }
+
   int CRTBackTrackerAlg::RollUpID(const int &id)
   {
     if(fTrackIDMotherMap.find(id) != fTrackIDMotherMap.end())
@@ -337,39 +487,22 @@ namespace sbnd::crt {
 
   CRTBackTrackerAlg::TruthMatchMetrics CRTBackTrackerAlg::TruthMatching(const art::Event &event, const art::Ptr<CRTStripHit> &stripHit)
   {  
-    art::Handle<std::vector<FEBData>> febDataHandle;
-    event.getByLabel(fFEBDataModuleLabel, febDataHandle);
-
-    art::Handle<std::vector<CRTStripHit>> stripHitHandle;
-    event.getByLabel(fStripHitModuleLabel, stripHitHandle);
-
-    art::FindManyP<sim::AuxDetIDE, FEBTruthInfo> febDataToIDEs(febDataHandle, event, fFEBDataModuleLabel);
-    art::FindOneP<FEBData> stripHitToFEBData(stripHitHandle, event, fStripHitModuleLabel);
     const CRTTagger tagger = fCRTGeoAlg.ChannelToTaggerEnum(stripHit->Channel());
 
-    auto const febData = stripHitToFEBData.at(stripHit.key());
-    auto const assnIDEVec = febDataToIDEs.at(febData.key());
-
-    std::map<int, double> idToEnergyMap;
+    std::vector<std::pair<int, double>> idToEnergy;
     double totalEnergy = 0., x = 0., y = 0., z = 0., t = 0.;
     uint nides = 0;
 
-    for(unsigned i = 0; i < assnIDEVec.size(); ++i)
-      {
-        const art::Ptr<sim::AuxDetIDE> ide = assnIDEVec[i];
-        const FEBTruthInfo *febTruthInfo = febDataToIDEs.data(febData.key())[i];
-        if((uint) febTruthInfo->GetChannel() == (stripHit->Channel() % 32))
-          {
-            idToEnergyMap[RollUpID(ide->trackID)] += ide->energyDeposited;
-            totalEnergy                           += ide->energyDeposited;
+    AddStripHitEnergies(stripHit.key(), idToEnergy, totalEnergy);
 
-            x                                     += (ide->entryX + ide->exitX) / 2.;
-            y                                     += (ide->entryY + ide->exitY) / 2.;
-            z                                     += (ide->entryZ + ide->exitZ) / 2.;
-            t                                     += (ide->entryT + ide->exitT) / 2.;
+    for(size_t i = fStripHitIDEOffsets[stripHit.key()]; i < fStripHitIDEOffsets[stripHit.key() + 1]; ++i)
+      {
+        x += fStripHitIDEs[i].x;
+        y += fStripHitIDEs[i].y;
+        z += fStripHitIDEs[i].z;
+        t += fStripHitIDEs[i].t;
 
-            ++nides;
-          }
+        ++nides;
       }
 
     x /= nides;
@@ -377,21 +510,11 @@ namespace sbnd::crt {
     z /= nides;
     t /= nides;
 
-    double bestPur = 0., comp = 0.;
-    int trackid = -99999;
-
-    for(auto const [id, en] : idToEnergyMap)
-      {
-        double pur = en / totalEnergy;
-        if(pur > bestPur)
-          {
-            Category category(id, tagger);
+    double bestPur, bestEnergy, comp = 0.;
+    const int trackid = BestPurityID(idToEnergy, totalEnergy, bestPur, bestEnergy);
 
-            trackid = id;
-            bestPur = pur;
-            comp    = en / fMCPIDEsEnergyPerTaggerMap[category];
-          }
-      }
+    if(trackid != -99999)
+      comp = bestEnergy / fMCPIDEsEnergyPerTaggerMap[Category(trackid, tagger)];
 
     TrueDeposit deposit(trackid, -999999, tagger, totalEnergy, t, x, y, z, true);
 
@@ -400,67 +523,35 @@ namespace sbnd::crt {
 
   CRTBackTrackerAlg::TruthMatchMetrics CRTBackTrackerAlg::TruthMatching(const art::Event &event, const art::Ptr<CRTCluster> &cluster)
   {
-    art::Handle<std::vector<FEBData>> febDataHandle;
-    event.getByLabel(fFEBDataModuleLabel, febDataHandle);
-
-    art::Handle<std::vector<CRTStripHit>> stripHitHandle;
-    event.getByLabel(fStripHitModuleLabel, stripHitHandle);
-
-    art::Handle<std::vector<CRTCluster>> clusterHandle;
-    event.getByLabel(fClusterModuleLabel, clusterHandle);
-
-    art::FindManyP<sim::AuxDetIDE, FEBTruthInfo> febDataToIDEs(febDataHandle, event, fFEBDataModuleLabel);
-    art::FindManyP<FEBData> stripHitToFEBData(stripHitHandle, event, fStripHitModuleLabel);
-    art::FindManyP<CRTStripHit> clusterToStripHits(clusterHandle, event, fClusterModuleLabel);
+    if(!fClusterIndexBuilt)
+      BuildClusterIndex(event);
 
-    std::map<int, double> idToEnergyMap;
+    std::vector<std::pair<int, double>> idToEnergy;
     double totalEnergy = 0.;
-    std::map<int, uint> idToNHitsMap;
 
-    auto const assnStripHitVec = clusterToStripHits.at(cluster.key());
+    const size_t begin = fClusterStripHitOffsets[cluster.key()];
+    const size_t end   = fClusterStripHitOffsets[cluster.key() + 1];
 
-    for(auto const stripHit : assnStripHitVec)
-      {
-        auto const febData = stripHitToFEBData.at(stripHit.key());
-        assert(febData.size() == 1);
-        auto const assnIDEVec = febDataToIDEs.at(febData.at(0).key());
-        for(unsigned i = 0; i < assnIDEVec.size(); ++i)
-          {
-            const art::Ptr<sim::AuxDetIDE> ide = assnIDEVec[i];
-            const FEBTruthInfo *febTruthInfo = febDataToIDEs.data(febData.at(0).key())[i];
-            if((uint) febTruthInfo->GetChannel() == (stripHit->Channel() % 32))
-              {
-                idToEnergyMap[RollUpID(ide->trackID)] += ide->energyDeposited;
-                totalEnergy                           += ide->energyDeposited;
-              }
-          }
+    for(size_t i = begin; i < end; ++i)
+      AddStripHitEnergies(fClusterStripHitKeys[i], idToEnergy, totalEnergy);
 
-        if(idToNHitsMap.find(fStripHitMCPMap[stripHit.key()]) == idToNHitsMap.end())
-          idToNHitsMap[fStripHitMCPMap[stripHit.key()]] = 0;
-        
-        ++idToNHitsMap[fStripHitMCPMap[stripHit.key()]];
-      }
+    double bestPur, bestEnergy, comp = 0.;
+    const int trackid = BestPurityID(idToEnergy, totalEnergy, bestPur, bestEnergy);
 
-    double bestPur = 0., comp = 0.;
-    int trackid = -99999;
+    Category category(trackid, cluster->Tagger());
 
-    for(auto const [id, en] : idToEnergyMap)
-      {
-        double pur = en / totalEnergy;
-        if(pur > bestPur)
-          {
-            Category category(id, cluster->Tagger());
+    if(trackid != -99999)
+      comp = bestEnergy / fMCPIDEsEnergyPerTaggerMap[category];
 
-            trackid = id;
-            bestPur = pur;
-            comp    = en / fMCPIDEsEnergyPerTaggerMap[category];
-          }
+    uint nHits = 0;
+    for(size_t i = begin; i < end; ++i)
+      {
+        if(fStripHitMCPVec[fClusterStripHitKeys[i]] == trackid)
+          ++nHits;
       }
 
-    Category category(trackid, cluster->Tagger());
-
-    double hitComp = idToNHitsMap[trackid] / (double) fMCPStripHitsMap[category];
-    double hitPur  = idToNHitsMap[trackid] / (double) assnStripHitVec.size();
+    double hitComp = nHits / (double) fMCPStripHitsMap[category];
+    double hitPur  = nHits / (double) (end - begin);
 
     return TruthMatchMetrics(trackid, comp, bestPur, hitComp, hitPur, 
                              fTrueDepositsPerTaggerMap[category]);
@@ -468,69 +559,20 @@ namespace sbnd::crt {
 
   CRTBackTrackerAlg::TruthMatchMetrics CRTBackTrackerAlg::TruthMatching(const art::Event &event, const art::Ptr<CRTTrack> &track)
   {
-    art::Handle<std::vector<FEBData>> febDataHandle;
-    event.getByLabel(fFEBDataModuleLabel, febDataHandle);
-
-    art::Handle<std::vector<CRTStripHit>> stripHitHandle;
-    event.getByLabel(fStripHitModuleLabel, stripHitHandle);
-
-    art::Handle<std::vector<CRTCluster>> clusterHandle;
-    event.getByLabel(fClusterModuleLabel, clusterHandle);
-
-    art::Handle<std::vector<CRTSpacePoint>> spacePointHandle;
-    event.getByLabel(fSpacePointModuleLabel, spacePointHandle);
-
-    art::Handle<std::vector<CRTTrack>> trackHandle;
-    event.getByLabel(fTrackModuleLabel, trackHandle);
+    if(!fTrackIndexBuilt)
+      BuildTrackIndex(event);
 
-    art::FindManyP<sim::AuxDetIDE, FEBTruthInfo> febDataToIDEs(febDataHandle, event, fFEBDataModuleLabel);
-    art::FindManyP<FEBData> stripHitToFEBData(stripHitHandle, event, fStripHitModuleLabel);
-    art::FindManyP<CRTStripHit> clusterToStripHits(clusterHandle, event, fClusterModuleLabel);
-    art::FindOneP<CRTCluster> spacePointToCluster(spacePointHandle, event, fSpacePointModuleLabel);
-    art::FindManyP<CRTSpacePoint> trackToSpacePoints(trackHandle, event, fTrackModuleLabel);
-
-    std::map<int, double> idToEnergyMap;
+    std::vector<std::pair<int, double>> idToEnergy;
     double totalEnergy = 0.;
 
-    auto const spacePointVec = trackToSpacePoints.at(track.key());
+    for(size_t i = fTrackStripHitOffsets[track.key()]; i < fTrackStripHitOffsets[track.key() + 1]; ++i)
+      AddStripHitEnergies(fTrackStripHitKeys[i], idToEnergy, totalEnergy);
 
-    for(auto const spacePoint : spacePointVec)
-      {
-        auto const cluster     = spacePointToCluster.at(spacePoint.key());
-        auto const stripHitVec = clusterToStripHits.at(cluster.key());
-        
-        for(auto const stripHit : stripHitVec)
-          {
-            auto const febData = stripHitToFEBData.at(stripHit.key());
-            assert(febData.size() == 1);
-            auto const assnIDEVec = febDataToIDEs.at(febData.at(0).key());
-
-            for(unsigned i = 0; i < assnIDEVec.size(); ++i)
-              {
-                const art::Ptr<sim::AuxDetIDE> ide = assnIDEVec[i];
-                const FEBTruthInfo *febTruthInfo = febDataToIDEs.data(febData.at(0).key())[i];
-                if((uint) febTruthInfo->GetChannel() == (stripHit->Channel() % 32))
-                  {
-                    idToEnergyMap[RollUpID(ide->trackID)] += ide->energyDeposited;
-                    totalEnergy                           += ide->energyDeposited;
-                  }
-              }
-          }
-      }
+    double bestPur, bestEnergy, comp = 0.;
+    const int trackid = BestPurityID(idToEnergy, totalEnergy, bestPur, bestEnergy);
 
-    double bestPur = 0., comp = 0.;
-    int trackid = -99999;
-    
-    for(auto const [id, en] : idToEnergyMap)
-      {
-        double pur = en / totalEnergy;
-        if(pur > bestPur)
-          {
-            trackid = id;
-            bestPur = pur;
-            comp    = en / fMCPIDEsEnergyMap[id];
-          }
-      }
+    if(trackid != -99999)
+      comp = bestEnergy / fMCPIDEsEnergyMap[trackid];
 
     return TruthMatchMetrics(trackid, comp, bestPur, 1., 1., fTrueDepositsMap[trackid],
                              fTrueTrackInfosMap[trackid]);
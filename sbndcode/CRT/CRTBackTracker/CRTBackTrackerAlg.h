@@ -227,6 +227,28 @@ namespace sbnd::crt {
     void TrueParticlePDGEnergyTime(const int trackID, int &pdg, double &energy, double &time);
 
   private:
+
+    // Strip hit truth flattened per event, one entry per IDE on the strip hit's channel
+    struct StripHitIDE {
+      int    trackid;
+      double energy;
+      double x;
+      double y;
+      double z;
+      double t;
+    };
+
+    void BuildStripHitIndex(const art::Event &event);
+
+    void BuildClusterIndex(const art::Event &event);
+
+    void BuildTrackIndex(const art::Event &event);
+
+    void AddStripHitEnergies(const size_t stripHitKey, std::vector<std::pair<int, double>> &idToEnergy,
+                             double &totalEnergy) const;
+
+    int BestPurityID(const std::vector<std::pair<int, double>> &idToEnergy, const double totalEnergy,
+                     double &bestPur, double &bestEnergy) const;
     
     CRTGeoAlg fCRTGeoAlg;
     art::ServiceHandle<cheat::ParticleInventoryService> particleInv;
@@ -248,7 +270,16 @@ namespace sbnd::crt {
     std::map<int, double>                fMCPIDEsEnergyMap;
     std::map<Category, int>              fMCPStripHitsMap;
     std::map<int, int>                   fTrackIDMotherMap;
-    std::map<int, int>                   fStripHitMCPMap;
+    std::vector<int>                     fStripHitMCPVec;
+
+    std::vector<size_t>      fStripHitIDEOffsets;
+    std::vector<StripHitIDE> fStripHitIDEs;
+    std::vector<size_t>      fClusterStripHitOffsets;
+    std::vector<size_t>      fClusterStripHitKeys;
+    std::vector<size_t>      fTrackStripHitOffsets;
+    std::vector<size_t>      fTrackStripHitKeys;
+    bool                     fClusterIndexBuilt = false;
+    bool                     fTrackIndexBuilt   = false;
     
   };
 }
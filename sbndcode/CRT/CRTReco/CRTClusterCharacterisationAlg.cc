@@ -20,7 +20,7 @@ namespace sbnd::crt {
   
   CRTClusterCharacterisationAlg::~CRTClusterCharacterisationAlg(){}
 
-  CRTSpacePoint CRTClusterCharacterisationAlg::CharacteriseSingleHitCluster(const art::Ptr<CRTCluster> &cluster, const art::Ptr<CRTStripHit> &stripHit)
+  CRTSpacePoint CRTClusterCharacterisationAlg::CharacteriseSingleHitCluster(const art::Ptr<CRTCluster> &cluster, const art::Ptr<CRTStripHit> &stripHit) const
   {
     const std::array<double, 6> hitPos = fCRTGeoAlg.StripHit3DPos(stripHit->Channel(), stripHit->Pos(), stripHit->Error());
 
@@ -32,7 +32,7 @@ namespace sbnd::crt {
     return CRTSpacePoint(pos, err, pe, stripHit->Ts1() + fTimeOffset, 0., false);
   }
 
-  bool CRTClusterCharacterisationAlg::CharacteriseDoubleHitCluster(const art::Ptr<CRTCluster> &cluster, const std::vector<art::Ptr<CRTStripHit>> &stripHits, CRTSpacePoint &spacepoint)
+  bool CRTClusterCharacterisationAlg::CharacteriseDoubleHitCluster(const art::Ptr<CRTCluster> &cluster, const std::vector<art::Ptr<CRTStripHit>> &stripHits, CRTSpacePoint &spacepoint) const
   {
     const art::Ptr<CRTStripHit> &hit0 = stripHits[0];
     const art::Ptr<CRTStripHit> &hit1 = stripHits[1];
@@ -40,7 +40,7 @@ namespace sbnd::crt {
     return TwoHitSpacePoint(hit0, hit1, spacepoint);
   }
 
-  bool CRTClusterCharacterisationAlg::TwoHitSpacePoint(const art::Ptr<CRTStripHit> hit0, const art::Ptr<CRTStripHit> hit1, CRTSpacePoint &spacepoint)
+  bool CRTClusterCharacterisationAlg::TwoHitSpacePoint(const art::Ptr<CRTStripHit> hit0, const art::Ptr<CRTStripHit> hit1, CRTSpacePoint &spacepoint) const
   {
     const bool threeD = fCRTGeoAlg.ChannelToOrientation(hit0->Channel()) != fCRTGeoAlg.ChannelToOrientation(hit1->Channel());
 
@@ -82,7 +82,7 @@ namespace sbnd::crt {
       }
   }
 
-  bool CRTClusterCharacterisationAlg::CharacteriseMultiHitCluster(const art::Ptr<CRTCluster> &cluster, const std::vector<art::Ptr<CRTStripHit>> &stripHits, CRTSpacePoint &spacepoint)
+  bool CRTClusterCharacterisationAlg::CharacteriseMultiHitCluster(const art::Ptr<CRTCluster> &cluster, const std::vector<art::Ptr<CRTStripHit>> &stripHits, CRTSpacePoint &spacepoint) const
   {
     std::vector<CRTSpacePoint> spacepoints, complete_spacepoints;
 
@@ -127,17 +127,17 @@ namespace sbnd::crt {
     return true;
   }
 
-  double CRTClusterCharacterisationAlg::ADCToPE(const uint16_t channel, const uint16_t adc1, const uint16_t adc2)
+  double CRTClusterCharacterisationAlg::ADCToPE(const uint16_t channel, const uint16_t adc1, const uint16_t adc2) const
   {
     return ADCToPE(channel, adc1) + ADCToPE(channel+1, adc2);
   }
 
-  double CRTClusterCharacterisationAlg::ADCToPE(const uint16_t channel, const uint16_t adc)
+  double CRTClusterCharacterisationAlg::ADCToPE(const uint16_t channel, const uint16_t adc) const
   {
     return fCRTGeoAlg.GetSiPM(channel).gain * adc;
   }
 
-  std::array<double, 6> CRTClusterCharacterisationAlg::FindOverlap(const art::Ptr<CRTStripHit> &hit0, const art::Ptr<CRTStripHit> &hit1)
+  std::array<double, 6> CRTClusterCharacterisationAlg::FindOverlap(const art::Ptr<CRTStripHit> &hit0, const art::Ptr<CRTStripHit> &hit1) const
   {
     const std::array<double, 6> hit0pos = fCRTGeoAlg.StripHit3DPos(hit0->Channel(), hit0->Pos(), hit0->Error());
     const std::array<double, 6> hit1pos = fCRTGeoAlg.StripHit3DPos(hit1->Channel(), hit1->Pos(), hit1->Error());
@@ -152,7 +152,7 @@ namespace sbnd::crt {
     return overlap;
   }
 
-  std::array<double, 6> CRTClusterCharacterisationAlg::FindAdjacentPosition(const art::Ptr<CRTStripHit> &hit0, const art::Ptr<CRTStripHit> &hit1)
+  std::array<double, 6> CRTClusterCharacterisationAlg::FindAdjacentPosition(const art::Ptr<CRTStripHit> &hit0, const art::Ptr<CRTStripHit> &hit1) const
   {
     const std::array<double, 6> hit0pos = fCRTGeoAlg.StripHit3DPos(hit0->Channel(), hit0->Pos(), hit0->Error());
     const std::array<double, 6> hit1pos = fCRTGeoAlg.StripHit3DPos(hit1->Channel(), hit1->Pos(), hit1->Error());
@@ -168,7 +168,7 @@ namespace sbnd::crt {
   }
 
   void CRTClusterCharacterisationAlg::CentralPosition(const std::array<double, 6> overlap, 
-                                                      geo::Point_t &pos, geo::Point_t &err)
+                                                      geo::Point_t &pos, geo::Point_t &err) const
   {
     pos = geo::Point_t((overlap[0] + overlap[1])/2.,
                        (overlap[2] + overlap[3])/2.,
@@ -179,7 +179,7 @@ namespace sbnd::crt {
                        std::abs((overlap[4] - overlap[5])/2.));
   }
 
-  double CRTClusterCharacterisationAlg::ReconstructPE(const art::Ptr<CRTStripHit> &hit0, const art::Ptr<CRTStripHit> &hit1, const geo::Point_t &pos)
+  double CRTClusterCharacterisationAlg::ReconstructPE(const art::Ptr<CRTStripHit> &hit0, const art::Ptr<CRTStripHit> &hit1, const geo::Point_t &pos) const
   {
     const double dist0 = fCRTGeoAlg.DistanceDownStrip(pos, hit0->Channel());
     const double dist1 = fCRTGeoAlg.DistanceDownStrip(pos, hit1->Channel());
@@ -187,7 +187,7 @@ namespace sbnd::crt {
     return ReconstructPE(hit0, dist0) + ReconstructPE(hit1, dist1);
   }
 
-  double CRTClusterCharacterisationAlg::ReconstructPE(const art::Ptr<CRTStripHit> &hit, const double dist)
+  double CRTClusterCharacterisationAlg::ReconstructPE(const art::Ptr<CRTStripHit> &hit, const double dist) const
   {
     const double pe         = ADCToPE(hit->Channel(), hit->ADC1(), hit->ADC2());
     const double correction = std::pow(dist - fPEAttenuation, 2) / std::pow(fPEAttenuation, 2);
@@ -196,7 +196,7 @@ namespace sbnd::crt {
   }
 
   void CRTClusterCharacterisationAlg::CorrectTime(const art::Ptr<CRTStripHit> &hit0, const art::Ptr<CRTStripHit> &hit1, const geo::Point_t &pos,
-                                                  double &time, double &etime)
+                                                  double &time, double &etime) const
   {
     const double dist0 = fCRTGeoAlg.DistanceDownStrip(pos, hit0->Channel());
     const double dist1 = fCRTGeoAlg.DistanceDownStrip(pos, hit1->Channel());
@@ -219,12 +219,12 @@ namespace sbnd::crt {
       }
   }
 
-  double CRTClusterCharacterisationAlg::TimingCorrectionOffset(const double &dist, const double &pe)
+  double CRTClusterCharacterisationAlg::TimingCorrectionOffset(const double &dist, const double &pe) const
   {
     return dist * fPropDelay + fTimeWalkNorm * std::exp(-0.5 * std::pow((pe - fTimeWalkShift) / fTimeWalkSigma, 2)) + fTimeWalkOffset;
   }
 
-  void CRTClusterCharacterisationAlg::AggregatePositions(const std::vector<CRTSpacePoint> &complete_spacepoints, geo::Point_t &pos, geo::Point_t &err)
+  void CRTClusterCharacterisationAlg::AggregatePositions(const std::vector<CRTSpacePoint> &complete_spacepoints, geo::Point_t &pos, geo::Point_t &err) const
   {
     double sum_x = 0., sum_y = 0., sum_z = 0.;
     const unsigned n_sp = complete_spacepoints.size();
@@ -259,7 +259,7 @@ namespace sbnd::crt {
       err.SetZ(complete_spacepoints[0].ZErr());
   }
 
-  void CRTClusterCharacterisationAlg::TimeErrorCalculator(const std::vector<double> &times, double &mean, double &err)
+  void CRTClusterCharacterisationAlg::TimeErrorCalculator(const std::vector<double> &times, double &mean, double &err) const
   {
     double sum = 0.;
     for(auto const &time : times)
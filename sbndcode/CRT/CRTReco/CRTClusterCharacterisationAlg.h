@@ -42,36 +42,36 @@ namespace sbnd::crt {
     
     ~CRTClusterCharacterisationAlg();
 
-    CRTSpacePoint CharacteriseSingleHitCluster(const art::Ptr<CRTCluster> &cluster, const art::Ptr<CRTStripHit> &stripHit);
+    CRTSpacePoint CharacteriseSingleHitCluster(const art::Ptr<CRTCluster> &cluster, const art::Ptr<CRTStripHit> &stripHit) const;
 
-    bool CharacteriseDoubleHitCluster(const art::Ptr<CRTCluster> &cluster, const std::vector<art::Ptr<CRTStripHit>> &stripHits, CRTSpacePoint &spacepoint);
+    bool CharacteriseDoubleHitCluster(const art::Ptr<CRTCluster> &cluster, const std::vector<art::Ptr<CRTStripHit>> &stripHits, CRTSpacePoint &spacepoint) const;
 
-    bool TwoHitSpacePoint(const art::Ptr<CRTStripHit> hit0, const art::Ptr<CRTStripHit> hit1, CRTSpacePoint &spacepoint);
+    bool TwoHitSpacePoint(const art::Ptr<CRTStripHit> hit0, const art::Ptr<CRTStripHit> hit1, CRTSpacePoint &spacepoint) const;
 
-    bool CharacteriseMultiHitCluster(const art::Ptr<CRTCluster> &cluster, const std::vector<art::Ptr<CRTStripHit>> &stripHits, CRTSpacePoint &spacepoint);
+    bool CharacteriseMultiHitCluster(const art::Ptr<CRTCluster> &cluster, const std::vector<art::Ptr<CRTStripHit>> &stripHits, CRTSpacePoint &spacepoint) const;
 
-    double ADCToPE(const uint16_t channel, const uint16_t adc1, const uint16_t adc2);
+    double ADCToPE(const uint16_t channel, const uint16_t adc1, const uint16_t adc2) const;
 
-    double ADCToPE(const uint16_t channel, const uint16_t adc);
+    double ADCToPE(const uint16_t channel, const uint16_t adc) const;
 
-    std::array<double, 6> FindOverlap(const art::Ptr<CRTStripHit> &hit0, const art::Ptr<CRTStripHit> &hit1);
+    std::array<double, 6> FindOverlap(const art::Ptr<CRTStripHit> &hit0, const art::Ptr<CRTStripHit> &hit1) const;
 
-    std::array<double, 6> FindAdjacentPosition(const art::Ptr<CRTStripHit> &hit0, const art::Ptr<CRTStripHit> &hit1);
+    std::array<double, 6> FindAdjacentPosition(const art::Ptr<CRTStripHit> &hit0, const art::Ptr<CRTStripHit> &hit1) const;
 
-    void CentralPosition(const std::array<double, 6> overlap, geo::Point_t &pos, geo::Point_t &err);
+    void CentralPosition(const std::array<double, 6> overlap, geo::Point_t &pos, geo::Point_t &err) const;
 
-    double ReconstructPE(const art::Ptr<CRTStripHit> &hit0, const art::Ptr<CRTStripHit> &hit1, const geo::Point_t &pos);
+    double ReconstructPE(const art::Ptr<CRTStripHit> &hit0, const art::Ptr<CRTStripHit> &hit1, const geo::Point_t &pos) const;
 
-    double ReconstructPE(const art::Ptr<CRTStripHit> &hit, const double dist);
+    double ReconstructPE(const art::Ptr<CRTStripHit> &hit, const double dist) const;
 
     void CorrectTime(const art::Ptr<CRTStripHit> &hit0, const art::Ptr<CRTStripHit> &hit1, const geo::Point_t &pos,
-                     double &time, double &etime);
+                     double &time, double &etime) const;
 
-    double TimingCorrectionOffset(const double &dist, const double &pe);
+    double TimingCorrectionOffset(const double &dist, const double &pe) const;
 
-    void AggregatePositions(const std::vector<CRTSpacePoint> &complete_spacepoints, geo::Point_t &pos, geo::Point_t &err);
+    void AggregatePositions(const std::vector<CRTSpacePoint> &complete_spacepoints, geo::Point_t &pos, geo::Point_t &err) const;
 
-    void TimeErrorCalculator(const std::vector<double> &times, double &mean, double &err);
+    void TimeErrorCalculator(const std::vector<double> &times, double &mean, double &err) const;
 
   private:
 
@@ -6,7 +6,7 @@
 // Author:      Henry Lay (h.lay@lancaster.ac.uk)
 ////////////////////////////////////////////////////////////////////////
 
-#include "art/Framework/Core/EDProducer.h"
+#include "art/Framework/Core/SharedProducer.h"
 #include "art/Framework/Core/ModuleMacros.h"
 #include "art/Framework/Principal/Event.h"
 #include "art/Framework/Principal/Handle.h"
@@ -26,42 +26,58 @@
 #include "sbndcode/CRT/CRTUtils/CRTCommonUtils.h"
 
 #include <memory>
+#include <algorithm>
 
 namespace sbnd::crt {
   class CRTClusterProducer;
 }
 
 
-class sbnd::crt::CRTClusterProducer : public art::EDProducer {
+class sbnd::crt::CRTClusterProducer : public art::SharedProducer {
 public:
-  explicit CRTClusterProducer(fhicl::ParameterSet const& p);
+  explicit CRTClusterProducer(fhicl::ParameterSet const& p, art::ProcessingFrame const&);
 
   CRTClusterProducer(CRTClusterProducer const&) = delete;
   CRTClusterProducer(CRTClusterProducer&&) = delete;
   CRTClusterProducer& operator=(CRTClusterProducer const&) = delete;
   CRTClusterProducer& operator=(CRTClusterProducer&&) = delete;
 
-  void produce(art::Event& e) override;
+  void produce(art::Event& e, art::ProcessingFrame const&) override;
 
-  std::map<CRTTagger, std::vector<art::Ptr<CRTStripHit>>> GroupStripHits(const std::vector<art::Ptr<CRTStripHit>> &CRTStripHitVec);
+  void BuildChannelCache();
 
-  std::vector<std::pair<CRTCluster, std::vector<art::Ptr<CRTStripHit>>>> CreateClusters(const std::vector<art::Ptr<CRTStripHit>> &stripHits);
+  std::vector<std::vector<art::Ptr<CRTStripHit>>> GroupStripHits(const std::vector<art::Ptr<CRTStripHit>> &CRTStripHitVec) const;
 
-  std::vector<std::pair<CRTCluster, std::vector<art::Ptr<CRTStripHit>>>> SplitClusters(const std::vector<std::pair<CRTCluster, std::vector<art::Ptr<CRTStripHit>>>> &initialClusters);
+  std::vector<std::pair<CRTCluster, std::vector<art::Ptr<CRTStripHit>>>> CreateClusters(const std::vector<art::Ptr<CRTStripHit>> &stripHits) const;
 
-  CRTCluster CharacteriseCluster(const std::vector<art::Ptr<CRTStripHit>> &clusteredHits);
+  std::vector<std::pair<CRTCluster, std::vector<art::Ptr<CRTStripHit>>>> SplitClusters(const std::vector<std::pair<CRTCluster, std::vector<art::Ptr<CRTStripHit>>>> &initialClusters) const;
+
+  CRTCluster CharacteriseCluster(const std::vector<art::Ptr<CRTStripHit>> &clusteredHits) const;
+
+  bool CheckOverlap(const uint16_t channel1, const uint16_t channel2, const double overlap_buffer) const;
 
 private:
 
-  CRTGeoAlg   fCRTGeoAlg;
-  std::string fCRTStripHitModuleLabel;
-  uint32_t    fCoincidenceTimeRequirement;
-  double      fOverlapBuffer;
+  // Geometry needed for clustering, looked up once per channel rather than through the
+  // name keyed maps of the CRTGeoAlg for every pair of hits
+  struct ChannelInfo {
+    CRTTagger tagger      = kUndefinedTagger;
+    size_t    orientation = 0;
+    CoordSet  taggerCoord = kUndefinedSet;
+    CoordSet  constrained = kUndefinedSet;
+    double    minX = 0., maxX = 0., minY = 0., maxY = 0., minZ = 0., maxZ = 0.;
+  };
+
+  CRTGeoAlg                fCRTGeoAlg;
+  std::string              fCRTStripHitModuleLabel;
+  uint32_t                 fCoincidenceTimeRequirement;
+  double                   fOverlapBuffer;
+  std::vector<ChannelInfo> fChannelInfo;
 };
 
 
-sbnd::crt::CRTClusterProducer::CRTClusterProducer(fhicl::ParameterSet const& p)
-  : EDProducer{p}
+sbnd::crt::CRTClusterProducer::CRTClusterProducer(fhicl::ParameterSet const& p, art::ProcessingFrame const&)
+  : SharedProducer{p}
   , fCRTGeoAlg(p.get<fhicl::ParameterSet>("CRTGeoAlg", fhicl::ParameterSet()))
   , fCRTStripHitModuleLabel(p.get<std::string>("CRTStripHitModuleLabel"))
   , fCoincidenceTimeRequirement(p.get<uint32_t>("CoincidenceTimeRequirement"))
@@ -69,9 +85,37 @@ sbnd::crt::CRTClusterProducer::CRTClusterProducer(fhicl::ParameterSet const& p)
   {
     produces<std::vector<CRTCluster>>();
     produces<art::Assns<CRTCluster, CRTStripHit>>();
+
+    BuildChannelCache();
+
+    // The channel cache is only written here, all event state is local to produce
+    async<art::InEvent>();
   }
 
-void sbnd::crt::CRTClusterProducer::produce(art::Event& e)
+void sbnd::crt::CRTClusterProducer::BuildChannelCache()
+{
+  for(auto const& [channel, sipm] : fCRTGeoAlg.GetSiPMs())
+    {
+      if(channel >= fChannelInfo.size())
+        fChannelInfo.resize(channel + 1);
+
+      const CRTStripGeo strip = fCRTGeoAlg.GetStrip(channel);
+
+      ChannelInfo &info = fChannelInfo[channel];
+      info.tagger       = fCRTGeoAlg.ChannelToTaggerEnum(channel);
+      info.orientation  = fCRTGeoAlg.ChannelToOrientation(channel);
+      info.taggerCoord  = CRTCommonUtils::GetTaggerDefinedCoordinate(info.tagger);
+      info.constrained  = fCRTGeoAlg.GlobalConstrainedCoordinates(strip.channel0);
+      info.minX         = strip.minX;
+      info.maxX         = strip.maxX;
+      info.minY         = strip.minY;
+      info.maxY         = strip.maxY;
+      info.minZ         = strip.minZ;
+      info.maxZ         = strip.maxZ;
+    }
+}
+
+void sbnd::crt::CRTClusterProducer::produce(art::Event& e, art::ProcessingFrame const&)
 {
   auto clusterVec          = std::make_unique<std::vector<CRTCluster>>();
   auto clusterStripHitAssn = std::make_unique<art::Assns<CRTCluster, CRTStripHit>>();
@@ -82,16 +126,11 @@ void sbnd::crt::CRTClusterProducer::produce(art::Event& e)
   std::vector<art::Ptr<CRTStripHit>> CRTStripHitVec;
   art::fill_ptr_vector(CRTStripHitVec, CRTStripHitHandle);
 
-  std::map<CRTTagger, std::vector<art::Ptr<CRTStripHit>>> taggerStripHitsMap = GroupStripHits(CRTStripHitVec);
+  std::vector<std::vector<art::Ptr<CRTStripHit>>> taggerStripHits = GroupStripHits(CRTStripHitVec);
 
-  for(auto& [tagger, stripHits] : taggerStripHitsMap)
+  for(auto const& stripHits : taggerStripHits)
     {
-      std::sort(stripHits.begin(), stripHits.end(), [](art::Ptr<CRTStripHit> &a, art::Ptr<CRTStripHit> &b)->bool{
-          return a->Ts1() < b->Ts1();});
-
-      std::vector<std::pair<CRTCluster, std::vector<art::Ptr<CRTStripHit>>>> clustersAndHits = CreateClusters(stripHits);
-
-      for(auto const& [cluster, clusteredHits] : clustersAndHits)
+      for(auto const& [cluster, clusteredHits] : CreateClusters(stripHits))
         {
           clusterVec->push_back(cluster);
           util::CreateAssn(*this, e, *clusterVec, clusteredHits, *clusterStripHitAssn);
@@ -102,33 +141,42 @@ void sbnd::crt::CRTClusterProducer::produce(art::Event& e)
   e.put(std::move(clusterStripHitAssn));
 }
 
-std::map<sbnd::crt::CRTTagger, std::vector<art::Ptr<sbnd::crt::CRTStripHit>>> sbnd::crt::CRTClusterProducer::GroupStripHits(const std::vector<art::Ptr<CRTStripHit>> &CRTStripHitVec)
+std::vector<std::vector<art::Ptr<sbnd::crt::CRTStripHit>>> sbnd::crt::CRTClusterProducer::GroupStripHits(const std::vector<art::Ptr<CRTStripHit>> &CRTStripHitVec) const
 {
-  std::map<CRTTagger, std::vector<art::Ptr<CRTStripHit>>> taggerStripHitsMap;
+  // Sort once by tagger then time so each tagger is a contiguous, time ordered run of hits
+  std::vector<art::Ptr<CRTStripHit>> sortedStripHits(CRTStripHitVec);
 
-  for(const art::Ptr<CRTStripHit> &stripHit : CRTStripHitVec)
+  std::sort(sortedStripHits.begin(), sortedStripHits.end(), [this](const art::Ptr<CRTStripHit> &a, const art::Ptr<CRTStripHit> &b)->bool{
+      const CRTTagger taggerA = fChannelInfo.at(a->Channel()).tagger;
+      const CRTTagger taggerB = fChannelInfo.at(b->Channel()).tagger;
+      if(taggerA != taggerB)
+        return taggerA < taggerB;
+      return a->Ts1() < b->Ts1();});
+
+  std::vector<std::vector<art::Ptr<CRTStripHit>>> taggerStripHits;
+
+  for(size_t i = 0; i < sortedStripHits.size(); )
     {
-      CRTTagger tagger = fCRTGeoAlg.ChannelToTaggerEnum(stripHit->Channel());
+      const CRTTagger tagger = fChannelInfo.at(sortedStripHits[i]->Channel()).tagger;
 
-      if(taggerStripHitsMap.find(tagger) != taggerStripHitsMap.end())
-        taggerStripHitsMap[tagger].push_back(stripHit);
-      else
-        {
-          taggerStripHitsMap[tagger] = std::vector<art::Ptr<CRTStripHit>>();
-          taggerStripHitsMap[tagger].push_back(stripHit);
-        }
+      size_t end = i + 1;
+      while(end < sortedStripHits.size() && fChannelInfo.at(sortedStripHits[end]->Channel()).tagger == tagger)
+        ++end;
+
+      taggerStripHits.emplace_back(sortedStripHits.begin() + i, sortedStripHits.begin() + end);
+      i = end;
     }
 
-  return taggerStripHitsMap;
+  return taggerStripHits;
 }
 
-std::vector<std::pair<sbnd::crt::CRTCluster, std::vector<art::Ptr<sbnd::crt::CRTStripHit>>>> sbnd::crt::CRTClusterProducer::CreateClusters(const std::vector<art::Ptr<CRTStripHit>> &stripHits)
+std::vector<std::pair<sbnd::crt::CRTCluster, std::vector<art::Ptr<sbnd::crt::CRTStripHit>>>> sbnd::crt::CRTClusterProducer::CreateClusters(const std::vector<art::Ptr<CRTStripHit>> &stripHits) const
 {
   std::vector<std::pair<CRTCluster, std::vector<art::Ptr<CRTStripHit>>>> clustersAndHits;
 
   std::vector<bool> used(stripHits.size(), false);
 
-  for(uint16_t i = 0; i < stripHits.size(); ++i)
+  for(size_t i = 0; i < stripHits.size(); ++i)
     {
       const art::Ptr<CRTStripHit> &initialStripHit = stripHits[i];
 
@@ -138,17 +186,18 @@ std::vector<std::pair<sbnd::crt::CRTCluster, std::vector<art::Ptr<sbnd::crt::CRT
           clusteredHits.push_back(initialStripHit);
           used[i] = true;
 
-          for(uint16_t ii = i+1; ii < stripHits.size(); ++ii)
+          // Hits are time ordered so the window closes at the first hit outside the coincidence time
+          for(size_t ii = i+1; ii < stripHits.size(); ++ii)
             {
               const art::Ptr<CRTStripHit> &stripHit = stripHits[ii];
-    
+
+              if(!(stripHit->Ts1() - initialStripHit->Ts1() < fCoincidenceTimeRequirement))
+                break;
+
               if(!used[ii])
                 {
-                  if(stripHit->Ts1() - initialStripHit->Ts1() < fCoincidenceTimeRequirement)
-                    {
-                      clusteredHits.push_back(stripHit);
-                      used[ii] = true;
-                    }
+                  clusteredHits.push_back(stripHit);
+                  used[ii] = true;
                 }
             }
           
@@ -160,66 +209,81 @@ std::vector<std::pair<sbnd::crt::CRTCluster, std::vector<art::Ptr<sbnd::crt::CRT
 }
 
 std::vector<std::pair<sbnd::crt::CRTCluster, std::vector<art::Ptr<sbnd::crt::CRTStripHit>>>>
-  sbnd::crt::CRTClusterProducer::SplitClusters(const std::vector<std::pair<CRTCluster, std::vector<art::Ptr<CRTStripHit>>>> &initialClusters)
+  sbnd::crt::CRTClusterProducer::SplitClusters(const std::vector<std::pair<CRTCluster, std::vector<art::Ptr<CRTStripHit>>>> &initialClusters) const
 {
   std::vector<std::pair<CRTCluster, std::vector<art::Ptr<CRTStripHit>>>> clustersAndHits;
 
   for(auto const& [cluster, hits] : initialClusters)
     {
-      std::map<uint16_t, std::set<uint16_t>> overlaps;
-      
-      std::vector<bool> used(hits.size(), false);
+      // Overlap sets are stored as one bitmask row per hit
+      const size_t nHits  = hits.size();
+      const size_t nWords = (nHits + 63) / 64;
+
+      std::vector<uint64_t> overlaps(nHits * nWords, 0);
+      auto overlapRow = [&](const size_t j) { return overlaps.begin() + j * nWords; };
 
-      for(uint16_t j = 0; j < hits.size(); ++j)
+      for(size_t j = 0; j < nHits; ++j)
         {
-          const art::Ptr<CRTStripHit> &hit1 = hits[j];
-          overlaps[j] = {j};
-          
-          for(uint16_t jj = 0; jj < hits.size(); ++jj)
+          overlapRow(j)[j / 64] |= uint64_t(1) << (j % 64);
+
+          for(size_t jj = j + 1; jj < nHits; ++jj)
             {
-              const art::Ptr<CRTStripHit> &hit2 = hits[jj];
-              if(fCRTGeoAlg.CheckOverlap(hit1->Channel(), hit2->Channel(), 10.))
-                overlaps[j].insert(jj);
+              if(CheckOverlap(hits[j]->Channel(), hits[jj]->Channel(), 10.))
+                {
+                  overlapRow(j)[jj / 64]  |= uint64_t(1) << (jj % 64);
+                  overlapRow(jj)[j / 64]  |= uint64_t(1) << (j % 64);
+                }
             }
         }
 
-      std::set<uint16_t> leftovers;
-      
-      for(auto const& [id, overlap_set] : overlaps)
+      std::vector<bool> used(nHits, false);
+      std::vector<size_t> leftovers;
+
+      for(size_t id = 0; id < nHits; ++id)
         {
           if(used[id])
             continue;
 
+          std::vector<size_t> overlapSet;
+          for(size_t id2 = 0; id2 < nHits; ++id2)
+            {
+              if(overlapRow(id)[id2 / 64] >> (id2 % 64) & 1)
+                overlapSet.push_back(id2);
+            }
+
           bool exclusive = true;
-          
-          for(auto const& id2 : overlap_set)
+
+          for(auto const& id2 : overlapSet)
             {
-              if(overlaps[id2] != overlap_set)
-                exclusive = false;
+              if(!std::equal(overlapRow(id2), overlapRow(id2) + nWords, overlapRow(id)))
+                {
+                  exclusive = false;
+                  break;
+                }
             }
-          
+
           if(exclusive)
             {
               std::vector<art::Ptr<CRTStripHit>> newClusteredHits;
-              
-              for(auto const& id2 : overlap_set)
+
+              for(auto const& id2 : overlapSet)
                 {
                   newClusteredHits.push_back(hits[id2]);
                   used[id2] = true;
                 }
-              
+
               const CRTCluster &cluster = CharacteriseCluster(newClusteredHits);
               clustersAndHits.emplace_back(cluster, newClusteredHits);
             }
           else
-            leftovers.insert(id);
+            leftovers.push_back(id);
         }
-      
+
       std::vector<art::Ptr<CRTStripHit>> leftoverClusteredHits;
-      
+
       for(auto const& id : leftovers)
         leftoverClusteredHits.push_back(hits[id]);
-      
+
       if(leftoverClusteredHits.size() != 0)
         {
           const CRTCluster &cluster = CharacteriseCluster(leftoverClusteredHits);
@@ -230,31 +294,30 @@ std::vector<std::pair<sbnd::crt::CRTCluster, std::vector<art::Ptr<sbnd::crt::CRT
   return clustersAndHits;
 }     
 
-sbnd::crt::CRTCluster sbnd::crt::CRTClusterProducer::CharacteriseCluster(const std::vector<art::Ptr<CRTStripHit>> &clusteredHits)
+sbnd::crt::CRTCluster sbnd::crt::CRTClusterProducer::CharacteriseCluster(const std::vector<art::Ptr<CRTStripHit>> &clusteredHits) const
 {
   const uint16_t nHits = clusteredHits.size();
 
-  const CRTStripGeo strip0 = fCRTGeoAlg.GetStrip(clusteredHits.at(0)->Channel());
-  const CRTTagger tagger = fCRTGeoAlg.ChannelToTaggerEnum(clusteredHits.at(0)->Channel());
+  const ChannelInfo &info0 = fChannelInfo.at(clusteredHits.at(0)->Channel());
+  const CRTTagger tagger    = info0.tagger;
 
   uint32_t ts0 = 0, ts1 = 0, s = 0;
   CoordSet composition = kUndefinedSet;
 
   for(uint16_t i = 0; i < clusteredHits.size(); ++i)
     {
-      const art::Ptr<CRTStripHit> hit = clusteredHits[i];
+      const art::Ptr<CRTStripHit> &hit = clusteredHits[i];
 
       ts0 += hit->Ts0();
       ts1 += hit->Ts1();
       s   += hit->UnixS();
 
-      const CRTStripGeo strip = fCRTGeoAlg.GetStrip(hit->Channel());
-      if(fCRTGeoAlg.DifferentOrientations(strip0, strip))
+      if(fChannelInfo.at(hit->Channel()).orientation != info0.orientation)
         composition = kXYZ;
     }
 
   if(composition == kUndefinedSet)
-    composition = fCRTGeoAlg.GlobalConstrainedCoordinates(strip0.channel0);
+    composition = info0.constrained;
 
   s   /= nHits;
   ts0 /= nHits;
@@ -262,5 +325,31 @@ sbnd::crt::CRTCluster sbnd::crt::CRTClusterProducer::CharacteriseCluster(const s
 
   return CRTCluster(ts0, ts1, s, nHits, tagger, composition);
 }
+
+bool sbnd::crt::CRTClusterProducer::CheckOverlap(const uint16_t channel1, const uint16_t channel2, const double overlap_buffer) const
+{
+  // Same test as CRTGeoAlg::CheckOverlap using the cached strip extents
+  const ChannelInfo &strip1 = fChannelInfo.at(channel1);
+  const ChannelInfo &strip2 = fChannelInfo.at(channel2);
+
+  if(strip1.tagger != strip2.tagger)
+    return false;
+
+  const double minX = std::max(strip1.minX, strip2.minX) - overlap_buffer / 2.;
+  const double maxX = std::min(strip1.maxX, strip2.maxX) + overlap_buffer / 2.;
+  const double minY = std::max(strip1.minY, strip2.minY) - overlap_buffer / 2.;
+  const double maxY = std::min(strip1.maxY, strip2.maxY) + overlap_buffer / 2.;
+  const double minZ = std::max(strip1.minZ, strip2.minZ) - overlap_buffer / 2.;
+  const double maxZ = std::min(strip1.maxZ, strip2.maxZ) + overlap_buffer / 2.;
+
+  if(strip1.taggerCoord == kX)
+    return minY<maxY && minZ<maxZ;
+  else if(strip1.taggerCoord == kY)
+    return minX<maxX && minZ<maxZ;
+  else if(strip1.taggerCoord == kZ)
+    return minX<maxX && minY<maxY;
+  else
+    return false;
+}
   
 DEFINE_ART_MODULE(sbnd::crt::CRTClusterProducer)
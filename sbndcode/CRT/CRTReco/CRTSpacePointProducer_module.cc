@@ -6,7 +6,7 @@
 // Author:      Henry Lay (h.lay@lancaster.ac.uk)
 ////////////////////////////////////////////////////////////////////////
 
-#include "art/Framework/Core/EDProducer.h"
+#include "art/Framework/Core/SharedProducer.h"
 #include "art/Framework/Core/ModuleMacros.h"
 #include "art/Framework/Principal/Event.h"
 #include "art/Framework/Principal/Handle.h"
@@ -25,16 +25,16 @@ namespace sbnd::crt {
   class CRTSpacePointProducer;
 }
 
-class sbnd::crt::CRTSpacePointProducer : public art::EDProducer {
+class sbnd::crt::CRTSpacePointProducer : public art::SharedProducer {
 public:
-  explicit CRTSpacePointProducer(fhicl::ParameterSet const& p);
+  explicit CRTSpacePointProducer(fhicl::ParameterSet const& p, art::ProcessingFrame const&);
 
   CRTSpacePointProducer(CRTSpacePointProducer const&) = delete;
   CRTSpacePointProducer(CRTSpacePointProducer&&) = delete;
   CRTSpacePointProducer& operator=(CRTSpacePointProducer const&) = delete;
   CRTSpacePointProducer& operator=(CRTSpacePointProducer&&) = delete;
 
-  void produce(art::Event& e) override;
+  void produce(art::Event& e, art::ProcessingFrame const&) override;
 
 private:
 
@@ -43,16 +43,19 @@ private:
 };
 
 
-sbnd::crt::CRTSpacePointProducer::CRTSpacePointProducer(fhicl::ParameterSet const& p)
-  : EDProducer{p}
+sbnd::crt::CRTSpacePointProducer::CRTSpacePointProducer(fhicl::ParameterSet const& p, art::ProcessingFrame const&)
+  : SharedProducer{p}
   , fClusterCharacAlg(p.get<fhicl::ParameterSet>("ClusterCharacterisationAlg", fhicl::ParameterSet()))
   , fClusterModuleLabel(p.get<std::string>("ClusterModuleLabel"))
   {
     produces<std::vector<CRTSpacePoint>>();
     produces<art::Assns<CRTCluster, CRTSpacePoint>>();
+
+    // The characterisation algorithm is const, so events can be run concurrently
+    async<art::InEvent>();
   }
 
-void sbnd::crt::CRTSpacePointProducer::produce(art::Event& e)
+void sbnd::crt::CRTSpacePointProducer::produce(art::Event& e, art::ProcessingFrame const&)
 {
   auto spacePointVec         = std::make_unique<std::vector<CRTSpacePoint>>();
   auto spacePointClusterAssn = std::make_unique<art::Assns<CRTCluster, CRTSpacePoint>>();
@@ -68,7 +71,7 @@ void sbnd::crt::CRTSpacePointProducer::produce(art::Event& e)
   for(const art::Ptr<CRTCluster> &cluster : clusterVec)
     {
       const uint nhits = cluster->NHits();
-      const std::vector<art::Ptr<CRTStripHit>> stripHits = clusterToStripHits.at(cluster.key());
+      const std::vector<art::Ptr<CRTStripHit>> &stripHits = clusterToStripHits.at(cluster.key());
 
       if(nhits == 1 && cluster->Tagger() == kBottomTagger)
         {
@@ -6,7 +6,7 @@
 // Author:      Henry Lay (h.lay@lancaster.ac.uk)
 ////////////////////////////////////////////////////////////////////////
 
-#include "art/Framework/Core/EDProducer.h"
+#include "art/Framework/Core/SharedProducer.h"
 #include "art/Framework/Core/ModuleMacros.h"
 #include "art/Framework/Principal/Event.h"
 #include "art/Framework/Principal/Handle.h"
@@ -31,18 +31,18 @@ namespace sbnd::crt {
 }
 
 
-class sbnd::crt::CRTStripHitProducer : public art::EDProducer {
+class sbnd::crt::CRTStripHitProducer : public art::SharedProducer {
 public:
-  explicit CRTStripHitProducer(fhicl::ParameterSet const& p);
+  explicit CRTStripHitProducer(fhicl::ParameterSet const& p, art::ProcessingFrame const&);
 
   CRTStripHitProducer(CRTStripHitProducer const&) = delete;
   CRTStripHitProducer(CRTStripHitProducer&&) = delete;
   CRTStripHitProducer& operator=(CRTStripHitProducer const&) = delete;
   CRTStripHitProducer& operator=(CRTStripHitProducer&&) = delete;
 
-  void produce(art::Event& e) override;
+  void produce(art::Event& e, art::ProcessingFrame const&) override;
 
-  std::vector<CRTStripHit> CreateStripHits(art::Ptr<FEBData> &data);
+  std::vector<CRTStripHit> CreateStripHits(const art::Ptr<FEBData> &data) const;
 
 private:
 
@@ -53,8 +53,8 @@ private:
 };
 
 
-sbnd::crt::CRTStripHitProducer::CRTStripHitProducer(fhicl::ParameterSet const& p)
-  : EDProducer{p}
+sbnd::crt::CRTStripHitProducer::CRTStripHitProducer(fhicl::ParameterSet const& p, art::ProcessingFrame const&)
+  : SharedProducer{p}
   , fCRTGeoAlg(p.get<fhicl::ParameterSet>("CRTGeoAlg", fhicl::ParameterSet()))
   , fFEBDataModuleLabel(p.get<std::string>("FEBDataModuleLabel"))
   , fADCThreshold(p.get<uint16_t>("ADCThreshold"))
@@ -62,9 +62,12 @@ sbnd::crt::CRTStripHitProducer::CRTStripHitProducer(fhicl::ParameterSet const& p
   {
     produces<std::vector<CRTStripHit>>();
     produces<art::Assns<FEBData, CRTStripHit>>();
+
+    // All event state is local to produce, so events can be run concurrently
+    async<art::InEvent>();
   }
 
-void sbnd::crt::CRTStripHitProducer::produce(art::Event& e)
+void sbnd::crt::CRTStripHitProducer::produce(art::Event& e, art::ProcessingFrame const&)
 {
   auto stripHitVec      = std::make_unique<std::vector<CRTStripHit>>();
   auto stripHitDataAssn = std::make_unique<art::Assns<FEBData, CRTStripHit>>();
@@ -75,11 +78,11 @@ void sbnd::crt::CRTStripHitProducer::produce(art::Event& e)
   std::vector<art::Ptr<FEBData>> FEBDataVec;
   art::fill_ptr_vector(FEBDataVec, FEBDataHandle);
 
-  for(auto data : FEBDataVec)
+  for(auto const& data : FEBDataVec)
     {
       std::vector<CRTStripHit> newStripHits = CreateStripHits(data);
       
-      for(auto hit : newStripHits)
+      for(auto const& hit : newStripHits)
 	{
 	  stripHitVec->push_back(hit);
 	  util::CreateAssn(*this, e, *stripHitVec, data, *stripHitDataAssn);
@@ -90,7 +93,7 @@ void sbnd::crt::CRTStripHitProducer::produce(art::Event& e)
   e.put(std::move(stripHitDataAssn));
 }
 
-std::vector<sbnd::crt::CRTStripHit> sbnd::crt::CRTStripHitProducer::CreateStripHits(art::Ptr<FEBData> &data)
+std::vector<sbnd::crt::CRTStripHit> sbnd::crt::CRTStripHitProducer::CreateStripHits(const art::Ptr<FEBData> &data) const
 {
   std::vector<CRTStripHit> stripHits;
 
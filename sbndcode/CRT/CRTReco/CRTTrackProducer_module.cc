@@ -6,7 +6,7 @@
 // Author:      Henry Lay (h.lay@lancaster.ac.uk)
 ////////////////////////////////////////////////////////////////////////
 
-#include "art/Framework/Core/EDProducer.h"
+#include "art/Framework/Core/SharedProducer.h"
 #include "art/Framework/Core/ModuleMacros.h"
 #include "art/Framework/Principal/Event.h"
 #include "art/Framework/Principal/Handle.h"
@@ -49,47 +49,47 @@ namespace sbnd::crt {
 }
 
 
-class sbnd::crt::CRTTrackProducer : public art::EDProducer {
+class sbnd::crt::CRTTrackProducer : public art::SharedProducer {
 public:
-  explicit CRTTrackProducer(fhicl::ParameterSet const& p);
+  explicit CRTTrackProducer(fhicl::ParameterSet const& p, art::ProcessingFrame const&);
 
   CRTTrackProducer(CRTTrackProducer const&) = delete;
   CRTTrackProducer(CRTTrackProducer&&) = delete;
   CRTTrackProducer& operator=(CRTTrackProducer const&) = delete;
   CRTTrackProducer& operator=(CRTTrackProducer&&) = delete;
 
-  void produce(art::Event& e) override;
+  void produce(art::Event& e, art::ProcessingFrame const&) override;
 
-  void OrderSpacePoints(std::vector<art::Ptr<CRTSpacePoint>> &spacePointVec);
+  void OrderSpacePoints(std::vector<art::Ptr<CRTSpacePoint>> &spacePointVec) const;
 
   std::vector<std::pair<CRTTrack, std::set<unsigned>>> CreateTrackCandidates(const std::vector<art::Ptr<CRTSpacePoint>> &spacePointVec,
-                                                                             const art::FindOneP<CRTCluster> &spacePointsToCluster);
+                                                                             const art::FindOneP<CRTCluster> &spacePointsToCluster) const;
 
-  void TimeErrorCalculator(const std::vector<double> &times, double &mean, double &err);
+  void TimeErrorCalculator(const std::vector<double> &times, double &mean, double &err) const;
 
-  void OrderTrackCandidates(std::vector<std::pair<CRTTrack, std::set<unsigned>>> &trackCandidates);
+  void OrderTrackCandidates(std::vector<std::pair<CRTTrack, std::set<unsigned>>> &trackCandidates) const;
 
-  std::vector<std::pair<CRTTrack, std::set<unsigned>>> ChoseTracks(std::vector<std::pair<CRTTrack, std::set<unsigned>>> &trackCandidates);
+  std::vector<std::pair<CRTTrack, std::set<unsigned>>> ChoseTracks(std::vector<std::pair<CRTTrack, std::set<unsigned>>> &trackCandidates) const;
 
   double DistanceOfClosestApproach(const CRTTagger tagger, const art::Ptr<CRTSpacePoint> &spacePoint,
-                                   const geo::Point_t &start, const geo::Vector_t &dir);
+                                   const geo::Point_t &start, const geo::Vector_t &dir) const;
 
-  bool IsPointInsideBox(const geo::Point_t &point, const geo::Point_t &centre, const geo::Point_t &widths);
+  bool IsPointInsideBox(const geo::Point_t &point, const geo::Point_t &centre, const geo::Point_t &widths) const;
 
   double DistanceOfClosestApproach(const CoordSet &constrainedPlane, const geo::Point_t &point,
-                                   const geo::Point_t &centre, const geo::Point_t &widths);
+                                   const geo::Point_t &centre, const geo::Point_t &widths) const;
 
-  double MinimumApproach(const double &x, const double &dx, const double &y, const double &dy, const geo::Point2D_t &p);
+  double MinimumApproach(const double &x, const double &dx, const double &y, const double &dy, const geo::Point2D_t &p) const;
 
-  double DistanceOfClosestApproach(const geo::Point2D_t &v1, const geo::Point2D_t &v2, const geo::Point2D_t &p);
+  double DistanceOfClosestApproach(const geo::Point2D_t &v1, const geo::Point2D_t &v2, const geo::Point2D_t &p) const;
 
   void BestFitLine(const geo::Point_t &a, const geo::Point_t &b, const geo::Point_t &c, const CRTTagger &primary_tagger,
                    const CRTTagger &secondary_tagger, const CRTTagger &tertiary_tagger, geo::Point_t &start,
-                   geo::Point_t &mid, geo::Point_t &end, double &gof);
+                   geo::Point_t &mid, geo::Point_t &end, double &gof) const;
 
-  geo::Point_t LineTaggerIntersectionPoint(const geo::Point_t &start, const geo::Vector_t &dir, const CRTTagger &tagger);
+  geo::Point_t LineTaggerIntersectionPoint(const geo::Point_t &start, const geo::Vector_t &dir, const CRTTagger &tagger) const;
 
-  double TripleTrackToF(std::vector<double> times);
+  double TripleTrackToF(std::vector<double> times) const;
 
 private:
 
@@ -100,8 +100,8 @@ private:
 };
 
 
-sbnd::crt::CRTTrackProducer::CRTTrackProducer(fhicl::ParameterSet const& p)
-  : EDProducer{p}
+sbnd::crt::CRTTrackProducer::CRTTrackProducer(fhicl::ParameterSet const& p, art::ProcessingFrame const&)
+  : SharedProducer{p}
   , fCRTGeoAlg(p.get<fhicl::ParameterSet>("CRTGeoAlg", fhicl::ParameterSet()))
   , fCRTSpacePointModuleLabel(p.get<std::string>("CRTSpacePointModuleLabel"))
   , fCoincidenceTimeRequirement(p.get<double>("CoincidenceTimeRequirement"))
@@ -109,9 +109,12 @@ sbnd::crt::CRTTrackProducer::CRTTrackProducer(fhicl::ParameterSet const& p)
   {
     produces<std::vector<CRTTrack>>();
     produces<art::Assns<CRTSpacePoint, CRTTrack>>();
+
+    // Track building only reads the configuration, so events can be run concurrently
+    async<art::InEvent>();
   }
 
-void sbnd::crt::CRTTrackProducer::produce(art::Event& e)
+void sbnd::crt::CRTTrackProducer::produce(art::Event& e, art::ProcessingFrame const&)
 {
   auto trackVec            = std::make_unique<std::vector<CRTTrack>>();
   auto trackSpacePointAssn = std::make_unique<art::Assns<CRTSpacePoint, CRTTrack>>();
@@ -144,7 +147,7 @@ void sbnd::crt::CRTTrackProducer::produce(art::Event& e)
   e.put(std::move(trackSpacePointAssn));
 }
 
-void sbnd::crt::CRTTrackProducer::OrderSpacePoints(std::vector<art::Ptr<CRTSpacePoint>> &spacePointVec)
+void sbnd::crt::CRTTrackProducer::OrderSpacePoints(std::vector<art::Ptr<CRTSpacePoint>> &spacePointVec) const
 {
   std::sort(spacePointVec.begin(), spacePointVec.end(), 
             [](const art::Ptr<CRTSpacePoint> &a, const art::Ptr<CRTSpacePoint> &b) -> bool {
@@ -153,7 +156,7 @@ void sbnd::crt::CRTTrackProducer::OrderSpacePoints(std::vector<art::Ptr<CRTSpace
 }
 
 std::vector<std::pair<sbnd::crt::CRTTrack, std::set<unsigned>>> sbnd::crt::CRTTrackProducer::CreateTrackCandidates(const std::vector<art::Ptr<CRTSpacePoint>> &spacePointVec,
-                                                                                                                   const art::FindOneP<CRTCluster> &spacePointsToCluster)
+                                                                                                                   const art::FindOneP<CRTCluster> &spacePointsToCluster) const
 {
   std::vector<std::pair<CRTTrack, std::set<unsigned>>> candidates;
 
@@ -239,7 +242,7 @@ std::vector<std::pair<sbnd::crt::CRTTrack, std::set<unsigned>>> sbnd::crt::CRTTr
   return candidates;
 }
 
-void sbnd::crt::CRTTrackProducer::TimeErrorCalculator(const std::vector<double> &times, double &mean, double &err)
+void sbnd::crt::CRTTrackProducer::TimeErrorCalculator(const std::vector<double> &times, double &mean, double &err) const
 {
   double sum = 0.;
   for(auto const &time : times)
@@ -254,7 +257,7 @@ void sbnd::crt::CRTTrackProducer::TimeErrorCalculator(const std::vector<double>
   err = std::sqrt(summed_var / times.size());
 }
 
-void sbnd::crt::CRTTrackProducer::OrderTrackCandidates(std::vector<std::pair<CRTTrack, std::set<unsigned>>> &trackCandidates)
+void sbnd::crt::CRTTrackProducer::OrderTrackCandidates(std::vector<std::pair<CRTTrack, std::set<unsigned>>> &trackCandidates) const
 {
   std::sort(trackCandidates.begin(), trackCandidates.end(),
             [](const std::pair<CRTTrack, std::set<unsigned>> &a, const std::pair<CRTTrack, std::set<unsigned>> &b) -> bool {
@@ -265,7 +268,7 @@ void sbnd::crt::CRTTrackProducer::OrderTrackCandidates(std::vector<std::pair<CRT
             });
 }
 
-std::vector<std::pair<sbnd::crt::CRTTrack, std::set<unsigned>>> sbnd::crt::CRTTrackProducer::ChoseTracks(std::vector<std::pair<CRTTrack, std::set<unsigned>>> &trackCandidates)
+std::vector<std::pair<sbnd::crt::CRTTrack, std::set<unsigned>>> sbnd::crt::CRTTrackProducer::ChoseTracks(std::vector<std::pair<CRTTrack, std::set<unsigned>>> &trackCandidates) const
 {
   std::vector<std::pair<sbnd::crt::CRTTrack, std::set<unsigned>>> chosenTracks;
 
@@ -293,7 +296,7 @@ std::vector<std::pair<sbnd::crt::CRTTrack, std::set<unsigned>>> sbnd::crt::CRTTr
 }
 
 double sbnd::crt::CRTTrackProducer::DistanceOfClosestApproach(const CRTTagger tagger, const art::Ptr<CRTSpacePoint> &spacePoint,
-                                                              const geo::Point_t &start, const geo::Vector_t &dir)
+                                                              const geo::Point_t &start, const geo::Vector_t &dir) const
 {
   const CoordSet constrainedPlane = CRTCommonUtils::GetTaggerDefinedCoordinate(tagger);
   const geo::Point_t spacePointCentre = spacePoint->Pos();
@@ -326,7 +329,7 @@ double sbnd::crt::CRTTrackProducer::DistanceOfClosestApproach(const CRTTagger ta
   return DistanceOfClosestApproach(constrainedPlane, planePoint, spacePointCentre, spacePointWidths);
 }
 
-bool sbnd::crt::CRTTrackProducer::IsPointInsideBox(const geo::Point_t &point, const geo::Point_t &centre, const geo::Point_t &widths)
+bool sbnd::crt::CRTTrackProducer::IsPointInsideBox(const geo::Point_t &point, const geo::Point_t &centre, const geo::Point_t &widths) const
 {
   return (point.X() < centre.X() + widths.X())
     && (point.X() > centre.X() - widths.X())
@@ -337,7 +340,7 @@ bool sbnd::crt::CRTTrackProducer::IsPointInsideBox(const geo::Point_t &point, co
 }
 
 double sbnd::crt::CRTTrackProducer::DistanceOfClosestApproach(const CoordSet &constrainedPlane, const geo::Point_t &point,
-                                                              const geo::Point_t &centre, const geo::Point_t &widths)
+                                                              const geo::Point_t &centre, const geo::Point_t &widths) const
 {
   switch(constrainedPlane)
     {
@@ -353,7 +356,7 @@ double sbnd::crt::CRTTrackProducer::DistanceOfClosestApproach(const CoordSet &co
     }
 }
 
-double sbnd::crt::CRTTrackProducer::MinimumApproach(const double &x, const double &dx, const double &y, const double &dy, const geo::Point2D_t &p)
+double sbnd::crt::CRTTrackProducer::MinimumApproach(const double &x, const double &dx, const double &y, const double &dy, const geo::Point2D_t &p) const
 {
   const geo::Point2D_t v1(x - dx, y - dy);
   const geo::Point2D_t v2(x - dx, y + dy);
@@ -367,7 +370,7 @@ double sbnd::crt::CRTTrackProducer::MinimumApproach(const double &x, const doubl
         });
 }
 
-double sbnd::crt::CRTTrackProducer::DistanceOfClosestApproach(const geo::Point2D_t &v1, const geo::Point2D_t &v2, const geo::Point2D_t &p)
+double sbnd::crt::CRTTrackProducer::DistanceOfClosestApproach(const geo::Point2D_t &v1, const geo::Point2D_t &v2, const geo::Point2D_t &p) const
 {
   const geo::Vector2D_t line = v2 - v1;
   const geo::Vector2D_t v1p  = p - v1;
@@ -384,7 +387,7 @@ double sbnd::crt::CRTTrackProducer::DistanceOfClosestApproach(const geo::Point2D
 
 void sbnd::crt::CRTTrackProducer::BestFitLine(const geo::Point_t &a, const geo::Point_t &b, const geo::Point_t &c, const CRTTagger &primary_tagger, 
                                               const CRTTagger &secondary_tagger, const CRTTagger &tertiary_tagger, geo::Point_t &start, 
-                                              geo::Point_t &mid, geo::Point_t &end, double &gof)
+                                              geo::Point_t &mid, geo::Point_t &end, double &gof) const
 {
   Eigen::Matrix3d X {
     {a.X(), a.Y(), a.Z()},
@@ -436,7 +439,7 @@ void sbnd::crt::CRTTrackProducer::BestFitLine(const geo::Point_t &a, const geo::
 
 }
 
-geo::Point_t sbnd::crt::CRTTrackProducer::LineTaggerIntersectionPoint(const geo::Point_t &start, const geo::Vector_t &dir, const CRTTagger &tagger)
+geo::Point_t sbnd::crt::CRTTrackProducer::LineTaggerIntersectionPoint(const geo::Point_t &start, const geo::Vector_t &dir, const CRTTagger &tagger) const
 {
   const CoordSet constrainedPlane = CRTCommonUtils::GetTaggerDefinedCoordinate(tagger);
   const CRTTaggerGeo taggerGeo    = fCRTGeoAlg.GetTagger(CRTCommonUtils::GetTaggerName(tagger));
@@ -471,7 +474,7 @@ geo::Point_t sbnd::crt::CRTTrackProducer::LineTaggerIntersectionPoint(const geo:
   return start + k * dir;
 }
 
-double sbnd::crt::CRTTrackProducer::TripleTrackToF(std::vector<double> times)
+double sbnd::crt::CRTTrackProducer::TripleTrackToF(std::vector<double> times) const
 {
   if(times.size() != 3)
     {
@@ -3,6 +3,8 @@
 
 #include "sbndcode/CRT/CRTSimulation/CRTDetSimAlg.h"
 
+#include <iterator>
+
 namespace sbnd {
 namespace crt {
 
@@ -14,6 +16,10 @@ namespace crt {
         ConfigureWaveform();
         ConfigureTimeOffset();
 
+        if (fParams.EqualizeSiPMTimes()) {
+            mf::LogWarning("CRTDetSimAlg") << "EqualizeSiPMTimes is on." << std::endl;
+        }
+
         fTaggers.clear();
         fData.clear();
         fAuxData.clear();
@@ -33,11 +39,27 @@ namespace crt {
         // estimate its effect on time delays.
         std::reverse(wvf_y.begin(),wvf_y.end());
 
-        fInterpolator = std::make_unique<ROOT::Math::Interpolator>
-            (wvf_y.size(), ROOT::Math::Interpolation::kLINEAR);
+        fWaveformX = wvf_x;
+        fWaveformY = wvf_y;
 
-        fInterpolator->SetData(wvf_x, wvf_y);
+    }
 
+    double CRTDetSimAlg::WaveformValue(double x) const
+    {
+        if (fWaveformX.size() < 2 || x < fWaveformX.front() || x > fWaveformX.back()) return 0.;
+
+        // Same bracketing and formula as the GSL linear interpolation
+        size_t ilo = 0, ihi = fWaveformX.size() - 1;
+        while (ihi > ilo + 1) {
+            size_t i = (ihi + ilo) / 2;
+            if (fWaveformX[i] > x) ihi = i;
+            else ilo = i;
+        }
+
+        double dx = fWaveformX[ilo + 1] - fWaveformX[ilo];
+        if (dx <= 0.) return 0.;
+
+        return fWaveformY[ilo] + (x - fWaveformX[ilo]) / dx * (fWaveformY[ilo + 1] - fWaveformY[ilo]);
     }
 
     void CRTDetSimAlg::ConfigureTimeOffset()
@@ -68,7 +90,7 @@ namespace crt {
 
 
 
-    uint16_t CRTDetSimAlg::WaveformEmulation(const uint32_t & time_delay, const double & adc)
+    uint16_t CRTDetSimAlg::WaveformEmulation(const uint32_t & time_delay, const double & adc) const
     {
 
         if (!fParams.DoWaveformEmulation())
@@ -82,7 +104,7 @@ namespace crt {
                 << "Time delay cannot be negative for waveform emulation to happen." << std::endl;
         }
 
-        if (time_delay > fParams.WaveformX().back())
+        if (time_delay > fWaveformX.back())
         {
             // If the time delay is more than the waveform rise time, we
             // will never be able to see this signal. So return a 0 ADC value.
@@ -90,7 +112,7 @@ namespace crt {
         }
 
         // Evaluate the waveform
-        double wf = fInterpolator->Eval(time_delay);
+        double wf = WaveformValue(time_delay);
         wf *= adc;
 
         if (fParams.DebugTrigger()) std::cout << "WaveformEmulation, time_delay " << time_delay
@@ -102,7 +124,7 @@ namespace crt {
 
 
     void CRTDetSimAlg::AddADC(FEBData & feb_data,
-                              const int & sipmID, const uint16_t & adc)
+                              const int & sipmID, const uint16_t & adc) const
     {
         uint16_t original_adc = feb_data.ADC(sipmID);
         uint16_t new_adc = original_adc + adc;
@@ -125,53 +147,71 @@ namespace crt {
 
 
 
-    void CRTDetSimAlg::ProcessStrips(const std::vector<StripData> & strips)
+    void CRTDetSimAlg::ProcessStrips(const std::vector<const StripData*> & strips, TaggerOutput & output) const
     {
-        std::map<uint16_t, FEBData> mac_to_febdata;
-        std::map<uint16_t, std::vector<AuxDetIDE>> mac_to_ides;
-        std::map<uint16_t, std::vector<int>> mac_to_sipmids;
+        // FEBs are grouped through a mac5 indexed array of positions in
+        // output.febs, which is reset on the way out
+        auto & feb_slot = output.feb_slot;
+        auto & macs = output.macs;
+        auto & febs = output.febs;
+        auto & sipmids = output.sipmids;
+
+        febs.clear();
+        sipmids.clear();
+        macs.clear();
 
         // TODO Add pedestal fluctuations
         std::array<uint16_t, 32> adc_pedestal = {static_cast<uint16_t>(fParams.QPed())};
 
-        for (auto & strip : strips)
+        for (auto strip_ptr : strips)
         {
+            const StripData & strip = *strip_ptr;
+
+            if (strip.mac5 >= feb_slot.size()) feb_slot.resize(strip.mac5 + 1, -1);
+
+            int & slot = feb_slot[strip.mac5];
 
             // First time we encounter this FEB...
-            if (!mac_to_febdata.count(strip.mac5))
+            if (slot < 0)
             {
+                slot = febs.size();
+                macs.push_back(strip.mac5);
+
                 // Construct a new FEBData object with only pedestal values (will be filled later)
-                mac_to_febdata[strip.mac5] = FEBData(strip.mac5,          // FEB ID
-                                                     strip.flags,         // Flags
-                                                     strip.sipm0.t0,      // Ts0
-                                                     strip.sipm0.t1,      // Ts1
-                                                     strip.unixs,         // UnixS
-                                                     adc_pedestal,        // ADCs
-                                                     strip.sipm0.sipmID); // Coinc
-
-                mac_to_ides[strip.mac5] = std::vector<AuxDetIDE>();
-                mac_to_sipmids[strip.mac5] = std::vector<int>();
+                febs.emplace_back(FEBData(strip.mac5,          // FEB ID
+                                          strip.flags,         // Flags
+                                          strip.sipm0.t0,      // Ts0
+                                          strip.sipm0.t1,      // Ts1
+                                          strip.unixs,         // UnixS
+                                          adc_pedestal,        // ADCs
+                                          strip.sipm0.sipmID), // Coinc
+                                  std::vector<AuxDetIDE>());
+                sipmids.emplace_back();
             }
             // ... all the other times we encounter this FEB
             else
             {
+                FEBData & feb_data = febs[slot].first;
+
                 // We want to save the earliest t1 and t0 for each FEB.
-                if (strip.sipm0.t1 < mac_to_febdata[strip.mac5].Ts1())
+                if (strip.sipm0.t1 < feb_data.Ts1())
                 {
-                    mac_to_febdata[strip.mac5].SetFlags(strip.flags);
-                    mac_to_febdata[strip.mac5].SetTs1(strip.sipm0.t1);
-                    mac_to_febdata[strip.mac5].SetTs0(strip.sipm0.t0);
-                    mac_to_febdata[strip.mac5].SetUnixS(strip.unixs);
-                    mac_to_febdata[strip.mac5].SetCoinc(strip.sipm0.sipmID);
+                    feb_data.SetFlags(strip.flags);
+                    feb_data.SetTs1(strip.sipm0.t1);
+                    feb_data.SetTs0(strip.sipm0.t0);
+                    feb_data.SetUnixS(strip.unixs);
+                    feb_data.SetCoinc(strip.sipm0.sipmID);
                 }
             }
         }
 
 
-        for (auto & strip : strips)
+        for (auto strip_ptr : strips)
         {
+            const StripData & strip = *strip_ptr;
+            int slot = feb_slot[strip.mac5];
 
-            auto &feb_data = mac_to_febdata[strip.mac5];
+            auto &feb_data = febs[slot].first;
             uint32_t trigger_time = feb_data.Ts1();
 
             uint16_t adc_sipm0 = WaveformEmulation(strip.sipm0.t1 - trigger_time, strip.sipm0.adc);
@@ -180,182 +220,193 @@ namespace crt {
             AddADC(feb_data, strip.sipm0.sipmID, adc_sipm0);
             AddADC(feb_data, strip.sipm1.sipmID, adc_sipm1);
 
-            auto &ides = mac_to_ides[strip.mac5];
-            ides.push_back(strip.ide);
+            febs[slot].second.push_back(strip.ide);
 
-            auto &sipmids = mac_to_sipmids[strip.mac5];
-            sipmids.push_back(std::min(strip.sipm0.sipmID, strip.sipm1.sipmID));
+            sipmids[slot].push_back(std::min(strip.sipm0.sipmID, strip.sipm1.sipmID));
         }
 
-        for (auto const& [mac, feb_data] : mac_to_febdata)
+        // Output in mac5 order
+        std::sort(macs.begin(), macs.end());
+
+        for (auto mac : macs)
         {
-            fData.push_back(std::make_pair(feb_data, mac_to_ides[mac]));
-            fAuxData.push_back(mac_to_sipmids[mac]);
+            int & slot = feb_slot[mac];
+            output.data.push_back(std::move(febs[slot]));
+            output.aux_data.push_back(std::move(sipmids[slot]));
+            slot = -1;
         }
 
-        if (fParams.DebugTrigger()) std::cout << "Constructed " << mac_to_febdata.size()
+        if (fParams.DebugTrigger()) std::cout << "Constructed " << macs.size()
                                               << " FEBData object(s)." << std::endl << std::endl;
     }
 
 
 
-    void CRTDetSimAlg::CreateData()
-    {
+    /** A struct to temporarily store information on a CRT Tagger trigger.
+     */
+    struct Trigger {
+        bool _is_bottom;
+        double _dead_time;
+        bool _planeX;
+        bool _planeY;
+        std::set<int> _mac5s;
+        std::vector<const StripData*> _strips;
+        uint32_t _trigger_time;
+        bool _debug;
+
+        Trigger(bool is_bottom, double dead_time, bool debug) {
+            _planeX = _planeY = false;
+            _is_bottom = is_bottom;
+            _dead_time = dead_time;
+            _debug = debug;
+        }
 
-        /** A struct to temporarily store information on a CRT Tagger trigger.
-         */
-        struct Trigger {
-            bool _is_bottom;
-            double _dead_time;
-            bool _planeX;
-            bool _planeY;
-            std::set<int> _mac5s;
-            std::vector<StripData> _strips;
-            uint32_t _trigger_time;
-            bool _debug;
-
-            Trigger(bool is_bottom, double dead_time, bool debug) {
-                _planeX = _planeY = false;
-                _is_bottom = is_bottom;
-                _dead_time = dead_time;
-                _debug = debug;
-            }
+        /** \brief Resets this trigger object */
+        void reset(uint32_t trigger_time) {
+            _planeX = _planeY = false;
+            _strips.clear();
+            _mac5s.clear();
+            _trigger_time = trigger_time;
 
-            /** \brief Resets this trigger object */
-            void reset(uint32_t trigger_time) {
-                _planeX = _planeY = false;
-                _strips.clear();
-                _mac5s.clear();
-                _trigger_time = trigger_time;
+            if(_debug) std::cout << "TRIGGER TIME IS " << _trigger_time << std::endl;
+        }
 
-                if(_debug) std::cout << "TRIGGER TIME IS " << _trigger_time << std::endl;
-            }
+        /** \brief Add a strip belonging to a particular trigger */
+        void add_strip(const StripData & strip) {
+            _strips.push_back(&strip);
+            _mac5s.insert(strip.mac5);
 
-            /** \brief Add a strip belonging to a particular trigger */
-            void add_strip(StripData strip) {
-                _strips.push_back(strip);
-                _mac5s.insert(strip.mac5);
+            if (strip.sipm_coinc) {
+                if (strip.orientation == 0) _planeX = true;
+                if (strip.orientation == 1) _planeY = true;
+            }
 
-                if (strip.sipm_coinc) {
-                    if (strip.orientation == 0) _planeX = true;
-                    if (strip.orientation == 1) _planeY = true;
-                }
+            if(_debug) std::cout << "\tAdded strip with mac " << strip.mac5
+                                 << " on plane " << strip.orientation
+                                 << ", with time " << strip.sipm0.t1 << std::endl;
+        }
 
-                if(_debug) std::cout << "\tAdded strip with mac " << strip.mac5
-                                     << " on plane " << strip.orientation
-                                     << ", with time " << strip.sipm0.t1 << std::endl;
+        /** \brief Tells is a tagger is triggering or not */
+        bool tagger_triggered() {
+            if (_is_bottom) {
+                return _planeX or _planeY;
             }
+            return _planeX and _planeY;
+        }
 
-            /** \brief Tells is a tagger is triggering or not */
-            bool tagger_triggered() {
-                if (_is_bottom) {
-                    return _planeX or _planeY;
-                }
-                return _planeX and _planeY;
-            }
+        /** \brief Returns true is the strip is in dead time */
+        bool is_in_dead_time(int mac5, int time) {
+            if (!_mac5s.count(mac5)) { return false; }
+            return (time <= _dead_time);
+        }
 
-            /** \brief Returns true is the strip is in dead time */
-            bool is_in_dead_time(int mac5, int time) {
-                if (!_mac5s.count(mac5)) { return false; }
-                return (time <= _dead_time);
-            }
+        void print_no_coinc(const StripData & strip) {
+            if (_debug) std::cout << "\tStrip with mac " << strip.mac5
+                                 << " on plane " << strip.orientation
+                                 << ", with time " << strip.sipm0.t1
+                                 << " -> didn't have SiPMs coincidence" << std::endl;
+        }
 
-            void print_no_coinc(StripData strip) {
-                if (_debug) std::cout << "\tStrip with mac " << strip.mac5
-                                     << " on plane " << strip.orientation
-                                     << ", with time " << strip.sipm0.t1
-                                     << " -> didn't have SiPMs coincidence" << std::endl;
-            }
+        void print_dead_time(const StripData & strip) {
+            if (_debug) std::cout << "\tStrip with mac " << strip.mac5
+                                 << " on plane " << strip.orientation
+                                 << ", with time " << strip.sipm0.t1
+                                 << " -> happened during dead time." << std::endl;
+        }
+    };
 
-            void print_dead_time(StripData strip) {
-                if (_debug) std::cout << "\tStrip with mac " << strip.mac5
-                                     << " on plane " << strip.orientation
-                                     << ", with time " << strip.sipm0.t1
-                                     << " -> happened during dead time." << std::endl;
-            }
-        };
 
+    void CRTDetSimAlg::SimulateTagger(const std::string & name, Tagger & tagger, TaggerOutput & output) const
+    {
+        mf::LogInfo("CRTDetSimAlg") << "Simulating trigger for tagger " << name << std::endl;
 
-        // Loop over all the CRT Taggers and simulate triggering, dead time, ...
-        for (auto iter : fTaggers)
-        {
-            auto & name = iter.first;
-            auto & tagger = iter.second;
+        bool is_bottom = name.find("Bottom") != std::string::npos;
+        Trigger trigger(is_bottom, fParams.DeadTime(), fParams.DebugTrigger());
 
-           mf::LogInfo("CRTDetSimAlg") << "Simulating trigger for tagger " << name << std::endl;
+        auto & strip_data_v = tagger.data;
 
-            bool is_bottom = name.find("Bottom") != std::string::npos;
-            Trigger trigger(is_bottom, fParams.DeadTime(), fParams.DebugTrigger());
+        // Time order the data
+        std::sort(strip_data_v.begin(), strip_data_v.end(),
+                  [](const StripData& strip1,
+                     const StripData& strip2) {
+                     return strip1.sipm0.t1 < strip2.sipm0.t1;
+                     });
 
-            auto & strip_data_v = tagger.data;
+        uint32_t trigger_ts1 = 0, current_time = 0;
+        bool first_trigger = true;
 
-            // Time order the data
-            std::sort(strip_data_v.begin(), strip_data_v.end(),
-                      [](const StripData& strip1,
-                         const StripData& strip2) {
-                         return strip1.sipm0.t1 < strip2.sipm0.t1;
-                         });
+        // Loop over all the strips in this tagger
+        for (size_t i = 0; i < strip_data_v.size(); i++)
+        {
+            auto & strip_data = strip_data_v[i];
 
-            uint32_t trigger_ts1 = 0, current_time = 0;
-            bool first_trigger = true;
+            current_time = strip_data.sipm0.t1;
 
-            // Loop over all the strips in this tagger
-            for (size_t i = 0; i < strip_data_v.size(); i++)
+            // Save the first trigger
+            if (strip_data.sipm_coinc and first_trigger)
             {
-                auto & strip_data = strip_data_v[i];
-
-                current_time = strip_data.sipm0.t1;
+                first_trigger = false;
+                trigger_ts1 = current_time;
+                trigger.reset(trigger_ts1);
+            }
 
-                // Save the first trigger
-                if (strip_data.sipm_coinc and first_trigger)
-                {
-                    first_trigger = false;
-                    trigger_ts1 = current_time;
-                    trigger.reset(trigger_ts1);
+            // Save strips belonging to this trigger
+            if (current_time - trigger_ts1 < fParams.TaggerPlaneCoincidenceWindow())
+            {
+                trigger.add_strip(strip_data);
+            }
+            // Create a new trigger if either the current tagger is not trigger, or,
+            // if it is triggered, if we are past the dead time. Also, always require
+            // both sipm coincidence.
+            else if ((!trigger.tagger_triggered() or
+                     (trigger.tagger_triggered() and
+                      !trigger.is_in_dead_time(strip_data.mac5, current_time - trigger_ts1))) and
+                     strip_data.sipm_coinc)
+            {
+                if (trigger.tagger_triggered()) {
+                    ProcessStrips(trigger._strips, output);
                 }
 
-                // Save strips belonging to this trigger
-                if (current_time - trigger_ts1 < fParams.TaggerPlaneCoincidenceWindow())
-                {
-                    trigger.add_strip(strip_data);
-                }
-                // Create a new trigger if either the current tagger is not trigger, or,
-                // if it is triggered, if we are past the dead time. Also, always require
-                // both sipm coincidence.
-                else if ((!trigger.tagger_triggered() or
-                         (trigger.tagger_triggered() and
-                          !trigger.is_in_dead_time(strip_data.mac5, current_time - trigger_ts1))) and
-                         strip_data.sipm_coinc)
-                {
-                    if (trigger.tagger_triggered()) {
-                        ProcessStrips(trigger._strips);
-                    }
+                // Set the current, new, trigger
+                trigger_ts1 = current_time;
 
-                    // Set the current, new, trigger
-                    trigger_ts1 = current_time;
+                // Reset the trigger object
+                trigger.reset(trigger_ts1);
 
-                    // Reset the trigger object
-                    trigger.reset(trigger_ts1);
+                // Add this strip, which created the trigger
+                trigger.add_strip(strip_data);
+            }
+            else if (!strip_data.sipm_coinc)
+            {
+                trigger.print_no_coinc(strip_data);
+            }
+            else
+            {
+                trigger.print_dead_time(strip_data);
+            }
 
-                    // Add this strip, which created the trigger
-                    trigger.add_strip(strip_data);
-                }
-                else if (!strip_data.sipm_coinc)
-                {
-                    trigger.print_no_coinc(strip_data);
-                }
-                else
-                {
-                    trigger.print_dead_time(strip_data);
-                }
+        } // loop over strips
 
-            } // loop over strips
+        if (trigger.tagger_triggered()) {
+            ProcessStrips(trigger._strips, output);
+        }
+    }
 
-            if (trigger.tagger_triggered()) {
-                ProcessStrips(trigger._strips);
-            }
 
-        } // loop over taggers
+    void CRTDetSimAlg::CreateData()
+    {
+        // The FEB scratch space of the output is reused from tagger to tagger
+        TaggerOutput output;
+
+        for (auto & [name, tagger] : fTaggers)
+        {
+            SimulateTagger(name, tagger, output);
+
+            std::move(output.data.begin(), output.data.end(), std::back_inserter(fData));
+            std::move(output.aux_data.begin(), output.aux_data.end(), std::back_inserter(fAuxData));
+            output.data.clear();
+            output.aux_data.clear();
+        }
 
         mf::LogInfo("CRTDetSimAlg") << "There are " << fData.size() << " FEBData objects." << std::endl;
 
@@ -363,10 +414,13 @@ namespace crt {
 
 
     void CRTDetSimAlg::FillTaggers(const uint32_t adid, const uint32_t adsid,
-                                   vector<sim::AuxDetIDE> ides) {
+                                   const vector<sim::AuxDetIDE> & ides) {
+
+        if (ides.empty()) return;
 
-        // Return the vector of IDEs
-        std::sort(ides.begin(), ides.end(),
+        // Time order the IDEs, in a buffer reused between channels
+        fSortedIDEs.assign(ides.begin(), ides.end());
+        std::sort(fSortedIDEs.begin(), fSortedIDEs.end(),
                   [](const sim::AuxDetIDE & a, const sim::AuxDetIDE & b) -> bool{
                     return ((a.entryT + a.exitT)/2) < ((b.entryT + b.exitT)/2);
                   });
@@ -381,11 +435,23 @@ namespace crt {
         const uint16_t mac5 = adid;
         const uint16_t orientation = module.orientation;
 
+        // Retrive the Tagger object
+        Tagger& tagger = fTaggers[module.taggerName];
+
+        // Apply ADC threshold and strip-level coincidence (both fibers fire)
+        const double threshold = static_cast<double>(fParams.QThreshold());
+
+        // Give the flags parameter values 3 as all should be "data events"
+        const uint16_t flags = 3;
+
+        // Use the current server time to give us a unix timestamp
+        const uint32_t unixs = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+
         // Simulate the CRT response for each hit
-        mf::LogInfo("CRTDetSimAlg") << "We have " << ides.size() << " IDE for this SimChannel." << std::endl;
-        for (size_t ide_i = 0; ide_i < ides.size(); ide_i++) {
+        if (fParams.DebugIDEs()) mf::LogInfo("CRTDetSimAlg") << "We have " << ides.size() << " IDE for this SimChannel." << std::endl;
+        for (size_t ide_i = 0; ide_i < fSortedIDEs.size(); ide_i++) {
 
-            sim::AuxDetIDE ide = ides[ide_i];
+            const sim::AuxDetIDE & ide = fSortedIDEs[ide_i];
 
             // Finally, what is the distance from the hit (centroid of the entry
             // and exit points) to the readout end?
@@ -396,8 +462,8 @@ namespace crt {
             double tTrue = (ide.entryT + ide.exitT) / 2 + fTimeOffset; // ns
             double eDep = ide.energyDeposited;
 
-            mf::LogInfo("CRTDetSimAlg") << "True IDE with time " << tTrue
-                                      << ", energy " << eDep << std::endl;
+            if (fParams.DebugIDEs()) mf::LogInfo("CRTDetSimAlg") << "True IDE with time " << tTrue
+                                                                 << ", energy " << eDep << std::endl;
 
             if (tTrue < 0) {
                 throw art::Exception(art::errors::LogicError)
@@ -430,7 +496,6 @@ namespace crt {
             uint32_t ts1_ch1 = getChannelTriggerTicks(tTrue, npe1, distToReadout);
 
             if (fParams.EqualizeSiPMTimes()) {
-                mf::LogWarning("CRTDetSimAlg") << "EqualizeSiPMTimes is on." << std::endl;
                 ts1_ch1 = ts1_ch0;
             }
 
@@ -450,16 +515,8 @@ namespace crt {
             uint32_t sipm0ID = stripID * 2 + 0;
             uint32_t sipm1ID = stripID * 2 + 1;
 
-            // Apply ADC threshold and strip-level coincidence (both fibers fire)
-            double threshold = static_cast<double>(fParams.QThreshold());
             bool sipm_coinc = false;
 
-            // Give the flags parameter values 3 as all should be "data events"
-            const uint16_t flags = 3;
-
-            // Use the current server time to give us a unix timestamp
-            const uint32_t unixs = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count();
-
             if (q0 > threshold &&
                 q1 > threshold &&
                 lar::util::absDiff(ts1_ch0, ts1_ch1) < fParams.StripCoincidenceWindow())
@@ -487,20 +544,16 @@ namespace crt {
                                       ts1_ch1,
                                       q1);
 
-            StripData strip_data = StripData(mac5,
-                                             flags,
-                                             orientation,
-                                             sipm0,
-                                             sipm1,
-                                             unixs,
-                                             sipm_coinc,
-                                             ide);
-
-            // Retrive the Tagger object
-            Tagger& tagger = fTaggers[module.taggerName];
-            tagger.data.push_back(strip_data);
+            tagger.data.emplace_back(mac5,
+                                     flags,
+                                     orientation,
+                                     sipm0,
+                                     sipm1,
+                                     unixs,
+                                     sipm_coinc,
+                                     ide);
 
-            mf::LogInfo("CRTDetSimAlg")
+            if (fParams.DebugIDEs()) mf::LogInfo("CRTDetSimAlg")
                 << "CRT HIT in adid/adsid " << adid << "/" << adsid << "\n"
                 << "MAC5 " << mac5 << "\n"
                 << "TRUE TIME  " << tTrue << "\n"
@@ -549,7 +602,7 @@ namespace crt {
         if (q0 < 0.) q0 = 0.;
         if (q1 < 0.) q1 = 0.;
 
-        mf::LogInfo("CRTSetSimAlg")
+        if (fParams.DebugIDEs()) mf::LogInfo("CRTSetSimAlg")
             << "CRT CHARGE RESPONSE: eDep = " << eDep
             << ", npeExpected = " << npeExpected
             << ", npe0 = " << npe0 << " -> q0 = " << q0
@@ -592,7 +645,7 @@ namespace crt {
 
         uint32_t time_int = static_cast<uint32_t>(time);
 
-        mf::LogInfo("CRTSetSimAlg")
+        if (fParams.DebugIDEs()) mf::LogInfo("CRTSetSimAlg")
             << "CRT TIMING: t0 = " << t0 << " (true G4 time)"
             << ", tDelayMean = " << tDelayMean
             << ", tDelayRMS = " << tDelayRMS
@@ -44,7 +44,6 @@
 // ROOT includes
 #include "TGeoManager.h"
 #include "TGeoNode.h"
-#include "Math/Interpolator.h"
 
 // CRT includes
 #include "sbnobj/SBND/CRT/FEBData.hh"
@@ -149,7 +148,7 @@ public:
      * @param adsid The AuxDetSensitiveChannelID
      * @param ides The vector of AuxDetIDE
      */
-    void FillTaggers(const uint32_t adid, const uint32_t adsid, std::vector<AuxDetIDE> ides);
+    void FillTaggers(const uint32_t adid, const uint32_t adsid, const std::vector<AuxDetIDE> & ides);
 
     /**
      * Returns FEBData objects.
@@ -218,7 +217,7 @@ public:
      * @param adc The simulated ADC counts (double) of this SiPM.
      * @return The simulated ADC counts after waveform emulation (in uint16_t format).
      */
-    uint16_t WaveformEmulation(const uint32_t & time_delay, const double & adc);
+    uint16_t WaveformEmulation(const uint32_t & time_delay, const double & adc) const;
 
 
     /**
@@ -239,10 +238,13 @@ private:
     double fG4RefTime; //!< The G4 reference time that can be used as a time offset
     double fTimeOffset; //!< The time that will be used in the simulation
 
-    std::unique_ptr<ROOT::Math::Interpolator> fInterpolator; //!< The interpolator used to estimate the CRT waveform
+    std::vector<double> fWaveformX; //!< The sampled CRT waveform times
+    std::vector<double> fWaveformY; //!< The normalised and reversed CRT waveform, linearly interpolated
 
     std::map<std::string, Tagger> fTaggers; //!< A list of hit taggers, before any coincidence requirement (name -> tagger)
 
+    std::vector<AuxDetIDE> fSortedIDEs; //!< Time ordered copy of the AuxDetIDEs being filled, reused between channels
+
     std::vector<std::pair<FEBData, std::vector<AuxDetIDE>>> fData; //!< This member stores the final FEBData for the CRT simulation
 
     std::vector<std::vector<int>> fAuxData; //!< This member stores the indeces of SiPM per AuxDetIDE
@@ -261,14 +263,39 @@ private:
      */
     void ConfigureTimeOffset();
 
+    /**
+     * The FEBData simulated for one tagger, and the scratch space used to
+     * group its strips by FEB (a mac5 indexed array of positions in febs).
+     */
+    struct TaggerOutput {
+        std::vector<std::pair<FEBData, std::vector<AuxDetIDE>>> data;
+        std::vector<std::vector<int>> aux_data;
+
+        std::vector<int> feb_slot;
+        std::vector<uint16_t> macs;
+        std::vector<std::pair<FEBData, std::vector<AuxDetIDE>>> febs;
+        std::vector<std::vector<int>> sipmids;
+    };
+
+    /**
+     * Simulates triggering and dead time for one tagger, time ordering its
+     * strips in place.
+     *
+     * @param name The tagger name
+     * @param tagger The tagger
+     * @param output Where the FEBData are added
+     */
+    void SimulateTagger(const std::string & name, Tagger & tagger, TaggerOutput & output) const;
+
     /**
      * Proccesses a set of CRT strips that belong to the same trigger. This method
      * takes as input all the strips that belong to a single CRT tagger-level trigger
-     * and constructs FEBData objects from them.
+     * and constructs FEBData objects from them, in ascending mac5 order.
      *
      * @param strips The set of strips that belong to the same trigger
+     * @param output Where the FEBData are added
      */
-    void ProcessStrips(const std::vector<StripData> & strips);
+    void ProcessStrips(const std::vector<const StripData*> & strips, TaggerOutput & output) const;
 
     /**
      * Adds ADCs to a certain SiPM in a FEBData object
@@ -277,7 +304,16 @@ private:
      * @param sipmID The SiPM index (0-31).
      * @param adc ADC value to be added.
      */
-    void AddADC(FEBData & feb_data, const int & sipmID, const uint16_t & adc);
+    void AddADC(FEBData & feb_data, const int & sipmID, const uint16_t & adc) const;
+
+    /**
+     * Linear interpolation of the sampled waveform, thread safe unlike
+     * ROOT::Math::Interpolator. Zero outside of the sampled range.
+     *
+     * @param x The time delay
+     * @return The interpolated waveform value
+     */
+    double WaveformValue(double x) const;
 
 };
 
@@ -170,6 +170,11 @@ namespace crt
       fhicl::Comment("If true, prints out additional debug messages for trigger debugging"),
       false
     };
+    fhicl::Atom<bool> DebugIDEs {
+      fhicl::Name("DebugIDEs"),
+      fhicl::Comment("If true, logs the simulated response to every AuxDetIDE"),
+      false
+    };
   };
 }
 }
@@ -34,7 +34,7 @@ namespace sbnd::crt {
   }
 
   SPMatchCandidate CRTSpacePointMatchAlg::GetClosestCRTSpacePoint(detinfo::DetectorPropertiesData const &detProp, const art::Ptr<recob::Track> &track,
-                                                                  const std::vector<art::Ptr<CRTSpacePoint>> &crtSPs, const art::Event &e)
+                                                                  const std::vector<art::Ptr<CRTSpacePoint>> &crtSPs, const art::Event &e) const
   {
     art::Handle<std::vector<recob::Track>> trackHandle;
     e.getByLabel(fTPCTrackLabel, trackHandle);
@@ -47,7 +47,7 @@ namespace sbnd::crt {
 
   SPMatchCandidate CRTSpacePointMatchAlg::GetClosestCRTSpacePoint(detinfo::DetectorPropertiesData const &detProp, const art::Ptr<recob::Track> &track,
                                                                   const std::vector<art::Ptr<recob::Hit>> &hits, const std::vector<art::Ptr<CRTSpacePoint>> &crtSPs,
-                                                                  const art::Event &e)
+                                                                  const art::Event &e) const
   {
     const geo::Point_t start = track->Vertex();
     const geo::Point_t end   = track->End();
@@ -62,7 +62,7 @@ namespace sbnd::crt {
 
   SPMatchCandidate CRTSpacePointMatchAlg::GetClosestCRTSpacePoint(detinfo::DetectorPropertiesData const &detProp, const art::Ptr<recob::Track> &track,
                                                                   const std::pair<double, double> t0MinMax, const std::vector<art::Ptr<CRTSpacePoint>> &crtSPs, const int driftDirection,
-                                                                  const art::Event &e)
+                                                                  const art::Event &e) const
   {
     if(track->Length() < fMinTPCTrackLength)
       return SPMatchCandidate();
@@ -137,7 +137,7 @@ namespace sbnd::crt {
   }
 
   std::pair<double, double> CRTSpacePointMatchAlg::TrackT0Range(detinfo::DetectorPropertiesData const &detProp, const double startX,
-                                                                const double endX, const int driftDirection, const std::pair<double, double> xLimits)
+                                                                const double endX, const int driftDirection, const std::pair<double, double> xLimits) const
   {
     if(driftDirection == 0)
       return std::make_pair(0, 0);
@@ -160,7 +160,7 @@ namespace sbnd::crt {
 
   double CRTSpacePointMatchAlg::DistOfClosestApproach(detinfo::DetectorPropertiesData const &detProp, geo::Point_t trackStart,
                                                       const geo::Vector_t &trackDir, const art::Ptr<CRTSpacePoint> &crtSP,
-                                                      const int driftDirection, const double t0, const art::Event &e)
+                                                      const int driftDirection, const double t0, const art::Event &e) const
   {
     const double xshift = driftDirection* t0 * detProp.DriftVelocity();
     trackStart.SetX(trackStart.X() + xshift);
@@ -179,7 +179,7 @@ namespace sbnd::crt {
       return CRTCommonUtils::SimpleDCA(crtSP, trackStart, trackDir);
   }
 
-  std::pair<geo::Vector_t, geo::Vector_t> CRTSpacePointMatchAlg::AverageTrackDirections(const art::Ptr<recob::Track> &track, const double frac)
+  std::pair<geo::Vector_t, geo::Vector_t> CRTSpacePointMatchAlg::AverageTrackDirections(const art::Ptr<recob::Track> &track, const double frac) const
   {
     const unsigned N          = track->NumberTrajectoryPoints();
     const unsigned NValid     = track->CountValidPoints();
@@ -212,7 +212,7 @@ namespace sbnd::crt {
   }
 
   std::pair<geo::Vector_t, geo::Vector_t> CRTSpacePointMatchAlg::TrackDirections(detinfo::DetectorPropertiesData const &detProp, const art::Ptr<recob::Track> &track,
-                                                                                 const double frac, const double CRTtime, const int driftDirection)
+                                                                                 const double frac, const double CRTtime, const int driftDirection) const
   {
     const unsigned N    = track->NumberTrajectoryPoints();
     const unsigned NMid = std::floor(N * frac);
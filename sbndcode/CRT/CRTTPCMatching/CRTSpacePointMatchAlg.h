@@ -144,26 +144,26 @@ namespace sbnd::crt {
     void reconfigure(const Config& config);
 
     SPMatchCandidate GetClosestCRTSpacePoint(detinfo::DetectorPropertiesData const &detProp, const art::Ptr<recob::Track> &track,
-                                             const std::vector<art::Ptr<CRTSpacePoint>> &crtSPs, const art::Event &e);
+                                             const std::vector<art::Ptr<CRTSpacePoint>> &crtSPs, const art::Event &e) const;
 
     SPMatchCandidate GetClosestCRTSpacePoint(detinfo::DetectorPropertiesData const &detProp, const art::Ptr<recob::Track> &track,
                                              const std::vector<art::Ptr<recob::Hit>> &hits, const std::vector<art::Ptr<CRTSpacePoint>> &crtSPs,
-                                             const art::Event &e);
+                                             const art::Event &e) const;
 
     SPMatchCandidate GetClosestCRTSpacePoint(detinfo::DetectorPropertiesData const &detProp, const art::Ptr<recob::Track> &track,
                                              const std::pair<double, double> t0MinMax, const std::vector<art::Ptr<CRTSpacePoint>> &crtSPs, const int driftDirection,
-                                             const art::Event &e);
+                                             const art::Event &e) const;
 
     std::pair<double, double> TrackT0Range(detinfo::DetectorPropertiesData const &detProp, const double startX,
-                                           const double endX, const int driftDirection, const std::pair<double, double> xLimits);
+                                           const double endX, const int driftDirection, const std::pair<double, double> xLimits) const;
 
     double DistOfClosestApproach(detinfo::DetectorPropertiesData const &detProp, geo::Point_t trackStart,
                                  const geo::Vector_t &trackDir, const art::Ptr<CRTSpacePoint> &crtSP,
-                                 const int driftDirection, const double t0, const art::Event &e);
+                                 const int driftDirection, const double t0, const art::Event &e) const;
 
-    std::pair<geo::Vector_t, geo::Vector_t> AverageTrackDirections(const art::Ptr<recob::Track> &track, const double frac);
+    std::pair<geo::Vector_t, geo::Vector_t> AverageTrackDirections(const art::Ptr<recob::Track> &track, const double frac) const;
     std::pair<geo::Vector_t, geo::Vector_t> TrackDirections(detinfo::DetectorPropertiesData const &detProp, const art::Ptr<recob::Track> &track,
-                                                            const double frac, const double CRTtime, const int driftDirection);
+                                                            const double frac, const double CRTtime, const int driftDirection) const;
 
   private:
 
@@ -9,7 +9,7 @@
 /// Modified from CRTT0Matching by Thomas Warburton.
 /////////////////////////////////////////////////////////////////////////////
 
-#include "art/Framework/Core/EDProducer.h"
+#include "art/Framework/Core/SharedProducer.h"
 #include "art/Framework/Core/ModuleMacros.h"
 #include "art/Framework/Principal/Event.h" 
 #include "art/Framework/Principal/Handle.h"
@@ -34,17 +34,17 @@ namespace sbnd::crt {
   class CRTSpacePointMatching;
 }
 
-class sbnd::crt::CRTSpacePointMatching : public art::EDProducer {
+class sbnd::crt::CRTSpacePointMatching : public art::SharedProducer {
 public:
 
-  explicit CRTSpacePointMatching(fhicl::ParameterSet const& p);
+  explicit CRTSpacePointMatching(fhicl::ParameterSet const& p, art::ProcessingFrame const&);
 
   CRTSpacePointMatching(CRTSpacePointMatching const&) = delete;
   CRTSpacePointMatching(CRTSpacePointMatching&&) = delete;
   CRTSpacePointMatching& operator=(CRTSpacePointMatching const&) = delete;
   CRTSpacePointMatching& operator=(CRTSpacePointMatching&&) = delete;
 
-  void produce(art::Event& e) override;
+  void produce(art::Event& e, art::ProcessingFrame const&) override;
 
 private:
 
@@ -54,16 +54,19 @@ private:
 };
 
 
-sbnd::crt::CRTSpacePointMatching::CRTSpacePointMatching(fhicl::ParameterSet const& p)
-  : EDProducer{p}
+sbnd::crt::CRTSpacePointMatching::CRTSpacePointMatching(fhicl::ParameterSet const& p, art::ProcessingFrame const&)
+  : SharedProducer{p}
   , fMatchingAlg(p.get<fhicl::ParameterSet>("MatchingAlg"))
   , fTPCTrackModuleLabel(p.get<art::InputTag>("TPCTrackModuleLabel"))
   , fCRTSpacePointModuleLabel(p.get<art::InputTag>("CRTSpacePointModuleLabel"))
   {
     produces<art::Assns<CRTSpacePoint, recob::Track, anab::T0>>();
+
+    // The matching algorithm is const, so events can be run concurrently
+    async<art::InEvent>();
   }
 
-void sbnd::crt::CRTSpacePointMatching::produce(art::Event& e)
+void sbnd::crt::CRTSpacePointMatching::produce(art::Event& e, art::ProcessingFrame const&)
 {
   auto crtSPTPCTrackAssn = std::make_unique<art::Assns<CRTSpacePoint, recob::Track, anab::T0>>();
 
@@ -29,7 +29,7 @@ namespace sbnd::crt {
   }
  
   TrackMatchCandidate CRTTrackMatchAlg::GetBestMatchedCRTTrack(detinfo::DetectorPropertiesData const &detProp, const art::Ptr<recob::Track> &tpcTrack,
-                                                               const std::vector<art::Ptr<CRTTrack>> &crtTracks, const art::Event &e)
+                                                               const std::vector<art::Ptr<CRTTrack>> &crtTracks, const art::Event &e) const
   {
     art::Handle<std::vector<recob::Track>> tpcTrackHandle;
     e.getByLabel(fTPCTrackLabel, tpcTrackHandle);
@@ -41,7 +41,7 @@ namespace sbnd::crt {
   }
 
   TrackMatchCandidate CRTTrackMatchAlg::GetBestMatchedCRTTrack(detinfo::DetectorPropertiesData const &detProp, const art::Ptr<recob::Track> &tpcTrack,
-                                                               const std::vector<art::Ptr<recob::Hit>> &hits, const std::vector<art::Ptr<CRTTrack>> &crtTracks)
+                                                               const std::vector<art::Ptr<recob::Hit>> &hits, const std::vector<art::Ptr<CRTTrack>> &crtTracks) const
   {
     if(tpcTrack->Length() < fMinTPCTrackLength)
       return TrackMatchCandidate();
@@ -75,7 +75,7 @@ namespace sbnd::crt {
       }
   }
 
-  bool CRTTrackMatchAlg::TPCIntersection(const geo::TPCGeo &tpcGeo, const art::Ptr<CRTTrack> &track, geo::Point_t &entry, geo::Point_t &exit)
+  bool CRTTrackMatchAlg::TPCIntersection(const geo::TPCGeo &tpcGeo, const art::Ptr<CRTTrack> &track, geo::Point_t &entry, geo::Point_t &exit) const
   {
     const geo::Point_t start = track->Start();
     const geo::Point_t end   = track->End();
@@ -87,7 +87,7 @@ namespace sbnd::crt {
   }
 
   std::vector<art::Ptr<CRTTrack>> CRTTrackMatchAlg::AllPossibleCRTTracks(detinfo::DetectorPropertiesData const &detProp, const art::Ptr<recob::Track> &tpcTrack,
-                                                                         const std::vector<art::Ptr<CRTTrack>> &crtTracks, const art::Event &e)
+                                                                         const std::vector<art::Ptr<CRTTrack>> &crtTracks, const art::Event &e) const
   {
     art::Handle<std::vector<recob::Track>> tpcTrackHandle;
     e.getByLabel(fTPCTrackLabel, tpcTrackHandle);
@@ -99,7 +99,7 @@ namespace sbnd::crt {
   }
 
   std::vector<art::Ptr<CRTTrack>> CRTTrackMatchAlg::AllPossibleCRTTracks(detinfo::DetectorPropertiesData const &detProp, const art::Ptr<recob::Track> &tpcTrack,
-                                                                         const std::vector<art::Ptr<recob::Hit>> &hits, const std::vector<art::Ptr<CRTTrack>> &crtTracks)
+                                                                         const std::vector<art::Ptr<recob::Hit>> &hits, const std::vector<art::Ptr<CRTTrack>> &crtTracks) const
   {
     std::vector<art::Ptr<CRTTrack>> candidates;
 
@@ -136,7 +136,7 @@ namespace sbnd::crt {
   }
 
   TrackMatchCandidate CRTTrackMatchAlg::ClosestCRTTrackByAngle(detinfo::DetectorPropertiesData const &detProp, const art::Ptr<recob::Track> &tpcTrack,
-                                                               const std::vector<art::Ptr<CRTTrack>> &crtTracks, const art::Event &e, const double maxDCA)
+                                                               const std::vector<art::Ptr<CRTTrack>> &crtTracks, const art::Event &e, const double maxDCA) const
   {
     art::Handle<std::vector<recob::Track>> tpcTrackHandle;
     e.getByLabel(fTPCTrackLabel, tpcTrackHandle);
@@ -148,7 +148,7 @@ namespace sbnd::crt {
   }
 
   TrackMatchCandidate CRTTrackMatchAlg::ClosestCRTTrackByAngle(detinfo::DetectorPropertiesData const &detProp, const art::Ptr<recob::Track> &tpcTrack,
-                                                               const std::vector<art::Ptr<recob::Hit>> &hits, const std::vector<art::Ptr<CRTTrack>> &crtTracks, const double maxDCA)
+                                                               const std::vector<art::Ptr<recob::Hit>> &hits, const std::vector<art::Ptr<CRTTrack>> &crtTracks, const double maxDCA) const
   {
     if(maxDCA == - 1.)
       return TrackMatchCandidate();
@@ -183,7 +183,7 @@ namespace sbnd::crt {
   }
 
   TrackMatchCandidate CRTTrackMatchAlg::ClosestCRTTrackByDCA(detinfo::DetectorPropertiesData const &detProp, const art::Ptr<recob::Track> &tpcTrack,
-                                                             const std::vector<art::Ptr<CRTTrack>> &crtTracks, const art::Event &e, const double maxAngle)
+                                                             const std::vector<art::Ptr<CRTTrack>> &crtTracks, const art::Event &e, const double maxAngle) const
   {
     art::Handle<std::vector<recob::Track>> tpcTrackHandle;
     e.getByLabel(fTPCTrackLabel, tpcTrackHandle);
@@ -195,7 +195,7 @@ namespace sbnd::crt {
   }
 
   TrackMatchCandidate CRTTrackMatchAlg::ClosestCRTTrackByDCA(detinfo::DetectorPropertiesData const &detProp, const art::Ptr<recob::Track> &tpcTrack,
-                                                             const std::vector<art::Ptr<recob::Hit>> &hits, const std::vector<art::Ptr<CRTTrack>> &crtTracks,  const double maxAngle)
+                                                             const std::vector<art::Ptr<recob::Hit>> &hits, const std::vector<art::Ptr<CRTTrack>> &crtTracks,  const double maxAngle) const
   {
     if(maxAngle == -1.)
       return TrackMatchCandidate();
@@ -229,7 +229,7 @@ namespace sbnd::crt {
   }
 
   TrackMatchCandidate CRTTrackMatchAlg::ClosestCRTTrackByScore(detinfo::DetectorPropertiesData const &detProp, const art::Ptr<recob::Track> &tpcTrack,
-                                                               const std::vector<art::Ptr<CRTTrack>> &crtTracks, const art::Event &e)
+                                                               const std::vector<art::Ptr<CRTTrack>> &crtTracks, const art::Event &e) const
   {
     art::Handle<std::vector<recob::Track>> tpcTrackHandle;
     e.getByLabel(fTPCTrackLabel, tpcTrackHandle);
@@ -241,7 +241,7 @@ namespace sbnd::crt {
   }
 
   TrackMatchCandidate CRTTrackMatchAlg::ClosestCRTTrackByScore(detinfo::DetectorPropertiesData const &detProp, const art::Ptr<recob::Track> &tpcTrack,
-                                                               const std::vector<art::Ptr<recob::Hit>> &hits, const std::vector<art::Ptr<CRTTrack>> &crtTracks)
+                                                               const std::vector<art::Ptr<recob::Hit>> &hits, const std::vector<art::Ptr<CRTTrack>> &crtTracks) const
   {
     const int driftDirection = TPCGeoUtil::DriftDirectionFromHits(fGeometryService, hits);
 
@@ -271,7 +271,7 @@ namespace sbnd::crt {
       return TrackMatchCandidate();
   }
 
-  double CRTTrackMatchAlg::AngleBetweenTracks(const art::Ptr<recob::Track> &tpcTrack, const art::Ptr<CRTTrack> &crtTrack)
+  double CRTTrackMatchAlg::AngleBetweenTracks(const art::Ptr<recob::Track> &tpcTrack, const art::Ptr<CRTTrack> &crtTrack) const
   {
     geo::Point_t crtStart = crtTrack->Start();
     geo::Point_t crtEnd   = crtTrack->End();
@@ -291,7 +291,7 @@ namespace sbnd::crt {
     return angle;
   }
 
-  double CRTTrackMatchAlg::AveDCABetweenTracks(const art::Ptr<recob::Track> &tpcTrack, const art::Ptr<CRTTrack> &crtTrack, const double shift)
+  double CRTTrackMatchAlg::AveDCABetweenTracks(const art::Ptr<recob::Track> &tpcTrack, const art::Ptr<CRTTrack> &crtTrack, const double shift) const
   {
     geo::Point_t crtStart = crtTrack->Start();
     geo::Point_t crtEnd   = crtTrack->End();
@@ -7,7 +7,7 @@
 /// E-mail address: tbrooks@fnal.gov
 /////////////////////////////////////////////////////////////////////////////
 
-#include "art/Framework/Core/EDProducer.h"
+#include "art/Framework/Core/SharedProducer.h"
 #include "art/Framework/Core/ModuleMacros.h"
 #include "art/Framework/Principal/Event.h" 
 #include "art/Framework/Principal/Handle.h"
@@ -31,17 +31,17 @@ namespace sbnd::crt {
   class CRTTrackMatching;
 }
 
-class sbnd::crt::CRTTrackMatching : public art::EDProducer {
+class sbnd::crt::CRTTrackMatching : public art::SharedProducer {
 public:
 
-  explicit CRTTrackMatching(fhicl::ParameterSet const& p);
+  explicit CRTTrackMatching(fhicl::ParameterSet const& p, art::ProcessingFrame const&);
 
   CRTTrackMatching(CRTTrackMatching const&) = delete;
   CRTTrackMatching(CRTTrackMatching&&) = delete;
   CRTTrackMatching& operator=(CRTTrackMatching const&) = delete;
   CRTTrackMatching& operator=(CRTTrackMatching&&) = delete;
 
-  void produce(art::Event& e) override;
+  void produce(art::Event& e, art::ProcessingFrame const&) override;
 
 private:
 
@@ -51,16 +51,19 @@ private:
 };
 
 
-sbnd::crt::CRTTrackMatching::CRTTrackMatching(fhicl::ParameterSet const& p)
-  : EDProducer{p}
+sbnd::crt::CRTTrackMatching::CRTTrackMatching(fhicl::ParameterSet const& p, art::ProcessingFrame const&)
+  : SharedProducer{p}
   , fMatchingAlg(p.get<fhicl::ParameterSet>("MatchingAlg"))
   , fTPCTrackModuleLabel(p.get<art::InputTag>("TPCTrackModuleLabel"))
   , fCRTTrackModuleLabel(p.get<art::InputTag>("CRTTrackModuleLabel"))
   {
     produces<art::Assns<CRTTrack, recob::Track, anab::T0>>();
+
+    // The matching algorithm is const, so events can be run concurrently
+    async<art::InEvent>();
   }
 
-void sbnd::crt::CRTTrackMatching::produce(art::Event& e)
+void sbnd::crt::CRTTrackMatching::produce(art::Event& e, art::ProcessingFrame const&)
 {
   auto crtTrackTPCTrackAssn = std::make_unique<art::Assns<CRTTrack, recob::Track, anab::T0>>();
 
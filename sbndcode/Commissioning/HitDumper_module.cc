@@ -78,6 +78,7 @@
 #include <map>
 #include <vector>
 #include <algorithm>
+#include <numeric>
 #include <iostream>
 #include <string>
 #include <cmath>
@@ -127,6 +128,8 @@ public:
   virtual void beginSubRun(art::SubRun const& sr) override;
 private:
 
+  /// Reserves the capacity of the TTree variables once at the start of the job
+  void ReserveVars();
   /// Resets the variables that are saved to the TTree
   void ResetVars();
   /// Resets wire hits tree variables
@@ -162,6 +165,21 @@ private:
   /// Resize the data structure for MCShowers
   void ResizeMCShower(int nShowers);
 
+  /// Fills the wire hits tree variables
+  void FillWireHits(const art::Event& evt);
+  /// Fills the crt strips, custom tracks, hits, tracks and software trigger tree variables
+  void FillCRT(const art::Event& evt);
+  /// Fills the optical hits and pmt trigger tree variables
+  void FillOptical(const art::Event& evt);
+  /// Fills the crossing muon tracks tree variables
+  void FillMuonTracks(const art::Event& evt);
+  /// Fills the raw waveforms around the wire hits
+  void FillWaveforms(const art::Event& evt);
+  /// Fills the MCParticle, MCTrack and MCShower tree variables
+  void FillMCParticles(const art::Event& evt);
+  /// Fills the generator truth tree variables
+  void FillTruth(const art::Event& evt);
+
   opdet::sbndPDMapAlg _pd_map;
 
   TTree* fTree;
@@ -520,6 +538,21 @@ void Hitdumper::analyze(const art::Event& evt)
   _t0 = 0.;
   // t0 = detprop->TriggerOffset();  // units of TPC ticks
 
+  // The waveforms are taken around the wire hits, so they are filled after them
+  FillWireHits(evt);
+  FillMuonTracks(evt);
+  FillWaveforms(evt);
+  FillCRT(evt);
+  FillOptical(evt);
+  FillMCParticles(evt);
+  FillTruth(evt);
+
+  fTree->Fill();
+
+}
+
+void Hitdumper::FillWireHits(const art::Event& evt)
+{
   //
   // Hits
   //
@@ -572,7 +605,10 @@ void Hitdumper::analyze(const art::Event& evt)
     _hit_width[counter] = hitlist[i]->RMS();
     counter ++;
   }
+}
 
+void Hitdumper::FillCRT(const art::Event& evt)
+{
   //
   // CRT strips
   //
@@ -597,7 +633,6 @@ void Hitdumper::analyze(const art::Event& evt)
   for (int i = 0; i < _nstr; i += 2){
     uint32_t chan = striplist[i]->Channel();
 
-    std::string taggerName  = fCRTGeoAlg.ChannelToTaggerName(chan);
     sbnd::crt::CRTTagger ip = fCRTGeoAlg.ChannelToTaggerEnum(chan);
 
     bool keep_tagger = false;
@@ -653,7 +688,18 @@ void Hitdumper::analyze(const art::Event& evt)
   if (fmakeCRTtracks) {
     std::cout<<"Making tracks, number of strips = "<< ns<<std::endl;
     int ntr = 0;
-    int iflag[1000] = {0};
+    std::vector<int> iflag(ns, 0);
+
+    // Order the strips in time so the coincidences for each strip can be found
+    // by walking a window around it instead of looping over all later strips
+    std::vector<int> time_order(ns);
+    std::iota(time_order.begin(), time_order.end(), 0);
+    std::stable_sort(time_order.begin(), time_order.end(),
+                     [this](int a, int b) { return _crt_time[a] < _crt_time[b]; });
+    std::vector<int> time_rank(ns);
+    for (int k = 0; k < ns; ++k) time_rank[time_order[k]] = k;
+    std::vector<int> coincident;
+
     for (int i = 0; i < (ns - 1); ++i) {
       if (iflag[i] == 0) {
         iflag[i] = 1;
@@ -715,60 +761,66 @@ void Hitdumper::analyze(const art::Event& evt)
             }
           }
         }
-        for (int j=i+1;j<ns;++j) {
-          float tdiff = fabs(_crt_time[i]-_crt_time[j]);
-          if (tdiff<0.1) {
-            iflag[j]=1;
-            if (_crt_plane[j]==sbnd::crt::kSouthTagger) {
-              if (_crt_orient[j]==kCRTVertical && _crt_adc[j]>1000) {
-                if (nh1x==0 ||  (_crt_module[j]==plane1xm)) {
-                  nh1x++;
-                  if (_crt_adc[j]>adc1x) {
-                    plane1tx=_crt_time[j];
-                    adc1x+=_crt_adc[j];
-                    plane1x=_crt_pos_x[j];
-                    plane1xm=_crt_module[j];
-                  }
+        // Later strips within 0.1 us of strip i, kept in index order
+        coincident.clear();
+        for (int k = time_rank[i] + 1; k < ns && fabs(_crt_time[i]-_crt_time[time_order[k]]) < 0.1; ++k) {
+          if (time_order[k] > i) coincident.push_back(time_order[k]);
+        }
+        for (int k = time_rank[i] - 1; k >= 0 && fabs(_crt_time[i]-_crt_time[time_order[k]]) < 0.1; --k) {
+          if (time_order[k] > i) coincident.push_back(time_order[k]);
+        }
+        std::sort(coincident.begin(), coincident.end());
+        for (int j : coincident) {
+          iflag[j]=1;
+          if (_crt_plane[j]==sbnd::crt::kSouthTagger) {
+            if (_crt_orient[j]==kCRTVertical && _crt_adc[j]>1000) {
+              if (nh1x==0 ||  (_crt_module[j]==plane1xm)) {
+                nh1x++;
+                if (_crt_adc[j]>adc1x) {
+                  plane1tx=_crt_time[j];
+                  adc1x+=_crt_adc[j];
+                  plane1x=_crt_pos_x[j];
+                  plane1xm=_crt_module[j];
                 }
               }
-              else if (_crt_orient[j]==kCRTHorizontal && _crt_adc[j]>1000) {
-                if (nh1y==0 ||  (_crt_module[j]==plane1ym)) {
-                  nh1y++;
-                  if (_crt_adc[j]>adc1y) {
-                    plane1ty=_crt_time[j];
-                    adc1y+=_crt_adc[j];
-                    plane1y=_crt_pos_y[j];
-                    plane1ym=_crt_module[j];
-                  }
+            }
+            else if (_crt_orient[j]==kCRTHorizontal && _crt_adc[j]>1000) {
+              if (nh1y==0 ||  (_crt_module[j]==plane1ym)) {
+                nh1y++;
+                if (_crt_adc[j]>adc1y) {
+                  plane1ty=_crt_time[j];
+                  adc1y+=_crt_adc[j];
+                  plane1y=_crt_pos_y[j];
+                  plane1ym=_crt_module[j];
                 }
               }
             }
-            else {
-              if (_crt_orient[j]==kCRTVertical && _crt_adc[j]>1000) {
-                if (nh2x==0 ||  (_crt_module[j]==plane2xm)) {
-                  nh2x++;
-                  if (_crt_adc[j]>adc2x) {
-                    plane2tx=_crt_time[j];
-                    adc2x+=_crt_adc[j];
-                    plane2x=_crt_pos_x[j];
-                    plane2xm=_crt_module[j];
-                  }
+          }
+          else {
+            if (_crt_orient[j]==kCRTVertical && _crt_adc[j]>1000) {
+              if (nh2x==0 ||  (_crt_module[j]==plane2xm)) {
+                nh2x++;
+                if (_crt_adc[j]>adc2x) {
+                  plane2tx=_crt_time[j];
+                  adc2x+=_crt_adc[j];
+                  plane2x=_crt_pos_x[j];
+                  plane2xm=_crt_module[j];
                 }
               }
-              else if (_crt_orient[j]==kCRTHorizontal && _crt_adc[j]>1000) {
-                if (nh2y==0 ||  (_crt_module[j]==plane2ym)) {
-                  nh2y++;
-                  if (_crt_adc[j]>adc2y) {
-                    plane2ty=_crt_time[j];
-                    adc2y+=_crt_adc[j];
-                    plane2y=_crt_pos_y[j];
-                    plane2ym=_crt_module[j];
-                  }
+            }
+            else if (_crt_orient[j]==kCRTHorizontal && _crt_adc[j]>1000) {
+              if (nh2y==0 ||  (_crt_module[j]==plane2ym)) {
+                nh2y++;
+                if (_crt_adc[j]>adc2y) {
+                  plane2ty=_crt_time[j];
+                  adc2y+=_crt_adc[j];
+                  plane2y=_crt_pos_y[j];
+                  plane2ym=_crt_module[j];
                 }
               }
             }
           }
-	      } // look for hits at the same time as hit i
+        } // look for hits at the same time as hit i
 	      if (nh1x>0 && nh1y>0 && nh2x>0 && nh2y>0 && adc1x<9000 && adc1y<9000 && adc2x<9000 && adc2y<9000) {
 	      // make a track!
           _ctrk_x1.push_back(plane1x);
@@ -870,6 +922,30 @@ void Hitdumper::analyze(const art::Event& evt)
   }
 
 
+  //
+  // CRT Software Trigger
+  //
+  if (freadcrtSoftTrigger){
+    art::Handle<std::vector<sbndaq::CRTmetric>> crtSoftTriggerListHandle;
+    std::vector<art::Ptr<sbndaq::CRTmetric>>    crtsofttriggerlist;
+    if (evt.getByLabel(fcrtSoftTriggerModuleLabel, crtSoftTriggerListHandle)){
+      art::fill_ptr_vector(crtsofttriggerlist, crtSoftTriggerListHandle);
+      ResetCrtSoftTriggerVars();
+      auto crtSoftTriggerMetrics = crtsofttriggerlist[0];
+
+      for (int i=0; i<7; i++){
+	      _crtSoftTrigger_hitsperplane[i] = crtSoftTriggerMetrics->hitsperplane[i];
+      }
+    }
+    else{
+      std::cout << "Failed to get sbndaq::crtMetric data product" << std::endl;
+    }
+
+  }
+}
+
+void Hitdumper::FillOptical(const art::Event& evt)
+{
   //
   // Optical Hits
   //
@@ -975,28 +1051,10 @@ void Hitdumper::analyze(const art::Event& evt)
       std::cout << "Failed to get sbnd::trigger::pmtSoftwareTrigger data product" << std::endl;
     }
   }
+}
 
-  //
-  // CRT Software Trigger
-  //
-  if (freadcrtSoftTrigger){
-    art::Handle<std::vector<sbndaq::CRTmetric>> crtSoftTriggerListHandle;
-    std::vector<art::Ptr<sbndaq::CRTmetric>>    crtsofttriggerlist;
-    if (evt.getByLabel(fcrtSoftTriggerModuleLabel, crtSoftTriggerListHandle)){
-      art::fill_ptr_vector(crtsofttriggerlist, crtSoftTriggerListHandle);
-      ResetCrtSoftTriggerVars();
-      auto crtSoftTriggerMetrics = crtsofttriggerlist[0];
-
-      for (int i=0; i<7; i++){
-	      _crtSoftTrigger_hitsperplane[i] = crtSoftTriggerMetrics->hitsperplane[i];
-      }
-    }
-    else{
-      std::cout << "Failed to get sbndaq::crtMetric data product" << std::endl;
-    }
-
-  }
-
+void Hitdumper::FillMuonTracks(const art::Event& evt)
+{
   //
   // Muon tracks 
   //
@@ -1048,15 +1106,12 @@ void Hitdumper::analyze(const art::Event& evt)
       std::cout << "Failed to get sbnd::comm::MuonTrack data product" << std::endl;
     }
   }
+}
 
+void Hitdumper::FillWaveforms(const art::Event& evt)
+{
   if (fcheckTransparency) {
 
-    _waveform_number.resize(_max_hits*_max_samples, -9999.);
-    _adc_on_wire.resize(_max_hits*_max_samples, -9999.);
-    _time_for_waveform.resize(_max_hits*_max_samples, -9999.);
-    _waveform_integral.resize(_max_hits*_max_samples, -9999.);
-    _adc_count_in_waveform.resize(_max_hits*_max_samples, -9999.);
-
     art::Handle<std::vector<raw::RawDigit>> digitVecHandle;
 
     bool retVal = evt.getByLabel(fDigitModuleLabel, digitVecHandle);
@@ -1070,66 +1125,76 @@ void Hitdumper::analyze(const art::Event& evt)
     int adc_counter = 1;
     _adc_count = _nhits * (fWindow * 2 + 1);
 
+    // index the hits by channel so each waveform only visits the hits on its own channel
+    std::map<int, std::vector<int>> hits_on_channel;
+    for (int ihit = 0; ihit < _nhits; ++ihit) {
+      hits_on_channel[_hit_channel[ihit]].push_back(ihit);
+    }
+
+    std::vector<short> rawadc;      //UNCOMPRESSED ADC VALUES.
+
     // loop over waveforms
     for(size_t rdIter = 0; rdIter < digitVecHandle->size(); ++rdIter) {
 
       //GET THE REFERENCE TO THE CURRENT raw::RawDigit.
       art::Ptr<raw::RawDigit> digitVec(digitVecHandle, rdIter);
       int channel   = digitVec->Channel();
-      auto fDataSize = digitVec->Samples();
-      std::vector<short> rawadc;      //UNCOMPRESSED ADC VALUES.
-      rawadc.resize(fDataSize);
 
       // see if there is a hit on this channel
-      for (int ihit = 0; ihit < _nhits; ++ihit) {
-        if (_hit_channel[ihit] == channel) {
+      auto channel_hits = hits_on_channel.find(channel);
+      if (channel_hits == hits_on_channel.end()) continue;
 
-          int pedestal = (int)digitVec->GetPedestal();
-          //UNCOMPRESS THE DATA.
-          if (fUncompressWithPed) {
-            raw::Uncompress(digitVec->ADCs(), rawadc, pedestal, digitVec->Compression());
-          }
-          else {
-            raw::Uncompress(digitVec->ADCs(), rawadc, digitVec->Compression());
-          }
+      auto fDataSize = digitVec->Samples();
+      rawadc.resize(fDataSize);
 
-          unsigned int bin = _hit_peakT[ihit];
-          unsigned int low_edge,high_edge;
-          if((int)bin > fWindow and _hit_plane[ihit] == 0) {
-            low_edge = bin - (2*fWindow);
-          }
-          else if ((int)bin>fWindow) {
-            low_edge = bin-fWindow;
-          }
-          else {
-            low_edge = 0;
-          }
-          high_edge = bin + fWindow;
-          if (high_edge > (fDataSize-1)) {
-            high_edge = fDataSize - 1;
-          }
-          double integral = 0.0;
-          waveform_number_tracker++;
-          int counter_for_adc_in_waveform = 0;
-          for (size_t ibin = low_edge; ibin <= high_edge; ++ibin) {
-            _adc_count_in_waveform[adc_counter] = counter_for_adc_in_waveform;
-            counter_for_adc_in_waveform++;
-            _waveform_number[adc_counter] = waveform_number_tracker;
-            _adc_on_wire[adc_counter] = rawadc[ibin]-pedestal;
-            _time_for_waveform[adc_counter] = ibin;
-            //std::cout << "DUMP: " << _waveform_number[adc_counter] << " " << _adc_count << " " << _hit_plane[ihit] << " " << _hit_wire[ihit] << " " <<ibin << " " << (rawadc[ibin]-pedestal) << " " << _time_for_waveform[adc_counter] << " " << _adc_on_wire[adc_counter] << std::endl;
-            integral+=_adc_on_wire[adc_counter];
-            _waveform_integral[adc_counter] = integral;
-            adc_counter++;
-          }
-          std::cout << "DUMP SUM: " << _hit_tpc[ihit] << " " << _hit_plane[ihit] << " " << _hit_wire[ihit] << " " <<  integral << " " << waveform_number_tracker << std::endl;
-          _hit_full_integral[ihit] = integral;
-        } // if hit channel matches waveform channel
+      int pedestal = (int)digitVec->GetPedestal();
+      //UNCOMPRESS THE DATA, once for all the hits on this channel.
+      if (fUncompressWithPed) {
+        raw::Uncompress(digitVec->ADCs(), rawadc, pedestal, digitVec->Compression());
+      }
+      else {
+        raw::Uncompress(digitVec->ADCs(), rawadc, digitVec->Compression());
+      }
+
+      for (int ihit : channel_hits->second) {
+        unsigned int bin = _hit_peakT[ihit];
+        unsigned int low_edge,high_edge;
+        if((int)bin > fWindow and _hit_plane[ihit] == 0) {
+          low_edge = bin - (2*fWindow);
+        }
+        else if ((int)bin>fWindow) {
+          low_edge = bin-fWindow;
+        }
+        else {
+          low_edge = 0;
+        }
+        high_edge = bin + fWindow;
+        if (high_edge > (fDataSize-1)) {
+          high_edge = fDataSize - 1;
+        }
+        double integral = 0.0;
+        waveform_number_tracker++;
+        int counter_for_adc_in_waveform = 0;
+        for (size_t ibin = low_edge; ibin <= high_edge; ++ibin) {
+          _adc_count_in_waveform[adc_counter] = counter_for_adc_in_waveform;
+          counter_for_adc_in_waveform++;
+          _waveform_number[adc_counter] = waveform_number_tracker;
+          _adc_on_wire[adc_counter] = rawadc[ibin]-pedestal;
+          _time_for_waveform[adc_counter] = ibin;
+          //std::cout << "DUMP: " << _waveform_number[adc_counter] << " " << _adc_count << " " << _hit_plane[ihit] << " " << _hit_wire[ihit] << " " <<ibin << " " << (rawadc[ibin]-pedestal) << " " << _time_for_waveform[adc_counter] << " " << _adc_on_wire[adc_counter] << std::endl;
+          integral+=_adc_on_wire[adc_counter];
+          _waveform_integral[adc_counter] = integral;
+          adc_counter++;
+        }
+        std::cout << "DUMP SUM: " << _hit_tpc[ihit] << " " << _hit_plane[ihit] << " " << _hit_wire[ihit] << " " <<  integral << " " << waveform_number_tracker << std::endl;
+        _hit_full_integral[ihit] = integral;
       } //end loop over hits
     }// end loop over waveforms
   }// end if fCheckTrasparency
+}
 
-
+void Hitdumper::FillMCParticles(const art::Event& evt)
+{
   if (freadMCParticle){
     //MCParticle
     art::Handle<std::vector<simb::MCParticle>> MCParticleListHandle;
@@ -1205,6 +1270,10 @@ void Hitdumper::analyze(const art::Event& evt)
     }
 
   } // end read mcparticle
+}
+
+void Hitdumper::FillTruth(const art::Event& evt)
+{
   if (freadTruth){
     //Genie
     int nGeniePrimaries = 0, nMCNeutrinos = 0;
@@ -1336,11 +1405,6 @@ void Hitdumper::analyze(const art::Event& evt)
 
 
   }//if (fReadTruth){
-
-
-
-  fTree->Fill();
-
 }
 
  void Hitdumper::beginJob()
@@ -1561,6 +1625,8 @@ void Hitdumper::analyze(const art::Event& evt)
     fTree->Branch("mcshower_TrackId",&mcshower_TrackId);
   }
 
+  ReserveVars();
+
   if (fsavePOTInfo) {
     _sr_tree = tfs->make<TTree>("pottree","");
     _sr_tree->Branch("run", &_sr_run, "run/I");
@@ -1720,6 +1786,52 @@ void Hitdumper::ResetMuonHitVars(int n){
   _mhit_charge.reserve(n);
 }
 
+void Hitdumper::ReserveVars() {
+
+  _hit_cryostat.reserve(_max_hits);
+  _hit_tpc.reserve(_max_hits);
+  _hit_plane.reserve(_max_hits);
+  _hit_wire.reserve(_max_hits);
+  _hit_channel.reserve(_max_hits);
+  _hit_peakT.reserve(_max_hits);
+  _hit_charge.reserve(_max_hits);
+  _hit_ph.reserve(_max_hits);
+  _hit_width.reserve(_max_hits);
+  _hit_full_integral.reserve(_max_hits);
+
+  ResetCRTStripsVars(_max_chits);
+  ResetCRTCustomTracksVars(_max_chits);
+
+  _chit_plane.reserve(_max_chits);
+  _chit_time.reserve(_max_chits);
+  _chit_x.reserve(_max_chits);
+  _chit_y.reserve(_max_chits);
+  _chit_z.reserve(_max_chits);
+
+  _ophit_opch.reserve(_max_ophits);
+  _ophit_opdet.reserve(_max_ophits);
+  _ophit_peakT.reserve(_max_ophits);
+  _ophit_startT.reserve(_max_ophits);
+  _ophit_riseT.reserve(_max_ophits);
+  _ophit_width.reserve(_max_ophits);
+  _ophit_area.reserve(_max_ophits);
+  _ophit_amplitude.reserve(_max_ophits);
+  _ophit_pe.reserve(_max_ophits);
+  _ophit_opdet_x.reserve(_max_ophits);
+  _ophit_opdet_y.reserve(_max_ophits);
+  _ophit_opdet_z.reserve(_max_ophits);
+  _ophit_opdet_type.reserve(_max_ophits);
+
+  if (fcheckTransparency) {
+    _waveform_number.resize(_max_hits*_max_samples, -9999.);
+    _adc_on_wire.resize(_max_hits*_max_samples, -9999.);
+    _time_for_waveform.resize(_max_hits*_max_samples, -9999.);
+    _waveform_integral.resize(_max_hits*_max_samples, -9999.);
+    _adc_count_in_waveform.resize(_max_hits*_max_samples, -9999.);
+  }
+
+}
+
 void Hitdumper::ResetVars() {
 
 
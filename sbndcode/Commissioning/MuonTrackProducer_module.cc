@@ -41,9 +41,247 @@
 #include <cmath>
 #include <bitset>
 #include <memory>
+#include <array>
 
 using std::vector;
 
+namespace {
+
+// Hough transform line finder for (wire, peakT, hit index) points.
+// The trig tables and the accumulator are built once and reused between
+// calls; every vote is removed again before returning so the accumulator
+// never needs to be cleared.
+class HoughLineFinder {
+public:
+   HoughLineFinder();
+
+   // Finds lines with param = {threshold, max_gap, range, min_length, muon_length}
+   void Find(const vector<vector<int>>& coords, const vector<int>& param, bool save_hits,
+             vector<vector<int>>& lines, vector<vector<int>>& hit_idx);
+
+private:
+   static constexpr int h = 3500; static constexpr int w = 2000; //range of hit_wire
+   static constexpr int accu_h = h + w + 1; static constexpr int accu_w = 180;
+   static constexpr int x_c = (w/2); static constexpr int y_c = (h/2);
+
+   // accumulator cell, rho is centred so negative values can be used
+   int& Accu(int r, int j) { return fAccu[(r + (accu_h-1)/2)*accu_w + j]; }
+   int Rho(int x, int y, int j) const { return int(round((x-x_c)*fCos[j] + (y-y_c)*fSin[j])); }
+   // peakT on the line (rho, theta) at wire x, theta in degrees
+   int LineY(int x, int rho, int theta) const { return int(round((rho - (x - x_c)*fCos[theta])/fSin[theta] + y_c)); }
+   void Vote(int x, int y, int inc);
+
+   std::array<double, accu_w> fCos, fSin;
+   vector<int> fAccu;
+
+   vector<char> fActive;                 // point can still seed a line
+   vector<char> fFree;                   // point is not yet part of a line
+   vector<std::array<int, 2>> fDeaccu;   // voted points that are still in the accumulator
+   vector<vector<int>> fOutlines, fOutHitIdx;
+};
+
+HoughLineFinder::HoughLineFinder()
+{
+   // accu_w bins over 180 degrees, so the bin index is also the angle in degrees
+   for (int j=0; j<accu_w; j++){
+      fCos[j] = cos(j*M_PI/accu_w);
+      fSin[j] = sin(j*M_PI/accu_w);
+   }
+}
+
+void HoughLineFinder::Vote(int x, int y, int inc)
+{
+   for (int j=0; j<accu_w; j++)
+      Accu(Rho(x,y,j),j) += inc;
+}
+
+void HoughLineFinder::Find(const vector<vector<int>>& coords, const vector<int>& param, bool save_hits,
+                           vector<vector<int>>& lines, vector<vector<int>>& hit_idx){
+   // set parameters 
+   int threshold = param.at(0);
+   int max_gap = param.at(1);
+   int range = param.at(2);
+   int min_length = param.at(3);
+   int muon_length = param.at(4);
+
+   TRandom3 rndgen;
+   if (fAccu.empty())
+      fAccu.assign(accu_h*accu_w, 0);
+
+   const int npoints = coords.size();
+   fActive.assign(npoints, 1);
+   fFree.assign(npoints, 1);
+   fDeaccu.clear();
+   fOutlines.clear();
+   fOutHitIdx.clear();
+
+   // loop over points and perform transform 
+   for (int count = npoints; count>0; count--){ 
+      int idx = rndgen.Uniform(count);
+      int max_val = threshold-1;
+      if (!fActive[idx])
+         continue; 
+      int x = coords[idx][0], y = coords[idx][1], rho = 0, theta = 0;
+      fDeaccu.push_back({x,y});
+      //loop over all angles and fill the accumulator 
+      for (int j=0; j<accu_w; j++){ 
+         int r = Rho(x,y,j);
+         int val = ++Accu(r,j);
+         if (max_val < val){
+            max_val = val;
+            rho = r;
+            theta = j*180/accu_w;
+         }
+      }
+      if (max_val < threshold){
+         fActive[idx] = 0;
+         continue;
+      }
+      //start at point and walk the corridor on both sides 
+      int endpoint[2][4] = {{0}};
+      vector<int> lines_idx;
+      for (int k=0; k<2;k++){
+         int i=0, gap=0;
+         while (gap < max_gap){ 
+            (k==0)? i++ : i--; 
+            if ( (idx+i) == npoints || (idx+i) <0) // if we reach the edges of the data set 
+               break;
+            if (!fFree[idx+i]) // if the point has already been removed 
+               continue;
+            int x1 = coords[idx+i][0], y1 = coords[idx+i][1], wire_idx = coords[idx+i][2]; 
+            if (endpoint[k][0]!= 0){ // ensure we don't jump large x-values 
+               if (abs(endpoint[k][0] - x1) > 30){
+                  break;
+               }
+            }
+            int y_val = LineY(x1, rho, theta);
+            if (abs(y_val-y1) <= range){
+               gap = 0;
+               endpoint[k][0] = x1; endpoint[k][1] = y1; endpoint[k][2] = wire_idx; endpoint[k][3] = idx+i;
+               fActive[idx+i] = 0;
+               fFree[idx+i] = 0;
+               if (save_hits){
+                  lines_idx.push_back(wire_idx);
+               }
+            }
+            else
+               gap++;
+         } // end of while loop 
+      } // end of k loop 
+
+      // unvote from the accumulator, order of the remaining points does not matter
+      for (int n = (fDeaccu.size()-1); n>=0; n--){ 
+         int x1 = fDeaccu[n][0], y1 = fDeaccu[n][1];
+         int y_val = LineY(x1, rho, theta);
+         if (y1 >= (y_val-range) && y1 <= (y_val+range)){
+            Vote(x1, y1, -1);
+            fDeaccu[n] = fDeaccu.back();
+            fDeaccu.pop_back();
+         }
+      } // end of deaccumulator loop
+
+      int x0_end = endpoint[0][0], y0_end = endpoint[0][1], x1_end = endpoint[1][0], y1_end = endpoint[1][1];
+      int wire0_end = endpoint[0][2], wire1_end = endpoint[1][2]; 
+      int idx0_end = endpoint[0][3], idx1_end = endpoint[1][3];
+      if ((x0_end==0 && y0_end==0) || (x1_end==0 && y1_end==0)) // don't add the (0,0) points 
+         continue;
+      fOutlines.push_back({x0_end, y0_end, x1_end, y1_end, wire0_end, wire1_end, idx0_end, idx1_end, rho, theta});
+      if (save_hits){
+         fOutHitIdx.push_back(std::move(lines_idx));
+      }
+
+   } // end of point loop 
+
+   // leave the accumulator empty for the next call
+   for (auto const& p : fDeaccu)
+      Vote(p[0], p[1], -1);
+   fDeaccu.clear();
+
+   vector<vector<int>>& outlines = fOutlines;
+   vector<vector<int>>& outhit_idx = fOutHitIdx;
+
+   // combine lines that are split 
+   for (size_t i=0; i<outlines.size(); i++){
+      bool same = false;
+      for (size_t j=i+1; j<outlines.size() && same == false; j++){ 
+         int xi_coords[2] = {outlines[i][0], outlines[i][2]}; int xj_coords[2] = {outlines[j][0], outlines[j][2]};
+         int yi_coords[2] = {outlines[i][1], outlines[i][3]}; int yj_coords[2] = {outlines[j][1], outlines[j][3]};
+         int rhoi = outlines[i][8], rhoj = outlines[j][8];
+         int thetai = outlines[i][9], thetaj = outlines[j][9]; 
+
+         int var = 100;
+         int rho_var = 30;
+         int theta_var = 20; 
+         for (int k=0; k<2 && same == false; k++){
+            for (int l=0; l<2 && same == false; l++){
+               int counter = 0; 
+               if ((xi_coords[k] < (xj_coords[l] + var)) && (xi_coords[k] > (xj_coords[l] - var)))
+                  counter++;
+               if ((yi_coords[k] < (yj_coords[l] + var)) && (yi_coords[k] > (yj_coords[l] - var)))
+                  counter++ ;
+               if ((rhoi < (rhoj + rho_var)) && (rhoi > (rhoj - rho_var)))
+                  counter++; 
+               if ((thetai < (thetaj + theta_var)) && (thetai > (thetaj - theta_var)))
+                  counter++;
+               if (counter >= 3){ // if at least three of the conditions are fulfilled 
+                  if(k==0){
+                     if(l==0){
+                        outlines[j][2] = outlines[i][0];
+                        outlines[j][3] = outlines[i][1];
+                     }
+                     else{
+                        outlines[j][0] = outlines[i][0];
+                        outlines[j][1] = outlines[i][1];
+                     }
+                  }
+                  else{
+                     if(l==0){
+                        outlines[j][2] = outlines[i][2]; 
+                        outlines[j][3] = outlines[i][3];                        
+                     }
+                     else{
+                        outlines[j][0] = outlines[i][2];
+                        outlines[j][1] = outlines[i][3]; 
+                     }  
+                  }
+                  same = true;
+                  // remove the extra segment 
+                  (outlines.at(i)).clear();
+                  if (save_hits){
+                     (outhit_idx.at(j)).insert( (outhit_idx.at(j)).end(),  (outhit_idx.at(i)).begin(),  (outhit_idx.at(i)).end()); 
+                     (outhit_idx.at(i)).clear();
+                  }
+               } 
+            }
+         }
+      } // end of j loop 
+   } // end of i loop 
+
+   for (size_t i=0; i < outlines.size(); i++){
+      if ((outlines.at(i)).empty())
+         continue;
+      int x0_end = outlines[i][0], y0_end = outlines[i][1], x1_end = outlines[i][2], y1_end = outlines[i][3];
+      if (muon_length!=0){
+         int y_diff = abs(y0_end-y1_end);
+         if (y_diff > muon_length){
+            lines.push_back(outlines.at(i));
+            if (save_hits)
+               hit_idx.push_back(outhit_idx.at(i)); 
+         }
+      }
+      else{
+         float length = sqrt(pow(x1_end - x0_end, 2) + pow(y1_end - y0_end, 2) * 1.0);
+         if (length > min_length){
+            lines.push_back(outlines.at(i));
+            if (save_hits)
+               hit_idx.push_back(outhit_idx.at(i)); 
+         }
+      }
+   }
+} // end of hough 
+
+} // namespace
+
 class MuonTrackProducer: public art::EDProducer {
 public:
     // The destructor generated by the compiler is fine for classes
@@ -68,11 +306,15 @@ private:
    void ResetInductionHitVectors(int n);
    // Resets variables for AC Crossing muons 
    void ResetMuonVariables(int n); 
-   // Finds distance between two points 
-   float Distance(int x1, int y1, int x2, int y2);
-   // Performs Hough Transform for collection planes
-   void Hough(vector<vector<int>> coords, vector<int> param, bool save_hits, int nentry, 
-              vector<vector<int>>& lines, vector<vector<int>>& hit_idx);
+   // Input and output of a single plane/TPC Hough transform
+   struct HoughJob {
+      const vector<vector<int>>* coords;
+      vector<vector<int>>* lines;
+      vector<vector<int>>* hit_idx;
+      bool save_hits;
+   };
+   // Performs independent Hough Transforms, reusing one accumulator
+   void RunHough(const vector<HoughJob>& jobs, const vector<int>& param);
    // Finds t0, stores them in a vector<vector<double>>     
    void FindEndpoints(vector<vector<int>>& lines_col, vector<vector<int>>& lines_ind, vector<vector<int>>& hit_idx, 
                       int range, vector<art::Ptr<recob::Hit>> hitlist, 
@@ -118,6 +360,8 @@ private:
 
    int fLineCount;       // number of estimated hit lines/muon tracks 
 
+   HoughLineFinder fHoughFinder;
+
    // services 
    art::ServiceHandle<art::TFileService> tfs;
    geo::GeometryCore const* fGeometryService;
@@ -194,8 +438,8 @@ void MuonTrackProducer::produce(art::Event & evt)
    // perform hough transform
    bool save_col_hits = true;
    vector<int> HoughParam{fHoughThreshold, fHoughMaxGap, fHoughRange, fHoughMinLength, fHoughMuonLength};
-   Hough(hit_02, HoughParam, save_col_hits, event, lines_02, hit_idx_02);
-   Hough(hit_12, HoughParam, save_col_hits, event, lines_12, hit_idx_12);
+   RunHough({{&hit_02, &lines_02, &hit_idx_02, save_col_hits},
+             {&hit_12, &lines_12, &hit_idx_12, save_col_hits}}, HoughParam);
 
    bool muon_in_tpc0 = !(lines_02.empty()); // will be true if a muon was detected in tpc0 
    bool muon_in_tpc1 = !(lines_12.empty()); // will be true if a muon was detected in tpc1
@@ -224,17 +468,22 @@ void MuonTrackProducer::produce(art::Event & evt)
       }
       bool save_ind_hits = false;
       vector<vector<int>> ind_empty; // placeholder empty vector 
+      vector<HoughJob> ind_jobs;
       if (muon_in_tpc0){
-         Hough(hit_00, HoughParam, save_ind_hits, event, lines_00, ind_empty);
-         Hough(hit_01, HoughParam, save_ind_hits, event, lines_01, ind_empty);
+         ind_jobs.push_back({&hit_00, &lines_00, &ind_empty, save_ind_hits});
+         ind_jobs.push_back({&hit_01, &lines_01, &ind_empty, save_ind_hits});
+      }
+      if (muon_in_tpc1){
+         ind_jobs.push_back({&hit_10, &lines_10, &ind_empty, save_ind_hits});
+         ind_jobs.push_back({&hit_11, &lines_11, &ind_empty, save_ind_hits});
+      }
+      RunHough(ind_jobs, HoughParam);
 
+      if (muon_in_tpc0){
          FindEndpoints(lines_02, lines_00, hit_idx_02, fEndpointRange, hitlist, muon_endpoints, muon_hitpeakT, muon_hit_idx);
          FindEndpoints(lines_02, lines_01, hit_idx_02, fEndpointRange, hitlist, muon_endpoints, muon_hitpeakT, muon_hit_idx);
       }
       if (muon_in_tpc1){
-         Hough(hit_10, HoughParam, save_ind_hits, event, lines_10, ind_empty);
-         Hough(hit_11, HoughParam, save_ind_hits, event, lines_11, ind_empty);
-
          FindEndpoints(lines_12, lines_10, hit_idx_12, fEndpointRange, hitlist, muon_endpoints, muon_hitpeakT, muon_hit_idx);
          FindEndpoints(lines_12, lines_11, hit_idx_12, fEndpointRange, hitlist, muon_endpoints, muon_hitpeakT, muon_hit_idx);
       }
@@ -283,203 +532,11 @@ void MuonTrackProducer::produce(art::Event & evt)
    evt.put(std::move(muon_tracks_assn)); 
 } // MuonTrackProducer::produce()
 
-float MuonTrackProducer::Distance(int x1, int y1, int x2, int y2){
-   return sqrt(pow(x2 - x1, 2) + pow(y2 - y1, 2) * 1.0);
-}
-
-void MuonTrackProducer::Hough(vector<vector<int>> coords, vector<int> param,  bool save_hits, int nentry,
-                              vector<vector<int>>& lines, vector<vector<int>>& hit_idx){
-   // set parameters 
-   int threshold = param.at(0);
-   int max_gap = param.at(1);
-   int range = param.at(2);
-   int min_length = param.at(3);
-   int muon_length = param.at(4);
-
-   // set global variables 
-   TRandom3 rndgen;
-   const int h = 3500; const int w = 2000; //range of hit_wire
-   constexpr int accu_h = h + w + 1 ; const int accu_w = 180; 
-   const int x_c = (w/2); const int y_c = (h/2);
-
-   // create accumulator/pointer to accumulator 
-   int accu[accu_h][accu_w] = {{0}};
-   int (*adata)[accu_w];
-   adata = &accu[(accu_h-1)/2]; // have pointer point to the middle of the accumulator array (then we can use negative indices)
-
-   // declare necessary vectors 
-   vector<vector<int>> data = coords; // points will not be removed 
-   vector<vector<int>> deaccu; // deaccumulator
-   vector<vector<int>> outlines; 
-   vector<vector<int>> outhit_idx; 
-
-   // loop over points and perform transform 
-   int count = coords.size(); 
-   for ( ; count>0; count--){ 
-      int idx = rndgen.Uniform(count);
-      int max_val = threshold-1;
-      if ((coords.at(idx)).empty())
-         continue; 
-      int x = coords[idx][0], y = coords[idx][1], rho = 0, theta = 0;
-      vector<int> v{x,y}; 
-      deaccu.push_back(v);
-      //loop over all angles and fill the accumulator 
-      for (int j=0; j<accu_w; j++){ 
-         int r = int(round((x-x_c)*cos(j*M_PI/accu_w) + (y-y_c)*sin(j*M_PI/accu_w)));
-         int val = ++(adata[r][j]);       
-         if (max_val < val){
-            max_val = val;
-            rho = r;
-            theta = j*180/accu_w;
-         }
-      }
-      if (max_val < threshold){
-         (coords.at(idx)).clear(); 
-         continue;
-      }
-      //start at point and walk the corridor on both sides 
-      vector<vector<int>> endpoint(2, vector<int>(4)); 
-      vector<int> lines_idx;
-      lines_idx.clear(); 
-      for (int k=0; k<2;k++){
-         int i=0, gap=0;
-         while (gap < max_gap){ 
-            (k==0)? i++ : i--; 
-            if ( (idx+i) == int(data.size()) || (idx+i) <0) // if we reach the edges of the data set 
-               break;
-            if ((data.at(idx+i)).empty()) // if the point has already been removed 
-               continue;
-            int x1 = data[idx+i][0], y1 = int(data[idx+i][1]), wire_idx = data[idx+i][2]; 
-            int last_x, diffx; 
-            if (endpoint[k][0]!= 0){ // ensure we don't jump large x-values 
-               last_x = endpoint[k][0];
-               diffx = abs(last_x - x1);
-               if (diffx > 30){
-                  break;
-               }
-            }
-            int y_val = int(round((rho - (x1 - x_c)*cos(theta*M_PI/180.0))/sin(theta*M_PI/180.0) + y_c));
-            if (abs(y_val-y1) <= range){
-               gap = 0;
-               endpoint[k] = {x1, y1, wire_idx, idx+i};
-               (coords.at(idx+i)).clear();
-               (data.at(idx+i)).clear();
-               if (save_hits){
-                  lines_idx.push_back(wire_idx);
-               }
-            }
-            else
-               gap++;
-         } // end of while loop 
-      } // end of k loop 
-
-      // unvote from the accumulator 
-      for (int n = (deaccu.size()-1); n>=0; n--){ 
-         int x1 = deaccu[n][0], y1 = int(deaccu[n][1]);
-         int y_val = int(round((rho - (x1 - x_c)*cos(theta*M_PI/180.0))/sin(theta*M_PI/180.0) + y_c));
-         if (y1 >= (y_val-range) && y1 <= (y_val+range)){
-            for (int m=0; m<accu_w; m++){
-               int r = int(round((x1-x_c)*cos(m*M_PI/accu_w) + (y1-y_c)*sin(m*M_PI/accu_w)));
-               (adata[r][m])--;
-            }
-            deaccu.erase(deaccu.begin() + n);
-         }
-      } // end of deaccumulator loop
-
-      int x0_end = endpoint[0][0], y0_end = endpoint[0][1], x1_end = endpoint[1][0], y1_end = endpoint[1][1];
-      int wire0_end = endpoint[0][2], wire1_end = endpoint[1][2]; 
-      int idx0_end = endpoint[0][3], idx1_end = endpoint[1][3];
-      if ((x0_end==0 && y0_end==0) || (x1_end==0 && y1_end==0)) // don't add the (0,0) points 
-         continue;
-      vector<int> outline = {x0_end, y0_end, x1_end, y1_end, wire0_end, wire1_end, idx0_end, idx1_end, rho, theta};
-
-      outlines.push_back(outline);
-      if (save_hits){
-         outhit_idx.push_back(lines_idx);
-      }
-
-   } // end of point loop 
-   // combine lines that are split 
-   for (size_t i=0; i<outlines.size(); i++){
-      bool same = false;
-      for (size_t j=i+1; j<outlines.size() && same == false; j++){ 
-         int xi_coords[2] = {outlines[i][0], outlines[i][2]}; int xj_coords[2] = {outlines[j][0], outlines[j][2]};
-         int yi_coords[2] = {outlines[i][1], outlines[i][3]}; int yj_coords[2] = {outlines[j][1], outlines[j][3]};
-         int rhoi = outlines[i][8], rhoj = outlines[j][8];
-         int thetai = outlines[i][9], thetaj = outlines[j][9]; 
-
-         int var = 100;
-         int rho_var = 30;
-         int theta_var = 20; 
-         for (int k=0; k<2 && same == false; k++){
-            for (int l=0; l<2 && same == false; l++){
-               int counter = 0; 
-               if ((xi_coords[k] < (xj_coords[l] + var)) && (xi_coords[k] > (xj_coords[l] - var)))
-                  counter++;
-               if ((yi_coords[k] < (yj_coords[l] + var)) && (yi_coords[k] > (yj_coords[l] - var)))
-                  counter++ ;
-               if ((rhoi < (rhoj + rho_var)) && (rhoi > (rhoj - rho_var)))
-                  counter++; 
-               if ((thetai < (thetaj + theta_var)) && (thetai > (thetaj - theta_var)))
-                  counter++;
-               if (counter >= 3){ // if at least three of the conditions are fulfilled 
-                  if(k==0){
-                     if(l==0){
-                        outlines[j][2] = outlines[i][0];
-                        outlines[j][3] = outlines[i][1];
-                     }
-                     else{
-                        outlines[j][0] = outlines[i][0];
-                        outlines[j][1] = outlines[i][1];
-                     }
-                  }
-                  else{
-                     if(l==0){
-                        outlines[j][2] = outlines[i][2]; 
-                        outlines[j][3] = outlines[i][3];                        
-                     }
-                     else{
-                        outlines[j][0] = outlines[i][2];
-                        outlines[j][1] = outlines[i][3]; 
-                     }  
-                  }
-                  same = true;
-                  // remove the extra segment 
-                  (outlines.at(i)).clear();
-                  if (save_hits){
-                     (outhit_idx.at(j)).insert( (outhit_idx.at(j)).end(),  (outhit_idx.at(i)).begin(),  (outhit_idx.at(i)).end()); 
-                     (outhit_idx.at(i)).clear();
-                  }
-               } 
-            }
-         }
-      } // end of j loop 
-   } // end of i loop 
 
-   for (size_t i=0; i < outlines.size(); i++){
-      if ((outlines.at(i)).empty())
-         continue;
-      int x0_end = outlines[i][0], y0_end = outlines[i][1], x1_end = outlines[i][2], y1_end = outlines[i][3];
-      if (muon_length!=0){
-         int y_diff = abs(y0_end-y1_end);
-         if (y_diff > muon_length){
-            lines.push_back(outlines.at(i));
-            if (save_hits)
-               hit_idx.push_back(outhit_idx.at(i)); 
-         }
-      }
-      else{
-         float length = Distance(x0_end,y0_end,x1_end,y1_end);
-         if (length > min_length){
-            lines.push_back(outlines.at(i));
-            if (save_hits)
-               hit_idx.push_back(outhit_idx.at(i)); 
-         }
-      }
-   }
-   //free memory 
-   data.clear(); deaccu.clear(); outlines.clear(); outhit_idx.clear();
-} // end of hough 
+void MuonTrackProducer::RunHough(const vector<HoughJob>& jobs, const vector<int>& param){
+   for (auto const& job : jobs)
+      fHoughFinder.Find(*job.coords, param, job.save_hits, *job.lines, *job.hit_idx);
+}
 
 void MuonTrackProducer::ResetCollectionHitVectors(int n) {
    hit_02.clear(); 
@@ -0,0 +1,160 @@
+#include "StoppingChiSqFitter.h"
+
+// c++
+#include <cmath>
+#include <algorithm>
+
+namespace sbnd{
+
+StoppingChiSqFitter::StoppingChiSqFitter(unsigned maxIterations, double tolerance)
+  : fMaxIterations(maxIterations)
+  , fTolerance(tolerance)
+{
+}
+
+
+// Fit y = p0 to n contiguous points
+StoppingChiSqFitter::FitResult StoppingChiSqFitter::FitPol0(const double* y, size_t n) const{
+
+  FitResult result;
+  if(n < 1) return result;
+
+  // Least squares constant is just the mean
+  double sum = 0;
+  for(size_t i = 0; i < n; i++) sum += y[i];
+  double mean = sum/n;
+
+  double chi2 = 0;
+  for(size_t i = 0; i < n; i++){
+    double res = y[i] - mean;
+    chi2 += res*res;
+  }
+
+  result.valid = true;
+  result.p0 = mean;
+  result.chi2 = chi2;
+  return result;
+
+}
+
+
+// Fit y = exp(p0 + p1*x) to n contiguous points
+StoppingChiSqFitter::FitResult StoppingChiSqFitter::FitExpo(const double* x, const double* y, size_t n) const{
+
+  FitResult result;
+  if(n < 2) return result;
+
+  // Seed with a log-linear fit weighted by y^2, which approximates the linear space residuals
+  double sw = 0, swx = 0, swxx = 0, swl = 0, swxl = 0, sy = 0;
+  size_t npos = 0;
+  for(size_t i = 0; i < n; i++){
+    sy += y[i];
+    if(y[i] <= 0) continue;
+    double w = y[i]*y[i];
+    double l = std::log(y[i]);
+    sw += w;
+    swx += w*x[i];
+    swxx += w*x[i]*x[i];
+    swl += w*l;
+    swxl += w*x[i]*l;
+    npos++;
+  }
+
+  double p0 = 0;
+  double p1 = 0;
+  double det = sw*swxx - swx*swx;
+  if(npos >= 2 && det > 0){
+    p0 = (swxx*swl - swx*swxl)/det;
+    p1 = (sw*swxl - swx*swl)/det;
+  }
+  // Fall back to a flat exponential if the log fit is degenerate
+  else if(sy > 0){
+    p0 = std::log(sy/n);
+  }
+  else return result;
+
+  double chi2 = ExpoChiSq(x, y, n, p0, p1);
+  if(!std::isfinite(chi2)) return result;
+
+  // Refine in linear space with damped Gauss-Newton (Levenberg-Marquardt) steps
+  double lambda = 1e-3;
+  for(unsigned iter = 0; iter < fMaxIterations; iter++){
+
+    double a00 = 0, a01 = 0, a11 = 0, b0 = 0, b1 = 0;
+    for(size_t i = 0; i < n; i++){
+      double f = std::exp(p0 + p1*x[i]);
+      double r = y[i] - f;
+      double fx = f*x[i];
+      a00 += f*f;
+      a01 += f*fx;
+      a11 += fx*fx;
+      b0 += f*r;
+      b1 += fx*r;
+    }
+
+    // Increase damping until a step reduces the chi2
+    bool improved = false;
+    double newChi2 = chi2;
+    while(lambda < 1e10){
+      double d00 = a00*(1 + lambda);
+      double d11 = a11*(1 + lambda);
+      double ddet = d00*d11 - a01*a01;
+      if(ddet > 0){
+        double dp0 = (d11*b0 - a01*b1)/ddet;
+        double dp1 = (d00*b1 - a01*b0)/ddet;
+        newChi2 = ExpoChiSq(x, y, n, p0 + dp0, p1 + dp1);
+        if(std::isfinite(newChi2) && newChi2 <= chi2){
+          p0 += dp0;
+          p1 += dp1;
+          lambda = std::max(lambda/10, 1e-12);
+          improved = true;
+          break;
+        }
+      }
+      lambda *= 10;
+    }
+
+    if(!improved) break;
+    double change = chi2 - newChi2;
+    chi2 = newChi2;
+    if(change <= fTolerance*chi2) break;
+  }
+
+  result.valid = true;
+  result.p0 = p0;
+  result.p1 = p1;
+  result.chi2 = chi2;
+  return result;
+
+}
+
+
+// Ratio of pol0 to exponential chi2, returns false if either fit fails
+bool StoppingChiSqFitter::ChiSqRatio(const double* x, const double* y, size_t n, double& ratio) const{
+
+  FitResult polfit = FitPol0(y, n);
+  if(!polfit.valid) return false;
+
+  FitResult expfit = FitExpo(x, y, n);
+  if(!expfit.valid) return false;
+
+  ratio = polfit.chi2/expfit.chi2;
+  return true;
+
+}
+
+
+// Sum of squared residuals for the exponential model
+double StoppingChiSqFitter::ExpoChiSq(const double* x, const double* y, size_t n, double p0, double p1) const{
+
+  double chi2 = 0;
+  for(size_t i = 0; i < n; i++){
+    double res = y[i] - std::exp(p0 + p1*x[i]);
+    chi2 += res*res;
+  }
+  return chi2;
+
+}
+
+
+}
@@ -0,0 +1,56 @@
+#ifndef STOPPINGCHISQFITTER_H_SEEN
+#define STOPPINGCHISQFITTER_H_SEEN
+
+
+///////////////////////////////////////////////
+// StoppingChiSqFitter.h
+//
+// Closed form pol0 and exponential least squares
+// fits of dE/dx vs residual range, used by the
+// stopping particle cosmic tagger in place of
+// ROOT TGraph/TF1 fits through Minuit.
+// Both fits use unit errors so the chi2 values
+// match those of TGraph::Fit("pol0"/"expo").
+///////////////////////////////////////////////
+
+// c++
+#include <cstddef>
+
+namespace sbnd{
+
+  class StoppingChiSqFitter {
+  public:
+
+    // Result of a fit, chi2 is only meaningful if valid is true
+    struct FitResult {
+      bool   valid = false;
+      double p0    = 0;
+      double p1    = 0;
+      double chi2  = 0;
+    };
+
+    StoppingChiSqFitter(unsigned maxIterations = 100, double tolerance = 1e-10);
+
+    // Fit y = p0 to n contiguous points
+    FitResult FitPol0(const double* y, size_t n) const;
+
+    // Fit y = exp(p0 + p1*x) to n contiguous points
+    // Seeded with a weighted log-linear fit then refined with Gauss-Newton steps
+    FitResult FitExpo(const double* x, const double* y, size_t n) const;
+
+    // Ratio of pol0 to exponential chi2, returns false if either fit fails
+    bool ChiSqRatio(const double* x, const double* y, size_t n, double& ratio) const;
+
+  private:
+
+    // Sum of squared residuals for the exponential model
+    double ExpoChiSq(const double* x, const double* y, size_t n, double p0, double p1) const;
+
+    unsigned fMaxIterations;
+    double   fTolerance;
+
+  };
+
+}
+
+#endif
@@ -36,7 +36,7 @@ void StoppingParticleCosmicIdAlg::reconfigure(const Config& config){
 }
 
 // Calculate the chi2 ratio of pol0 and exp fit to dE/dx vs residual range
-double StoppingParticleCosmicIdAlg::StoppingChiSq(geo::Point_t end, std::vector<art::Ptr<anab::Calorimetry>> calos){
+double StoppingParticleCosmicIdAlg::StoppingChiSq(geo::Point_t end, const std::vector<art::Ptr<anab::Calorimetry>>& calos){
 
   // If calorimetry object is null then return 0
   if(calos.size()==0) return -99999;
@@ -54,22 +54,29 @@ double StoppingParticleCosmicIdAlg::StoppingChiSq(geo::Point_t end, std::vector<
   // If there's something wrong with the calorimetry object return null
   if(calo->XYZ().size() != nhits || nhits < 1) return -99999;
 
+  const std::vector<float>& dedxs = calo->dEdx();
+  const std::vector<float>& resrgs = calo->ResidualRange();
+
   // Get the distance from the track point and the start/end of calo data
   double distStart = (calo->XYZ()[0] - end).Mag2();
   double distEnd = (calo->XYZ()[nhits-1] - end).Mag2();
 
+  // Flip the residual range if the track and calo objects don't match up
+  double flipOffset = 0;
+  bool flip = false;
+  if(distStart < distEnd && resrgs[0] > resrgs[nhits-1]){ flip = true; flipOffset = resrgs[0]; }
+  if(distStart > distEnd && resrgs[0] < resrgs[nhits-1]){ flip = true; flipOffset = resrgs[nhits-1]; }
+
   double maxDedx = 0;
   double resrgStart = 0;
   std::vector<double> v_resrg;
   std::vector<double> v_dedx;
+  v_resrg.reserve(nhits);
+  v_dedx.reserve(nhits);
   // Loop over plane's calorimetry data
   for(size_t i = 0; i < nhits; i++){
-    double dedx = calo->dEdx()[i];
-    double resrg = calo->ResidualRange()[i];
-
-    // Flip the residual range if the track and calo objects don't match up
-    if(distStart < distEnd && calo->ResidualRange()[0] > calo->ResidualRange()[nhits-1]) resrg = calo->ResidualRange()[0] - calo->ResidualRange()[i];
-    if(distStart > distEnd && calo->ResidualRange()[0] < calo->ResidualRange()[nhits-1]) resrg = calo->ResidualRange()[nhits-1] - calo->ResidualRange()[i];
+    double dedx = dedxs[i];
+    double resrg = flip ? flipOffset - resrgs[i] : resrgs[i];
 
     // Find the maximum dE/dx within a limit and the corresponding res range
     if(resrg < fResRangeMin && dedx > maxDedx && dedx < fDEdxMax){
@@ -81,12 +88,8 @@ double StoppingParticleCosmicIdAlg::StoppingChiSq(geo::Point_t end, std::vector<
 
   // Loop over it again
   for(size_t i = 0; i < nhits; i++){
-    double dedx = calo->dEdx()[i];
-    double resrg = calo->ResidualRange()[i];
-
-    // Flip the residual range if the track and calo objects don't match up
-    if(distStart < distEnd && calo->ResidualRange()[0] > calo->ResidualRange()[nhits-1]) resrg = calo->ResidualRange()[0] - calo->ResidualRange()[i];
-    if(distStart > distEnd && calo->ResidualRange()[0] < calo->ResidualRange()[nhits-1]) resrg = calo->ResidualRange()[nhits-1] - calo->ResidualRange()[i];
+    double dedx = dedxs[i];
+    double resrg = flip ? flipOffset - resrgs[i] : resrgs[i];
 
     // Record all dE/dx and residual ranges below limits
     if(resrg > resrgStart && resrg < resrgStart + fResRangeMax && dedx < fDEdxMax){
@@ -98,25 +101,17 @@ double StoppingParticleCosmicIdAlg::StoppingChiSq(geo::Point_t end, std::vector<
   // Return null value if not enough points to do fits
   if(v_dedx.size() < 10) return -99999;
 
-  // Try to do a pol0 fit
-  TGraph *gdedx = new TGraph(v_dedx.size(), &v_resrg[0], &v_dedx[0]);
-  try{ gdedx->Fit("pol0", "Q"); } catch(...){ return -99999; }
-  TF1* polfit = gdedx->GetFunction("pol0");
-  double polchi2 = polfit->GetChisquare();
-
-  // Try to do and exp fit
-  try{ gdedx->Fit("expo", "Q"); } catch(...){ return -99999; }
-  TF1* expfit = gdedx->GetFunction("expo");
-  double expchi2 = expfit->GetChisquare();
+  // Do the pol0 and exp fits in closed form and return the chi2 ratio
+  double chi2Ratio = -99999;
+  if(!fFitter.ChiSqRatio(v_resrg.data(), v_dedx.data(), v_dedx.size(), chi2Ratio)) return -99999;
 
-  // Return the chi2 ratio
-  return polchi2/expchi2;
+  return chi2Ratio;
 
 }
 
 
 // Determine if the track end looks like it stops
-bool StoppingParticleCosmicIdAlg::StoppingEnd(geo::Point_t end, std::vector<art::Ptr<anab::Calorimetry>> calos){
+bool StoppingParticleCosmicIdAlg::StoppingEnd(geo::Point_t end, const std::vector<art::Ptr<anab::Calorimetry>>& calos){
   
   // Get the chi2 ratio
   double chiSqRatio = StoppingChiSq(end, calos);
@@ -10,6 +10,7 @@
 ///////////////////////////////////////////////
 
 #include "sbndcode/Geometry/GeometryWrappers/TPCGeoAlg.h"
+#include "sbndcode/CosmicId/Algs/StoppingChiSqFitter.h"
 
 // framework
 #include "fhiclcpp/ParameterSet.h" 
@@ -21,10 +22,6 @@
 #include "lardataobj/RecoBase/Track.h"
 #include "lardataobj/AnalysisBase/Calorimetry.h"
 
-// ROOT
-#include "TGraph.h"
-#include "TF1.h"
-
 // c++
 #include <vector>
 
@@ -88,10 +85,10 @@ namespace sbnd{
     void reconfigure(const Config& config);
 
     // Calculate the chi2 ratio of pol0 and exp fit to dE/dx vs residual range
-    double StoppingChiSq(geo::Point_t end, std::vector<art::Ptr<anab::Calorimetry>> calos);
+    double StoppingChiSq(geo::Point_t end, const std::vector<art::Ptr<anab::Calorimetry>>& calos);
 
     // Determine if the track end looks like it stops
-    bool StoppingEnd(geo::Point_t end, std::vector<art::Ptr<anab::Calorimetry>> calos);
+    bool StoppingEnd(geo::Point_t end, const std::vector<art::Ptr<anab::Calorimetry>>& calos);
 
     // Determine if a track looks like a stopping cosmic
     bool StoppingParticleCosmicId(recob::Track track, std::vector<art::Ptr<anab::Calorimetry>> calos);
@@ -113,6 +110,7 @@ namespace sbnd{
     double fStoppingChi2Limit;
 
     TPCGeoAlg fTpcGeo;
+    StoppingChiSqFitter fFitter;
 
   };
 
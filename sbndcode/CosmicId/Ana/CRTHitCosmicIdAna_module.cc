@@ -288,13 +288,14 @@ namespace sbnd {
     //                                DISTANCE OF CLOSEST APPROACH ANALYSIS
     //----------------------------------------------------------------------------------------------------------
     auto const clockData = art::ServiceHandle<detinfo::DetectorClocksService const>()->DataFor(event);
+    RecoUtils::TruthMatchCache truthMatch(clockData, false);
     auto const detProp = art::ServiceHandle<detinfo::DetectorPropertiesService const>()->DataFor(event, clockData);
 
     // Loop over reconstructed tracks
     for (auto const& tpcTrack : (*tpcTrackHandle)){
       // Get the associated hits
       std::vector<art::Ptr<recob::Hit>> hits = findManyHits.at(tpcTrack.ID());
-      int trackTrueID = RecoUtils::TrueParticleIDFromTotalRecoHits(clockData, hits, false);
+      int trackTrueID = truthMatch.TrueParticleIDFromTotalRecoHits(hits);
       std::string type = "none";
       if(std::find(lepParticleIds.begin(), lepParticleIds.end(), trackTrueID) != lepParticleIds.end()) type = "NuMuTrack";
       if(std::find(nuParticleIds.begin(), nuParticleIds.end(), trackTrueID) != nuParticleIds.end()) type = "NuTrack";
@@ -372,7 +373,7 @@ namespace sbnd {
 
         // Truth match muon tracks and pfps
         std::vector<art::Ptr<recob::Hit>> hits = findManyHits.at(tpcTrack.ID());
-        int trueId = RecoUtils::TrueParticleIDFromTotalRecoHits(clockData, hits, false);
+        int trueId = truthMatch.TrueParticleIDFromTotalRecoHits(hits);
         if(std::find(lepParticleIds.begin(), lepParticleIds.end(), trueId) != lepParticleIds.end()){ 
           type = "NuMuPfp";
         }
@@ -394,7 +395,7 @@ namespace sbnd {
 
       recob::Track tpcTrack = nuTracks[0];
       std::vector<art::Ptr<recob::Hit>> hits = findManyHits.at(tpcTrack.ID());
-      int trackTrueID = RecoUtils::TrueParticleIDFromTotalRecoHits(clockData, hits, false);
+      int trackTrueID = truthMatch.TrueParticleIDFromTotalRecoHits(hits);
 
       if(numHitMap.find(trackTrueID) != numHitMap.end()){
         hNumTrueMatches[type]->Fill(numHitMap[trackTrueID]);
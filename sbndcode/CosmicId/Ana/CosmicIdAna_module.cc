@@ -328,6 +328,7 @@ namespace sbnd {
     //----------------------------------------------------------------------------------------------------------
 
     auto const clockData = art::ServiceHandle<detinfo::DetectorClocksService const>()->DataFor(event);
+    RecoUtils::TruthMatchCache truthMatch(clockData, false);
     auto const detProp = art::ServiceHandle<detinfo::DetectorPropertiesService const>()->DataFor(event, clockData);
 
     //Loop over the pfparticle map
@@ -359,7 +360,7 @@ namespace sbnd {
 
         // Truth match muon tracks and pfps
         std::vector<art::Ptr<recob::Hit>> hits = findManyHits.at(tpcTrack.ID());
-        int trueId = RecoUtils::TrueParticleIDFromTotalRecoHits(clockData, hits, false);
+        int trueId = truthMatch.TrueParticleIDFromTotalRecoHits(hits);
         int trackType = 3;
         if(std::find(lepParticleIds.begin(), lepParticleIds.end(), trueId) != lepParticleIds.end()){ 
           trackType = 0;
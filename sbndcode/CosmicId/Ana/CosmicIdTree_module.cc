@@ -492,6 +492,7 @@ namespace sbnd {
     //----------------------------------------------------------------------------------------------------------
 
     auto const clockData = art::ServiceHandle<detinfo::DetectorClocksService const>()->DataFor(event);
+    RecoUtils::TruthMatchCache truthMatch(clockData, false);
     auto const detProp = art::ServiceHandle<detinfo::DetectorPropertiesService const>()->DataFor(event, clockData);
 
     //Loop over the pfparticle map
@@ -529,7 +530,7 @@ namespace sbnd {
 
         // Truth match muon tracks and pfps
         std::vector<art::Ptr<recob::Hit>> hits = findManyHits.at(tpcTrack.ID());
-        int trueId = RecoUtils::TrueParticleIDFromTotalRecoHits(clockData, hits, false);
+        int trueId = truthMatch.TrueParticleIDFromTotalRecoHits(hits);
         if(std::find(lepParticleIds.begin(), lepParticleIds.end(), trueId) != lepParticleIds.end()){ 
           pfp_type = "NuMu";
         }
@@ -562,7 +563,7 @@ namespace sbnd {
       // Choose longest track as cosmic muon candidate
       recob::Track tpcTrack = nuTracks[0];
       std::vector<art::Ptr<recob::Hit>> hits = findManyHits.at(tpcTrack.ID());
-      int trueId = RecoUtils::TrueParticleIDFromTotalRecoHits(clockData, hits, false);
+      int trueId = truthMatch.TrueParticleIDFromTotalRecoHits(hits);
 
       std::vector<art::Ptr<anab::Calorimetry>> calos = findManyCalo.at(tpcTrack.ID());
 
@@ -674,7 +675,7 @@ namespace sbnd {
 
       // Get the associated hits
       std::vector<art::Ptr<recob::Hit>> hits = findManyHits.at(tpcTrack.ID());
-      int trueId = RecoUtils::TrueParticleIDFromTotalRecoHits(clockData, hits, false);
+      int trueId = truthMatch.TrueParticleIDFromTotalRecoHits(hits);
 
       std::vector<art::Ptr<anab::Calorimetry>> calos = findManyCalo.at(tpcTrack.ID());
 
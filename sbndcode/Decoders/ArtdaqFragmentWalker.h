@@ -0,0 +1,92 @@
+#ifndef SBND_DECODERS_ARTDAQFRAGMENTWALKER_H
+#define SBND_DECODERS_ARTDAQFRAGMENTWALKER_H
+
+////////////////////////////////////////////////////////////////////////
+// ArtdaqFragmentWalker.h
+//
+// Visits the artdaq fragments of a given type in a fragment collection,
+// whether they are stored directly or as blocks of container fragments.
+// Fragments in the collection are visited by const reference and
+// containers are read in place rather than copied. Container blocks
+// are unpacked into a buffer that is reused from block to block.
+////////////////////////////////////////////////////////////////////////
+
+// artdaq includes
+#include "artdaq-core/Data/ContainerFragment.hh"
+#include "artdaq-core/Data/Fragment.hh"
+
+// C++ includes
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace daq {
+
+  class ArtdaqFragmentWalker {
+  public:
+
+    // Number of fragments of the given type, for presizing outputs
+    static std::size_t Count(std::vector<artdaq::Fragment> const& frags,
+                             artdaq::Fragment::type_t type)
+    {
+      std::size_t count = 0;
+      for (artdaq::Fragment const& frag : frags) {
+        if (frag.type() == artdaq::Fragment::ContainerFragmentType) {
+          artdaq::ContainerFragment const cont(frag);
+          if (cont.fragment_type() == type) count += cont.block_count();
+        }
+        else if (frag.type() == type) count++;
+      }
+      return count;
+    }
+
+    // Call visit(artdaq::Fragment const&) on every fragment of the given type
+    // and return the number visited. A container block is only valid for
+    // the duration of the call, copy it if it needs to be kept
+    template<class Visitor>
+    std::size_t Visit(std::vector<artdaq::Fragment> const& frags,
+                      artdaq::Fragment::type_t type, Visitor&& visit)
+    {
+      std::size_t count = 0;
+      for (artdaq::Fragment const& frag : frags) {
+        if (frag.type() == artdaq::Fragment::ContainerFragmentType) {
+          artdaq::ContainerFragment const cont(frag);
+          if (cont.fragment_type() != type) continue;
+          for (std::size_t i = 0; i < cont.block_count(); i++) {
+            visit(Block(cont, i));
+            count++;
+          }
+        }
+        else if (frag.type() == type) {
+          visit(frag);
+          count++;
+        }
+      }
+      return count;
+    }
+
+  private:
+
+    // As ContainerFragment::at, but into fBlock instead of a new fragment
+    artdaq::Fragment const& Block(artdaq::ContainerFragment const& cont, std::size_t i)
+    {
+      std::size_t const bytes = cont.fragSize(i);
+      std::size_t const words = bytes / sizeof(artdaq::RawDataType);
+
+      // Size the buffer to the whole block, header and metadata words of the
+      // previous block included, then overwrite it with the block
+      if (words < fBlock.size() - fBlock.dataSize()) fBlock = artdaq::Fragment();
+      fBlock.resize(words - (fBlock.size() - fBlock.dataSize()));
+      std::memcpy(fBlock.headerAddress(),
+                  reinterpret_cast<uint8_t const*>(cont.dataBegin()) + cont.fragmentIndex(i),
+                  bytes);
+      return fBlock;
+    }
+
+    artdaq::Fragment fBlock;
+
+  };
+
+}
+
+#endif
@@ -24,6 +24,8 @@
 
 #include "sbnobj/SBND/Timing/DAQTimestamp.hh"
 
+#include "sbndcode/Decoders/ArtdaqFragmentWalker.h"
+
 class SPECTDCDecoder;
 
 
@@ -48,6 +50,8 @@ private:
 
   std::string              fSPECTDCModuleLabel;
   std::vector<std::string> fSPECTDCInstanceLabels;
+
+  daq::ArtdaqFragmentWalker fFragmentWalker;
 };
 
 
@@ -65,6 +69,9 @@ void SPECTDCDecoder::produce(art::Event& e)
   auto daqTimestampVec      = std::make_unique<std::vector<sbnd::timing::DAQTimestamp>>();
   // auto daqTimestampFragAssn = std::make_unique<art::Assns<artdaq::Fragment,sbnd::timing::DAQTimestamp>>();
   
+  std::vector<art::Handle<std::vector<artdaq::Fragment>>> fragmentHandles;
+  size_t nTimestamps = 0;
+
   for(const std::string &SPECTDCInstanceLabel : fSPECTDCInstanceLabels)
     {
       art::Handle<std::vector<artdaq::Fragment>> fragmentHandle;
@@ -73,23 +80,19 @@ void SPECTDCDecoder::produce(art::Event& e)
       if(!fragmentHandle.isValid() || fragmentHandle->size() == 0)
         continue;
 
-      if(fragmentHandle->front().type() == artdaq::Fragment::ContainerFragmentType)
-        {
-          for(auto cont : *fragmentHandle)
-            {
-              artdaq::ContainerFragment contf(cont);
-              if(contf.fragment_type() == sbndaq::detail::FragmentType::TDCTIMESTAMP)
-                {
-                  for(unsigned i = 0; i < contf.block_count(); ++i)
-                    daqTimestampVec->emplace_back(FragToDAQTimestamp(*contf[i].get()));
-                }
-            }
-        }
-      else if(fragmentHandle->front().type() == sbndaq::detail::FragmentType::TDCTIMESTAMP)
-        {
-          for(auto frag : *fragmentHandle)
-            daqTimestampVec->emplace_back(FragToDAQTimestamp(frag));
-        }
+      nTimestamps += daq::ArtdaqFragmentWalker::Count(*fragmentHandle, sbndaq::detail::FragmentType::TDCTIMESTAMP);
+      fragmentHandles.push_back(fragmentHandle);
+    }
+
+  daqTimestampVec->reserve(nTimestamps);
+
+  // TDC fragments may come on their own or in containers
+  for(auto const& fragmentHandle : fragmentHandles)
+    {
+      fFragmentWalker.Visit(*fragmentHandle, sbndaq::detail::FragmentType::TDCTIMESTAMP,
+                            [&](const artdaq::Fragment &frag) {
+                              daqTimestampVec->emplace_back(FragToDAQTimestamp(frag));
+                            });
     }
   
   e.put(std::move(daqTimestampVec));
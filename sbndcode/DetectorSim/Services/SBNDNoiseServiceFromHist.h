@@ -25,6 +25,7 @@
 #include "art/Framework/Services/Registry/ServiceHandle.h"
 #include "art/Framework/Services/Registry/ServiceDeclarationMacros.h"
 #include "art_root_io/TFileService.h"
+#include "lardata/DetectorInfoServices/DetectorClocksService.h"
 #include "lardata/DetectorInfoServices/DetectorPropertiesService.h"
 #include "lardata/Utilities/LArFFT.h"
 #include "larcore/Geometry/Geometry.h"
@@ -34,11 +35,16 @@
 #include "CLHEP/Random/JamesRandom.h"
 #include "CLHEP/Random/RandFlat.h"
 
+#include "cetlib/search_path.h"
+
+#include "TFile.h"
+#include "TH1D.h"
 #include "TH1F.h"
 #include "TRandom3.h"
 #include "TF1.h"
 #include "TMath.h"
 
+#include <map>
 #include <vector>
 #include <iostream>
 #include <sstream>
@@ -62,10 +68,14 @@ public:
   ~SBNDNoiseServiceFromHist();
 
   // Add noise to a signal array.
-  int addNoise(Channel chan, AdcSignalVector& sigs) const;
+  int addNoise(detinfo::DetectorClocksData const& clockData,
+               Channel chan, AdcSignalVector& sigs) const override;
 
   // Print the configuration.
-  std::ostream& print(std::ostream& out =std::cout, std::string prefix ="") const;
+  std::ostream& print(std::ostream& out =std::cout, std::string prefix ="") const override;
+
+  // Fill the noise bank, if used, once the producer has set up the noise engine.
+  void postBeginJob();
 
 private:
  
@@ -73,8 +83,40 @@ private:
   unsigned int fNoiseArrayPoints;  ///< number of points in randomly generated noise array
   int          fRandomSeed;        ///< Seed for random number service. If absent or zero, use SeedSvc.
   int          fLogLevel;          ///< Log message level: 0=quiet, 1=init only, 2+=every event
+  std::map< double, int > fShapingTimeOrder;
+  double       fNoiseWidth;        ///< exponential noise width (kHz)
+  double       fNoiseRand;         ///< fraction of random "wiggle" in noise in freq. spectrum
+  double       fLowCutoff;         ///< low frequency filter cutoff (kHz)
+
+  std::string  fNoiseHistoName;    ///< name of the noise frequency histogram
+  std::string  fNoiseFileFname;    ///< path of the file holding the noise histogram
+  TH1D*        fNoiseHist;         ///< noise frequency spectrum
+
+  // Noise bank parameters
+  bool         fUseNoiseBank;             ///< copy noise from a bank of waveforms made at the start of the job
+  unsigned int fNoiseBankSize;            ///< number of bank waveforms per plane
+  double       fNoiseBankAmplitudeSpread; ///< fractional spread of the per-channel amplitude of banked noise
+
+  std::vector<std::vector<AdcSignalVector>> fNoiseBank; ///< [view][entry] unit amplitude noise waveforms, one FFT size long
+
+  // Fill sigs (one FFT size long) with noise of the given amplitude, generated in frequency.
+  void generateWaveform(CLHEP::RandFlat& flat, double noise_factor, AdcSignalVector& sigs) const;
+
+  // Fill the noise bank with fNoiseBankSize unit amplitude waveforms per plane.
+  void generateNoiseBank();
 
+  //Declare noise engines.
   CLHEP::HepRandomEngine* m_pran;
+  CLHEP::HepRandomEngine* fNoiseEngine;
+
+  // Function to allow use of noise engine in ChannelNoiseService setup.
+  void InitialiseProducerDeps(EngineCreator createEngine, fhicl::ParameterSet const& pset) override{
+    
+    CLHEP::HepRandomEngine& NoiseEngine(art::ServiceHandle<rndm::NuRandomService>{}->registerAndSeedEngine(
+                                          createEngine("HepJamesRandom","noise"), "HepJamesRandom","noise",pset,"Seed"));
+    fNoiseEngine = &NoiseEngine;
+    return; 
+  } 
 
 
 };
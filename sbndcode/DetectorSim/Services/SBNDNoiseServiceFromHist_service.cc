@@ -18,7 +18,7 @@ using CLHEP::HepJamesRandom;
 
 SBNDNoiseServiceFromHist::
 SBNDNoiseServiceFromHist(fhicl::ParameterSet const& pset)
-  : fRandomSeed(0), fLogLevel(1),  m_pran(nullptr), fNoiseEngine(nullptr)
+  : fRandomSeed(0), fLogLevel(1), fNoiseHist(nullptr), m_pran(nullptr), fNoiseEngine(nullptr)
 {
   const string myname = "SBNDNoiseServiceFromHist::ctor: ";
   fNoiseArrayPoints  = pset.get<unsigned int>("NoiseArrayPoints");
@@ -29,12 +29,16 @@ SBNDNoiseServiceFromHist(fhicl::ParameterSet const& pset)
   fNoiseWidth        = pset.get< double              >("NoiseWidth");
   fNoiseRand         = pset.get< double              >("NoiseRand");
   fLowCutoff         = pset.get< double              >("LowCutoff");
+
+  fUseNoiseBank             = pset.get< bool         >("UseNoiseBank", false);
+  fNoiseBankSize            = pset.get< unsigned int >("NoiseBankSize", 100);
+  fNoiseBankAmplitudeSpread = pset.get< double       >("NoiseBankAmplitudeSpread", 0.);
   
   //Getting noise histo
-  fNoiseHistoName = p.get< std::string         >("NoiseHistoName");
+  fNoiseHistoName = pset.get< std::string         >("NoiseHistoName");
   
   cet::search_path sp("FW_SEARCH_PATH");
-  sp.find_file(p.get<std::string>("NoiseFileFname"), fNoiseFileFname);
+  sp.find_file(pset.get<std::string>("NoiseFileFname"), fNoiseFileFname);
   
   TFile in(fNoiseFileFname.c_str(), "READ");
   if (!in.IsOpen()) {
@@ -70,15 +74,22 @@ SBNDNoiseServiceFromHist(fhicl::ParameterSet const& pset)
     seedSvc->registerEngine(NuRandomService::CLHEPengineSeeder(m_pran), rname);
   }
   if ( fLogLevel > 0 ) cout << myname << "  Registered seed: " << m_pran->getSeed() << endl;
-  generateNoise();
   if ( fLogLevel > 1 ) print() << endl;
 }
 
 //**********************************************************************
 
 SBNDNoiseServiceFromHist::
-SBNDNoiseServiceFromHist(fhicl::ParameterSet const& pset, art::ActivityRegistry&)
-: SBNDNoiseServiceFromHist(pset) { }
+SBNDNoiseServiceFromHist(fhicl::ParameterSet const& pset, art::ActivityRegistry& reg)
+: SBNDNoiseServiceFromHist(pset) {
+  reg.sPostBeginJob.watch(this, &SBNDNoiseServiceFromHist::postBeginJob);
+}
+
+//**********************************************************************
+
+void SBNDNoiseServiceFromHist::postBeginJob() {
+  if ( fUseNoiseBank ) generateNoiseBank();
+}
 
 //**********************************************************************
 
@@ -88,11 +99,13 @@ SBNDNoiseServiceFromHist::~SBNDNoiseServiceFromHist() {
     cout << myname << "Deleting random engine with seed " << m_pran->getSeed() << endl;
   }
   delete m_pran;
+  delete fNoiseHist;
 }
 
 //**********************************************************************
 
-int SBNDNoiseServiceFromHist::addNoise(Channel chan, AdcSignalVector& sigs) const {
+int SBNDNoiseServiceFromHist::addNoise(detinfo::DetectorClocksData const&,
+                                       Channel chan, AdcSignalVector& sigs) const {
 
   //Get services.
   art::ServiceHandle<geo::Geometry> geo;
@@ -103,7 +116,7 @@ int SBNDNoiseServiceFromHist::addNoise(Channel chan, AdcSignalVector& sigs) cons
   size_t view = (size_t)geo->View(chan);
   
   double noise_factor;
-  auto tempNoiseVec = sss->GetNoiseFactVec();
+  auto const& tempNoiseVec = sss->GetNoiseFactVec();
   double shapingTime = 2.0; //sss->GetShapingTime(chan);
   double asicGain = sss->GetASICGain(chan);
 
@@ -136,17 +149,45 @@ int SBNDNoiseServiceFromHist::addNoise(Channel chan, AdcSignalVector& sigs) cons
         << "\033[00m"
         << std::endl;
 
+  if ( !fUseNoiseBank ) {
+    generateWaveform(flat, noise_factor, sigs);
+    return 0;
+  }
+
+  if ( view >= fNoiseBank.size() || fNoiseBank[view].empty() || fNoiseBank[view].front().size() != fNTicks )
+    throw cet::exception("SBNDNoiseServiceFromHist_service.cc")
+        << "Noise bank for view " << view << " has not been generated for FFT size " << fNTicks
+        << std::endl;
+
+  // Copy a random bank waveform from a random offset. The inverse FFT is
+  // periodic, so wrapping around keeps the noise spectrum.
+  const AdcSignalVector& bank = fNoiseBank[view][CLHEP::RandFlat::shootInt(fNoiseEngine, fNoiseBank[view].size())];
+  size_t offset = CLHEP::RandFlat::shootInt(fNoiseEngine, fNTicks);
+
+  if ( fNoiseBankAmplitudeSpread > 0 )
+    noise_factor *= (1 - fNoiseBankAmplitudeSpread) + 2 * fNoiseBankAmplitudeSpread * flat.fire(0, 1);
+
+  for (size_t i = offset; i < fNTicks; ++i) sigs[i - offset] = noise_factor * bank[i];
+  for (size_t i = 0; i < offset; ++i) sigs[fNTicks - offset + i] = noise_factor * bank[i];
+
+  return 0;
+}
+
+//**********************************************************************
+
+void SBNDNoiseServiceFromHist::
+generateWaveform(CLHEP::RandFlat& flat, double noise_factor, AdcSignalVector& sigs) const {
+
+  art::ServiceHandle<util::LArFFT> fFFT;
+  size_t fNTicks = fFFT->FFTSize();
+
   // noise in frequency space
   std::vector<TComplex> noiseFrequency(fNTicks / 2 + 1, 0.);
 
   double pval = 0.;
-  double lofilter = 0.;
   double phase = 0.;
   double rnd[2] = {0.};
 
-  // width of frequencyBin in kHz
-  double binWidth = 1.0 / (fNTicks * fSampleRate * 1.0e-6);
-
   for (size_t i = 0; i < fNTicks / 2 + 1; ++i) {
     // exponential noise spectrum
     flat.fireArray(2, rnd, 0, 1);
@@ -168,10 +209,29 @@ int SBNDNoiseServiceFromHist::addNoise(Channel chan, AdcSignalVector& sigs) cons
   for (unsigned int i = 0; i < sigs.size(); ++i) {
     sigs.at(i) *= 1.*fNTicks;
   }
-
-  return 0;
 }
 
+//**********************************************************************
+
+void SBNDNoiseServiceFromHist::generateNoiseBank() {
+  const string myname = "SBNDNoiseServiceFromHist::generateNoiseBank: ";
+
+  art::ServiceHandle<util::SignalShapingServiceSBND> sss;
+  art::ServiceHandle<util::LArFFT> fFFT;
+  size_t fNTicks = fFFT->FFTSize();
+
+  // Waveforms have unit amplitude, the plane and gain dependent noise
+  // factor is applied when they are copied to a channel
+  CLHEP::RandFlat flat(*fNoiseEngine, -1, 1);
+  size_t nViews = sss->GetNoiseFactVec().size();
+  fNoiseBank.assign(nViews, std::vector<AdcSignalVector>(fNoiseBankSize, AdcSignalVector(fNTicks)));
+  for ( auto& viewBank : fNoiseBank ) {
+    for ( auto& waveform : viewBank ) generateWaveform(flat, 1., waveform);
+  }
+
+  if ( fLogLevel > 0 ) cout << myname << "Generated " << fNoiseBankSize << " noise waveforms of "
+                            << fNTicks << " ticks for each of " << nViews << " views." << endl;
+}
 
 //**********************************************************************
 
@@ -181,6 +241,11 @@ ostream& SBNDNoiseServiceFromHist::print(ostream& out, string prefix) const {
   out << prefix << "          LogLevel: " <<  fLogLevel << endl;
   out << prefix << "        RandomSeed: " <<  fRandomSeed << endl;
   out << prefix << "  NoiseArrayPoints: " << fNoiseArrayPoints << endl;
+  out << prefix << "      UseNoiseBank: " << fUseNoiseBank << endl;
+  if ( fUseNoiseBank ) {
+    out << prefix << "     NoiseBankSize: " << fNoiseBankSize << endl;
+    out << prefix << "  AmplitudeSpread: " << fNoiseBankAmplitudeSpread << endl;
+  }
   
   return out;
 }
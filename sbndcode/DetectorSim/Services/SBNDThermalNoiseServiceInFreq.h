@@ -61,6 +61,9 @@ public:
   int addNoise(detinfo::DetectorClocksData const& clockData,
                Channel chan, AdcSignalVector& sigs) const override;
 
+  // Fill the noise bank, if used, once the producer has set up the noise engine.
+  void postBeginJob();
+
   // Print the configuration.
   std::ostream& print(std::ostream& out =std::cout, std::string prefix ="") const override;
 
@@ -71,11 +74,24 @@ private:
   int                     fRandomSeed;       ///< Seed for random number service. If absent or zero, use SeedSvc.
   int                     fLogLevel;         ///< Log message level: 0=quiet, 1=init only, 2+=every event
   std::map< double, int > fShapingTimeOrder;
-  double                  fSampleRate;
   double                  fNoiseWidth;       ///< exponential noise width (kHz)
   double                  fNoiseRand;        ///< fraction of random "wiggle" in noise in freq. spectrum
   double                  fLowCutoff;        ///< low frequency filter cutoff (kHz)
+
+  // Noise bank parameters
+  bool                    fUseNoiseBank;             ///< copy noise from a bank of waveforms made at the start of the job
+  unsigned int            fNoiseBankSize;            ///< number of bank waveforms per plane
+  double                  fNoiseBankAmplitudeSpread; ///< fractional spread of the per-channel amplitude of banked noise
+
+  std::vector<std::vector<AdcSignalVector>> fNoiseBank; ///< [view][entry] unit amplitude noise waveforms, one FFT size long
   
+  // Fill sigs (one FFT size long) with noise of the given amplitude, generated in frequency.
+  void generateWaveform(detinfo::DetectorClocksData const& clockData, CLHEP::RandFlat& flat,
+                        double noise_factor, AdcSignalVector& sigs) const;
+
+  // Fill the noise bank with fNoiseBankSize unit amplitude waveforms per plane.
+  void generateNoiseBank(detinfo::DetectorClocksData const& clockData);
+
   //Declare noise engines.
   CLHEP::HepRandomEngine* m_pran;
   CLHEP::HepRandomEngine* fNoiseEngine;
@@ -31,6 +31,10 @@ SBNDThermalNoiseServiceInFreq(fhicl::ParameterSet const& pset)
   fNoiseRand         = pset.get< double              >("NoiseRand");
   fLowCutoff         = pset.get< double              >("LowCutoff");
 
+  fUseNoiseBank             = pset.get< bool         >("UseNoiseBank", false);
+  fNoiseBankSize            = pset.get< unsigned int >("NoiseBankSize", 100);
+  fNoiseBankAmplitudeSpread = pset.get< double       >("NoiseBankAmplitudeSpread", 0.);
+
 
   if ( fRandomSeed == 0 ) haveSeed = false;
   pset.get_if_present<int>("LogLevel", fLogLevel);
@@ -56,8 +60,18 @@ SBNDThermalNoiseServiceInFreq(fhicl::ParameterSet const& pset)
 //**********************************************************************
 
 SBNDThermalNoiseServiceInFreq::
-SBNDThermalNoiseServiceInFreq(fhicl::ParameterSet const& pset, art::ActivityRegistry&)
-: SBNDThermalNoiseServiceInFreq(pset) { }
+SBNDThermalNoiseServiceInFreq(fhicl::ParameterSet const& pset, art::ActivityRegistry& reg)
+: SBNDThermalNoiseServiceInFreq(pset) {
+  reg.sPostBeginJob.watch(this, &SBNDThermalNoiseServiceInFreq::postBeginJob);
+}
+
+//**********************************************************************
+
+void SBNDThermalNoiseServiceInFreq::postBeginJob() {
+  if ( !fUseNoiseBank ) return;
+  auto const clockData = art::ServiceHandle<detinfo::DetectorClocksService const>()->DataForJob();
+  generateNoiseBank(clockData);
+}
 
 //**********************************************************************
 
@@ -71,7 +85,7 @@ SBNDThermalNoiseServiceInFreq::~SBNDThermalNoiseServiceInFreq() {
 
 //**********************************************************************
 
-int SBNDThermalNoiseServiceInFreq::addNoise(detinfo::DetectorClocksData const&,
+int SBNDThermalNoiseServiceInFreq::addNoise(detinfo::DetectorClocksData const& clockData,
                                             Channel chan, AdcSignalVector& sigs) const {
 
   //Get services.
@@ -83,7 +97,7 @@ int SBNDThermalNoiseServiceInFreq::addNoise(detinfo::DetectorClocksData const&,
   size_t view = (size_t)geo->View(chan);
   
   double noise_factor;
-  auto tempNoiseVec = sss->GetNoiseFactVec();
+  auto const& tempNoiseVec = sss->GetNoiseFactVec();
   double shapingTime = 2.0; //sss->GetShapingTime(chan);
   double asicGain = sss->GetASICGain(chan);
 
@@ -116,6 +130,39 @@ int SBNDThermalNoiseServiceInFreq::addNoise(detinfo::DetectorClocksData const&,
         << "\033[00m"
         << std::endl;
 
+  if ( !fUseNoiseBank ) {
+    generateWaveform(clockData, flat, noise_factor, sigs);
+    return 0;
+  }
+
+  if ( view >= fNoiseBank.size() || fNoiseBank[view].empty() || fNoiseBank[view].front().size() != fNTicks )
+    throw cet::exception("SBNDThermalNoiseServiceInFreq_service.cc")
+        << "Noise bank for view " << view << " has not been generated for FFT size " << fNTicks
+        << std::endl;
+
+  // Copy a random bank waveform from a random offset. The inverse FFT is
+  // periodic, so wrapping around keeps the noise spectrum.
+  const AdcSignalVector& bank = fNoiseBank[view][CLHEP::RandFlat::shootInt(fNoiseEngine, fNoiseBank[view].size())];
+  size_t offset = CLHEP::RandFlat::shootInt(fNoiseEngine, fNTicks);
+
+  if ( fNoiseBankAmplitudeSpread > 0 )
+    noise_factor *= (1 - fNoiseBankAmplitudeSpread) + 2 * fNoiseBankAmplitudeSpread * flat.fire(0, 1);
+
+  for (size_t i = offset; i < fNTicks; ++i) sigs[i - offset] = noise_factor * bank[i];
+  for (size_t i = 0; i < offset; ++i) sigs[fNTicks - offset + i] = noise_factor * bank[i];
+  
+  return 0;
+}
+
+//**********************************************************************
+
+void SBNDThermalNoiseServiceInFreq::
+generateWaveform(detinfo::DetectorClocksData const& clockData, CLHEP::RandFlat& flat,
+                 double noise_factor, AdcSignalVector& sigs) const {
+
+  art::ServiceHandle<util::LArFFT> fFFT;
+  size_t fNTicks = fFFT->FFTSize();
+
   // noise in frequency space
   std::vector<TComplex> noiseFrequency(fNTicks / 2 + 1, 0.);
 
@@ -125,13 +172,11 @@ int SBNDThermalNoiseServiceInFreq::addNoise(detinfo::DetectorClocksData const&,
   double rnd[2] = {0.};
 
   // width of frequencyBin in kHz
-  double binWidth = 1.0 / (fNTicks * fSampleRate * 1.0e-6);
+  double binWidth = 1.0 / (fNTicks * sampling_rate(clockData) * 1.0e-6);
 
   for (size_t i = 0; i < fNTicks / 2 + 1; ++i) {
     // exponential noise spectrum
     flat.fireArray(2, rnd, 0, 1);
-    std::cout << "rnd[0]: " << rnd[0] << std::endl;
-    std::cout << "rnd[1]: " << rnd[1] << std::endl;
 
     pval = noise_factor * exp(-(double)i * binWidth / fNoiseWidth);
     // low frequency cutoff
@@ -140,25 +185,6 @@ int SBNDThermalNoiseServiceInFreq::addNoise(detinfo::DetectorClocksData const&,
 
     pval *= lofilter * ((1 - fNoiseRand) + 2 * fNoiseRand * rnd[0]);
 
-    /*
-    //if not from histo or in time --> then hardcoded freq. spectrum
-    if ( !fGetNoiseFromHisto )
-    {
-      pval = noise_factor * exp(-(double)i * binWidth / fNoiseWidth);
-      // low frequency cutoff
-      lofilter = 1.0 / (1.0 + exp(-(i - fLowCutoff / binWidth) / 0.5));
-      // randomize 10%
-
-      pval *= lofilter * ((1 - fNoiseRand) + 2 * fNoiseRand * rnd[0]);
-    }
-
-
-    else
-    {
-
-      pval = fNoiseHist->GetBinContent(i) * ((1 - fNoiseRand) + 2 * fNoiseRand * rnd[0]) * noise_factor;
-    }
-    */
     phase = rnd[1] * 2.*TMath::Pi();
     TComplex tc(pval * cos(phase), pval * sin(phase));
     noiseFrequency.at(i) += tc;
@@ -176,10 +202,29 @@ int SBNDThermalNoiseServiceInFreq::addNoise(detinfo::DetectorClocksData const&,
   for (unsigned int i = 0; i < sigs.size(); ++i) {
     sigs.at(i) *= 1.*fNTicks;
   }
-  
-  return 0;
 }
 
+//**********************************************************************
+
+void SBNDThermalNoiseServiceInFreq::generateNoiseBank(detinfo::DetectorClocksData const& clockData) {
+  const string myname = "SBNDThermalNoiseServiceInFreq::generateNoiseBank: ";
+
+  art::ServiceHandle<util::SignalShapingServiceSBND> sss;
+  art::ServiceHandle<util::LArFFT> fFFT;
+  size_t fNTicks = fFFT->FFTSize();
+
+  // Waveforms have unit amplitude, the plane and gain dependent noise
+  // factor is applied when they are copied to a channel
+  CLHEP::RandFlat flat(*fNoiseEngine, -1, 1);
+  size_t nViews = sss->GetNoiseFactVec().size();
+  fNoiseBank.assign(nViews, std::vector<AdcSignalVector>(fNoiseBankSize, AdcSignalVector(fNTicks)));
+  for ( auto& viewBank : fNoiseBank ) {
+    for ( auto& waveform : viewBank ) generateWaveform(clockData, flat, 1., waveform);
+  }
+
+  if ( fLogLevel > 0 ) cout << myname << "Generated " << fNoiseBankSize << " noise waveforms of "
+                            << fNTicks << " ticks for each of " << nViews << " views." << endl;
+}
 
 //**********************************************************************
 
@@ -189,6 +234,11 @@ ostream& SBNDThermalNoiseServiceInFreq::print(ostream& out, string prefix) const
   out << prefix << "          LogLevel: " <<  fLogLevel << endl;
   out << prefix << "        RandomSeed: " <<  fRandomSeed << endl;
   out << prefix << "  NoiseArrayPoints: " << fNoiseArrayPoints << endl;
+  out << prefix << "      UseNoiseBank: " << fUseNoiseBank << endl;
+  if ( fUseNoiseBank ) {
+    out << prefix << "     NoiseBankSize: " << fNoiseBankSize << endl;
+    out << prefix << "  AmplitudeSpread: " << fNoiseBankAmplitudeSpread << endl;
+  }
   
   return out;
 }
@@ -76,7 +76,7 @@ int SBNDThermalNoiseServiceInTime::addNoise(detinfo::DetectorClocksData const&,
   size_t view = (size_t)geo->View(chan);
   
   double noise_factor;
-  auto tempNoiseVec = sss->GetNoiseFactVec();
+  auto const& tempNoiseVec = sss->GetNoiseFactVec();
   double shapingTime = 2.0; //sss->GetShapingTime(chan);
   double asicGain = sss->GetASICGain(chan);
   
@@ -1,5 +1,8 @@
 #include <iostream>
 #include <algorithm>
+#include <array>
+#include <limits>
+#include <cmath>
 
 #include "TGeoManager.h"
 
@@ -25,6 +28,27 @@ namespace filt{
 
     private:
 
+      // Affine world->local transform and scaled half extents of one CRT module
+      struct CRTModuleSlab {
+        std::array<double, 9> rot;  // row major, local = rot * world + shift
+        std::array<double, 3> shift;
+        std::array<double, 3> halfExtent;
+      };
+
+      // World axis aligned bounding box of a tagger used as a broadphase before the module tests
+      struct CRTTaggerSlabs {
+        std::array<double, 3> min;
+        std::array<double, 3> max;
+        std::vector<CRTModuleSlab> modules;
+      };
+
+      // Start positions and directions of the candidate particles in structure of arrays form
+      struct ParticleRays {
+        std::vector<double> ox, oy, oz, dx, dy, dz;
+        void clear() { ox.clear(); oy.clear(); oz.clear(); dx.clear(); dy.clear(); dz.clear(); }
+        size_t size() const { return ox.size(); }
+      };
+
       std::vector<unsigned int> fTopHighCRTAuxDetIDs; 
       std::vector<unsigned int> fTopLowCRTAuxDetIDs; 
       std::vector<unsigned int> fBottomCRTAuxDetIDs; 
@@ -33,6 +57,13 @@ namespace filt{
       std::vector<unsigned int> fLeftCRTAuxDetIDs; 
       std::vector<unsigned int> fRightCRTAuxDetIDs; 
 
+      // Precomputed slabs of the taggers that the user requested, filled at beginJob
+      std::vector<CRTTaggerSlabs> fRequiredTaggers;
+
+      // Per event scratch reused between events
+      ParticleRays fRays;
+      std::vector<char> fRayHits;
+
       bool fUseTopHighCRTs; 
       bool fUseTopLowCRTs; 
       bool fUseBottomCRTs; 
@@ -53,9 +84,10 @@ namespace filt{
 
       bool IsInterestingParticle(const simb::MCParticle &particle);
       void LoadCRTAuxDetIDs();
-      bool UsesCRTAuxDets(const simb::MCParticle &particle, const std::vector<unsigned int> &crt_auxdet_vector);
-      bool UsesCRTAuxDet(const simb::MCParticle &particle, geo::AuxDetGeo const& crt);
-      bool RayIntersectsBox(TVector3 ray_origin, TVector3 ray_direction, TVector3 box_min_extent, TVector3 box_max_extent);
+      CRTTaggerSlabs BuildCRTTaggerSlabs(const std::vector<unsigned int> &crt_auxdet_vector);
+      void KeepRaysUsingTagger(const CRTTaggerSlabs &tagger);
+      static bool RayIntersectsBox(double ox, double oy, double oz, double dx, double dy, double dz,
+                                   double minx, double miny, double minz, double maxx, double maxy, double maxz);
       std::pair<double, double> XLimitsTPC(const simb::MCParticle &particle);
       std::pair<TVector3, TVector3> CubeIntersection(TVector3 min, TVector3 max, TVector3 start, TVector3 end);
   };
@@ -102,11 +134,13 @@ namespace filt{
 
     auto const detProp = art::ServiceHandle<detinfo::DetectorPropertiesService const>()->DataFor(e);
 
+    fRays.clear();
+
     for (unsigned int i = 0; i < mclists.size() ; i++){
       for (simb::MCTruth const& mc_truth : *mclists[i]) {
         // std::cout << " MCtruth particles " << mc_truth.NParticles() << std::endl;
         for (int part = 0; part < mc_truth.NParticles(); part++){
-          const simb::MCParticle particle = mc_truth.GetParticle(part);
+          const simb::MCParticle& particle = mc_truth.GetParticle(part);
 
           if (!IsInterestingParticle(particle)) continue;
 
@@ -127,54 +161,40 @@ namespace filt{
             if (time<0 || time>(readoutWindow-driftTime)) continue;
           }
 
-          if (fUseTopHighCRTs){
-            bool OK = UsesCRTAuxDets(particle, fTopHighCRTAuxDetIDs);
-            if (!OK) continue;
-            //std::cout<<"TopHighCRTs: " << OK << std::endl;
-          }
-          if (fUseTopLowCRTs){
-            bool OK = UsesCRTAuxDets(particle, fTopLowCRTAuxDetIDs);
-            if (!OK) continue;
-
-            //std::cout<<"TopLowCRTs: " << OK << std::endl;
-          }
-          if (fUseBottomCRTs){
-            bool OK = UsesCRTAuxDets(particle, fBottomCRTAuxDetIDs);
-            if (!OK) continue;
-            //std::cout<<"BottomCRTs: " << OK << std::endl;
-          }
-          if (fUseFrontCRTs){
-            bool OK = UsesCRTAuxDets(particle, fFrontCRTAuxDetIDs);
-            if (!OK) continue;
-            //std::cout<<"FrontCRTs: " << OK << std::endl;
-          }
-          if (fUseBackCRTs){
-            bool OK = UsesCRTAuxDets(particle, fBackCRTAuxDetIDs);
-            if (!OK) continue;
-            //std::cout<<"BackCRTs: " << OK << std::endl;
-          }
-          if (fUseLeftCRTs){
-            bool OK = UsesCRTAuxDets(particle, fLeftCRTAuxDetIDs);
-            if (!OK) continue;
-            //std::cout<<"LeftCRTs: " << OK << std::endl;
-          }
-          if (fUseRightCRTs){
-            bool OK = UsesCRTAuxDets(particle, fRightCRTAuxDetIDs);
-            if (!OK) continue;
-            //std::cout<<"RightCRTs: " << OK << std::endl;
-          }
-
-          return true;
+          // Defer the CRT tests so they can be run over all candidates at once
+          auto const position = particle.Position(0).Vect();
+          auto const direction = particle.Momentum(0).Vect().Unit();
+          fRays.ox.push_back(position.X());
+          fRays.oy.push_back(position.Y());
+          fRays.oz.push_back(position.Z());
+          fRays.dx.push_back(direction.X());
+          fRays.dy.push_back(direction.Y());
+          fRays.dz.push_back(direction.Z());
         }
       }
     }
 
-    return false;
+    // A particle must cross every requested tagger, drop candidates tagger by tagger
+    for (CRTTaggerSlabs const& tagger : fRequiredTaggers){
+      if (fRays.size() == 0) break;
+      KeepRaysUsingTagger(tagger);
+    }
+
+    return fRays.size() > 0;
   }
 
 
   void GenFilter::beginJob() {
     LoadCRTAuxDetIDs();
+
+    // Order matches the original sequence of tests
+    if (fUseTopHighCRTs) fRequiredTaggers.push_back(BuildCRTTaggerSlabs(fTopHighCRTAuxDetIDs));
+    if (fUseTopLowCRTs) fRequiredTaggers.push_back(BuildCRTTaggerSlabs(fTopLowCRTAuxDetIDs));
+    if (fUseBottomCRTs) fRequiredTaggers.push_back(BuildCRTTaggerSlabs(fBottomCRTAuxDetIDs));
+    if (fUseFrontCRTs) fRequiredTaggers.push_back(BuildCRTTaggerSlabs(fFrontCRTAuxDetIDs));
+    if (fUseBackCRTs) fRequiredTaggers.push_back(BuildCRTTaggerSlabs(fBackCRTAuxDetIDs));
+    if (fUseLeftCRTs) fRequiredTaggers.push_back(BuildCRTTaggerSlabs(fLeftCRTAuxDetIDs));
+    if (fUseRightCRTs) fRequiredTaggers.push_back(BuildCRTTaggerSlabs(fRightCRTAuxDetIDs));
   }
 
 
@@ -262,72 +282,131 @@ namespace filt{
   }
 
 
-  bool GenFilter::UsesCRTAuxDets(const simb::MCParticle &particle, const std::vector<unsigned int> &crt_auxdet_vector){
-    //Loop over the aux dets, extract each one and then perform the test
+  GenFilter::CRTTaggerSlabs GenFilter::BuildCRTTaggerSlabs(const std::vector<unsigned int> &crt_auxdet_vector){
     art::ServiceHandle<geo::Geometry> geom;
 
-    for (unsigned int i = 0; i < crt_auxdet_vector.size(); i++){
-      unsigned int auxdet_index = crt_auxdet_vector[i];
+    CRTTaggerSlabs tagger;
+    tagger.min.fill(std::numeric_limits<double>::max());
+    tagger.max.fill(std::numeric_limits<double>::lowest());
+    tagger.modules.reserve(crt_auxdet_vector.size());
+
+    for (unsigned int auxdet_index : crt_auxdet_vector){
       geo::AuxDetGeo const& crt = geom->AuxDet(auxdet_index);
-      if (UsesCRTAuxDet(particle,crt)){
-        return true;
+
+      //The world->local transform is affine, so recover it from the images of the origin and the unit vectors
+      CRTModuleSlab module;
+      auto const origin = crt.toLocalCoords(geo::Point_t(0., 0., 0.));
+      module.shift = {origin.X(), origin.Y(), origin.Z()};
+      std::array<geo::Vector_t, 3> const axes = {geo::Vector_t(1., 0., 0.), geo::Vector_t(0., 1., 0.), geo::Vector_t(0., 0., 1.)};
+      for (size_t col = 0; col < 3; col++){
+        auto const image = crt.toLocalCoords(axes[col]);
+        module.rot[col] = image.X();
+        module.rot[3 + col] = image.Y();
+        module.rot[6 + col] = image.Z();
       }
+
+      //In local coordinates, the normal of the CRT is parallel to the z-axis, the length is parallel to z, width parallel to x and height parallel to y
+      //A gotchya: AuxDets pass half widths and half heights but FULL lengths.  So, divide length by 2
+      //Scale the dimensions if the user wants them scaling
+      module.halfExtent = {crt.HalfWidth1()*fCRTDimensionScaling,
+                           crt.HalfHeight()*fCRTDimensionScaling,
+                           crt.Length()/2.*fCRTDimensionScaling};
+
+      //Grow the tagger bounding box by the world position of each corner, the rotation is orthonormal so invert with the transpose
+      for (int corner = 0; corner < 8; corner++){
+        std::array<double, 3> local = {(corner & 1 ? 1. : -1.)*module.halfExtent[0] - module.shift[0],
+                                       (corner & 2 ? 1. : -1.)*module.halfExtent[1] - module.shift[1],
+                                       (corner & 4 ? 1. : -1.)*module.halfExtent[2] - module.shift[2]};
+        for (size_t row = 0; row < 3; row++){
+          double world = module.rot[row]*local[0] + module.rot[3 + row]*local[1] + module.rot[6 + row]*local[2];
+          tagger.min[row] = std::min(tagger.min[row], world);
+          tagger.max[row] = std::max(tagger.max[row], world);
+        }
+      }
+
+      tagger.modules.push_back(module);
     }
 
-    return false;
-  }
+    //Pad the broadphase box slightly so rounding in the transforms can never reject a real crossing
+    for (size_t row = 0; row < 3; row++){
+      tagger.min[row] -= 1e-6*std::max(1., std::abs(tagger.min[row]));
+      tagger.max[row] += 1e-6*std::max(1., std::abs(tagger.max[row]));
+    }
 
-  bool GenFilter::UsesCRTAuxDet(const simb::MCParticle &particle, geo::AuxDetGeo const& crt){
-    //We need to prepare the particle's position and direction and construct a bounding box from the CRT for the ray-box collision algorithm
-    //Start with the particle
-    auto const position = particle.Position(0).Vect();
-    auto const momentum_dir = particle.Momentum(0).Vect().Unit();
-    auto const particle_local_position_array = crt.toLocalCoords(geo::vect::toPoint(position));
-    auto const particle_local_direction_array = crt.toLocalCoords(geo::vect::toVector(momentum_dir));
-    TVector3 particle_local_position(particle_local_position_array.X(),
-                                     particle_local_position_array.Y(),
-                                     particle_local_position_array.Z());
-    TVector3 particle_local_direction(particle_local_direction_array.X(),
-                                      particle_local_direction_array.Y(),
-                                      particle_local_direction_array.Z());
-
-    //Now make the bounding box min and max extent from the CRT
-    //In local coordinates, the normal of the CRT is parallel to the z-axis, the length is parallel to z, width parallel to x and height parallel to y
-    //A gotchya: AuxDets pass half widths and half heights but FULL lengths.  So, divide length by 2
-    TVector3 crt_min_extent(-1.*crt.HalfWidth1(),-1.*crt.HalfHeight(),-1.*crt.Length()/2.);
-    //Scale the dimensions if the user wants them scaling
-    crt_min_extent*=fCRTDimensionScaling;
-    //Now make the max extent
-    //Use symmetry to reduce change of a typo
-    TVector3 crt_max_extent = crt_min_extent*-1.;
-
-    //Now run the algorithm
-    return RayIntersectsBox(particle_local_position,particle_local_direction,crt_min_extent,crt_max_extent);
+    return tagger;
   }
 
 
-  bool GenFilter::RayIntersectsBox(TVector3 ray_origin, TVector3 ray_direction, TVector3 box_min_extent, TVector3 box_max_extent){
-    double t1 = (box_min_extent.X() - ray_origin.X())/ray_direction.X();
-    double t2 = (box_max_extent.X() - ray_origin.X())/ray_direction.X();
-    double t3 = (box_min_extent.Y() - ray_origin.Y())/ray_direction.Y();
-    double t4 = (box_max_extent.Y() - ray_origin.Y())/ray_direction.Y();
-    double t5 = (box_min_extent.Z() - ray_origin.Z())/ray_direction.Z();
-    double t6 = (box_max_extent.Z() - ray_origin.Z())/ray_direction.Z();
+  void GenFilter::KeepRaysUsingTagger(const CRTTaggerSlabs &tagger){
+    size_t const nRays = fRays.size();
+    fRayHits.assign(nRays, 0);
 
-    double tmin = std::max(std::max(std::min(t1, t2), std::min(t3, t4)), std::min(t5, t6));
-    double tmax = std::min(std::min(std::max(t1, t2), std::max(t3, t4)), std::max(t5, t6));
+    //Broadphase: rays missing the whole tagger box cannot hit any of its modules
+    bool anyCandidate = false;
+    for (size_t i = 0; i < nRays; i++){
+      fRayHits[i] = RayIntersectsBox(fRays.ox[i], fRays.oy[i], fRays.oz[i], fRays.dx[i], fRays.dy[i], fRays.dz[i],
+                                     tagger.min[0], tagger.min[1], tagger.min[2], tagger.max[0], tagger.max[1], tagger.max[2]) ? 1 : 2;
+      anyCandidate |= (fRayHits[i] == 1);
+    }
 
-    if (tmin > tmax){
-      //std::cout<<"Ray does not intersect the box"<<std::endl;
-      return false;
+    //Narrow phase: slab test against each module box in its local frame, looping over rays in the inner loop
+    //fRayHits is 0 for untested candidates, 1 for confirmed hits and 2 for broadphase misses
+    if (anyCandidate){
+      for (size_t i = 0; i < nRays; i++) if (fRayHits[i] == 1) fRayHits[i] = 0;
+      for (CRTModuleSlab const& module : tagger.modules){
+        std::array<double, 9> const& r = module.rot;
+        std::array<double, 3> const& h = module.halfExtent;
+        for (size_t i = 0; i < nRays; i++){
+          if (fRayHits[i] != 0) continue;
+          double const ox = r[0]*fRays.ox[i] + r[1]*fRays.oy[i] + r[2]*fRays.oz[i] + module.shift[0];
+          double const oy = r[3]*fRays.ox[i] + r[4]*fRays.oy[i] + r[5]*fRays.oz[i] + module.shift[1];
+          double const oz = r[6]*fRays.ox[i] + r[7]*fRays.oy[i] + r[8]*fRays.oz[i] + module.shift[2];
+          double const dx = r[0]*fRays.dx[i] + r[1]*fRays.dy[i] + r[2]*fRays.dz[i];
+          double const dy = r[3]*fRays.dx[i] + r[4]*fRays.dy[i] + r[5]*fRays.dz[i];
+          double const dz = r[6]*fRays.dx[i] + r[7]*fRays.dy[i] + r[8]*fRays.dz[i];
+          if (RayIntersectsBox(ox, oy, oz, dx, dy, dz, -h[0], -h[1], -h[2], h[0], h[1], h[2])) fRayHits[i] = 1;
+        }
+      }
     }
-    if (tmax < 0){
-      //std::cout<<"Ray path intersects but ray is aiming the wrong way"<<std::endl;
-      return false;
+
+    //Compact the surviving rays in place
+    size_t nKept = 0;
+    for (size_t i = 0; i < nRays; i++){
+      if (fRayHits[i] != 1) continue;
+      fRays.ox[nKept] = fRays.ox[i];
+      fRays.oy[nKept] = fRays.oy[i];
+      fRays.oz[nKept] = fRays.oz[i];
+      fRays.dx[nKept] = fRays.dx[i];
+      fRays.dy[nKept] = fRays.dy[i];
+      fRays.dz[nKept] = fRays.dz[i];
+      nKept++;
     }
+    fRays.ox.resize(nKept);
+    fRays.oy.resize(nKept);
+    fRays.oz.resize(nKept);
+    fRays.dx.resize(nKept);
+    fRays.dy.resize(nKept);
+    fRays.dz.resize(nKept);
+  }
+
+
+  bool GenFilter::RayIntersectsBox(double ox, double oy, double oz, double dx, double dy, double dz,
+                                   double minx, double miny, double minz, double maxx, double maxy, double maxz){
+    double t1 = (minx - ox)/dx;
+    double t2 = (maxx - ox)/dx;
+    double t3 = (miny - oy)/dy;
+    double t4 = (maxy - oy)/dy;
+    double t5 = (minz - oz)/dz;
+    double t6 = (maxz - oz)/dz;
+
+    double tmin = std::max(std::max(std::min(t1, t2), std::min(t3, t4)), std::min(t5, t6));
+    double tmax = std::min(std::min(std::max(t1, t2), std::max(t3, t4)), std::max(t5, t6));
 
+    //Ray does not intersect the box
+    if (tmin > tmax) return false;
+    //Ray path intersects but ray is aiming the wrong way
+    if (tmax < 0) return false;
 
-    //std::cout<<"Ray intersects the box"<<std::endl;
     return true;
   }
 
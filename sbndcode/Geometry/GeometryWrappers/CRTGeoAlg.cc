@@ -295,7 +295,7 @@ namespace sbnd::crt {
   }
 
   std::array<double, 6> CRTGeoAlg::StripHit3DPos(const uint16_t channel, const double x,
-                                                 const double ex)
+                                                 const double ex) const
   {
     const CRTStripGeo &strip = GetStrip(channel);
 
@@ -321,7 +321,7 @@ namespace sbnd::crt {
   }
 
   std::vector<double> CRTGeoAlg::StripWorldToLocalPos(const CRTStripGeo &strip, const double x, 
-                                                      const double y, const double z)
+                                                      const double y, const double z) const
   {
     const uint16_t adsID = strip.adsID;
     const uint16_t adID  = fModules.at(strip.moduleName).adID;
@@ -336,13 +336,13 @@ namespace sbnd::crt {
   }
 
   std::vector<double> CRTGeoAlg::StripWorldToLocalPos(const uint16_t channel, const double x,
-                                                      const double y, const double z)
+                                                      const double y, const double z) const
   {
     const CRTStripGeo strip = GetStrip(channel);
     return StripWorldToLocalPos(strip, x, y, z);
   }
 
-  std::array<double, 6> CRTGeoAlg::FEBWorldPos(const CRTModuleGeo &module)
+  std::array<double, 6> CRTGeoAlg::FEBWorldPos(const CRTModuleGeo &module) const
   {
     const geo::AuxDetGeo &auxDet = fAuxDetGeoCore->AuxDetGeoVec()[module.adID];
 
@@ -371,7 +371,7 @@ namespace sbnd::crt {
     return {minX, maxX, minY, maxY, minZ, maxZ};
   }
 
-  std::array<double, 6> CRTGeoAlg::FEBChannel0WorldPos(const CRTModuleGeo &module)
+  std::array<double, 6> CRTGeoAlg::FEBChannel0WorldPos(const CRTModuleGeo &module) const
   {
     const geo::AuxDetGeo &auxDet = fAuxDetGeoCore->AuxDetGeoVec()[module.adID];
 
@@ -448,7 +448,7 @@ namespace sbnd::crt {
     return DistanceDownStrip(position, sipm.stripName);
   }
 
-  bool CRTGeoAlg::CheckOverlap(const CRTStripGeo &strip1, const CRTStripGeo &strip2, const double overlap_buffer)
+  bool CRTGeoAlg::CheckOverlap(const CRTStripGeo &strip1, const CRTStripGeo &strip2, const double overlap_buffer) const
   {
     const CRTTagger tagger1 = CRTCommonUtils::GetTaggerEnum(ChannelToTaggerName(strip1.channel0));
     const CRTTagger tagger2 = CRTCommonUtils::GetTaggerEnum(ChannelToTaggerName(strip2.channel0));
@@ -478,7 +478,7 @@ namespace sbnd::crt {
       }
   }
 
-  bool CRTGeoAlg::CheckOverlap(const uint16_t channel1, const uint16_t channel2, const double overlap_buffer)
+  bool CRTGeoAlg::CheckOverlap(const uint16_t channel1, const uint16_t channel2, const double overlap_buffer) const
   {
     CRTStripGeo strip1 = GetStrip(channel1);
     CRTStripGeo strip2 = GetStrip(channel2);
@@ -486,7 +486,7 @@ namespace sbnd::crt {
     return CheckOverlap(strip1, strip2, overlap_buffer);
   }
 
-  bool CRTGeoAlg::AdjacentStrips(const CRTStripGeo &strip1, const CRTStripGeo &strip2, const double overlap_buffer)
+  bool CRTGeoAlg::AdjacentStrips(const CRTStripGeo &strip1, const CRTStripGeo &strip2, const double overlap_buffer) const
   {
     CRTModuleGeo module1 = GetModule(strip1.channel0);
     CRTModuleGeo module2 = GetModule(strip2.channel0);
@@ -514,7 +514,7 @@ namespace sbnd::crt {
       return false;
   }
 
-  bool CRTGeoAlg::AdjacentStrips(const uint16_t channel1, const uint16_t channel2, const double overlap_buffer)
+  bool CRTGeoAlg::AdjacentStrips(const uint16_t channel1, const uint16_t channel2, const double overlap_buffer) const
   {
     CRTStripGeo strip1 = GetStrip(channel1);
     CRTStripGeo strip2 = GetStrip(channel2);
@@ -522,7 +522,7 @@ namespace sbnd::crt {
     return AdjacentStrips(strip1, strip2, overlap_buffer);
   }
 
-  bool CRTGeoAlg::DifferentOrientations(const CRTStripGeo &strip1, const CRTStripGeo &strip2)
+  bool CRTGeoAlg::DifferentOrientations(const CRTStripGeo &strip1, const CRTStripGeo &strip2) const
   {
     const CRTModuleGeo module1 = GetModule(strip1.moduleName);
     const CRTModuleGeo module2 = GetModule(strip2.moduleName);
@@ -530,7 +530,7 @@ namespace sbnd::crt {
     return module1.orientation != module2.orientation;
   }
 
-  enum CRTTagger CRTGeoAlg::WhichTagger(const double &x, const double &y, const double &z, const double &buffer)
+  enum CRTTagger CRTGeoAlg::WhichTagger(const double &x, const double &y, const double &z, const double &buffer) const
   {
     for(auto const& [name, tagger] : fTaggers)
       {
@@ -545,7 +545,7 @@ namespace sbnd::crt {
     return kUndefinedTagger;
   }
 
-  enum CoordSet CRTGeoAlg::GlobalConstrainedCoordinates(const uint16_t channel)
+  enum CoordSet CRTGeoAlg::GlobalConstrainedCoordinates(const uint16_t channel) const
   {
     const std::string taggerName = ChannelToTaggerName(channel);
     const CRTTagger tagger       = CRTCommonUtils::GetTaggerEnum(taggerName);
@@ -557,7 +557,7 @@ namespace sbnd::crt {
     return widthdir | taggercoord;
   }
 
-  bool CRTGeoAlg::IsPointInsideCRTLimits(const geo::Point_t &point)
+  bool CRTGeoAlg::IsPointInsideCRTLimits(const geo::Point_t &point) const
   {
     const std::vector<double> lims = CRTLimits();
 
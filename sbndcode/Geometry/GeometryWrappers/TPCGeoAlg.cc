@@ -160,69 +160,83 @@ double TPCGeoAlg::MinDistToWall(geo::Point_t point){
 // ----------------------------------------------------------------------------------
 // Determine if a true particle is ever inside the TPC volume
 bool TPCGeoAlg::InVolume(const simb::MCParticle& particle){
-  for(size_t i = 0; i < particle.NumberTrajectoryPoints(); i++){
-    double x = particle.Vx(i); 
-    double y = particle.Vy(i);
-    double z = particle.Vz(i);
-    if(x > fMinX && y > fMinY && z > fMinZ && x < fMaxX && y < fMaxY && z < fMaxZ){
-      return true;
-    }
-  }
-  return false;
+  return ParticleVolumeFlags(particle).inVolume;
 }
 
 // ----------------------------------------------------------------------------------
 // Determine if a true particle is contained inside the TPC volume
 bool TPCGeoAlg::IsContained(const simb::MCParticle& particle){
-  for(size_t i = 0; i < particle.NumberTrajectoryPoints(); i++){
-    double x = particle.Vx(i); 
-    double y = particle.Vy(i);
-    double z = particle.Vz(i);
-    if(x < fMinX || y < fMinY || z < fMinZ || x > fMaxX || y > fMaxY || z > fMaxZ){
-      return false;
-    }
-  }
-  return true;
+  return ParticleVolumeFlags(particle).contained;
 }
 
 // ----------------------------------------------------------------------------------
 // Determine if a true particle enters the TPC volume
 bool TPCGeoAlg::EntersVolume(const simb::MCParticle& particle){
-  bool enters = false;
-  bool startOutside = false;
-  bool endOutside = false;
-  for(size_t i = 0; i < particle.NumberTrajectoryPoints(); i++){
-    double x = particle.Vx(i); 
-    double y = particle.Vy(i);
-    double z = particle.Vz(i);
-    if(x > fMinX && y > fMinY && z > fMinZ && x < fMaxX && y < fMaxY && z < fMaxZ){
-      enters = true;
-    }
-    else if(i == 0) startOutside = true;
-    else if(i == particle.NumberTrajectoryPoints()-1) endOutside = true;
-  }
-  if(enters && (startOutside || endOutside)) return true;
-  return false;
+  return ParticleVolumeFlags(particle).enters;
 }
 
 // ----------------------------------------------------------------------------------
 // Determine if a true particle crosses the TPC volume
 bool TPCGeoAlg::CrossesVolume(const simb::MCParticle& particle){
-  bool enters = false;
-  bool startOutside = false;
-  bool endOutside = false;
-  for(size_t i = 0; i < particle.NumberTrajectoryPoints(); i++){
-    double x = particle.Vx(i); 
-    double y = particle.Vy(i);
-    double z = particle.Vz(i);
-    if(x > fMinX && y > fMinY && z > fMinZ && x < fMaxX && y < fMaxY && z < fMaxZ){
-      enters = true;
-    }
-    else if(i == 0) startOutside = true;
-    else if(i == particle.NumberTrajectoryPoints()-1) endOutside = true;
+  return ParticleVolumeFlags(particle).crosses;
+}
+
+// ----------------------------------------------------------------------------------
+// All volume checks for a true particle from one pass over its trajectory
+TPCGeoAlg::VolumeFlags TPCGeoAlg::ParticleVolumeFlags(const simb::MCParticle& particle){
+  fPointX.clear();
+  fPointY.clear();
+  fPointZ.clear();
+  for(auto const& point : particle.Trajectory()){
+    fPointX.push_back(point.first.X());
+    fPointY.push_back(point.first.Y());
+    fPointZ.push_back(point.first.Z());
   }
-  if(startOutside && enters && endOutside) return true;
-  return false;
+  ClassifyPoints();
+  return FlagsFromPoints();
+}
+
+// Branch free so the loop vectorizes
+void TPCGeoAlg::ClassifyPoints(){
+  size_t n = fPointX.size();
+  fPointInside.resize(n);
+  fPointOutside.resize(n);
+  const double* x = fPointX.data();
+  const double* y = fPointY.data();
+  const double* z = fPointZ.data();
+  char* inside = fPointInside.data();
+  char* outside = fPointOutside.data();
+  for(size_t i = 0; i < n; i++){
+    inside[i] = (x[i] > fMinX) & (y[i] > fMinY) & (z[i] > fMinZ)
+              & (x[i] < fMaxX) & (y[i] < fMaxY) & (z[i] < fMaxZ);
+    outside[i] = (x[i] < fMinX) | (y[i] < fMinY) | (z[i] < fMinZ)
+               | (x[i] > fMaxX) | (y[i] > fMaxY) | (z[i] > fMaxZ);
+  }
+}
+
+TPCGeoAlg::VolumeFlags TPCGeoAlg::FlagsFromPoints() const{
+  VolumeFlags flags;
+  size_t n = fPointInside.size();
+  if(n == 0) return flags;
+
+  const char* inside = fPointInside.data();
+  const char* outside = fPointOutside.data();
+  char anyInside = 0;
+  char anyOutside = 0;
+  for(size_t i = 0; i < n; i++){
+    anyInside |= inside[i];
+    anyOutside |= outside[i];
+  }
+
+  // The end point only counts if it isn't also the start point
+  bool startOutside = !inside[0];
+  bool endOutside = n > 1 && !inside[n-1];
+
+  flags.inVolume = anyInside;
+  flags.contained = !anyOutside;
+  flags.enters = anyInside && (startOutside || endOutside);
+  flags.crosses = anyInside && startOutside && endOutside;
+  return flags;
 }
 
 // ----------------------------------------------------------------------------------
@@ -35,6 +35,14 @@ namespace sbnd{
   class TPCGeoAlg {
   public:
 
+    // Where a true particle's trajectory lies with respect to the TPC volume
+    struct VolumeFlags {
+      bool inVolume = false;  ///< Some point is inside the volume
+      bool contained = true;  ///< No point is outside the volume
+      bool enters = false;    ///< Inside at some point, and starts or ends outside
+      bool crosses = false;   ///< Inside at some point, and starts and ends outside
+    };
+
     TPCGeoAlg();
 
     ~TPCGeoAlg();
@@ -77,6 +85,9 @@ namespace sbnd{
     // Determine if a true particle crosses either APA
     bool CrossesApa(const simb::MCParticle& particle);
 
+    // All of the above volume checks from one pass over the trajectory
+    VolumeFlags ParticleVolumeFlags(const simb::MCParticle& particle);
+
     std::pair<TVector3, TVector3> CrossingPoints(const simb::MCParticle& particle);
     double TpcLength(const simb::MCParticle& particle);
 
@@ -92,6 +103,18 @@ namespace sbnd{
 
     geo::GeometryCore const* fGeometryService;
 
+    // Trajectory points of the particle being classified, as separate coordinate arrays
+    std::vector<double> fPointX;
+    std::vector<double> fPointY;
+    std::vector<double> fPointZ;
+    std::vector<char> fPointInside;  ///< Point strictly inside the volume
+    std::vector<char> fPointOutside; ///< Point strictly outside the volume
+
+    // Classify the points in the arrays
+    void ClassifyPoints();
+    // Volume flags of the classified points
+    VolumeFlags FlagsFromPoints() const;
+
   };
 
 }
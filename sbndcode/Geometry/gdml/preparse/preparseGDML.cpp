@@ -1,13 +1,16 @@
 #include <iostream>
-#include "TList.h"
-#include "TString.h"
-#include "TFormula.h"
 #include <vector>
 #include <map>
+#include <unordered_map>
+#include <memory>
 #include <fstream>
-#include <iostream>
 #include <sstream>
-#include <stdio.h>
+#include <string>
+#include <cctype>
+#include <cerrno>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
 #include <limits> // std::numeric_limits<>
 #include <getopt.h> // getopt_long(), option
 #include <stdexcept> // std::runtime_error
@@ -15,7 +18,7 @@
 bool sci = false;
 bool setupChoice = false;
 int debug = 0;
-TString mySetup = "Default"; // Default volWorld
+std::string mySetup = "Default"; // Default volWorld
 int prec = std::numeric_limits<double>::max_digits10;
 
 using namespace std;
@@ -24,271 +27,540 @@ struct aLoop{
 	std::string	varName;
 	double varTo;
 	double varStep;
-};	
+};
 
 struct aSetup{
 	std::string	stpName;
 	std::string	stpWorldVolume;
 	std::string	stpVersion;
-};	
+};
 
-typedef std::map<std::string, double> Variables_t;
 
-bool isComment(TString key) {
+//---- String helpers (replacements for the TString calls of the original preparser)
 
-	int pos1 = key.Index("<!--");
-	int pos2 = key.Index("-->");
-	bool k=0;
-	TString s1="X", s2="X";
-	if(pos1>=0 && pos2>pos1){
-		s1=key;
-		s1.Remove(pos1);
-		s2=key;
-		s2.Replace(0,pos2+3,"");
-	}
-	for(int i=0; i<s1.Length(); i++) if(s1[i]==char(9)) {s1.Replace(i,1," ");}
-	for(int i=0; i<s2.Length(); i++) if(s2[i]==char(9)) {s2.Replace(i,1," ");}
-	k = s1.IsWhitespace() && s2.IsWhitespace();
-	return k;
-}
+bool contains(std::string const& key, std::string const& what) { return key.find(what) != std::string::npos; }
 
-void replaceVariable(TString &key, Variables_t const& variables ){
+// Same as TString::IsWhitespace(): only blanks (not tabs) count as whitespace
+bool isWhitespace(std::string const& key) {
+	return key.find_first_not_of(' ') == std::string::npos;
+}
 
-	Variables_t::const_iterator it;
+std::string formatNumber(double value, bool scientificNotation) {
 	std::stringstream stream;
-	TString varValue;
-	int i;
-	TString temp;
 	stream.precision(prec);
-	for (it=variables.begin(); it!=variables.end(); ++it) { 
-		TString const& varName = it->first;
-		double value = it->second;
-		if (!key.Contains("=") || !key.Contains(varName) ) continue;
-		if (debug >= 3) {
-			std::cout.precision(prec);
-			std::cout << "REPLACING\t'" << varName << "'\t";
+	if(scientificNotation) { stream << scientific << value;} else {stream << value;}
+	return stream.str();
+}
+
+
+//---- Variables ---------------------------------------------------------------
+//
+// Variables are substituted textually into the lines, in alphabetical order
+// of their names, exactly like the original map-scanning implementation.
+// Instead of testing every variable against every line, the names are kept
+// in a character trie so that the variables occurring in a line are found
+// in one walk, and the textual form of each value is cached until it changes.
+//
+class Variables_t {
+public:
+
+	Variables_t(): fTrie(1) {}
+
+	bool has(std::string const& name) const { return fValues.count(name) > 0; }
+
+	double get(std::string const& name) const {
+		auto it = fValues.find(name);
+		return (it == fValues.end())? 0.0: it->second.value;
+	}
+
+	void set(std::string const& name, double value) {
+		auto it = fValues.find(name);
+		if (it == fValues.end()) {
+			it = fValues.emplace(name, Entry{}).first;
+			insertName(name);
 		}
-		stream.str("");
-		stream.clear();	
+		it->second.value = value;
+		it->second.text.clear();
+	}
 
-		if(0) { stream << scientific << value;} else {stream << value;}
-		stream >> varValue;
+	// Replace every variable in key with its value (only if key contains an assignment)
+	void replaceIn(std::string &key) const;
+
+private:
+
+	struct Entry {
+		double value = 0.0;
+		mutable std::string text; // cached textual value, empty if stale
+	};
+
+	struct TrieNode {
+		std::map<char, size_t> children;
+		bool terminal = false;
+	};
+
+	void insertName(std::string const& name);
+
+	// Smallest variable name strictly after `after` occurring anywhere in key
+	std::string const* nextNameIn(std::string const& key, std::string const* after) const;
+
+	std::map<std::string, Entry> fValues;
+	std::vector<TrieNode> fTrie;
+
+};
+
+void Variables_t::insertName(std::string const& name) {
+	size_t node = 0;
+	for (char c: name) {
+		auto it = fTrie[node].children.find(c);
+		if (it == fTrie[node].children.end()) {
+			fTrie.emplace_back();
+			it = fTrie[node].children.emplace(c, fTrie.size() - 1).first;
+		}
+		node = it->second;
+	}
+	fTrie[node].terminal = true;
+}
+
+std::string const* Variables_t::nextNameIn(std::string const& key, std::string const* after) const {
+
+	std::string const* best = nullptr;
+	std::string name;
+	for (size_t start = 0; start < key.length(); start++) {
+		size_t node = 0;
+		name.clear();
+		for (size_t pos = start; pos < key.length(); pos++) {
+			auto it = fTrie[node].children.find(key[pos]);
+			if (it == fTrie[node].children.end()) break;
+			node = it->second;
+			name += key[pos];
+			if (!fTrie[node].terminal) continue;
+			if (after && name <= *after) continue;
+			if (best && name >= *best) continue;
+			best = &(fValues.find(name)->first);
+		}
+	}
+	return best;
+}
+
+void Variables_t::replaceIn(std::string &key) const {
+
+	if (!contains(key, "=")) return;
 
+	std::string const* varName = nullptr;
+	while ((varName = nextNameIn(key, varName))) {
+		Entry const& entry = fValues.find(*varName)->second;
+		if (debug >= 3) {
+			std::cout.precision(prec);
+			std::cout << "REPLACING\t'" << *varName << "'\t";
+		}
+		if (entry.text.empty()) {
+			// stream extraction stops at the first blank, as in the original
+			std::stringstream stream(formatNumber(entry.value, false));
+			stream >> entry.text;
+		}
 		if (debug >= 3) {
 			std::cout.precision(prec);
-			std::cout << "=> " << varValue << "\n";
+			std::cout << "=> " << entry.text << "\n";
 		}
 
+		// an occurrence at the very beginning of the line stops the replacement
+		size_t i;
 		do {
-			i = key.Index(varName);
-			if (i>0) {
-				temp = key;
-				temp.Remove(i);
-				temp += varValue;
-				key.Replace(0,i+varName.Length(),"");
-				temp += key;
-				key = temp;
+			i = key.find(*varName);
+			if (i != std::string::npos && i > 0) key.replace(i, varName->length(), entry.text);
+		} while (i != std::string::npos && i > 0);
+	}
+}
+
+
+//---- Formulas ----------------------------------------------------------------
+//
+// Small recursive descent parser covering the TFormula syntax used in the
+// GDML templates: numbers, + - * / % ^ ** , unary signs, parentheses, the
+// usual math functions and the pi/e constants. Each distinct expression is
+// parsed once into an AST and its value is cached.
+//
+class FormulaEvaluator {
+public:
+
+	double eval(std::string const& formula);
+
+private:
+
+	struct Node {
+		enum Kind { Number, Unary, Binary, Call } kind = Number;
+		char op = 0;
+		double value = 0.0;
+		double (*func1)(double) = nullptr;
+		double (*func2)(double, double) = nullptr;
+		std::vector<std::unique_ptr<Node>> args;
+		double eval() const;
+	};
+	using NodePtr = std::unique_ptr<Node>;
+
+	struct Parser {
+		std::string const& text;
+		size_t pos = 0;
+		explicit Parser(std::string const& t): text(t) {}
+		void skipBlanks() { while (pos < text.length() && std::isspace((unsigned char) text[pos])) pos++; }
+		bool accept(char c) { skipBlanks(); if (pos < text.length() && text[pos] == c) { pos++; return true; } return false; }
+		NodePtr parseExpression();
+		NodePtr parseTerm();
+		NodePtr parseUnary();
+		NodePtr parsePower();
+		NodePtr parsePrimary();
+	};
+
+	static NodePtr makeBinary(char op, NodePtr lhs, NodePtr rhs);
+
+	std::unordered_map<std::string, double> fCache;
+
+};
+
+double FormulaEvaluator::Node::eval() const {
+	switch (kind) {
+		case Number: return value;
+		case Unary: return (op == '-')? 0.0 - args[0]->eval(): args[0]->eval(); // like TFormula, "-0" gives 0
+		case Call: return func2? func2(args[0]->eval(), args[1]->eval()): func1(args[0]->eval());
+		case Binary: {
+			double const a = args[0]->eval(), b = args[1]->eval();
+			switch (op) {
+				case '+': return a + b;
+				case '-': return a - b;
+				case '*': return a * b;
+				case '/': return a / b;
+				case '%': return std::fmod(a, b);
+				case '^': return std::pow(a, b);
 			}
-		} while (i>0);
+		}
 	}
+	return std::numeric_limits<double>::quiet_NaN();
 }
 
-void replaceKeyword(TString &key, TString word, TString keyword){
+FormulaEvaluator::NodePtr FormulaEvaluator::makeBinary(char op, NodePtr lhs, NodePtr rhs) {
+	NodePtr node = std::make_unique<Node>();
+	node->kind = Node::Binary;
+	node->op = op;
+	node->args.push_back(std::move(lhs));
+	node->args.push_back(std::move(rhs));
+	return node;
+}
 
-	int pos1 = key.Index(word);
-	if(pos1>=1){
-		int pos2 = word.Length();
-		TString delimiter1 = key[pos1-1];
-		TString delimiter2 = key[pos1+pos2];
-		if(delimiter1=="\"" && delimiter2=="\"") key.Replace(pos1,pos2,keyword);
+FormulaEvaluator::NodePtr FormulaEvaluator::Parser::parseExpression() {
+	NodePtr node = parseTerm();
+	while (true) {
+		if (accept('+')) node = makeBinary('+', std::move(node), parseTerm());
+		else if (accept('-')) node = makeBinary('-', std::move(node), parseTerm());
+		else return node;
 	}
+}
 
+FormulaEvaluator::NodePtr FormulaEvaluator::Parser::parseTerm() {
+	NodePtr node = parseUnary();
+	while (true) {
+		if (accept('*')) node = makeBinary('*', std::move(node), parseUnary());
+		else if (accept('/')) node = makeBinary('/', std::move(node), parseUnary());
+		else if (accept('%')) node = makeBinary('%', std::move(node), parseUnary());
+		else return node;
+	}
+}
+
+FormulaEvaluator::NodePtr FormulaEvaluator::Parser::parseUnary() {
+	if (accept('-')) {
+		NodePtr node = std::make_unique<Node>();
+		node->kind = Node::Unary;
+		node->op = '-';
+		node->args.push_back(parseUnary());
+		return node;
+	}
+	if (accept('+')) return parseUnary();
+	return parsePower();
 }
 
-void getVariable(TString key, Variables_t& variables){
+FormulaEvaluator::NodePtr FormulaEvaluator::Parser::parsePower() {
+	NodePtr base = parsePrimary();
+	skipBlanks();
+	if (text.compare(pos, 2, "**") == 0) { pos += 2; return makeBinary('^', std::move(base), parseUnary()); }
+	if (accept('^')) return makeBinary('^', std::move(base), parseUnary());
+	return base;
+}
+
+FormulaEvaluator::NodePtr FormulaEvaluator::Parser::parsePrimary() {
+
+	static std::map<std::string, double(*)(double)> const functions1 = {
+		{ "sin", [](double x){ return std::sin(x); } },   { "cos", [](double x){ return std::cos(x); } },
+		{ "tan", [](double x){ return std::tan(x); } },   { "asin", [](double x){ return std::asin(x); } },
+		{ "acos", [](double x){ return std::acos(x); } }, { "atan", [](double x){ return std::atan(x); } },
+		{ "sinh", [](double x){ return std::sinh(x); } }, { "cosh", [](double x){ return std::cosh(x); } },
+		{ "tanh", [](double x){ return std::tanh(x); } }, { "sqrt", [](double x){ return std::sqrt(x); } },
+		{ "exp", [](double x){ return std::exp(x); } },   { "log", [](double x){ return std::log(x); } },
+		{ "log10", [](double x){ return std::log10(x); } }, { "abs", [](double x){ return std::abs(x); } },
+		{ "fabs", [](double x){ return std::abs(x); } },
+	};
+	static std::map<std::string, double(*)(double, double)> const functions2 = {
+		{ "pow", [](double x, double y){ return std::pow(x, y); } },
+		{ "atan2", [](double x, double y){ return std::atan2(x, y); } },
+		{ "fmod", [](double x, double y){ return std::fmod(x, y); } },
+	};
+	// TFormula constants, and the coordinates which TFormula::Eval(0) sets to 0
+	static std::map<std::string, double> const constants = {
+		{ "pi", M_PI }, { "e", M_E }, { "sqrt2", M_SQRT2 }, { "ln10", M_LN10 },
+		{ "x", 0.0 }, { "y", 0.0 }, { "z", 0.0 }, { "t", 0.0 },
+	};
+
+	skipBlanks();
+	if (pos >= text.length()) throw std::runtime_error("unexpected end of formula");
+
+	if (accept('(')) {
+		NodePtr node = parseExpression();
+		if (!accept(')')) throw std::runtime_error("missing ')'");
+		return node;
+	}
+
+	char const c = text[pos];
+	if (std::isdigit((unsigned char) c) || c == '.') {
+		char const* begin = text.c_str() + pos;
+		char* end = nullptr;
+		NodePtr node = std::make_unique<Node>();
+		node->value = std::strtod(begin, &end);
+		if (end == begin) throw std::runtime_error("invalid number");
+		pos += end - begin;
+		return node;
+	}
 
-	TString name;
+	if (std::isalpha((unsigned char) c) || c == '_') {
+		size_t const start = pos;
+		while (pos < text.length() && (std::isalnum((unsigned char) text[pos]) || text[pos] == '_' || text[pos] == ':')) pos++;
+		std::string const name = text.substr(start, pos - start);
+		if (accept('(')) {
+			NodePtr node = std::make_unique<Node>();
+			node->kind = Node::Call;
+			auto f1 = functions1.find(name);
+			auto f2 = functions2.find(name);
+			if (f1 != functions1.end()) node->func1 = f1->second;
+			else if (f2 != functions2.end()) node->func2 = f2->second;
+			else throw std::runtime_error("unknown function '" + name + "'");
+			node->args.push_back(parseExpression());
+			if (node->func2) {
+				if (!accept(',')) throw std::runtime_error("missing argument of '" + name + "'");
+				node->args.push_back(parseExpression());
+			}
+			if (!accept(')')) throw std::runtime_error("missing ')'");
+			return node;
+		}
+		auto constant = constants.find(name);
+		if (constant == constants.end()) throw std::runtime_error("unknown symbol '" + name + "'");
+		NodePtr node = std::make_unique<Node>();
+		node->value = constant->second;
+		return node;
+	}
+
+	throw std::runtime_error(std::string("unexpected character '") + c + "'");
+}
+
+double FormulaEvaluator::eval(std::string const& formula) {
+
+	auto cached = fCache.find(formula);
+	if (cached != fCache.end()) return cached->second;
+
+	double value = std::numeric_limits<double>::quiet_NaN();
+	try {
+		Parser parser(formula);
+		NodePtr tree = parser.parseExpression();
+		parser.skipBlanks();
+		if (parser.pos != formula.length())
+			throw std::runtime_error("unexpected trailing characters");
+		value = tree->eval();
+	}
+	catch (std::runtime_error const& e) {
+		std::cerr << "Error evaluating formula '" << formula << "': " << e.what() << std::endl;
+	}
+
+	fCache.emplace(formula, value);
+	return value;
+}
+
+FormulaEvaluator formulas;
+
+
+//---- Line processing ---------------------------------------------------------
+
+bool isComment(std::string const& key) {
+
+	size_t pos1 = key.find("<!--");
+	size_t pos2 = key.find("-->");
+	if(pos1==std::string::npos || pos2==std::string::npos || pos2<=pos1) return false;
+	std::string s1 = key.substr(0,pos1), s2 = key.substr(pos2+3);
+	for(char& c: s1) if(c==char(9)) c=' ';
+	for(char& c: s2) if(c==char(9)) c=' ';
+	return isWhitespace(s1) && isWhitespace(s2);
+}
+
+void replaceVariable(std::string &key, Variables_t const& variables ){
+	variables.replaceIn(key);
+}
+
+void replaceKeyword(std::string &key, std::string const& word, std::string const& keyword){
+
+	size_t pos1 = key.find(word);
+	if(pos1!=std::string::npos && pos1>=1){
+		size_t pos2 = word.length();
+		char delimiter1 = key[pos1-1];
+		char delimiter2 = (pos1+pos2 < key.length())? key[pos1+pos2]: '\0';
+		if(delimiter1=='"' && delimiter2=='"') key.replace(pos1,pos2,keyword);
+	}
+
+}
+
+// Text between the n-th and (n+1)-th double quote of key (n counts from 0)
+std::string quotedField(std::string const& key, int n){
+	size_t pos = 0;
+	for(int i=0; i<2*n+1; i++){
+		pos = key.find('"', pos);
+		if(pos==std::string::npos) return "";
+		pos++;
+	}
+	size_t end = key.find('"', pos);
+	return key.substr(pos, (end==std::string::npos)? std::string::npos: end-pos);
+}
+
+void getVariable(std::string key, Variables_t& variables){
 
 	replaceVariable(key,variables);
 
-	int pos = key.First("\"")+1;
-	key.Replace(0,pos,"");
-	pos = key.First("\"");
-	TString varName = key;
-	varName.Remove(pos);
-	pos = key.First("\"")+1;
-	key.Replace(0,pos,"");
-	pos = key.First("\"")+1;
-	key.Replace(0,pos,"");
-	pos = key.First("\"");
-	TString varValue = key;
-	varValue.Remove(pos);
-
-	TFormula formula("formula",varValue);
-	name = varName;
-	double value = formula.Eval(0);
+	std::string varName = quotedField(key,0);
+	std::string varValue = quotedField(key,1);
+
+	double value = formulas.eval(varValue);
 
 	if (debug >= 2) {
 		std::cout.precision(prec);
-		std::cout << "VARIABLE\t'" << name << "'=\"" << varValue << "\" => " << value << std::endl;
+		std::cout << "VARIABLE\t'" << varName << "'=\"" << varValue << "\" => " << value << std::endl;
 	}
-	variables[name.Data()]=value;
-
-//	if(varName.Length()==1) cout << varName << "\t"<< value<< endl;
+	variables.set(varName,value);
 }
 
-void evalFormulas(TString &key){
+void evalFormulas(std::string &key){
 
-	TString storeKey;
-	int pos1,pos2;
-	const int n=66;
-	TString lookFor[n]={"x=\"","y=\"","z=\"","r=\"","rmax=\"","rmin=\"","rmax1=\"","rmin1=\"","rmax2=\"","rmin2=\"",
+	static const std::vector<std::string> lookFor = {"x=\"","y=\"","z=\"","r=\"","rmax=\"","rmin=\"","rmax1=\"","rmin1=\"","rmax2=\"","rmin2=\"",
 	"startphi=\"","deltaphi=\"","starttheta=\"","deltatheta=\"","ax=\"","by=\"","cz=\"","dx=\"","dy=\"","dz=\"",
 	"zcut1=\"","zcut2=\"","rlo=\"","rhi=\"","alpha=\"","theta=\"","phi=\"","numsides=\"","x1=\"","x2=\"","y1=\"","y2=\"","x3=\"","x4=\"",
 	"alpha1=\"","alpha2=\"","inst=\"","outst=\"","lowX=\"","lowY=\"","lowZ=\"","highX=\"","highY=\"","highZ=\"","zOrder=\"","zPosition=\"",
 	"xOffset=\"","yOffset=\"","scalingFactor=\"","v1x=\"","v1y=\"","v2x=\"","v2y=\"","v3x=\"","v3y=\"","v4x=\"","v4y=\"","v5x=\"","v5y=\"",
 	"v6x=\"","v6y=\"","v7x=\"","v7y=\"","v8x=\"","v8y=\"","dz=\""};
 
-
-
-	for(int i=0; i<n; i++)
-	if(key.Contains(lookFor[i])){
-		storeKey=key;
-		pos1 = key.Index(lookFor[i])+lookFor[i].Length();
-		key.Replace(0,pos1,"");
-		pos2 = key.First("\"");
-		TString varFormula = key;
-		varFormula.Remove(pos2);
-		TFormula formula("",varFormula);
-		double value = formula.Eval(0);
+	for(std::string const& look: lookFor){
+		size_t pos1 = key.find(look);
+		if(pos1==std::string::npos) continue;
+		pos1 += look.length();
+		size_t pos2 = key.find('"', pos1);
+		std::string varFormula = key.substr(pos1, (pos2==std::string::npos)? std::string::npos: pos2-pos1);
+		double value = formulas.eval(varFormula);
 		if (debug >= 2) {
 			std::cout.precision(prec);
-			std::cout << "FML " << lookFor[i] << "='" << varFormula << "' => " << value << std::endl;
+			std::cout << "FML " << look << "='" << varFormula << "' => " << value << std::endl;
 		}
-		TString varValue;
-		std::stringstream stream;
-		stream.precision(prec);
-		if(sci) { stream << scientific << value;} else {stream << value;}
-		stream << "\"";
+		std::string varValue;
+		std::stringstream stream(formatNumber(value, sci) + "\"");
 		stream >> varValue;
-		key = storeKey;
-		key.Replace(pos1,varFormula.Length()+1,varValue);
+		key.replace(pos1,varFormula.length()+1,varValue);
 	}
 
+}
 
+// Value of the attribute following `attribute` in key; key is consumed up to the closing quote
+std::string nextAttribute(std::string &key, std::string const& attribute, size_t skip){
+	size_t pos = key.find(attribute);
+	key.erase(0, (pos==std::string::npos)? 0: pos+skip);
+	pos = key.find('"');
+	key.erase(0, (pos==std::string::npos)? 0: pos+1);
+	pos = key.find('"');
+	return key.substr(0, pos);
 }
 
-void makeLoop(TString &key, aLoop &theLoop){
-	int pos = key.Index("for")+3;
-	key.Replace(0,pos,"");
-	pos = key.First("\"")+1;
-	key.Replace(0,pos,"");
-	pos = key.First("\"");
-	TString name = key;
-	name.Remove(pos);
-
-	pos = key.Index("to")+2;
-	key.Replace(0,pos,"");
-	pos = key.First("\"")+1;
-	key.Replace(0,pos,"");
-	pos = key.First("\"");
-	TString value = key;
-	value.Remove(pos);
-
-	pos = key.Index("step")+1;
-	key.Replace(0,pos,"");
-	pos = key.First("\"")+1;
-	key.Replace(0,pos,"");
-	pos = key.First("\"");
-	TString step = key;
-	step.Remove(pos);
-
-	theLoop.varName = name;
-	theLoop.varTo = value.Atof();
-	theLoop.varStep = step.Atof();
+void makeLoop(std::string key, aLoop &theLoop){
+	theLoop.varName = nextAttribute(key, "for", 3);
+	theLoop.varTo = std::atof(nextAttribute(key, "to", 2).c_str());
+	theLoop.varStep = std::atof(nextAttribute(key, "step", 1).c_str());
 }
 
-void getFileNames(TString inName, TString &outName1, TString &outName2){
-	int pos = inName.Index("_base");
-	TString temp = inName;
-	temp.Remove(pos);
-	
-	if (outName1.IsNull()) outName1 = temp+".gdml";
-	if (outName2.IsNull()) outName2 = temp+"_nowires.gdml";
+void getFileNames(std::string const& inName, std::string &outName1, std::string &outName2){
+	std::string temp = inName.substr(0, inName.find("_base"));
+
+	if (outName1.empty()) outName1 = temp+".gdml";
+	if (outName2.empty()) outName2 = temp+"_nowires.gdml";
 }
 
 void SetDefaultVariables(Variables_t& variables) {
-	
-	variables["degree"] = M_PI / 180.0;
-	
+
+	variables.set("degree", M_PI / 180.0);
+
 } // SetDefaultVariables()
 
 
-void getSetup(TString key, aSetup &theSetup){
-	int pos;
-	TString s;
-	pos = key.Index("name=");
-	if(pos>=0){
-		pos+=6;
-		s = key;
-		s.Replace(0,pos,"");
-		pos = s.Index("\"");
-		s.Replace(pos,s.Length()-pos,"");
-		theSetup.stpName = s;
+void getSetup(std::string const& key, aSetup &theSetup){
+	size_t pos;
+	pos = key.find("name=");
+	if(pos!=std::string::npos){
+		std::string s = key.substr(std::min(pos+6, key.length()));
+		theSetup.stpName = s.substr(0, s.find('"'));
 	}
-	
-	pos = key.Index("version=\"");
-	if(pos>=0){
-		pos+=9;
-		s = key;
-		s.Replace(0,pos,"");
-		pos = s.Index("\"");
-		s.Replace(pos,s.Length()-pos,"");
-		theSetup.stpVersion = s;
+
+	pos = key.find("version=\"");
+	if(pos!=std::string::npos){
+		std::string s = key.substr(pos+9);
+		theSetup.stpVersion = s.substr(0, s.find('"'));
 	}
 
-	pos = key.Index("ref=\"");
-	if(pos>=0 && key.Contains("world")){
-		pos+=5;
-		s = key;
-		s.Replace(0,pos,"");
-		pos = s.Index("\"");
-		s.Replace(pos,s.Length()-pos,"");
-		theSetup.stpWorldVolume = s;
+	pos = key.find("ref=\"");
+	if(pos!=std::string::npos && contains(key, "world")){
+		std::string s = key.substr(pos+5);
+		theSetup.stpWorldVolume = s.substr(0, s.find('"'));
 	}
 
 }
 
-int preparse(TString inName="sbnd_base.gdml", TString outName1="sbnd.gdml", TString outName2=""){
-	
+// Output of the first pass, kept in memory for the setup selection pass
+struct OutputBuffer {
+	std::string text;
+	void add(std::string const& line) { text += line; text += '\n'; }
+};
+
+int writeOutput(std::string const& name, std::string const& text){
+	ofstream output(name);
+	if (!output) {
+		std::cerr << "Error writing '" << name << "': " << strerror(errno) << std::endl;
+		return errno? errno: 1;
+	}
+	output << text;
+	return 0;
+}
+
+int preparse(std::string inName="sbnd_base.gdml", std::string outName1="sbnd.gdml", std::string outName2=""){
+
 	std::cout << "Preparsing '" << inName << "'"
 		"\n => '" << outName1 << "' (complete description)";
-  if (!outName2.IsNull())
+  if (!outName2.empty())
 		std::cout << "\n => '" << outName2 << "' (without TPC wires)";
 	std::cout << "\n" << std::endl;
-  
-//	cout << sci << "\t" << prec << endl;
 
 	bool noWiresFiles = 1;
 	if(outName2!="") noWiresFiles = 0;
 
-	ofstream output1, output2;
-	output1.open(outName1);
-	if(!noWiresFiles) output2.open(outName2);
-	
+	OutputBuffer output1, output2;
 
 	ifstream input(inName);
-	TString key;
+	std::string key;
 	Variables_t variables;
 	SetDefaultVariables(variables);
-	
+
 	std::vector<std::string> loopLine;
 	aLoop theLoop;
 
 	std::vector<aSetup> stpList;
-	aSetup theSetup;	
+	aSetup theSetup;
 
-	TString name, loopkey;
+	std::string loopkey;
 	bool inLoop = 0;
 	bool inSetup = 0;
 	bool isWire = 0;
@@ -296,129 +568,121 @@ int preparse(TString inName="sbnd_base.gdml", TString outName1="sbnd.gdml", TStr
 	uint64_t lineCounter = 0;
 	do{
 		lineCounter++;
-		key.ReadLine(input,0);
+		if (!std::getline(input,key)) key.clear();
 		if(debug>3) cout << lineCounter << "\t::\t" << key << "\n";
-		if ((key.Contains("<variable") && !key.Contains("<!--")) || (key.Contains("<constant") && !key.Contains("<!--"))) {
+		if ((contains(key,"<variable") && !contains(key,"<!--")) || (contains(key,"<constant") && !contains(key,"<!--"))) {
 			getVariable(key,variables);
-		} else if (key.Contains("<loop")) {
+		} else if (contains(key,"<loop")) {
 			inLoop = 1;
-			if(key.Contains("#wire")) isWire=1;
+			if(contains(key,"#wire")) isWire=1;
 			makeLoop(key,theLoop);
-		} else if (key.Contains("</loop")) {
+		} else if (contains(key,"</loop")) {
 			do{
-				for (std::vector<std::string>::iterator it = loopLine.begin() ; it != loopLine.end(); ++it){
-					loopkey = *it;
+				for (std::string const& line: loopLine){
+					loopkey = line;
 					replaceVariable(loopkey,variables);
-					if(loopkey.Contains("--")) {
+					if(contains(loopkey,"--")) {
 					  if (debug) {
 					    std::cout << "checking double minus sign " << std::endl;
 					    std::cout << loopkey << std::endl;
 					  }
-					  loopkey.ReplaceAll("--","+");
-					  if (debug) std::cout << loopkey << std::endl; 
+					  size_t pos = 0;
+					  while((pos = loopkey.find("--", pos)) != std::string::npos) { loopkey.replace(pos,2,"+"); pos++; }
+					  if (debug) std::cout << loopkey << std::endl;
 					}
 					evalFormulas(loopkey);
-					output1 << loopkey << endl;
-					if(!isWire && !noWiresFiles) output2 << loopkey << endl;
-				}			
-				variables[theLoop.varName] += theLoop.varStep;
-				if(theLoop.varStep>0) {keepLoop = (variables[theLoop.varName] <= theLoop.varTo);}
-				else {keepLoop = (variables[theLoop.varName] >= theLoop.varTo);}
+					output1.add(loopkey);
+					if(!isWire && !noWiresFiles) output2.add(loopkey);
+				}
+				double const value = variables.get(theLoop.varName) + theLoop.varStep;
+				variables.set(theLoop.varName, value);
+				if(theLoop.varStep>0) {keepLoop = (value <= theLoop.varTo);}
+				else {keepLoop = (value >= theLoop.varTo);}
 			} while (keepLoop);
 			inLoop = 0;
 			isWire = 0;
 			loopLine.clear();
 		} else if (inLoop) {
-			loopLine.push_back(key.Data());
+			loopLine.push_back(key);
 		} else {
-			if( !( isComment(key) || key.IsWhitespace() ) ){
-				if(key.Contains("<setup")){
+			if( !( isComment(key) || isWhitespace(key) ) ){
+				if(contains(key,"<setup")){
 					inSetup = 1;
 					getSetup(key,theSetup);
 				}
 				if(inSetup) getSetup(key,theSetup);
-				if(key.Contains("</setup")) { 
+				if(contains(key,"</setup")) {
 					stpList.push_back(theSetup);
 					theSetup.stpName="";
 					theSetup.stpVersion="";
 					theSetup.stpWorldVolume="";
-					inSetup = 0;	
+					inSetup = 0;
 				}
 				replaceVariable(key,variables);
 				evalFormulas(key);
-				output1 << key << endl;
-				if(!noWiresFiles) output2 << key << endl;
+				output1.add(key);
+				if(!noWiresFiles) output2.add(key);
 			}
 		}
 
 	}while(!input.eof());
 
-	
-	output1.close();
-	if(!noWiresFiles) output2.close();
 	input.close();
 
 	bool goAhead = true;
 	if (!setupChoice) mySetup = "Default";
 
-	TString ver="1.0";
-	int pos=mySetup.Index(":");
-	if(pos>=0){
-		ver=mySetup;
-		ver.Replace(0,pos+1,"");
-		mySetup.Replace(pos,mySetup.Length()-pos,"");
+	std::string ver="1.0";
+	size_t pos=mySetup.find(":");
+	if(pos!=std::string::npos){
+		ver=mySetup.substr(pos+1);
+		mySetup.erase(pos);
 	}
 
 	// is the indicated setup among the ones available?
-	for (std::vector<aSetup>::iterator itx = stpList.begin() ; itx != stpList.end(); ++itx){
+	for (aSetup const& setup: stpList){
 
-		theSetup=(*itx);
+		theSetup=setup;
 		if( theSetup.stpName==mySetup && theSetup.stpVersion==ver ){ goAhead = true; break; }
 		else {goAhead = false;}
 	}
 
+	std::string outNameVec[]={outName1,outName2};
+	OutputBuffer* bufferVec[]={&output1,&output2};
+	const int kmax = 1+(!noWiresFiles);
+
 	if (!goAhead) {
 		cout << "ERROR: Setup " << mySetup << " or its version not found." << endl;
+		for(int k=0; k<kmax; k++){
+			int res = writeOutput(outNameVec[k], bufferVec[k]->text);
+			if (res != 0) return res;
+		}
 	} else {
 
-		TString inName1, inName2, comm;
-		inName1 = outName1+"~";
-		inName2 = outName2+"~";
-		TString inNameVec[]={inName1,inName2};
-		TString outNameVec[]={outName1,outName2};
-
-		const int kmax = 1+(!noWiresFiles);
-
+		// second pass over the in-memory output: drop the setups and make the chosen one the world
 		for(int k=0; k<kmax; k++){
-			errno = 0;
-			rename(outNameVec[k], inNameVec[k]);
-			if (errno != 0) {
-			  std::cerr << "Error renaming '" << outNameVec[k] << "' into '" << inNameVec[k] << "': "
-			    << strerror(errno) << std::endl;
-        return errno;
-			}
-			output1.open(outNameVec[k]);
-			ifstream input1(inNameVec[k]);
+			OutputBuffer final;
+			final.text.reserve(bufferVec[k]->text.size());
+			std::istringstream input1(bufferVec[k]->text);
 
 			inSetup=0;
 			do{
-				key.ReadLine(input1,0);
-				if((!key.Contains("<setup") && !inSetup) ){
+				if (!std::getline(input1,key)) key.clear();
+				if((!contains(key,"<setup") && !inSetup) ){
 					if (theSetup.stpWorldVolume != "volWorld") {
 						replaceKeyword(key,"volWorld","volIgnoredOnThisSetup");
 					}
-					if(!key.Contains("volumeref")) replaceKeyword(key,theSetup.stpWorldVolume,"volWorld");
-					output1 << key << endl;
+					if(!contains(key,"volumeref")) replaceKeyword(key,theSetup.stpWorldVolume,"volWorld");
+					final.add(key);
 				}else {inSetup=1;}
 			}while(!input1.eof());
 
-			output1 << "\t<setup name=\"Default\" version=\"1.0\">" << endl;
-			output1 << "\t\t<world ref=\"volWorld\" />" << endl;
-			output1 << "\t</setup>" << endl;
-			output1 << "</gdml_simple_extension>" << endl;
-			output1.close();
-			input1.close();
-			remove(inNameVec[k]);
+			final.add("\t<setup name=\"Default\" version=\"1.0\">");
+			final.add("\t\t<world ref=\"volWorld\" />");
+			final.add("\t</setup>");
+			final.add("</gdml_simple_extension>");
+			int res = writeOutput(outNameVec[k], final.text);
+			if (res != 0) return res;
 		}
 	}
 	return 0;
@@ -426,10 +690,15 @@ int preparse(TString inName="sbnd_base.gdml", TString outName1="sbnd.gdml", TStr
 
 
 //---- Main program ------------------------------------------------------------
-# ifndef __CINT__
 
 bool genNoWires = false, printHelp = false;
-TString inFile="sbnd_base.gdml", outFile, outFile2, noWires, withWires;
+std::string inFile="sbnd_base.gdml", outFile, outFile2, noWires, withWires;
+
+bool isDigit(std::string const& par) {
+	if (par.empty()) return false;
+	for (char c: par) if (!std::isdigit((unsigned char) c)) return false;
+	return true;
+}
 
 void parseArguments(unsigned int argc, char** argv) {
 
@@ -443,7 +712,7 @@ void parseArguments(unsigned int argc, char** argv) {
     { "help",      no_argument,       NULL, 'h' },
     { NULL,        0,                 NULL,  0  }
   }; // longopts
-  
+
   // automatically build the short option string from the long one
   std::string shortopts = ":"; // this means no error printout
   for (auto const& longopt: longopts) {
@@ -453,10 +722,10 @@ void parseArguments(unsigned int argc, char** argv) {
     if (longopt.has_arg != no_argument) shortopts += ':';
     if (longopt.has_arg == optional_argument) shortopts += ':';
   } // for
-  
+
   // ----------------------------------------------------------------------
   // options
-  char ch;
+  int ch;
   optind = 1;
   while
     ((ch = getopt_long(argc, argv, shortopts.c_str(), longopts, NULL)) != -1)
@@ -476,27 +745,27 @@ void parseArguments(unsigned int argc, char** argv) {
       case 's': // -s, --sci
         sci = true;
         if (optarg) {
-          TString par = optarg;
-          if (!par.IsDigit())
+          std::string par = optarg;
+          if (!isDigit(par))
             throw std::runtime_error("Invalid precision in -s option.");
-          prec = par.Atoi();
+          prec = std::atoi(par.c_str());
         }
         continue;
       case 'd': // -d, --debug
         if (optarg) {
-          TString par = optarg;
-          if (!par.IsDigit())
+          std::string par = optarg;
+          if (!isDigit(par))
             throw std::runtime_error("Invalid debug level in -d option.");
-          debug = par.Atoi();
+          debug = std::atoi(par.c_str());
         }
         else debug = 1;
         continue;
       case 'p': // -p, --prec
         {
-          TString par = optarg;
-          if (!par.IsDigit())
+          std::string par = optarg;
+          if (!isDigit(par))
             throw std::runtime_error("Invalid precision in -s option.");
-          prec = par.Atoi();
+          prec = std::atoi(par.c_str());
         }
         continue;
       case 'h': // -h, --help
@@ -504,11 +773,11 @@ void parseArguments(unsigned int argc, char** argv) {
         continue;
      } // switch
   } // while
-  
+
   // ----------------------------------------------------------------------
   // arguments
   if (optind < (int) argc) inFile = argv[optind++];
-  
+
   if (optind < (int) argc) {
     std::cerr << "Spurious arguments: '" << argv[optind] << "'";
     if (optind + 1 < (int) argc)
@@ -516,7 +785,7 @@ void parseArguments(unsigned int argc, char** argv) {
     std::cerr << "." << std::endl;
     throw std::runtime_error("Too many arguments on the command line!");
   }
-  
+
 } // parseArguments()
 
 
@@ -525,13 +794,13 @@ int main(int argc, char **argv)
 {
 
 	parseArguments(argc, argv);
-	
+
 	if (printHelp) {
 		std::string programName = argv[0];
 		if (programName.rfind('/') != std::string::npos) programName.erase(programName.rfind('/'));
-		
+
 		cout <<
-		  "\nGDML Preparser v 1.0 (gustavo.valdiviesso@unifal-mg.edu.br)"
+		  "\nGDML Preparser v 1.1 (gustavo.valdiviesso@unifal-mg.edu.br)"
 		  "\nBasic usage:"
 		  "\n  " << programName << " [file_base.gdml] [flags]"
 		  "\n"
@@ -562,12 +831,12 @@ int main(int argc, char **argv)
 	}
 
 	ifstream input(inFile);
-	if (!input.is_open()) { 
+	if (!input.is_open()) {
 		std::cerr << "Error opening '" << inFile << "': " << strerror(errno) << std::endl;
 		return errno;
 	}
 
-	if(inFile.Contains("_base.gdml")) {getFileNames(inFile,withWires,noWires);}
+	if(contains(inFile,"_base.gdml")) {getFileNames(inFile,withWires,noWires);}
 	else {
 		withWires = inFile+"_preparsed.gdml";
 		noWires = inFile+"_nowires.gdml";
@@ -575,13 +844,12 @@ int main(int argc, char **argv)
 	if(outFile!="") {
 		withWires = outFile;
 		noWires = outFile;
-		int pos = outFile.Index(".gdml");
-		noWires.Replace(pos,5,"_nowires.gdml");
+		size_t pos = outFile.find(".gdml");
+		if(pos!=std::string::npos) noWires.replace(pos,5,"_nowires.gdml");
 	}
 	if(outFile2!="") { noWires = outFile2; }
 	if(!genNoWires) noWires="";
-	
+
 	return preparse(inFile,withWires,noWires);
-	
+
 } // main()
-#endif // __CINT__
@@ -40,6 +40,8 @@ namespace sbnd{
 * to make one reweight object for each weight needed.
 * This will also make a "total" reweight object that will set all the
 * switches on for all weighting parameters.
+* GENIE reweighting relies on process wide singletons, so the drivers are
+* always evaluated one at a time.
 */
   void NuAnaAlg::configureReWeight(const std::vector<reweight> & weights,
                          const std::vector<std::vector<float>>& reweightingSigmas){
@@ -55,7 +57,7 @@ namespace sbnd{
 
     // don't forget the last vector with all of the weights
     reweightVector.back().resize(reweightingSigmas.front().size());
-    for (auto & ptr : reweightVector.back()) ptr = new rwgt::NuReweight;
+    for (auto & ptr : reweightVector.back()) ptr = std::make_unique<rwgt::NuReweight>();
 
     for (unsigned int i_weight = 0; i_weight < reweightingSigmas.front().size(); ++i_weight)
     {
@@ -114,7 +116,7 @@ namespace sbnd{
         // double reweightingValue = rangeLow[i_reweightingKnob]
         //                         + weight_point*stepSize;
 
-        reweightVector[i_reweightingKnob][weight_point] = new rwgt::NuReweight;
+        reweightVector[i_reweightingKnob][weight_point] = std::make_unique<rwgt::NuReweight>();
 
         switch (weights[i_reweightingKnob]){
           case kNCEL:
@@ -17,6 +17,7 @@
 #include "TRandom.h"
 
 #include <memory>
+#include <vector>
 
 namespace sbnd{
 
@@ -115,7 +116,7 @@ namespace sbnd{
                                   TLorentzVector& ConversionMom);
     // The reweighting utility class:
     // std::unique_ptr<rwgt::NuReweight> reweight;
-    std::vector<std::vector<rwgt::NuReweight *> > reweightVector;
+    std::vector<std::vector<std::unique_ptr<rwgt::NuReweight> > > reweightVector;
 
     // geometry boundaries:
     double xlow, xhigh, ylow, yhigh, zlow, zhigh;
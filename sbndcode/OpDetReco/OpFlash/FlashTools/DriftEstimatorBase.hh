@@ -19,7 +19,7 @@ namespace lightana
     virtual ~DriftEstimatorBase() noexcept = default;
 
     // Method giving the estimated drift coordinate
-    virtual double GetDriftPosition(std::vector<double> PE_v) = 0;
+    virtual double GetDriftPosition(const std::vector<double>& PE_v) = 0;
 
     // Method giving the photon propagation
     virtual double GetPropagationTime(double drift) = 0;
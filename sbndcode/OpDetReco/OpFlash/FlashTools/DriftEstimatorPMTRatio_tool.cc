@@ -21,6 +21,8 @@
 #include "larcore/CoreUtils/ServiceUtil.h"
 #include "larcore/Geometry/Geometry.h"
 
+#include <algorithm>
+#include <cmath>
 #include <vector>
 #include <string>
 #include <map>
@@ -62,16 +64,20 @@ namespace lightana
     explicit DriftEstimatorPMTRatio(art::ToolConfigTable<Config> const& config);
 
     // Method giving the estimated drift coordinate
-    double GetDriftPosition(std::vector<double> PE_v) override;
+    double GetDriftPosition(const std::vector<double>& PE_v) override;
 
     // Method giving the photon propagation
     double GetPropagationTime(double drift) override;
 
     // Method giving the photon propagation from PE vector
-    double PEToPropagationTime(std::vector<double> PE_v);
+    double PEToPropagationTime(const std::vector<double>& PE_v);
 
   private:
-    double Interpolate(double val);
+    // Piecewise linear interpolation of the calibration profile
+    double Interpolate(double val) const;
+
+    // Drift from the uniformly binned lookup table
+    double LookUpDrift(double pmtratio) const;
 
     // Input filepah with calibration curve
     std::string fCalibrationFile;
@@ -93,10 +99,22 @@ namespace lightana
     double fPMTRatio_MinVal;
     double fPMTRatio_MaxVal;
 
+    // Calibration resampled on a uniform PMT ratio grid starting at fPMTRatio_MinVal
+    std::vector<double> fDriftLUT;
+    double fLUTStep_I;
+
     // PDS mapping
     opdet::sbndPDMapAlg fPDSMap;
 
-    std::set<int> fPDSBoxIDs;
+    // PMT channels, in increasing order, and the slot they add to:
+    // 2*(dense PDS box index) + 1 for coated, + 0 for uncoated
+    std::vector<size_t> fPMTChannels;
+    std::vector<size_t> fPMTSlots;
+    size_t fNBoxes;
+
+    // Per slot sums of PE and number of channels with light
+    std::vector<double> fSlotPE;
+    std::vector<int> fSlotNCh;
 
   };
 
@@ -135,49 +153,60 @@ namespace lightana
 
     fVGroupVUV_I = 1./fVGroupVUV;
 
+    // Resample the calibration on a uniform grid, as fine as the finest
+    // calibration binning, so a drift is one index computation away.
+    // For a fixed bin profile the grid is the bin centres themselves
+    double step = fPMTRatio_MaxVal - fPMTRatio_MinVal;
+    for (int ix=1; ix<fNCalBins; ix++){
+      step = std::min(step, fPMTRatioCal[ix]-fPMTRatioCal[ix-1]);
+    }
+    size_t nLUT = step>0 ? (size_t)std::lround((fPMTRatio_MaxVal-fPMTRatio_MinVal)/step) + 1 : 1;
+    fLUTStep_I = nLUT>1 ? (nLUT-1)/(fPMTRatio_MaxVal-fPMTRatio_MinVal) : 0;
+    fDriftLUT.resize(nLUT);
+    for (size_t ix=0; ix<nLUT; ix++){
+      double pmtratio = nLUT>1 ? fPMTRatio_MinVal + ix/fLUTStep_I : fPMTRatio_MinVal;
+      fDriftLUT[ix] = Interpolate( std::clamp(pmtratio, fPMTRatio_MinVal, fPMTRatio_MaxVal) );
+    }
+
+    // Assign each PMT to its box once, the xarapucas are excluded by now
+    std::map<int, size_t> boxIndex;
     for(size_t oc=0; oc<fPDSMap.size(); oc++){
-      fPDSBoxIDs.insert( fPDSMap.pdBox(oc) );
+      opdet::PDType pd_type = fPDSMap.pdTypeEnum(oc);
+      if(pd_type!=opdet::kPMTCoated && pd_type!=opdet::kPMTUncoated) continue;
+
+      size_t box = boxIndex.emplace(fPDSMap.pdBox(oc), boxIndex.size()).first->second;
+      fPMTChannels.push_back(oc);
+      fPMTSlots.push_back(2*box + (pd_type==opdet::kPMTCoated ? 1 : 0));
     }
+    fNBoxes = boxIndex.size();
+    fSlotPE.resize(2*fNBoxes);
+    fSlotNCh.resize(2*fNBoxes);
   }
 
-  double DriftEstimatorPMTRatio::GetDriftPosition(std::vector<double> PE_v){
+  double DriftEstimatorPMTRatio::GetDriftPosition(const std::vector<double>& PE_v){
 
-    std::map<int, double> BoxMap_PECoated;
-    std::map<int, double> BoxMap_PEUncoated;
-    std::map<int, int> BoxMap_NCoatedCh;
-    std::map<int, int> BoxMap_NUncoatedCh;
+    std::fill(fSlotPE.begin(), fSlotPE.end(), 0.);
+    std::fill(fSlotNCh.begin(), fSlotNCh.end(), 0);
 
-    for(size_t oc=0; oc<PE_v.size(); oc++){
+    // we store the pe in each box per PMT flavour
+    // and the number of "triggered" PMTs
+    for(size_t i=0; i<fPMTChannels.size(); i++){
+      size_t oc = fPMTChannels[i];
+      if(oc>=PE_v.size()) break;
       // skip 0 PE channels
       if(PE_v[oc]==0) continue;
-
-      std::string pd_type=fPDSMap.pdType(oc);
-      // exclude xarapucas by now
-      if(pd_type=="xarapuca_vuv" || pd_type=="xarapuca_vis") continue;
-
-      // get PDS box
-      int box_id = fPDSMap.pdBox(oc);
-
-      // we store the pe in each box per PMT flavour
-      // and the number of "triggered" PMTs
-      if(pd_type=="pmt_coated") {
-        BoxMap_PECoated[box_id]+=PE_v[oc];
-        BoxMap_NCoatedCh[box_id]+=1;
-      }
-      else if(pd_type=="pmt_uncoated") {
-        BoxMap_PEUncoated[box_id]+=PE_v[oc];
-        BoxMap_NUncoatedCh[box_id]+=1;
-      }
+      fSlotPE[fPMTSlots[i]]+=PE_v[oc];
+      fSlotNCh[fPMTSlots[i]]+=1;
     }
 
     // compute PMTRatio metric
     double PECoated=0, PEUncoated=0;
-    for(size_t boxID=0; boxID<fPDSBoxIDs.size(); boxID++){
+    for(size_t box=0; box<fNBoxes; box++){
       //we need the uncoated PMT in each window and at least one coated
-      if( BoxMap_NUncoatedCh[boxID]==1 && BoxMap_NCoatedCh[boxID]>=1){
-        double CoWeight = 1./BoxMap_NCoatedCh[boxID];
-        PECoated+=CoWeight * BoxMap_PECoated[boxID];
-        PEUncoated+=BoxMap_PEUncoated[boxID];
+      if( fSlotNCh[2*box]==1 && fSlotNCh[2*box+1]>=1){
+        double CoWeight = 1./fSlotNCh[2*box+1];
+        PECoated+=CoWeight * fSlotPE[2*box+1];
+        PEUncoated+=fSlotPE[2*box];
       }
     }
 
@@ -185,12 +214,12 @@ namespace lightana
       double pmtratio = PEUncoated/PECoated;
 
       double drift_distance;
-      if(pmtratio<=fPMTRatioCal[0])
+      if(pmtratio<=fPMTRatio_MinVal)
         drift_distance=fDriftCal[0];
-      else if(pmtratio>=fPMTRatioCal[fNCalBins-1])
+      else if(pmtratio>=fPMTRatio_MaxVal)
         drift_distance=fDriftCal[fNCalBins-1];
       else
-        drift_distance=Interpolate(pmtratio);
+        drift_distance=LookUpDrift(pmtratio);
 
       return drift_distance;
     }
@@ -207,22 +236,32 @@ namespace lightana
       return std::abs(drift) * fVGroupVUV_I + fVISLightPropTime;
   }
 
-  double DriftEstimatorPMTRatio::PEToPropagationTime(std::vector<double> PE_v){
+  double DriftEstimatorPMTRatio::PEToPropagationTime(const std::vector<double>& PE_v){
 
     double _drift = GetDriftPosition(PE_v);
 
     return GetPropagationTime(_drift);
   }
 
-  double DriftEstimatorPMTRatio::Interpolate(double val){
+  double DriftEstimatorPMTRatio::Interpolate(double val) const{
 
     size_t upix = std::upper_bound(fPMTRatioCal.begin(), fPMTRatioCal.end(), val)-fPMTRatioCal.begin();
+    if(upix==0) return fDriftCal.front();
+    if(upix==fPMTRatioCal.size()) return fDriftCal.back();
 
-    double slope = ( fDriftCal[upix]-fDriftCal[upix] ) / ( fPMTRatioCal[upix]-fPMTRatioCal[upix-1] );
+    double slope = ( fDriftCal[upix]-fDriftCal[upix-1] ) / ( fPMTRatioCal[upix]-fPMTRatioCal[upix-1] );
 
     return fDriftCal[upix-1] + slope * ( val - fPMTRatioCal[upix-1] );
   }
 
+  double DriftEstimatorPMTRatio::LookUpDrift(double pmtratio) const{
+
+    double x = (pmtratio-fPMTRatio_MinVal) * fLUTStep_I;
+    size_t ix = std::min((size_t)x, fDriftLUT.size()-2);
+
+    return fDriftLUT[ix] + (x-ix) * ( fDriftLUT[ix+1]-fDriftLUT[ix] );
+  }
+
 }
 
 DEFINE_ART_CLASS_TOOL(lightana::DriftEstimatorPMTRatio)
@@ -38,6 +38,10 @@
 #include "TH1D.h"
 // #include "TRandom3.h"
 
+#include <algorithm>
+#include <climits>
+#include <iterator>
+#include <map>
 #include <memory>
 
 class SBNDMCFlash;
@@ -57,6 +61,7 @@ public:
 
   // Required functions.
   void produce(art::Event& e) override;
+  void beginJob() override;
 
 private:
 
@@ -66,12 +71,19 @@ private:
   std::string _simphot_insta;
   std::vector<std::string> _pd_to_use;
   int _tpc;
+  std::vector<int> _tpcs;
+  bool _all_neutrinos;
   float _qe_direct, _qe_refl;
   float _window_length, _pre_window;
   bool _debug;
 
   opdet::sbndPDMapAlg _pds_map;
 
+  // For each entry of _tpcs, whether each optical channel contributes to its flash
+  std::vector<std::vector<bool>> _channel_mask;
+  // Optical channel centres, for the flash location
+  std::vector<double> _opch_y, _opch_z;
+
   // TRandom3 _random;
 
   int _run, _subrun, _event;
@@ -84,7 +96,7 @@ private:
   std::vector<int> _scintillation_pmt_v;
   TTree* _tree1;
 
-  void GetFlashLocation(std::vector<double>, double&, double&, double&, double&);
+  void GetFlashLocation(const std::vector<double>&, double&, double&, double&, double&);
 
 };
 
@@ -99,6 +111,8 @@ SBNDMCFlash::SBNDMCFlash(fhicl::ParameterSet const& p)
   _simphot_insta = p.get<std::string>("SimPhotProductInstance", "");
   _pd_to_use     = p.get<std::vector<std::string>>("PD", _pd_to_use);
   _tpc           = p.get<int>("TPC", -1);
+  _tpcs          = p.get<std::vector<int>>("TPCs", {_tpc}); // one flash per entry
+  _all_neutrinos = p.get<bool>("AllNeutrinos", false); // flash every neutrino interaction, not just the last
   _qe_direct     = p.get<float>("QEDirect", 0.03);
   _qe_refl       = p.get<float>("QERefl", 0.03);
   _window_length = p.get<float>("WindowLength", 8); // us
@@ -121,6 +135,38 @@ SBNDMCFlash::SBNDMCFlash(fhicl::ParameterSet const& p)
   produces< std::vector<recob::OpFlash> >();
 }
 
+void SBNDMCFlash::beginJob()
+{
+  ::art::ServiceHandle<geo::Geometry> geo;
+  size_t n_opch = geo->NOpDets();
+
+  // Get the OpChannel of the PD to use
+  std::vector<bool> use_opch(n_opch, false);
+  for (int opch : lightana::PDNamesToList(_pd_to_use)) {
+    if (opch >= 0 && (size_t)opch < n_opch) use_opch[opch] = true;
+  }
+
+  // The channels to use and the side of the cathode they sit on
+  // do not change, so mask them once for each TPC
+  _opch_y.resize(n_opch);
+  _opch_z.resize(n_opch);
+  _channel_mask.assign(_tpcs.size(), std::vector<bool>(n_opch, false));
+  for (size_t opch = 0; opch < n_opch; opch++) {
+
+    auto const& pt = geo->OpDetGeoFromOpChannel(opch).GetCenter();
+    _opch_y[opch] = pt.Y();
+    _opch_z[opch] = pt.Z();
+
+    if (!use_opch[opch]) continue;
+
+    for (size_t t = 0; t < _tpcs.size(); t++) {
+      if(pt.X() < 0 && _tpcs[t] == 1) continue;
+      if(pt.X() > 0 && _tpcs[t] == 0) continue;
+      _channel_mask[t][opch] = true;
+    }
+  }
+}
+
 void SBNDMCFlash::produce(art::Event& e)
 {
 
@@ -197,15 +243,6 @@ void SBNDMCFlash::produce(art::Event& e)
   }
 
 
-  // opdet=>opchannel mapping
-  std::vector<size_t> opdet2opch(geo->NOpDets(),0);
-  for(size_t opch=0; opch<opdet2opch.size(); ++opch){
-    opdet2opch[geo->OpDetFromOpChannel(opch)] = opch;
-  }
-
-  // Get the OpChannel of the PD to use
-  std::vector<int> opch_to_use = lightana::PDNamesToList(_pd_to_use);
-
   // auto const & evt_trigger = (*evt_trigger_h)[0];
   // auto const trig_time = evt_trigger.TriggerTime();
   auto const trig_time = clock_data.TriggerOffsetTPC();
@@ -215,7 +252,7 @@ void SBNDMCFlash::produce(art::Event& e)
   if (_debug) std::cout << "G4ToElecTime(1000): " << clock_data.G4ToElecTime(1000) << std::endl;
   if (_debug) std::cout << "Number of OpDets: " << geo->NOpDets() << std::endl;
 
-  double nuTime = -1.e9;
+  std::vector<double> nuTimes;
   if (_debug) std::cout << "We have " << evt_mctruth_h->size() << " mctruth events." << std::endl;
   for (size_t n = 0; n < evt_mctruth_h->size(); n++) {
 
@@ -233,21 +270,32 @@ void SBNDMCFlash::produce(art::Event& e)
         std::cout << "new    converted: " << clock_data.G4ToElecTime(par.T()) - trig_time << std::endl;
         std::cout << std::endl;
       }
+      // One flash per interaction: only the incoming neutrino, not the
+      // outgoing one of NC events
+      if (par.StatusCode() != 0) continue;
       if (std::abs(par.PdgCode()) == 14 || std::abs(par.PdgCode()) == 12) {
-        nuTime = par.T();
+        nuTimes.push_back(par.T());
+        break;
       }
     }
   }
 
-  if (nuTime == -1.e9) {
+  if (nuTimes.empty()) {
     std::cout << "[NeutrinoMCFlash] No neutrino found." << std::endl;
     e.put(std::move(opflashes));
     return;
   }
 
-  std::cout << "[NeutrinoMCFlash] Neutrino G4 interaction time: "  << nuTime << std::endl;
+  // Unless asked for all of them, only the last neutrino makes a flash
+  if (!_all_neutrinos) nuTimes.erase(nuTimes.begin(), nuTimes.end() - 1);
 
-  std::vector<std::vector<double> > pmt_v(1,std::vector<double>(geo->NOpDets(),0));
+  for (double nuTime : nuTimes)
+    std::cout << "[NeutrinoMCFlash] Neutrino G4 interaction time: "  << nuTime << std::endl;
+
+  // One flash per neutrino and TPC, neutrino major
+  size_t n_opch = _opch_y.size();
+  size_t n_tpcs = _tpcs.size();
+  std::vector<std::vector<double> > pmt_v(nuTimes.size()*n_tpcs, std::vector<double>(n_opch,0));
   _pe_total = _pe_cherenkov = _pe_scintillation = 0;
   _cherenkov_time_v.clear();
   _cherenkov_pmt_v.clear();
@@ -272,7 +320,28 @@ void SBNDMCFlash::produce(art::Event& e)
   // }
   std::cout << "We have " << evt_simphot_hs.size() << " SimPhoton collections" << std::endl;
 
-  float nuTime_elec = clock_data.G4ToElecTime(nuTime) - trig_time;
+  std::vector<float> nuTimes_elec;
+  for (double nuTime : nuTimes)
+    nuTimes_elec.push_back(clock_data.G4ToElecTime(nuTime) - trig_time);
+
+  // Photon time in elec clock w.r.t. the trigger for a DetectedPhotons tick
+  auto photon_elec_time = [&](int tick) -> float {
+    float photon_time = tick - start_window;
+    return clock_data.G4ToElecTime(photon_time) - trig_time;
+  };
+
+  // First entry of the tick sorted photon map later than time. The elec time
+  // grows with the tick, so binary search from the inverse of the conversion
+  // and step to the exact boundary
+  double g4_to_elec_offset = clock_data.G4ToElecTime(0);
+  auto first_later = [&](std::map<int, int> const& photon_map, float time) {
+    double tick = (time + trig_time - g4_to_elec_offset) * 1.e3 + start_window;
+    tick = std::clamp(std::floor(tick), (double)INT_MIN, (double)INT_MAX);
+    auto iter = photon_map.lower_bound((int)tick);
+    while (iter != photon_map.begin() && photon_elec_time(std::prev(iter)->first) > time) --iter;
+    while (iter != photon_map.end() && !(photon_elec_time(iter->first) > time)) ++iter;
+    return iter;
+  };
 
   for (const art::Handle<std::vector<sim::SimPhotonsLite>> &evt_simphot_h: evt_simphot_hs) {
 
@@ -283,33 +352,30 @@ void SBNDMCFlash::produce(art::Event& e)
 
     for(sim::SimPhotonsLite const& photons: *(evt_simphot_h)) {
 
-      int opch = photons.OpChannel;
-
+      size_t opch = photons.OpChannel;
+      if (opch >= n_opch) continue;
 
-      for(auto const& pair: photons.DetectedPhotons) {
-
-        float photon_time = pair.first - start_window;
-
-        float photon_time_elec = clock_data.G4ToElecTime(photon_time) - trig_time;
-
-        if (_debug && !reflected) {
-          std::cout << "Photon time: " << photon_time_elec
-                    << " - Neutrino time: " << nuTime_elec << std::endl;
-        }
+      bool use_opch = false;
+      for (size_t t = 0; t < n_tpcs; t++) use_opch |= _channel_mask[t][opch];
+      if (!use_opch) continue;
 
+      for (size_t i_nu = 0; i_nu < nuTimes_elec.size(); i_nu++) {
 
-        if (photon_time_elec > nuTime_elec + _window_length) continue;
-        if (photon_time_elec > nuTime_elec - _pre_window){
+        // Only the photons in (nuTime - pre window, nuTime + window]
+        auto begin = first_later(photons.DetectedPhotons, nuTimes_elec[i_nu] - _pre_window);
+        auto end   = first_later(photons.DetectedPhotons, nuTimes_elec[i_nu] + _window_length);
 
-          auto iter = std::find(opch_to_use.begin(), opch_to_use.end(), opch);
-          if (iter == opch_to_use.end()) continue;
+        for(auto iter = begin; iter != end; ++iter) {
 
-          auto const& pt = geo->OpDetGeoFromOpChannel(opch).GetCenter();
+          if (_debug && !reflected) {
+            std::cout << "Photon time: " << photon_elec_time(iter->first)
+                      << " - Neutrino time: " << nuTimes_elec[i_nu] << std::endl;
+          }
 
-          if(pt.X() < 0 && _tpc == 1) continue;
-          if(pt.X() > 0 && _tpc == 0) continue;
-
-          pmt_v[0][opch] += pair.second;
+          for (size_t t = 0; t < n_tpcs; t++) {
+            if (!_channel_mask[t][opch]) continue;
+            pmt_v[i_nu*n_tpcs + t][opch] += iter->second;
+          }
           _pe_total++;
 
           // for (int i = 0; i < pair.second; i++) {
@@ -324,31 +390,36 @@ void SBNDMCFlash::produce(art::Event& e)
     }
   }
 
-  double Ycenter, Zcenter, Ywidth, Zwidth;
-  GetFlashLocation(pmt_v[0], Ycenter, Zcenter, Ywidth, Zwidth);
-
-  recob::OpFlash flash(nuTime_elec,                                // time w.r.t. trigger
-                       0,                                          // time width
-                       nuTime_elec,                                // flash time in elec clock
-                       0.,                                         // frame (?)
-                       pmt_v[0],                                   // pe per pmt
-                       0, 0, 1,                                    // this are just default values
-                       Ycenter, Ywidth, Zcenter, Zwidth);          // flash location
-
-  std::cout << "[NeutrinoMCFlash] MC Flash Time: "  << flash.Time() << std::endl;
-  std::cout << "[NeutrinoMCFlash] MC Flash PE:   "  << flash.TotalPE() << std::endl;
-  // for (size_t i = 0; i < pmt_v[0].size(); i++) {
-  //   std::cout << "ch " << i << " => " << pmt_v[0][i] << std::endl;
-  // }
+  for (size_t i_flash = 0; i_flash < pmt_v.size(); i_flash++) {
+
+    float nuTime_elec = nuTimes_elec[i_flash / n_tpcs];
+
+    double Ycenter, Zcenter, Ywidth, Zwidth;
+    GetFlashLocation(pmt_v[i_flash], Ycenter, Zcenter, Ywidth, Zwidth);
 
-  opflashes->emplace_back(std::move(flash));
+    recob::OpFlash flash(nuTime_elec,                                // time w.r.t. trigger
+                         0,                                          // time width
+                         nuTime_elec,                                // flash time in elec clock
+                         0.,                                         // frame (?)
+                         pmt_v[i_flash],                             // pe per pmt
+                         0, 0, 1,                                    // this are just default values
+                         Ycenter, Ywidth, Zcenter, Zwidth);          // flash location
+
+    std::cout << "[NeutrinoMCFlash] MC Flash Time: "  << flash.Time() << std::endl;
+    std::cout << "[NeutrinoMCFlash] MC Flash PE:   "  << flash.TotalPE() << std::endl;
+    // for (size_t i = 0; i < pmt_v[i_flash].size(); i++) {
+    //   std::cout << "ch " << i << " => " << pmt_v[i_flash][i] << std::endl;
+    // }
+
+    opflashes->emplace_back(std::move(flash));
+  }
 
   e.put(std::move(opflashes));
 
   _tree1->Fill();
 }
 
-void SBNDMCFlash::GetFlashLocation(std::vector<double> pePerOpChannel,
+void SBNDMCFlash::GetFlashLocation(const std::vector<double>& pePerOpChannel,
                                        double& Ycenter,
                                        double& Zcenter,
                                        double& Ywidth,
@@ -363,15 +434,15 @@ void SBNDMCFlash::GetFlashLocation(std::vector<double> pePerOpChannel,
 
   for (unsigned int opch = 0; opch < pePerOpChannel.size(); opch++) {
 
-    // Get physical detector location for this opChannel
-    ::art::ServiceHandle<geo::Geometry> geo;
-    auto const PMTxyz = geo->OpDetGeoFromOpChannel(opch).GetCenter();
+    // Physical detector location for this opChannel, cached at beginJob
+    double y = _opch_y[opch];
+    double z = _opch_z[opch];
 
     // Add up the position, weighting with PEs
-    sumy    += pePerOpChannel[opch]*PMTxyz.Y();
-    sumy2   += pePerOpChannel[opch]*PMTxyz.Y()*PMTxyz.Y();
-    sumz    += pePerOpChannel[opch]*PMTxyz.Z();
-    sumz2   += pePerOpChannel[opch]*PMTxyz.Z()*PMTxyz.Z();
+    sumy    += pePerOpChannel[opch]*y;
+    sumy2   += pePerOpChannel[opch]*y*y;
+    sumz    += pePerOpChannel[opch]*z;
+    sumz2   += pePerOpChannel[opch]*z*z;
 
     totalPE += pePerOpChannel[opch];
   }
@@ -105,50 +105,21 @@ namespace opdet {
     double start_time,
     unsigned n_samples)
   {
-    sim::SimPhotons auxphotons;
     bool is_daphne = true; // for now ~rodrigoa
-    int nCT = 1;
     std::vector<double> wave(n_samples, fParams.Baseline);
-        //direct light
-    if(auto it{ DirectPhotonsMap.find(ch) }; it != std::end(DirectPhotonsMap) )
-    {auxphotons = it->second;}
-    for(size_t j = 0; j < auxphotons.size(); j++) //auxphotons is direct light
-    {
-      if(fFlatGen.fire(1.0) < fXArapucaVUVEffVUV) {
-          double tphoton = (fTimeXArapucaVUV->fire()) + auxphotons[j].Time - start_time;
-          if(tphoton < 0.) continue; // discard if it didn't made it to the acquisition
-          if(fParams.CrossTalk > 0.0 && fFlatGen.fire(1.0) < fParams.CrossTalk) nCT = 2;
-          else nCT = 1;
-          size_t timeBin = (is_daphne) ? std::floor(tphoton * fSampling_Daphne) : std::floor(tphoton * fSampling);
-          double timeBin_HD = (is_daphne) ? ( tphoton * fSampling_Daphne) : (tphoton * fSampling);//get decimals info
-          size_t wvf_shift  = fPMTHDOpticalWaveformsPtr->TimeBinShift(timeBin_HD);
-          if(timeBin < wave.size()) {
-            if (!is_daphne) {AddSPE(timeBin, wave, fWaveformSP, nCT);
-            }
-            else{ AddSPE(timeBin, wave, (std::vector<double>) (fWaveformSP_Daphne_HD[wvf_shift]), nCT);}
-          }
-        }
+    //direct light
+    if(auto it{ DirectPhotonsMap.find(ch) }; it != std::end(DirectPhotonsMap) ){
+      SelectDetectedPhotons(it->second, fXArapucaVUVEffVUV, start_time);
+      AddPhotonDelays(*fTimeXArapucaVUV);
+      QueuePhotons(wave.size(), is_daphne);
     }
-        //Reflected light
-    if(auto it{ ReflectedPhotonsMap.find(ch) }; it != std::end(ReflectedPhotonsMap) )
-    {auxphotons = it->second;}
-    for(size_t j = 0; j < auxphotons.size(); j++) //auxphotons is direct light
-    {
-      if(fFlatGen.fire(1.0) < fXArapucaVUVEffVis){
-          double tphoton = auxphotons[j].Time + fTimeTPB->fire() - start_time;
-          if(tphoton < 0.) continue; // discard if it didn't made it to the acquisition
-          if(fParams.CrossTalk > 0.0 && fFlatGen.fire(1.0) < fParams.CrossTalk) nCT = 2;
-          else nCT = 1;
-          size_t timeBin = (is_daphne) ? std::floor(tphoton * fSampling_Daphne) : std::floor(tphoton * fSampling);
-          double timeBin_HD = (is_daphne) ? ( tphoton * fSampling_Daphne) : (tphoton * fSampling);//get decimals info
-          size_t wvf_shift  = fPMTHDOpticalWaveformsPtr->TimeBinShift(timeBin_HD);
-          if(timeBin < wave.size()) {
-            if (!is_daphne) {AddSPE(timeBin, wave, fWaveformSP, nCT);
-            }
-            else{ AddSPE(timeBin, wave, (std::vector<double>) (fWaveformSP_Daphne_HD[wvf_shift]), nCT);}
-          }
-        }
+    //Reflected light
+    if(auto it{ ReflectedPhotonsMap.find(ch) }; it != std::end(ReflectedPhotonsMap) ){
+      SelectDetectedPhotons(it->second, fXArapucaVUVEffVis, start_time);
+      AddPhotonDelays(*fTimeTPB);
+      QueuePhotons(wave.size(), is_daphne);
     }
+    AddQueuedSPEs(wave, is_daphne);
 
     if (!is_daphne) AddDarkNoise(wave,fWaveformSP);
     else            AddDarkNoise(wave,fWaveformSP_Daphne_HD[0]);
@@ -185,47 +156,20 @@ namespace opdet {
     std::string pdtype,
     bool is_daphne)
   {
-    int nCT = 1;
     if(pdtype == "xarapuca_vuv") {
-      for(size_t i = 0; i < simphotons.size(); i++) {
-        if(fFlatGen.fire(1.0) < fXArapucaVUVEffVUV) {
-          double tphoton = (fTimeXArapucaVUV->fire()) + simphotons[i].Time - t_min;
-          if(tphoton < 0.) continue; // discard if it didn't made it to the acquisition
-          if(fParams.CrossTalk > 0.0 && fFlatGen.fire(1.0) < fParams.CrossTalk) nCT = 2;
-          else nCT = 1;
-          size_t timeBin = (is_daphne) ? std::floor(tphoton * fSampling_Daphne) : std::floor(tphoton * fSampling);
-          double timeBin_HD = (is_daphne) ? ( tphoton * fSampling_Daphne) : (tphoton * fSampling);//get decimals info
-          size_t wvf_shift  = fPMTHDOpticalWaveformsPtr->TimeBinShift(timeBin_HD);
-          if(timeBin < wave.size()) {
-            if (!is_daphne) {AddSPE(timeBin, wave, fWaveformSP, nCT);
-            }
-            else{ AddSPE(timeBin, wave, (std::vector<double>) (fWaveformSP_Daphne_HD[wvf_shift]), nCT);}
-          }
-        }
-      }
+      SelectDetectedPhotons(simphotons, fXArapucaVUVEffVUV, t_min);
+      AddPhotonDelays(*fTimeXArapucaVUV);
     }
     else if(pdtype == "xarapuca_vis") {
-      for(size_t i = 0; i < simphotons.size(); i++) {
-        if(fFlatGen.fire(1.0) < fXArapucaVISEff) {
-          double tphoton = fExponentialGen.fire(fParams.DecayTXArapucaVIS) + simphotons[i].Time - t_min + fTimeTPB->fire();
-          if(tphoton < 0.) continue; // discard if it didn't made it to the acquisition
-          if(fParams.CrossTalk > 0.0 && fFlatGen.fire(1.0) < fParams.CrossTalk) nCT = 2;
-          else nCT = 1;
-          size_t timeBin = (is_daphne) ? std::floor(tphoton * fSampling_Daphne) : std::floor(tphoton * fSampling);
-          double timeBin_HD = (is_daphne) ? ( tphoton * fSampling_Daphne) : (tphoton * fSampling);//get decimals info
-          size_t wvf_shift  = fPMTHDOpticalWaveformsPtr->TimeBinShift(timeBin_HD);
-          if(timeBin < wave.size()) {
-            if (!is_daphne) {AddSPE(timeBin, wave, fWaveformSP, nCT);
-            }
-            else{ AddSPE(timeBin, wave, (std::vector<double>) (fWaveformSP_Daphne_HD[wvf_shift]), nCT);
-            }
-          }
-        }
-      }
+      SelectDetectedPhotons(simphotons, fXArapucaVISEff, t_min);
+      AddPhotonDelays(*fTimeTPB, fParams.DecayTXArapucaVIS);
     }
     else{
       throw cet::exception("DigiARAPUCASBNDAlg") << "Wrong pdtype: " << pdtype << std::endl;
     }
+    QueuePhotons(wave.size(), is_daphne);
+    AddQueuedSPEs(wave, is_daphne);
+
     if(fParams.BaselineRMS > 0.0) AddLineNoise(wave);
     if(fParams.DarkNoiseRate > 0.0)
     {
@@ -274,62 +218,22 @@ namespace opdet {
     )
   {
     std::vector<double> wave(n_samples, fParams.Baseline);
-    double meanPhotons;
-    size_t acceptedPhotons;
-    double tphoton;
     bool is_daphne = true; //quick fix
 
     // direct light
     if ( auto it{ DirectPhotonsMap.find(ch) }; it != std::end(DirectPhotonsMap) ){
-      for (auto& directPhotons : (it->second).DetectedPhotons) {
-        // (1-accepted_photons) doesn't introduce some bias
-        meanPhotons = directPhotons.second*fXArapucaVUVEffVUV;
-        acceptedPhotons = fPoissonQGen.fire(meanPhotons);
-        for(size_t i = 0; i < acceptedPhotons; i++) {
-          tphoton = fTimeXArapucaVUV->fire();
-          tphoton += directPhotons.first - start_time;
-          if(tphoton < 0.) continue; // discard if it didn't made it to the acquisition
-          int nCT=1;
-          if(fParams.CrossTalk > 0.0 &&
-              fFlatGen.fire(1.0) < fParams.CrossTalk) nCT = 2;
-            size_t timeBin = (is_daphne) ? std::floor(tphoton * fSampling_Daphne) : std::floor(tphoton * fSampling);
-            double timeBin_HD = (is_daphne) ? ( tphoton * fSampling_Daphne) : (tphoton * fSampling);//get decimals info
-            size_t wvf_shift  = fPMTHDOpticalWaveformsPtr->TimeBinShift(timeBin_HD);
-            if(timeBin < wave.size()) {
-              // P_truth=P_truth+nCT;
-              if (!is_daphne) {AddSPE(timeBin, wave, fWaveformSP, nCT);
-              }
-              else{ AddSPE(timeBin, wave, (std::vector<double>) (fWaveformSP_Daphne_HD[wvf_shift]), nCT);}
-            }
-          }
-        }
+      SelectDetectedPhotonsLite((it->second).DetectedPhotons, fXArapucaVUVEffVUV, start_time);
+      AddPhotonDelays(*fTimeXArapucaVUV);
+      QueuePhotons(wave.size(), is_daphne);
     }
 
     // reflected light
     if ( auto it{ ReflectedPhotonsMap.find(ch) }; it != std::end(ReflectedPhotonsMap) ){
-      for (auto& reflectedPhotons : (it->second).DetectedPhotons) {
-        meanPhotons = reflectedPhotons.second*fXArapucaVUVEffVis;
-        acceptedPhotons = fPoissonQGen.fire(meanPhotons);
-        for(size_t i = 0; i < acceptedPhotons; i++) {
-          tphoton = fExponentialGen.fire(fParams.DecayTXArapucaVIS);
-          tphoton += reflectedPhotons.first - start_time + fTimeTPB->fire();
-          if(tphoton < 0.) continue; // discard if it didn't made it to the acquisition
-          int nCT=1;
-          if(fParams.CrossTalk > 0.0 &&
-              fFlatGen.fire(1.0) < fParams.CrossTalk) nCT = 2;
-            size_t timeBin = (is_daphne) ? std::floor(tphoton * fSampling_Daphne) : std::floor(tphoton * fSampling);
-            double timeBin_HD = (is_daphne) ? ( tphoton * fSampling_Daphne) : (tphoton * fSampling);//get decimals info
-            size_t wvf_shift  = fPMTHDOpticalWaveformsPtr->TimeBinShift(timeBin_HD);
-            if(timeBin < wave.size()) {
-              // P_truth=P_truth+nCT;
-              if (!is_daphne) {AddSPE(timeBin, wave, fWaveformSP, nCT);
-              }
-              else{ AddSPE(timeBin, wave, (std::vector<double>) (fWaveformSP_Daphne_HD[wvf_shift]), nCT);}
-            }
-          }
-      }
+      SelectDetectedPhotonsLite((it->second).DetectedPhotons, fXArapucaVUVEffVis, start_time);
+      AddPhotonDelays(*fTimeTPB, fParams.DecayTXArapucaVIS);
+      QueuePhotons(wave.size(), is_daphne);
     }
-    
+    AddQueuedSPEs(wave, is_daphne);
 
     if(fParams.BaselineRMS > 0.0) AddLineNoise(wave);
     if(fParams.DarkNoiseRate > 0.0) AddDarkNoise(wave,fWaveformSP_Daphne_HD[0]);
@@ -347,34 +251,10 @@ namespace opdet {
     bool is_daphne
     )
   {
-    // TODO: check that this new approach of not using the last
-    // (1-accepted_photons) doesn't introduce some bias
-    double meanPhotons;
-    size_t acceptedPhotons;
-    double tphoton;
-    for (auto const& photonMember : photonMap) {
-      // TODO: check that this new approach of not using the last
-      // (1-accepted_photons) doesn't introduce some bias
-      meanPhotons = photonMember.second*effT;
-      acceptedPhotons = fPoissonQGen.fire(meanPhotons);
-      for(size_t i = 0; i < acceptedPhotons; i++) {
-        tphoton = timeHisto->fire();
-        tphoton += photonMember.first - t_min;
-        if(tphoton < 0.) continue; // discard if it didn't made it to the acquisition
-        int nCT=1;
-        if(fParams.CrossTalk > 0.0 &&
-           fFlatGen.fire(1.0) < fParams.CrossTalk) nCT = 2;
-          size_t timeBin = (is_daphne) ? std::floor(tphoton * fSampling_Daphne) : std::floor(tphoton * fSampling);
-          double timeBin_HD = (is_daphne) ? ( tphoton * fSampling_Daphne) : (tphoton * fSampling);//get decimals info
-          size_t wvf_shift  = fPMTHDOpticalWaveformsPtr->TimeBinShift(timeBin_HD);
-          if(timeBin < wave.size()) {
-            // P_truth=P_truth+nCT;
-            if (!is_daphne) {AddSPE(timeBin, wave, fWaveformSP, nCT);
-            }
-            else{ AddSPE(timeBin, wave, (std::vector<double>) (fWaveformSP_Daphne_HD[wvf_shift]), nCT);}
-          }
-      }
-    }
+    SelectDetectedPhotonsLite(photonMap, effT, t_min);
+    AddPhotonDelays(*timeHisto);
+    QueuePhotons(wave.size(), is_daphne);
+    AddQueuedSPEs(wave, is_daphne);
   }
 
 
@@ -386,32 +266,118 @@ namespace opdet {
     bool is_daphne
     )
   {
-    double meanPhotons;
-    size_t acceptedPhotons;
-    double tphoton;
-    int nCT;
+    SelectDetectedPhotonsLite(photonMap, effT, t_min);
+    AddPhotonDelays(*fTimeTPB, fParams.DecayTXArapucaVIS);
+    QueuePhotons(wave.size(), is_daphne);
+    AddQueuedSPEs(wave, is_daphne);
+  }
+
+
+  // Keep the arrival times of the photons passing the efficiency cut.
+  // Rather than one flat draw per photon, the number of rejected photons
+  // before the next accepted one is drawn from a geometric distribution,
+  // which is the same Bernoulli(eff) thinning with ~eff*N draws
+  void DigiArapucaSBNDAlg::SelectDetectedPhotons(
+    sim::SimPhotons const& simphotons,
+    double eff,
+    double t_min)
+  {
+    fPhotonTimes.clear();
+    const size_t nphotons = simphotons.size();
+    if(nphotons == 0 || eff <= 0.) return;
+    if(eff >= 1.){
+      fPhotonTimes.reserve(nphotons);
+      for(size_t i = 0; i < nphotons; i++) fPhotonTimes.push_back(simphotons[i].Time - t_min);
+      return;
+    }
+    const double logReject = std::log1p(-eff);
+    size_t i = 0;
+    while(i < nphotons){
+      double skip = std::floor(std::log(fFlatGen.fire()) / logReject);
+      if(!(skip < static_cast<double>(nphotons - i))) break;
+      i += static_cast<size_t>(skip);
+      fPhotonTimes.push_back(simphotons[i].Time - t_min);
+      i++;
+    }
+  }
+
+
+  // Keep the arrival times of the photons passing the efficiency cut,
+  // the detected count is drawn once per time entry
+  void DigiArapucaSBNDAlg::SelectDetectedPhotonsLite(
+    std::map<int, int> const& photonMap,
+    double eff,
+    double t_min)
+  {
+    fPhotonTimes.clear();
     for (auto const& photonMember : photonMap) {
       // TODO: check that this new approach of not using the last
       // (1-accepted_photons) doesn't introduce some bias
-      meanPhotons = photonMember.second*effT;
-      acceptedPhotons = fPoissonQGen.fire(meanPhotons);
-      for(size_t i = 0; i < acceptedPhotons; i++) {
-        tphoton = fExponentialGen.fire(fParams.DecayTXArapucaVIS);
-        tphoton += photonMember.first - t_min + fTimeTPB->fire();
-        if(tphoton < 0.) continue; // discard if it didn't made it to the acquisition
-        if(fParams.CrossTalk > 0.0 && fFlatGen.fire(1.0) < fParams.CrossTalk) nCT = 2;
-        else nCT = 1;
-          size_t timeBin = (is_daphne) ? std::floor(tphoton * fSampling_Daphne) : std::floor(tphoton * fSampling);
-          double timeBin_HD = (is_daphne) ? ( tphoton * fSampling_Daphne) : (tphoton * fSampling);//get decimals info
-          size_t wvf_shift  = fPMTHDOpticalWaveformsPtr->TimeBinShift(timeBin_HD);
-          if(timeBin < wave.size()) {
-            // P_truth=P_truth+nCT;
-            if (!is_daphne) {AddSPE(timeBin, wave, fWaveformSP, nCT);
-            }
-            else{ AddSPE(timeBin, wave, (std::vector<double>) (fWaveformSP_Daphne_HD[wvf_shift]), nCT);}
-          }
-      }
+      double meanPhotons = photonMember.second*eff;
+      size_t acceptedPhotons = fPoissonQGen.fire(meanPhotons);
+      fPhotonTimes.insert(fPhotonTimes.end(), acceptedPhotons, photonMember.first - t_min);
+    }
+  }
+
+
+  // Add the transport/emission delays to all the selected photons at once,
+  // plus an exponential scintillator decay if decayTime is positive
+  void DigiArapucaSBNDAlg::AddPhotonDelays(CLHEP::RandGeneral& timeHisto, double decayTime)
+  {
+    const size_t n = fPhotonTimes.size();
+    if(n == 0) return;
+    fRandomBuffer.resize(n);
+    timeHisto.fireArray(n, fRandomBuffer.data());
+    for(size_t i = 0; i < n; i++) fPhotonTimes[i] += fRandomBuffer[i];
+    if(decayTime > 0.){
+      fExponentialGen.fireArray(n, fRandomBuffer.data(), decayTime);
+      for(size_t i = 0; i < n; i++) fPhotonTimes[i] += fRandomBuffer[i];
+    }
+  }
+
+
+  // Turn the selected photons into (time bin, HD shift, PE) deposits
+  void DigiArapucaSBNDAlg::QueuePhotons(size_t n_samples, bool is_daphne)
+  {
+    const size_t n = fPhotonTimes.size();
+    const bool crossTalk = fParams.CrossTalk > 0.0;
+    if(crossTalk && n > 0){
+      fRandomBuffer.resize(n);
+      fFlatGen.fireArray(n, fRandomBuffer.data());
+    }
+    const double sampling = (is_daphne) ? fSampling_Daphne : fSampling;
+    for(size_t i = 0; i < n; i++){
+      double tphoton = fPhotonTimes[i];
+      if(tphoton < 0.) continue; // discard if it didn't made it to the acquisition
+      double timeBin_HD = tphoton * sampling;//get decimals info
+      size_t timeBin = std::floor(timeBin_HD);
+      if(timeBin >= n_samples) continue;
+      int nCT = (crossTalk && fRandomBuffer[i] < fParams.CrossTalk) ? 2 : 1;
+      size_t wvf_shift = (is_daphne) ? fPMTHDOpticalWaveformsPtr->TimeBinShift(timeBin_HD) : 0;
+      fSPEDeposits.push_back({timeBin, wvf_shift, nCT});
+    }
+    fPhotonTimes.clear();
+  }
+
+
+  // Add the queued deposits to the waveform, one pulse per (time bin, HD shift).
+  // Amplitude fluctuations are gaussian with variance proportional to the
+  // number of PE, so merging deposits does not change their distribution
+  void DigiArapucaSBNDAlg::AddQueuedSPEs(std::vector<double>& wave, bool is_daphne)
+  {
+    std::sort(fSPEDeposits.begin(), fSPEDeposits.end(),
+              [](SPEDeposit const& a, SPEDeposit const& b){
+                return a.timeBin < b.timeBin || (a.timeBin == b.timeBin && a.wvfShift < b.wvfShift); });
+    size_t i = 0;
+    while(i < fSPEDeposits.size()){
+      SPEDeposit const& dep = fSPEDeposits[i];
+      int nPE = 0;
+      for(; i < fSPEDeposits.size() && fSPEDeposits[i].timeBin == dep.timeBin
+            && fSPEDeposits[i].wvfShift == dep.wvfShift; i++) nPE += fSPEDeposits[i].nPE;
+      if (!is_daphne) AddSPE(dep.timeBin, wave, fWaveformSP, nPE);
+      else            AddSPE(dep.timeBin, wave, fWaveformSP_Daphne_HD[dep.wvfShift], nPE);
     }
+    fSPEDeposits.clear();
   }
 
   //Ideal single pulse waveform, same shape for both electronics (not realistic: different capacitances, ...) 
@@ -457,22 +423,10 @@ namespace opdet {
 
   void DigiArapucaSBNDAlg::AddLineNoise(std::vector< double >& wave)
   {
-    // TODO: after running the profiler I can see that this is where
-    // most cycles are being used.  Potentially some improvement could
-    // be achieved with the below code but the array dynamic allocation
-    // is not helping. The function would need to have it passed.
-    // ~icaza
-    //
-    // double *array = new double[wave.size()]();
-    // CLHEP::RandGaussQ::shootArray(fEngine, wave.size(), array, 0, fParams.BaselineRMS);
-    // for(size_t i = 0; i<wave.size(); i++) {
-    //   wave[i] += array[i];
-    // }
-    // delete array;
-    //
-    std::transform(wave.begin(), wave.end(), wave.begin(),
-                   [this](double w) -> double {
-                     return w + fGaussQGen.fire(0., fParams.BaselineRMS) ; });
+    // Draw all the pedestal fluctuations at once into a reused buffer
+    fRandomBuffer.resize(wave.size());
+    fGaussQGen.fireArray(wave.size(), fRandomBuffer.data(), 0., fParams.BaselineRMS);
+    for(size_t i = 0; i < wave.size(); i++) wave[i] += fRandomBuffer[i];
   }
 
 
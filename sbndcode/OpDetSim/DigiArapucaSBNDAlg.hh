@@ -145,6 +145,18 @@ namespace opdet {
     //HDWaveforms
     std::unique_ptr<opdet::HDOpticalWaveform> fPMTHDOpticalWaveformsPtr;
 
+    // Single photon pulses waiting to be added to the waveform
+    struct SPEDeposit {
+      size_t timeBin;
+      size_t wvfShift; // HD pulse index, daphne only
+      int nPE;
+    };
+
+    // Work buffers, reused between channels
+    std::vector<double> fPhotonTimes;  // detected photon times relative to the waveform start
+    std::vector<double> fRandomBuffer; // batched random draws
+    std::vector<SPEDeposit> fSPEDeposits;
+
 
     void CreatePDWaveform(sim::SimPhotons const& SimPhotons,
                           double t_min,
@@ -167,6 +179,15 @@ namespace opdet {
                                      std::map<int, int> const& photonMap,
                                      double const& t_min,
                                      bool is_daphne);
+    void SelectDetectedPhotons(sim::SimPhotons const& simphotons,
+                               double eff,
+                               double t_min);
+    void SelectDetectedPhotonsLite(std::map<int, int> const& photonMap,
+                                   double eff,
+                                   double t_min);
+    void AddPhotonDelays(CLHEP::RandGeneral& timeHisto, double decayTime = 0.);
+    void QueuePhotons(size_t n_samples, bool is_daphne);
+    void AddQueuedSPEs(std::vector<double>& wave, bool is_daphne);
     void AddSPE(size_t time_bin, std::vector<double>& wave, const std::vector<double>& fWaveformSP, int nphotons); // add single pulse to auxiliary waveform
     void Pulse1PE(std::vector<double>& wave,const double sampling);
     // void produceSER_HD(std::vector<double> *SER_HD, std::vector<double>& SER);
@@ -1,6 +1,9 @@
 #include "sbndcode/OpDetSim/opDetSBNDTriggerAlg.hh"
 #include "lardataalg/DetectorInfo/DetectorClocksData.h"
 
+#include <algorithm>
+#include <queue>
+
 namespace {
   double optical_period(detinfo::DetectorClocksData const& clockData,bool is_daphne)
   {
@@ -26,31 +29,19 @@ struct TriggerPrimitive {
 };
 
 // Local static functions
-// Adds a value to a vector of trigger locations, while keeping the vector sorted
-void AddTriggerLocation(std::vector<std::array<raw::TimeStamp_t, 2>> &triggers, std::array<raw::TimeStamp_t,2> range) {
-  typedef std::vector<std::array<raw::TimeStamp_t,2>> TimeStamps;
-
-  TimeStamps::iterator insert = std::lower_bound(triggers.begin(), triggers.end(), range,
+// Sorts trigger locations by start time. Locations with equal start times
+// end up in reverse order of addition, as when each one was inserted at
+// its lower bound in an already sorted vector
+void SortTriggerLocations(std::vector<std::array<raw::TimeStamp_t, 2>> &triggers) {
+  std::reverse(triggers.begin(), triggers.end());
+  std::stable_sort(triggers.begin(), triggers.end(),
     [](const auto &lhs, const auto &rhs) { return lhs[0] < rhs[0]; });
-  triggers.insert(insert, range);
 }
 
-void AddTriggerPrimitive(std::vector<TriggerPrimitive> &triggers, TriggerPrimitive trigger) {
-  typedef std::vector<TriggerPrimitive> TimeStamps;
-
-  TimeStamps::iterator insert = std::lower_bound(triggers.begin(), triggers.end(), trigger,
+void SortTriggerPrimitives(std::vector<TriggerPrimitive> &triggers) {
+  std::reverse(triggers.begin(), triggers.end());
+  std::stable_sort(triggers.begin(), triggers.end(),
     [](auto const &lhs, auto const &rhs) { return lhs.start < rhs.start; });
-
-  triggers.insert(insert, trigger);
-}
-
-void AddTriggerPrimitiveFinish(std::vector<TriggerPrimitive> &triggers, TriggerPrimitive trigger) {
-  typedef std::vector<TriggerPrimitive> TimeStamps;
-  
-  TimeStamps::iterator insert = std::upper_bound(triggers.begin(), triggers.end(), trigger,
-    [](auto const &lhs, auto const &rhs) { return lhs.finish < rhs.finish; });
-
-  triggers.insert(insert, trigger);
 }
 
 opDetSBNDTriggerAlg::opDetSBNDTriggerAlg(const Config &config):
@@ -63,7 +54,6 @@ opDetSBNDTriggerAlg::opDetSBNDTriggerAlg(const Config &config):
 void opDetSBNDTriggerAlg::FindTriggerLocations(detinfo::DetectorClocksData const& clockData,
                                                detinfo::DetectorPropertiesData const& detProp,
                                                const raw::OpDetWaveform &waveform, raw::ADC_Count_t baseline) {
-  std::vector<std::array<raw::TimeStamp_t, 2>> this_trigger_ranges;
   const std::vector<raw::ADC_Count_t> &adcs = waveform; // upcast to get adcs
   raw::Channel_t channel = waveform.ChannelNumber();
   // if (channel > (unsigned)fOpDetMap.size()) return;
@@ -74,12 +64,8 @@ void opDetSBNDTriggerAlg::FindTriggerLocations(detinfo::DetectorClocksData const
   }
   
   // get the threshold -- first check if channel is Arapuca or PMT
-  std::string opdet_type = fOpDetMap.pdType(channel);
-  bool is_arapuca = false;
-  if( opdet_type.find("arapuca") != std::string::npos ) is_arapuca = true; 
-  bool is_daphne = false;
-  std::string sampling_type = fOpDetMap.electronicsType(channel);
-  if (sampling_type == "daphne") is_daphne = true;
+  bool is_arapuca = fOpDetMap.isArapuca(channel);
+  bool is_daphne = (fOpDetMap.electronicsEnum(channel) == kDaphne);
 
   int threshold = is_arapuca ? fConfig.TriggerThresholdADCArapuca() : fConfig.TriggerThresholdADCPMT(); 
   int polarity = is_arapuca ? fConfig.PulsePolarityArapuca() : fConfig.PulsePolarityPMT(); 
@@ -139,14 +125,14 @@ void opDetSBNDTriggerAlg::FindTriggerLocations(detinfo::DetectorClocksData const
     }
     else if (above_threshold && (val < threshold || i+1 == end_i)) {
       raw::TimeStamp_t trigger_finish = time;
-      AddTriggerLocation(this_trigger_locations, {{trigger_start, trigger_finish}});
+      this_trigger_locations.push_back({{trigger_start, trigger_finish}});
       above_threshold = false;
     }
     // add beam trigger (if enabled)
     // since the clock ticks might not sync up exactly, use the closet sample
     if( isLive && fConfig.BeamTriggerEnable() && !beam_trigger_added &&
       fabs(time-fConfig.BeamTriggerTime()) <= optical_period(clockData,is_daphne)/2. ){
-      AddTriggerLocation(this_trigger_locations, {{time,time}});
+      this_trigger_locations.push_back({{time,time}});
       beam_trigger_added = true;
       t_since_last_trigger = 0;
       t_deadtime = fConfig.BeamTriggerHoldoff();
@@ -157,14 +143,15 @@ void opDetSBNDTriggerAlg::FindTriggerLocations(detinfo::DetectorClocksData const
   //
   // Small speed optimization: if this is the first time we are setting the 
   // trigger times for the channel, just move the vector we already built
-  if (fTriggerRangesPerChannel[channel].size() == 0) {
-    fTriggerRangesPerChannel[channel] = std::move(this_trigger_locations);
+  std::vector<std::array<raw::TimeStamp_t, 2>> &channel_trigger_ranges = fTriggerRangesPerChannel[channel];
+  if (channel_trigger_ranges.size() == 0) {
+    SortTriggerLocations(this_trigger_locations);
+    channel_trigger_ranges = std::move(this_trigger_locations);
   }
   // Otherwise, merge them in and keep things sorted in time
   else {
-    for (const std::array<raw::TimeStamp_t, 2> &trigger_range: this_trigger_ranges) {
-      AddTriggerLocation(fTriggerRangesPerChannel[channel], trigger_range);
-    }
+    channel_trigger_ranges.insert(channel_trigger_ranges.end(), this_trigger_locations.begin(), this_trigger_locations.end());
+    SortTriggerLocations(channel_trigger_ranges);
   }
 
 }
@@ -175,18 +162,12 @@ bool opDetSBNDTriggerAlg::IsChannelMasked(raw::Channel_t channel) const {
   if (in_masked_list) return true;
 
   // mask by optical detector type
-  std::string opdet_type = fOpDetMap.pdType(channel);
-  if (opdet_type == "bar" && fConfig.MaskLightBars() /* RIP */) return true;
-  if (opdet_type == "pmt_coated" && fConfig.MaskPMTs()) return true;
-  if (opdet_type == "pmt_uncoated" && fConfig.MaskBarePMTs()) return true;
-  if (opdet_type == "xarapucaprime" && fConfig.MaskXArapucaPrimes()) return true;
-  if (opdet_type == "xarapuca" && fConfig.MaskXArapucas()) return true;
-  if (opdet_type == "xarapuca_vuv" && fConfig.MaskXArapucas()) return true;
-  if (opdet_type == "xarapuca_vis" && fConfig.MaskXArapucas()) return true;
-  if (opdet_type == "xarapucaT1" && fConfig.MaskXArapucas()) return true;
-  if (opdet_type == "xarapucaT2" && fConfig.MaskXArapucas()) return true;
-  if (opdet_type == "arapucaT1" && fConfig.MaskArapucaT1s()) return true;
-  if (opdet_type == "arapucaT2" && fConfig.MaskArapucaT2s()) return true;
+  // (light bars, xarapuca primes and arapuca T1/T2s are no longer in the map)
+  PDType opdet_type = fOpDetMap.pdTypeEnum(channel);
+  if (opdet_type == kPMTCoated && fConfig.MaskPMTs()) return true;
+  if (opdet_type == kPMTUncoated && fConfig.MaskBarePMTs()) return true;
+  if (opdet_type == kXArapucaVUV && fConfig.MaskXArapucas()) return true;
+  if (opdet_type == kXArapucaVis && fConfig.MaskXArapucas()) return true;
   return false;
 }
 
@@ -229,10 +210,11 @@ void opDetSBNDTriggerAlg::MergeTriggerLocations() {
         trigger.start = trigger_range[0];
         trigger.finish = trigger_range[1];
         trigger.channel = this_channel;
-        AddTriggerPrimitive(all_trigger_locations, trigger);
+        all_trigger_locations.push_back(trigger);
       }
     }
   }
+  SortTriggerPrimitives(all_trigger_locations);
 
   // Now merge the trigger locations we have 
   //
@@ -247,12 +229,13 @@ void opDetSBNDTriggerAlg::MergeTriggerLocations() {
   // synched.
   bool was_triggering = false;
 
-  std::vector<TriggerPrimitive> primitives;
+  // finish times of the active primitives, latest on top
+  std::priority_queue<raw::TimeStamp_t> primitives;
   for (const TriggerPrimitive &primitive: all_trigger_locations) {
-    AddTriggerPrimitiveFinish(primitives, primitive);
-    while (primitives.back().finish < primitive.start) {
+    primitives.push(primitive.finish);
+    while (!primitives.empty() && primitives.top() < primitive.start) {
       // remove the final element
-      primitives.resize(primitives.size() - 1);
+      primitives.pop();
     }
 
     bool is_triggering = primitives.size() >= fConfig.TriggerChannelCount();
@@ -339,9 +322,8 @@ std::vector<raw::OpDetWaveform> opDetSBNDTriggerAlg::ApplyTriggerLocations(detin
   raw::Channel_t channel = waveform.ChannelNumber();
   const std::vector<raw::TimeStamp_t> &trigger_times = GetTriggerTimes(channel);
   if( trigger_times.size() == 0 ) return ret;
-  bool is_daphne = false;
-  std::string sampling_type = fOpDetMap.electronicsType(channel);
-  if (sampling_type == "daphne") is_daphne = true;
+  bool is_daphne = (fOpDetMap.electronicsEnum(channel) == kDaphne);
+  const double period = optical_period(clockData,is_daphne);
 
 
 //  std::cout
@@ -351,89 +333,112 @@ std::vector<raw::OpDetWaveform> opDetSBNDTriggerAlg::ApplyTriggerLocations(detin
 
   // Extract waveform of raw ADC counts 
   const std::vector<raw::ADC_Count_t> &adcs = waveform; // upcast to get adcs
-  raw::OpDetWaveform this_waveform;
 
   // Set the pre- and post-readout sizes
   double    preTrig	= ReadoutWindowPreTrigger(channel);
   double    postTrig	= ReadoutWindowPostTrigger(channel);
-  unsigned  ro_samples  = (preTrig+postTrig)/optical_period(clockData,is_daphne);	// samples
+  unsigned  ro_samples  = (preTrig+postTrig)/period;	// samples
 
   // Are beam triggers enabled?
   double    beamTrigTime= fConfig.BeamTriggerTime();		// should be 0
   double    preTrigBeam	= ReadoutWindowPreTriggerBeam(channel);
   double    postTrigBeam	= ReadoutWindowPostTriggerBeam(channel);
-  unsigned  ro_samples_beam= (preTrigBeam+postTrigBeam)/optical_period(clockData,is_daphne); // samples
+  unsigned  ro_samples_beam= (preTrigBeam+postTrigBeam)/period; // samples
+
+  auto isBeam = [&](double trig) { return fabs(trig-beamTrigTime) < period/2; };
 
   // --------------------------------------------
   // Scan the waveform
-  unsigned  trigger_i	= 0;
+  //
+  // Only the sample range of each readout is tracked, the ADCs are copied
+  // once into the OpDetWaveform when the readout is closed. Stretches with
+  // no readout before the next trigger window are skipped over.
+  size_t    trigger_i	= 0;
   double    next_trig	= trigger_times[trigger_i];
   bool      isReadingOut	= false;
   bool      isBeamTrigger = false;
+  bool      noNextTrigger = false; // no later trigger can be reached any more
   unsigned  min_ro_samples = ro_samples;
+  size_t    ro_start    = 0;
+  double    ro_time     = 0;
 
   for(size_t i=0; i<adcs.size(); i++){
     double time = tick_to_timestamp(clockData, waveform.TimeStamp(), i,is_daphne);
 
-    // if we're out of triggers or nearing the end of the waveform, break
-    if( trigger_i >= trigger_times.size() ) break;
+    // if we're nearing the end of the waveform, break
     if( i >= adcs.size()-1-min_ro_samples ) break;
 
     // check if the current trigger is from the beam
-    isBeamTrigger = ( fabs(next_trig-beamTrigTime)<optical_period(clockData,is_daphne)/2 );
+    isBeamTrigger = isBeam(next_trig);
 
     // scan ahead to the "next" trigger if we've reached the end of the previous one
     double dT = time-next_trig;
     if( trigger_i < trigger_times.size()-1 &&
         ((isBeamTrigger && dT >= postTrigBeam)||(!isBeamTrigger && dT >= postTrig))) {
-      for(size_t j=trigger_i+1; j<trigger_times.size(); j++){
-        double this_trig = trigger_times[j];
-        isBeamTrigger = ( fabs(this_trig-beamTrigTime)<optical_period(clockData,is_daphne)/2 );
-        double t1 = this_trig-preTrig;
-        double t2 = this_trig+postTrig;
-        if(isBeamTrigger){
-          t1 = this_trig-preTrigBeam;
-          t2 = this_trig+postTrigBeam;
-        }
-        if(  ( fConfig.AllowTriggerOverlap() && (t2 >= time) )
-           ||(!fConfig.AllowTriggerOverlap() && (t1 >= time) ) ){
-	        next_trig = this_trig;
-	        trigger_i = j;
-	        break;
+      // the windows only fall further behind, so a failed scan fails from then on
+      // (and leaves the type of the last trigger behind, as the full scan did)
+      if( noNextTrigger ) {
+        isBeamTrigger = isBeam(trigger_times.back());
+      }
+      else {
+        size_t j = trigger_i+1;
+        for(; j<trigger_times.size(); j++){
+          double this_trig = trigger_times[j];
+          isBeamTrigger = isBeam(this_trig);
+          double t1 = this_trig-preTrig;
+          double t2 = this_trig+postTrig;
+          if(isBeamTrigger){
+            t1 = this_trig-preTrigBeam;
+            t2 = this_trig+postTrigBeam;
+          }
+          if(  ( fConfig.AllowTriggerOverlap() && (t2 >= time) )
+             ||(!fConfig.AllowTriggerOverlap() && (t1 >= time) ) ){
+            next_trig = this_trig;
+            trigger_i = j;
+            break;
+          }
         }
+        if( j == trigger_times.size() ) noNextTrigger = true;
       }
     }
 
     // if we're within the trigger window, we're triggering
-    bool  isTriggering	= false;
-    if(    (!isBeamTrigger && time >= (next_trig-preTrig) &&  time < (next_trig+postTrig))
-        || ( isBeamTrigger && time >= (next_trig-preTrigBeam) && time < (next_trig+postTrigBeam))
-      )
-      isTriggering = true;
-
-    // if already reading out, keep going!
-    if( isReadingOut && this_waveform.size() < min_ro_samples ){
-      this_waveform.push_back(adcs[i]);
-    }
+    double pre  = isBeamTrigger ? preTrigBeam : preTrig;
+    double post = isBeamTrigger ? postTrigBeam : postTrig;
+    bool  isTriggering	= time >= (next_trig-pre) && time < (next_trig+post);
+
     // once we've saved at least 1 full window, only continue adding
     // to it if we are allowing trigger overlaps. Otherwise, package up 
     // the waveform into an OpDetWaveform object and reset the readout 
-    else if( isReadingOut && this_waveform.size() >= min_ro_samples ){
-      if( fConfig.AllowTriggerOverlap() && isTriggering ) {
-        this_waveform.push_back(adcs[i]);
-      } else {
-        ret.push_back(std::move(this_waveform));
-        isReadingOut = false;
-      }
+    if( isReadingOut && i-ro_start >= min_ro_samples &&
+        !(fConfig.AllowTriggerOverlap() && isTriggering) ){
+      raw::OpDetWaveform this_waveform(ro_time, channel);
+      this_waveform.assign(adcs.begin()+ro_start, adcs.begin()+i);
+      ret.push_back(std::move(this_waveform));
+      isReadingOut = false;
     }
 
     // start new readout
     if( !isReadingOut && isTriggering ) {
-      this_waveform = raw::OpDetWaveform(time, channel); 
-      this_waveform.push_back(adcs[i]);
+      ro_start = i;
+      ro_time = time;
       isReadingOut = true;
-      min_ro_samples = ro_samples;
-      if( isBeamTrigger ) min_ro_samples = ro_samples_beam;
+      min_ro_samples = isBeamTrigger ? ro_samples_beam : ro_samples;
+    }
+
+    // nothing happens until the window of the next trigger opens
+    if( !isReadingOut && !isTriggering ) {
+      pre  = isBeam(next_trig) ? preTrigBeam : preTrig;
+      post = isBeam(next_trig) ? postTrigBeam : postTrig;
+      if( time >= next_trig+post ) {
+        if( trigger_i == trigger_times.size()-1 ) break;
+      }
+      else if( time < next_trig-pre && -pre <= post ) {
+        size_t k = std::min(adcs.size(), (size_t)std::max(0.0, (next_trig-pre-waveform.TimeStamp())/period));
+        while( k > i+1 && tick_to_timestamp(clockData, waveform.TimeStamp(), k-1,is_daphne) >= next_trig-pre ) k--;
+        while( k < adcs.size() && tick_to_timestamp(clockData, waveform.TimeStamp(), k,is_daphne) < next_trig-pre ) k++;
+        if( k > i+1 ) i = k-1;
+      }
     }
 
   }//endloop over ADCs
@@ -85,16 +85,33 @@ namespace opdet {
     int fThresholdArapuca; //in ADC
     int fEvNumber;
     int fChNumber;
-    std::string opdetType;
-    std::string electronicsType;
     int threshold;
     //int fSize;
     //int fTimePMT;         //Start time of PMT signal
     //int fTimeMax;         //Time of maximum (minimum) PMT signal
-    void subtractBaseline(std::vector<double>& waveform, std::string pdtype, std::string electronicsType, double& rms);
-    bool findAndSuppressPeak(std::vector<double>& waveform, size_t& timebin,
-                             double& Area, double& amplitude,
-                             const int& threshold, const std::string& opdetType, const std::string& electronicsType);
+
+    // Photon detector and readout kinds, resolved once per channel
+    // instead of comparing the map strings for every waveform
+    enum PDKind { kPDKindUnknown, kPDPMT, kPDArapuca };
+    struct ChannelKind {
+      PDKind pd = kPDKindUnknown;
+      bool daphne = false;
+    };
+    std::vector<ChannelKind> fChannelKinds;
+    ChannelKind channelKind(int ch);
+
+    // An above threshold region of the waveform
+    struct Peak {
+      size_t timebin;
+      double amplitude;
+      double area;
+    };
+    std::vector<Peak> fPeaks;
+
+    void subtractBaseline(const raw::OpDetWaveform& wvf, std::vector<double>& waveform,
+                          const ChannelKind& kind, double& rms);
+    void findPeaks(const std::vector<double>& waveform, std::vector<Peak>& peaks,
+                   const int& threshold, const bool daphne);
     void denoise(std::vector<double>& waveform, std::vector<double>& outwaveform);
     bool TV1D_denoise(std::vector<double>& waveform,
                       std::vector<double>& outwaveform,
@@ -123,10 +140,23 @@ namespace opdet {
     fSampling = clockData.OpticalClock().Frequency(); // MHz
     fSampling_Daphne = p.get<double>("DaphneFrequency"); 
 
+    fChannelKinds.resize(map.size());
+    for(size_t ch = 0; ch < fChannelKinds.size(); ch++) {
+      if(map.isPMT(ch)) fChannelKinds[ch].pd = kPDPMT;
+      else if(map.isArapuca(ch)) fChannelKinds[ch].pd = kPDArapuca;
+      fChannelKinds[ch].daphne = (map.electronicsEnum(ch) == kDaphne);
+    }
+
     // Call appropriate produces<>() functions here.
     produces<std::vector<recob::OpHit>>();
   }
 
+  opHitFinderSBND::ChannelKind opHitFinderSBND::channelKind(int ch)
+  {
+    if(ch >= 0 && (size_t)ch < fChannelKinds.size()) return fChannelKinds[ch];
+    return ChannelKind();
+  }
+
   void opHitFinderSBND::produce(art::Event & e)
   {
     // Implementation of required member function here.
@@ -148,7 +178,6 @@ namespace opdet {
       return;
     }
 
-    size_t timebin = 0;
     double FWHM = 1, Area = 0, phelec, fasttotal = 3./4., rms = 0, amplitude = 0, time = 0;
     unsigned short frame = 1;
     //int histogram_number = 0;
@@ -159,80 +188,65 @@ namespace opdet {
       }
 
       fChNumber = wvf.ChannelNumber();
-      opdetType = map.pdType(fChNumber);
-      electronicsType = map.electronicsType(fChNumber);
-      if(opdetType == "pmt_coated" || opdetType == "pmt_uncoated") {
+      const ChannelKind kind = channelKind(fChNumber);
+      if(kind.pd == kPDPMT) {
         threshold = fThresholdPMT;
       }
-      else if((opdetType == "xarapuca_vuv") || (opdetType == "xarapuca_vis")) {
+      else if(kind.pd == kPDArapuca) {
         threshold = fThresholdArapuca;
       }
       else {
-        mf::LogWarning("opHitFinder") << "Unexpected OpChannel: " << opdetType;
+        mf::LogWarning("opHitFinder") << "Unexpected OpChannel: " << fChNumber;
         continue;
       }
 
-      fwaveform.resize(wvf.size());
-      for(unsigned int i = 0; i < wvf.size(); i++) {
-        fwaveform[i] = wvf[i];
-      }
-
-      subtractBaseline(fwaveform, opdetType, electronicsType, rms);
+      // copies the ADCs into fwaveform with the baseline removed
+      subtractBaseline(wvf, fwaveform, kind, rms);
 
-      if(fUseDenoising) {
-        if((opdetType == "pmt_coated") || (opdetType == "pmt_uncoated")) {
-        }
-        else if((opdetType == "xarapuca_vuv") || (opdetType == "xarapuca_vis")) {
-          denoise(fwaveform, outwvform);
-        }
-        else {
-          mf::LogInfo("opHitFinder") << "Unexpected OpChannel: " << opdetType
-                    << ", continue." << std::endl;
-          std::terminate();
-        }
+      if(fUseDenoising && kind.pd == kPDArapuca) {
+        denoise(fwaveform, outwvform);
       }
 
       // TODO: pass rms to this function once that's sorted. ~icaza
-      while(findAndSuppressPeak(fwaveform, timebin, Area, amplitude, threshold, opdetType, electronicsType)){
-        if(electronicsType == "daphne") time = wvf.TimeStamp() + (double)timebin / fSampling_Daphne;
-        else time = wvf.TimeStamp() + (double)timebin / fSampling;
-
-        if(opdetType == "pmt_coated" || opdetType == "pmt_uncoated") {
+      findPeaks(fwaveform, fPeaks, threshold, kind.daphne);
+      for(auto const& peak : fPeaks) {
+        Area = peak.area;
+        amplitude = peak.amplitude;
+        if(kind.daphne) time = wvf.TimeStamp() + (double)peak.timebin / fSampling_Daphne;
+        else time = wvf.TimeStamp() + (double)peak.timebin / fSampling;
+
+        if(kind.pd == kPDPMT) {
           phelec = Area / fArea1pePMT;
         }
-        else if((opdetType == "xarapuca_vuv") || (opdetType == "xarapuca_vis")) {
-          phelec = Area / fArea1peSiPM;
-        }
         else {
-          mf::LogWarning("opHitFinder")  << "Unexpected OpChannel: " << opdetType
-                                         << ", continue.";
-          continue;
+          phelec = Area / fArea1peSiPM;
         }
 
         //including hit info: OpChannel, PeakTime, PeakTimeAbs, Frame, Width, Area, PeakHeight, PE, FastToTotal
         recob::OpHit opHit(fChNumber, time, time, frame, FWHM, Area, amplitude, phelec, fasttotal);
         pulseVecPtr->emplace_back(opHit);
-      } // while findAndSuppressPeak()
+      } // for peaks
     }
     e.put(std::move(pulseVecPtr));
   } // void opHitFinderSBND::produce(art::Event & e)
 
   DEFINE_ART_MODULE(opHitFinderSBND)
 
-  void opHitFinderSBND::subtractBaseline(std::vector<double>& waveform,
-                                         std::string pdtype, std::string electronicsType, double& rms)
+  void opHitFinderSBND::subtractBaseline(const raw::OpDetWaveform& wvf,
+                                         std::vector<double>& waveform,
+                                         const ChannelKind& kind, double& rms)
   {
     double baseline = 0.0;
     rms = 0.0;
     int cnt = 0;
     double NBins=fBaselineSample;
-    if (electronicsType=="daphne") NBins/=(fSampling/fSampling_Daphne);//correct the number of bins to the sampling frecuency. TODO: use a fixed time interval instead, then use the channel frequency to get the number of bins ~rodrigoa
+    if (kind.daphne) NBins/=(fSampling/fSampling_Daphne);//correct the number of bins to the sampling frecuency. TODO: use a fixed time interval instead, then use the channel frequency to get the number of bins ~rodrigoa
     // TODO: this is broken it assumes that the beginning of the
     // waveform is only noise, which is not always the case. ~icaza.
     // TODO: use std::accumulate instead of this loop. ~icaza.
     for(int i = 0; i < NBins; i++) {
-      baseline += waveform[i];
-      rms += std::pow(waveform[i], 2);
+      baseline += wvf[i];
+      rms += std::pow(wvf[i], 2);
       cnt++;
     }
 
@@ -240,60 +254,50 @@ namespace opdet {
     rms = sqrt(rms / cnt - baseline * baseline);
     rms = rms / sqrt(cnt - 1);
 
-    if(pdtype == "pmt_coated" || pdtype == "pmt_uncoated") {
-      for(unsigned int i = 0; i < waveform.size(); i++) waveform[i] = fPulsePolarityPMT * (waveform[i] - baseline);
-    }
-    else if((opdetType == "xarapuca_vuv") || (opdetType == "xarapuca_vis")) {
-      for(unsigned int i = 0; i < waveform.size(); i++) waveform[i] = fPulsePolarityArapuca * (waveform[i] - baseline);
-    }
-    else {
-      mf::LogWarning("opHitFinder") << "Unexpected OpChannel: " << opdetType;
-      return;
-    }
+    const double polarity = (kind.pd == kPDPMT) ? fPulsePolarityPMT : fPulsePolarityArapuca;
+    waveform.resize(wvf.size());
+    for(unsigned int i = 0; i < wvf.size(); i++) waveform[i] = polarity * (wvf[i] - baseline);
   }
 
 
+  // Finds every region of the waveform above threshold in a single sweep.
+  // The peaks are ordered by decreasing amplitude, earliest first on ties,
+  // which is the order the previous find-and-suppress of the maximum gave.
   // TODO: pass rms to this function once that's sorted. ~icaza
-  bool opHitFinderSBND::findAndSuppressPeak(std::vector<double>& waveform,
-                                            size_t& timebin, double& Area,
-                                            double& amplitude, const int& threshold,
-                                            const std::string& opdetType,
-                                            const std::string& electronicsType)
+  void opHitFinderSBND::findPeaks(const std::vector<double>& waveform,
+                                  std::vector<Peak>& peaks,
+                                  const int& threshold, const bool daphne)
   {
+    peaks.clear();
 
-    std::vector<double>::iterator max_element_it = std::max_element(waveform.begin(), waveform.end());
-    amplitude = *max_element_it;
-    if(amplitude < threshold) return false; // stop if there's no more peaks
-    timebin = std::distance(waveform.begin(), max_element_it);
-
-    // it_e contains the iterator to the last element in the peak
-    // where waveform is above threshold
-    auto it_e = std::find_if(max_element_it,
-                            waveform.end(),
-                            [threshold](const double& x)->bool
-                              {return x < threshold;} );
-    // it_s contains the iterator to the first element in the peak
-    // where waveform is above threshold
-    auto it_s = std::find_if(std::make_reverse_iterator(max_element_it),
-                            std::make_reverse_iterator(waveform.begin()),
-                            [threshold](const double& x)->bool
-                              {return x < threshold;} ).base();
-
-    // integrate the area below the peak
     // note that fSampling is in MHz and
     // we convert it to GHz here so as to
     // have an area in ADC*ns.
-    Area = std::accumulate(it_s, it_e, 0.0);
-    if (electronicsType == "daphne"){
-    Area = Area / (fSampling_Daphne / 1000.);}
-    else{
-    Area = Area / (fSampling / 1000.);};
-
-    // TODO: try to just remove this
-    // TODO: better even, return iterator to last position
-    std::fill(it_s, it_e, 0.0); // zeroes out that peak
-    return true;
-  } // bool opHitFinderSBND::findAndSuppressPeak()
+    const double sampling = daphne ? fSampling_Daphne / 1000. : fSampling / 1000.;
+
+    size_t i = 0;
+    while(i < waveform.size()) {
+      if(waveform[i] < threshold) {
+        i++;
+        continue;
+      }
+      // integrate the region while keeping track of its first maximum
+      Peak peak{i, waveform[i], 0.0};
+      for(; i < waveform.size() && !(waveform[i] < threshold); i++) {
+        if(waveform[i] > peak.amplitude) {
+          peak.amplitude = waveform[i];
+          peak.timebin = i;
+        }
+        peak.area += waveform[i];
+      }
+      peak.area = peak.area / sampling;
+      peaks.push_back(peak);
+    }
+
+    std::stable_sort(peaks.begin(), peaks.end(),
+                     [](const Peak& a, const Peak& b)->bool
+                       {return a.amplitude > b.amplitude;} );
+  } // void opHitFinderSBND::findPeaks()
 
 
   void opHitFinderSBND::denoise(std::vector<double>& waveform, std::vector<double>& outwaveform)
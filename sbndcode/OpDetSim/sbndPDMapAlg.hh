@@ -18,6 +18,11 @@
 // sensible_to_vuv: true or false
 // tpc: 0, 1
 // sampling: apsaia, daphne
+//
+// The map is read once into a dense channel indexed table of enums
+// with the channel lists of each type precomputed, so the per channel
+// accessors do not query the json. If sbnd_pds_mapping.json is not
+// found in FW_SEARCH_PATH the copy embedded at build time is used.
 ////////////////////////////////////////////////////////////////////////
 
 #ifndef SBND_OPDETSIM_SBNDPDMAPALG_HH
@@ -31,6 +36,7 @@
 #include <fstream>
 #include <map>
 #include <string>
+#include <vector>
 
 #include "art_root_io/TFileService.h"
 
@@ -38,6 +44,32 @@
 
 namespace opdet {
 
+  enum PDType {
+    kPDUnknown = -1,
+    kPMTCoated,
+    kPMTUncoated,
+    kXArapucaVUV,
+    kXArapucaVis,
+    kNPDTypes
+  };
+
+  enum PDElectronics {
+    kElectronicsUnknown = -1,
+    kCAEN,    ///< empty "electronics" entry in the map
+    kDaphne,
+    kNPDElectronics
+  };
+
+  // Properties of one channel of the map
+  struct PDChannel {
+    PDType        pdType       = kPDUnknown;
+    PDElectronics electronics  = kElectronicsUnknown;
+    int           pdsBox       = -1;
+    int           tpc          = -1;
+    bool          sensibleToVUV = false;
+    bool          sensibleToVis = false;
+  };
+
   class sbndPDMapAlg : PDMapAlg{
 
   public:
@@ -68,8 +100,27 @@ namespace opdet {
     size_t size() const;
     auto getChannelEntry(size_t ch) const;
 
+    // Typed accessors, these do not touch the json
+    const PDChannel& channel(size_t ch) const { return fChannels.at(ch); }
+    PDType pdTypeEnum(size_t ch) const { return fChannels.at(ch).pdType; }
+    PDElectronics electronicsEnum(size_t ch) const { return fChannels.at(ch).electronics; }
+    bool isPMT(size_t ch) const;
+    bool isArapuca(size_t ch) const;
+    const std::vector<int>& getChannelsOfType(PDType pdtype) const;
+    const std::vector<int>& getChannelsOfType(PDType pdtype, PDElectronics electronics) const;
+
+    static PDType pdTypeFromName(const std::string& pdname);
+    static PDElectronics electronicsFromName(const std::string& elname);
+    static const std::string& pdTypeName(PDType pdtype);
+    static const std::string& electronicsName(PDElectronics electronics);
+
   private:
+    void fillChannelTable();
+
     nlohmann::json PDmap;
+    std::vector<PDChannel> fChannels;
+    std::vector<int> fChannelsOfType[kNPDTypes];
+    std::vector<int> fChannelsOfTypeAndElectronics[kNPDTypes][kNPDElectronics];
 
   }; // class sbndPDMapAlg
 
@@ -1,6 +1,10 @@
 #include "sbndcode/OpDetSim/sbndPDMapAlg.hh"
 #include "art/Utilities/ToolMacros.h"
 #include "art/Utilities/make_tool.h"
+#include "messagefacility/MessageLogger/MessageLogger.h"
+
+// Default map, generated at build time from sbnd_pds_mapping.json
+#include "sbnd_pds_mapping_json.h"
 
 
 //------------------------------------------------------------------------------
@@ -13,64 +17,148 @@ namespace opdet {
   {
     std::string fname;
     cet::search_path sp("FW_SEARCH_PATH");
-    sp.find_file("sbnd_pds_mapping.json", fname);
-    std::ifstream i(fname, std::ifstream::in);
-    i >> PDmap;
-    i.close();
+    if(sp.find_file("sbnd_pds_mapping.json", fname)) {
+      std::ifstream i(fname, std::ifstream::in);
+      i >> PDmap;
+      i.close();
+    }
+    else {
+      mf::LogWarning("sbndPDMapAlg")
+        << "sbnd_pds_mapping.json not found in FW_SEARCH_PATH, "
+        << "using the copy embedded at build time, which may be out of date.";
+      PDmap = nlohmann::json::parse(kSBNDPDSMappingJSON);
+    }
+    fillChannelTable();
   }
 
   sbndPDMapAlg::~sbndPDMapAlg()
   { }
 
+  void sbndPDMapAlg::fillChannelTable()
+  {
+    fChannels.resize(PDmap.size());
+    for (size_t ch = 0; ch < PDmap.size(); ch++) {
+      const nlohmann::json& entry = PDmap.at(ch);
+      PDChannel& channel = fChannels[ch];
+      channel.pdType        = pdTypeFromName(entry["pd_type"].get<std::string>());
+      channel.electronics   = electronicsFromName(entry["electronics"].get<std::string>());
+      channel.pdsBox        = entry["pds_box"].get<int>();
+      channel.tpc           = entry["tpc"].get<int>();
+      channel.sensibleToVUV = entry["sensible_to_vuv"].get<bool>();
+      channel.sensibleToVis = entry["sensible_to_vis"].get<bool>();
+
+      if (channel.pdType == kPDUnknown) continue;
+      fChannelsOfType[channel.pdType].push_back(ch);
+      if (channel.electronics == kElectronicsUnknown) continue;
+      fChannelsOfTypeAndElectronics[channel.pdType][channel.electronics].push_back(ch);
+    }
+  }
+
+  PDType sbndPDMapAlg::pdTypeFromName(const std::string& pdname)
+  {
+    for (int t = 0; t < kNPDTypes; t++) {
+      if (pdname == pdTypeName(PDType(t))) return PDType(t);
+    }
+    return kPDUnknown;
+  }
+
+  PDElectronics sbndPDMapAlg::electronicsFromName(const std::string& elname)
+  {
+    for (int e = 0; e < kNPDElectronics; e++) {
+      if (elname == electronicsName(PDElectronics(e))) return PDElectronics(e);
+    }
+    return kElectronicsUnknown;
+  }
+
+  const std::string& sbndPDMapAlg::pdTypeName(PDType pdtype)
+  {
+    static const std::string names[kNPDTypes] = {"pmt_coated", "pmt_uncoated", "xarapuca_vuv", "xarapuca_vis"};
+    static const std::string unknown = "";
+    if (pdtype == kPDUnknown || pdtype >= kNPDTypes) return unknown;
+    return names[pdtype];
+  }
+
+  const std::string& sbndPDMapAlg::electronicsName(PDElectronics electronics)
+  {
+    static const std::string names[kNPDElectronics] = {"", "daphne"};
+    static const std::string unknown = "unknown";
+    if (electronics == kElectronicsUnknown || electronics >= kNPDElectronics) return unknown;
+    return names[electronics];
+  }
+
   bool sbndPDMapAlg::isPDType(size_t ch, std::string pdname) const
   {
-    if(PDmap.at(ch)["pd_type"] == std::string(pdname)) return true;
-    return false;
+    const PDType pdtype = pdTypeFromName(pdname);
+    return pdtype != kPDUnknown && fChannels.at(ch).pdType == pdtype;
   }
 
   bool sbndPDMapAlg::isElectronics(size_t ch, std::string pdname) const
   {
-    if(PDmap.at(ch)["electronics"] == std::string(pdname)) return true; // TODO: add number of electronics, daphne01, daphne02, .... ~rodrigoa
-    return false;
+    const PDElectronics electronics = electronicsFromName(pdname);
+    return electronics != kElectronicsUnknown && fChannels.at(ch).electronics == electronics; // TODO: add number of electronics, daphne01, daphne02, .... ~rodrigoa
+  }
+
+  bool sbndPDMapAlg::isPMT(size_t ch) const
+  {
+    const PDType pdtype = fChannels.at(ch).pdType;
+    return pdtype == kPMTCoated || pdtype == kPMTUncoated;
+  }
+
+  bool sbndPDMapAlg::isArapuca(size_t ch) const
+  {
+    const PDType pdtype = fChannels.at(ch).pdType;
+    return pdtype == kXArapucaVUV || pdtype == kXArapucaVis;
   }
 
   std::string sbndPDMapAlg::pdType(size_t ch) const
   {
-    return PDmap.at(ch)["pd_type"];
+    return pdTypeName(fChannels.at(ch).pdType);
   }
 
   std::string sbndPDMapAlg::electronicsType(size_t ch) const
   {
-    return PDmap.at(ch)["electronics"]; 
+    return electronicsName(fChannels.at(ch).electronics);
   }
 
   int sbndPDMapAlg::pdBox(size_t ch) const
   {
-    return PDmap.at(ch)["pds_box"];
+    return fChannels.at(ch).pdsBox;
   }
 
 
   int sbndPDMapAlg::pdTPC(size_t ch) const
   {
-    return PDmap.at(ch)["tpc"];
+    return fChannels.at(ch).tpc;
   }
 
   std::vector<int> sbndPDMapAlg::getChannelsOfType(std::string pdname) const
   {
-    std::vector<int> out_ch_v;
-    for (size_t ch = 0; ch < PDmap.size(); ch++) {
-      if (PDmap.at(ch)["pd_type"] == pdname) out_ch_v.push_back(ch);
-    }
-    return out_ch_v;
+    const PDType pdtype = pdTypeFromName(pdname);
+    if (pdtype == kPDUnknown) return {};
+    return fChannelsOfType[pdtype];
   }
 
   std::vector<int> sbndPDMapAlg::getChannelsOfType(std::string pdname,std::string elname) const
   {//overload to select channels by pdtype AND electronics type ~rodrigoa
-    std::vector<int> out_ch_v;
-    for (size_t ch = 0; ch < PDmap.size(); ch++) {
-      if ((PDmap.at(ch)["pd_type"] == pdname) && (PDmap.at(ch)["electronics"] == elname))out_ch_v.push_back(ch);
-    }
-    return out_ch_v;
+    const PDType pdtype = pdTypeFromName(pdname);
+    const PDElectronics electronics = electronicsFromName(elname);
+    if (pdtype == kPDUnknown || electronics == kElectronicsUnknown) return {};
+    return fChannelsOfTypeAndElectronics[pdtype][electronics];
+  }
+
+  const std::vector<int>& sbndPDMapAlg::getChannelsOfType(PDType pdtype) const
+  {
+    static const std::vector<int> empty;
+    if (pdtype == kPDUnknown || pdtype >= kNPDTypes) return empty;
+    return fChannelsOfType[pdtype];
+  }
+
+  const std::vector<int>& sbndPDMapAlg::getChannelsOfType(PDType pdtype, PDElectronics electronics) const
+  {
+    static const std::vector<int> empty;
+    if (pdtype == kPDUnknown || pdtype >= kNPDTypes ||
+        electronics == kElectronicsUnknown || electronics >= kNPDElectronics) return empty;
+    return fChannelsOfTypeAndElectronics[pdtype][electronics];
   }
 
   size_t sbndPDMapAlg::size() const
@@ -115,23 +115,25 @@ int RecoUtils::TrueParticleIDFromTotalRecoHits(detinfo::DetectorClocksData const
 bool RecoUtils::IsInsideTPC(TVector3 position, double distance_buffer){
   bool inside = false;
   art::ServiceHandle<geo::Geometry> geom;
+
+  // Bounds of the union of all the TPCs, the geometry doesn't change during the job
+  static const std::array<double, 6> bounds = [&geom]() {
+    std::array<double, 6> b = {99999, -99999, 99999, -99999, 99999, -99999};
+    for (auto const& tpcg : geom->Iterate<geo::TPCGeo>()) {
+      b[0] = std::min(b[0], tpcg.MinX()); b[1] = std::max(b[1], tpcg.MaxX());
+      b[2] = std::min(b[2], tpcg.MinY()); b[3] = std::max(b[3], tpcg.MaxY());
+      b[4] = std::min(b[4], tpcg.MinZ()); b[5] = std::max(b[5], tpcg.MaxZ());
+    }
+    return b;
+  }();
+
   geo::TPCID idtpc = geom->FindTPCAtPosition(geo::vect::toPoint(position));
 
   if (geom->HasTPC(idtpc))
   {
-    const geo::TPCGeo& tpcgeo = geom->GetElement(idtpc);
-    double minx = tpcgeo.MinX(); double maxx = tpcgeo.MaxX();
-    double miny = tpcgeo.MinY(); double maxy = tpcgeo.MaxY();
-    double minz = tpcgeo.MinZ(); double maxz = tpcgeo.MaxZ();
-
-    for (auto const& tpcg : geom->Iterate<geo::TPCGeo>()) {
-        if (tpcg.MinX() < minx) minx = tpcg.MinX();
-        if (tpcg.MaxX() > maxx) maxx = tpcg.MaxX();
-        if (tpcg.MinY() < miny) miny = tpcg.MinY();
-        if (tpcg.MaxY() > maxy) maxy = tpcg.MaxY();
-        if (tpcg.MinZ() < minz) minz = tpcg.MinZ();
-        if (tpcg.MaxZ() > maxz) maxz = tpcg.MaxZ();
-    }
+    double minx = bounds[0]; double maxx = bounds[1];
+    double miny = bounds[2]; double maxy = bounds[3];
+    double minz = bounds[4]; double maxz = bounds[5];
 
     //x
     double dista = fabs(minx - position.X());
@@ -175,3 +177,149 @@ double RecoUtils::CalculateTrackLength(const art::Ptr<recob::Track> track){
   }
   return length;
 }
+
+
+
+RecoUtils::TruthMatchCache::TruthMatchCache(detinfo::DetectorClocksData const& clockData, bool rollup_unsaved_ids)
+  : fClockData(clockData)
+  , fRollup(rollup_unsaved_ids)
+{
+}
+
+
+
+size_t RecoUtils::TruthMatchCache::HitIndex(const art::Ptr<recob::Hit>& hit) {
+  // Find the key table of this hit collection
+  std::vector<int>* keys = nullptr;
+  for (auto& collection : fHitKeys) {
+    if (collection.first == hit.id()) {
+      keys = &collection.second;
+      break;
+    }
+  }
+  if (!keys) {
+    fHitKeys.emplace_back(hit.id(), std::vector<int>());
+    keys = &fHitKeys.back().second;
+  }
+  if (hit.key() >= keys->size()) keys->resize(hit.key()+1, -1);
+
+  int& index = (*keys)[hit.key()];
+  if (index >= 0) return index;
+
+  // First time we see this hit, backtrack it
+  HitTruth truth;
+  truth.begin = fIDs.size();
+  std::vector<sim::TrackIDE> track_ides = fBackTracker->HitToTrackIDEs(fClockData, hit);
+  for (auto const& track_ide : track_ides) {
+    int id = track_ide.trackID;
+    if (fRollup) id = std::abs(id);
+    fIDs.push_back(id);
+    fEnergies.push_back(track_ide.energy);
+  }
+  truth.end = fIDs.size();
+
+  // Maximum contributor, as in TrueParticleID. Uses its own scratch as the
+  // matching methods call this while summing their totals in fScratch
+  fHitScratch.clear();
+  for (size_t i = truth.begin; i < truth.end; ++i) fHitScratch.emplace_back(fIDs[i], fEnergies[i]);
+  MergeContributions(fHitScratch);
+  double likely_particle_contrib_energy = -99999;
+  truth.trueID = 0;
+  for (auto const& [id, energy] : fHitScratch) {
+    if (energy > likely_particle_contrib_energy) {
+      likely_particle_contrib_energy = energy;
+      truth.trueID = id;
+    }
+  }
+
+  index = fHits.size();
+  fHits.push_back(truth);
+  return index;
+}
+
+
+
+void RecoUtils::TruthMatchCache::MergeContributions(std::vector<std::pair<int,double> >& contributions) {
+  // Stable so each ID is summed in the order its contributions were added, like the map based functions
+  std::stable_sort(contributions.begin(), contributions.end(),
+                   [](const std::pair<int,double>& a, const std::pair<int,double>& b) { return a.first < b.first; });
+  size_t n = 0;
+  for (size_t i = 0; i < contributions.size(); ++i) {
+    if (n > 0 && contributions[n-1].first == contributions[i].first) contributions[n-1].second += contributions[i].second;
+    else contributions[n++] = contributions[i];
+  }
+  contributions.resize(n);
+}
+
+
+
+int RecoUtils::TruthMatchCache::TrueParticleID(const art::Ptr<recob::Hit>& hit) {
+  return fHits[HitIndex(hit)].trueID;
+}
+
+
+
+int RecoUtils::TruthMatchCache::TrueParticleIDFromTotalTrueEnergy(const std::vector<art::Ptr<recob::Hit> >& hits) {
+  fScratch.clear();
+  for (auto const& hit : hits) {
+    HitTruth const& truth = fHits[HitIndex(hit)];
+    for (size_t i = truth.begin; i < truth.end; ++i) fScratch.emplace_back(fIDs[i], fEnergies[i]);
+  }
+  MergeContributions(fScratch);
+
+  double maxenergy = -1;
+  int objectTrack = -99999;
+  for (auto const& [id, energy] : fScratch) {
+    if (energy > maxenergy) {
+      maxenergy = energy;
+      objectTrack = id;
+    }
+  }
+  return objectTrack;
+}
+
+
+
+int RecoUtils::TruthMatchCache::TrueParticleIDFromTotalRecoCharge(const std::vector<art::Ptr<recob::Hit> >& hits) {
+  fScratch.clear();
+  for (auto const& hit : hits) fScratch.emplace_back(fHits[HitIndex(hit)].trueID, hit->Integral());
+  MergeContributions(fScratch);
+
+  double highestCharge = 0;
+  int objectTrack = -99999;
+  for (auto const& [id, charge] : fScratch) {
+    if (charge > highestCharge) {
+      highestCharge = charge;
+      objectTrack = id;
+    }
+  }
+  return objectTrack;
+}
+
+
+
+int RecoUtils::TruthMatchCache::TrueParticleIDFromTotalRecoHits(const std::vector<art::Ptr<recob::Hit> >& hits) {
+  fScratch.clear();
+  for (auto const& hit : hits) fScratch.emplace_back(fHits[HitIndex(hit)].trueID, 1.);
+  MergeContributions(fScratch);
+
+  int objectTrack = -99999;
+  int highestCount = -1;
+  int NHighestCounts = 0;
+  for (auto const& [id, nhits] : fScratch) {
+    int count = nhits;
+    if (count > highestCount) {
+      highestCount = count;
+      objectTrack = id;
+      NHighestCounts = 1;
+    }
+    else if (count == highestCount) {
+      NHighestCounts++;
+    }
+  }
+  if (NHighestCounts > 1){
+    std::cout<<"RecoUtils::TrueParticleIDFromTotalRecoHits - There are " << NHighestCounts << " particles which tie for highest number of contributing hits (" << highestCount<<" hits).  Using RecoUtils::TrueParticleIDFromTotalTrueEnergy instead."<<std::endl;
+    objectTrack = TrueParticleIDFromTotalTrueEnergy(hits);
+  }
+  return objectTrack;
+}
@@ -32,10 +32,12 @@
 //#include "lardataobj/AnalysisBase/ParticleID.h"
 #include "larsim/MCCheater/BackTrackerService.h"
 #include "larcore/Geometry/Geometry.h"
-namespace detinfo { class DetectorClocksData; }
+#include "lardataalg/DetectorInfo/DetectorClocksData.h"
 
 
 // c++
+#include <algorithm>
+#include <array>
 #include <vector>
 #include <map>
 
@@ -50,6 +52,45 @@ namespace RecoUtils{
   int TrueParticleIDFromTotalRecoHits(detinfo::DetectorClocksData const& clockData, const std::vector<art::Ptr<recob::Hit> >& hits, bool rollup_unsaved_ids=1);  //Returns the geant4 ID which contributes the most to the vector of hits.  The matching method looks for which true particle maximally contributes to the most reco hits
   bool IsInsideTPC(TVector3 position, double distance_buffer); //Checks if a position is within any of the TPCs in the geometry (user can define some distance buffer from the TPC walls)
   double CalculateTrackLength(const art::Ptr<recob::Track> track); //Calculates the total length of a recob::track by summing up the distances between adjacent traj. points
+
+  // Per-event truth matching cache. Each hit is backtracked once, the first time it is
+  // seen, and its (track ID, energy) contributions are kept in flat arrays, so matching
+  // many objects which share hits only reads the cache. The matching methods give the
+  // same answers as the free functions above. Make one per event.
+  class TruthMatchCache {
+  public:
+    TruthMatchCache(detinfo::DetectorClocksData const& clockData, bool rollup_unsaved_ids=1);
+
+    int TrueParticleID(const art::Ptr<recob::Hit>& hit);
+    int TrueParticleIDFromTotalTrueEnergy(const std::vector<art::Ptr<recob::Hit> >& hits);
+    int TrueParticleIDFromTotalRecoCharge(const std::vector<art::Ptr<recob::Hit> >& hits);
+    int TrueParticleIDFromTotalRecoHits(const std::vector<art::Ptr<recob::Hit> >& hits);
+
+  private:
+    struct HitTruth {
+      size_t begin;  // first contribution in fIDs/fEnergies
+      size_t end;    // one past the last contribution
+      int trueID;    // maximally contributing track ID
+    };
+
+    // Index of the hit in fHits, backtracking it the first time
+    size_t HitIndex(const art::Ptr<recob::Hit>& hit);
+
+    // Sums the (ID, value) pairs per ID, in ascending ID order
+    static void MergeContributions(std::vector<std::pair<int,double> >& contributions);
+
+    detinfo::DetectorClocksData fClockData;
+    bool fRollup;
+    art::ServiceHandle<cheat::BackTrackerService> fBackTracker;
+
+    std::vector<std::pair<art::ProductID, std::vector<int> > > fHitKeys; // per hit collection, hit key -> index in fHits (-1 if not seen)
+    std::vector<HitTruth> fHits;
+    std::vector<int> fIDs;
+    std::vector<double> fEnergies;
+
+    std::vector<std::pair<int,double> > fScratch;    // totals of the matching methods
+    std::vector<std::pair<int,double> > fHitScratch; // contributions of the hit being backtracked by HitIndex
+  };
 }
 
 #endif
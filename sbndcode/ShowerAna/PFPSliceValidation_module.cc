@@ -37,7 +37,11 @@
 
 // Root Includes
 #include "TTree.h"
+#include <algorithm>
 #include <iostream>
+#include <map>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 namespace ana {
@@ -60,31 +64,44 @@ public:
   void analyze(art::Event const &evt) override;
   void beginJob() override;
 
-  // Function to get a map of MCTruth to number of hits from that truth
-  std::map<art::Ptr<simb::MCTruth>, int>
-  GetTruthHitMap(const detinfo::DetectorClocksData &clockData,
-                 const sim::ParticleList &trueParticlesMap,
-                 const std::map<int, art::Ptr<simb::MCTruth>> &particleTruthMap,
-                 const std::vector<art::Ptr<recob::Hit>> &allHits);
+  // Function to get the index of the MCTruth that contributed the most energy to a hit
+  // Returns -1 if the hit does not match to any truth
+  int BackTrackHit(const detinfo::DetectorClocksData &clockData, const art::Ptr<recob::Hit> &hit);
 
-  // Function to match a slice, really any selection of hits, back to MCTruth
+  // Function to look up the truth index of a hit in the per-event hit-truth table
+  // Hits outside the event hit collection are backtracked once and cached
+  int HitTruthIndex(const detinfo::DetectorClocksData &clockData, const art::Ptr<recob::Hit> &hit);
+
+  // Function to match a slice, really any selection of hits, back to the index of an MCTruth
   // Also calculates purity and completeness of match (by reference)
-  art::Ptr<simb::MCTruth>
-  GetSliceTruthMatchHits(const detinfo::DetectorClocksData &clockData,
-                         const std::vector<art::Ptr<recob::Hit>> &sliceHits,
-                         const std::map<int, art::Ptr<simb::MCTruth>> &particleTruthMap,
-                         const std::map<art::Ptr<simb::MCTruth>, int> &truthHitMap,
-                         float &completeness, float &purity);
+  int GetSliceTruthMatchHits(const detinfo::DetectorClocksData &clockData,
+                             const std::vector<art::Ptr<recob::Hit>> &sliceHits,
+                             float &completeness, float &purity);
 
   // Functions to reset tree variables
   void ClearTrueTree();
   void ClearEventTree();
 
-  // Function to create branches on tree for a list of labels
+  // All of the metrics for a single PFParticle label
+  struct LabelMetrics {
+    // Event wide metrics
+    int eventPFPSlices, eventPFPNeutrinos;
+    std::vector<float> eventCosmicScores, eventNeutrinoScores;
+
+    // Truth-by-truth metrics
+    bool nuMatchNeutrino;
+    int nuSlices, nuNeutrinos, bestNuPdg;
+    float bestNuPurity, bestNuComp, bestNuScore;
+
+    // Vertex reco information
+    float pfpVertexX, pfpVertexY, pfpVertexZ;
+    float pfpVertexDistX, pfpVertexDistY, pfpVertexDistZ, pfpVertexDistMag;
+  };
+
+  // Function to create branches on tree for every label
   // Branches will have the form branchName_PFParticleLabel
   template <class T>
-  void initTree(TTree *Tree, std::string branchName, std::map<std::string, T> &Metric,
-                std::vector<std::string> fPFParticleLabels);
+  void initTree(TTree *Tree, std::string branchName, T LabelMetrics::*Metric);
 
   struct SliceMatch {
 
@@ -118,10 +135,16 @@ public:
     // }
   };
 
+  // Number of primary daughters of each truth
+  struct TruthDaughters {
+    int numProtons = 0, numPi = 0, numPi0 = 0;
+  };
+
 private:
   int fVerbose;
 
   std::string fHitLabel, fGenieGenModuleLabel;
+  // Unique labels, each label's metrics are stored at its index
   std::vector<std::string> fPFParticleLabels;
 
   art::ServiceHandle<art::TFileService> tfs;
@@ -133,30 +156,42 @@ private:
 
   // Event wide metrics
   int eventTrueNeutrinos;
-  std::map<std::string, int> eventPFPSlices, eventPFPNeutrinos;
-  std::map<std::string, std::vector<float>> eventCosmicScores, eventNeutrinoScores;
 
-  // Truth-by-truth metrics
-  std::map<std::string, bool> nuMatchNeutrino;
-  std::map<std::string, int> nuSlices, nuNeutrinos, bestNuPdg;
-  std::map<std::string, float> bestNuPurity, bestNuComp, bestNuScore;
+  // Per label metrics, the branches point into this so it is sized once in the constructor
+  std::vector<LabelMetrics> fLabelMetrics;
 
   // Neutrino Interaction variables
   int intType, CCNC, neutrinoPDG, numProtons, numNeutrons, numPi, numPi0, numTrueHits;
   float W, X, Y, QSqr, Pt, Theta, neutrinoE, leptonP;
   float trueVertexX, trueVertexY, trueVertexZ;
 
-  // Vertex reco information
-  std::map<std::string, float> pfpVertexX, pfpVertexY, pfpVertexZ;
-  std::map<std::string, float> pfpVertexDistX, pfpVertexDistY, pfpVertexDistZ, pfpVertexDistMag;
+  // Per-event truth tables, shared between all of the labels
+  std::vector<art::Ptr<simb::MCTruth>> fTruths;               // Truth for each truth index
+  std::unordered_map<int, int> fTrackTruth;                   // Track ID to truth index
+  std::vector<int> fTruthHits;                                // Number of hits from each truth
+  art::ProductID fHitProductID;                               // Product of the event hits
+  std::vector<int> fHitTruth;                                 // Truth index of each event hit
+  std::map<std::pair<art::ProductID, std::size_t>, int> fOtherHitTruth;
+
+  // Scratch space for matching slices
+  std::vector<int> fSliceTruthHits, fSliceTruths;
 };
 
 ana::PFPSliceValidation::PFPSliceValidation(fhicl::ParameterSet const &pset)
     : EDAnalyzer{pset}
     , fVerbose(pset.get<int>("Verbose", 0))
     , fHitLabel(pset.get<std::string>("HitLabel"))
-    , fGenieGenModuleLabel(pset.get<std::string>("GenieGenModuleLabel"))
-    , fPFParticleLabels(pset.get<std::vector<std::string>>("PFParticleLabels")) {}
+    , fGenieGenModuleLabel(pset.get<std::string>("GenieGenModuleLabel")) {
+
+  // Intern the labels, dropping any repeats
+  for (auto const &label : pset.get<std::vector<std::string>>("PFParticleLabels")) {
+    if (std::find(fPFParticleLabels.begin(), fPFParticleLabels.end(), label) ==
+        fPFParticleLabels.end())
+      fPFParticleLabels.push_back(label);
+  } // label: PFParticleLabels
+
+  fLabelMetrics.resize(fPFParticleLabels.size());
+}
 
 void ana::PFPSliceValidation::beginJob() {
   trueTree  = tfs->make<TTree>("trueTree", "Tree with true neutrino metrics");
@@ -164,12 +199,12 @@ void ana::PFPSliceValidation::beginJob() {
 
   eventTree->Branch("trueNeutrinos", &eventTrueNeutrinos);
 
-  initTree(eventTree, "pfpNeutrinos", eventPFPNeutrinos, fPFParticleLabels);
-  initTree(eventTree, "pfpSlices", eventPFPSlices, fPFParticleLabels);
+  initTree(eventTree, "pfpNeutrinos", &LabelMetrics::eventPFPNeutrinos);
+  initTree(eventTree, "pfpSlices", &LabelMetrics::eventPFPSlices);
   // Vector of scores of all slices that match to a cosmic
-  initTree(eventTree, "cosmicScores", eventCosmicScores, fPFParticleLabels);
+  initTree(eventTree, "cosmicScores", &LabelMetrics::eventCosmicScores);
   // Vector of socres of all slices that match to a neutrino
-  initTree(eventTree, "nuScores", eventNeutrinoScores, fPFParticleLabels);
+  initTree(eventTree, "nuScores", &LabelMetrics::eventNeutrinoScores);
 
   // Truth variables from GENIE
   trueTree->Branch("intType", &intType);
@@ -189,26 +224,26 @@ void ana::PFPSliceValidation::beginJob() {
   trueTree->Branch("leptonP", &leptonP);
 
   // Total number of all slices, and only neutrino slices matched to true interaction
-  initTree(trueTree, "numSlices", nuSlices, fPFParticleLabels);
-  initTree(trueTree, "numNeutrinos", nuNeutrinos, fPFParticleLabels);
+  initTree(trueTree, "numSlices", &LabelMetrics::nuSlices);
+  initTree(trueTree, "numNeutrinos", &LabelMetrics::nuNeutrinos);
   // Metrics of only best matched slice (Highest completeness)
-  initTree(trueTree, "bestMatchNeutrino", nuMatchNeutrino, fPFParticleLabels);
-  initTree(trueTree, "purity", bestNuPurity, fPFParticleLabels);
-  initTree(trueTree, "comp", bestNuComp, fPFParticleLabels);
-  initTree(trueTree, "score", bestNuScore, fPFParticleLabels);
-  initTree(trueTree, "recoPdg", bestNuPdg, fPFParticleLabels);
+  initTree(trueTree, "bestMatchNeutrino", &LabelMetrics::nuMatchNeutrino);
+  initTree(trueTree, "purity", &LabelMetrics::bestNuPurity);
+  initTree(trueTree, "comp", &LabelMetrics::bestNuComp);
+  initTree(trueTree, "score", &LabelMetrics::bestNuScore);
+  initTree(trueTree, "recoPdg", &LabelMetrics::bestNuPdg);
   // True vertex, needed for FV cuts
   trueTree->Branch("trueVertexX", &trueVertexX);
   trueTree->Branch("trueVertexY", &trueVertexY);
   trueTree->Branch("trueVertexZ", &trueVertexZ);
   // reco vertex of best matched slice, only available for neutrino slices
-  initTree(trueTree, "pfpVertexX", pfpVertexX, fPFParticleLabels);
-  initTree(trueTree, "pfpVertexY", pfpVertexY, fPFParticleLabels);
-  initTree(trueTree, "pfpVertexZ", pfpVertexZ, fPFParticleLabels);
-  initTree(trueTree, "pfpVertexDistX", pfpVertexDistX, fPFParticleLabels);
-  initTree(trueTree, "pfpVertexDistY", pfpVertexDistY, fPFParticleLabels);
-  initTree(trueTree, "pfpVertexDistZ", pfpVertexDistZ, fPFParticleLabels);
-  initTree(trueTree, "pfpVertexDistMag", pfpVertexDistMag, fPFParticleLabels);
+  initTree(trueTree, "pfpVertexX", &LabelMetrics::pfpVertexX);
+  initTree(trueTree, "pfpVertexY", &LabelMetrics::pfpVertexY);
+  initTree(trueTree, "pfpVertexZ", &LabelMetrics::pfpVertexZ);
+  initTree(trueTree, "pfpVertexDistX", &LabelMetrics::pfpVertexDistX);
+  initTree(trueTree, "pfpVertexDistY", &LabelMetrics::pfpVertexDistY);
+  initTree(trueTree, "pfpVertexDistZ", &LabelMetrics::pfpVertexDistZ);
+  initTree(trueTree, "pfpVertexDistMag", &LabelMetrics::pfpVertexDistMag);
 }
 
 void ana::PFPSliceValidation::analyze(art::Event const &evt) {
@@ -232,18 +267,45 @@ void ana::PFPSliceValidation::analyze(art::Event const &evt) {
   } // truth: truthVec
   std::cout << std::setprecision(2) << std::fixed;
 
-  // Get a map of each true particle to the MC Truth
-  std::map<int, art::Ptr<simb::MCTruth>> particleTruthMap;
+  // Intern the truths to indices, starting with the ones in the truth vector
+  std::map<art::Ptr<simb::MCTruth>, int> truthIndexMap;
+  fTruths.clear();
+  auto truthIndex = [&](const art::Ptr<simb::MCTruth> &truth) {
+    auto const [iter, inserted] = truthIndexMap.emplace(truth, fTruths.size());
+    if (inserted)
+      fTruths.push_back(truth);
+    return iter->second;
+  };
+  for (auto const &truth : truthVec) {
+    truthIndex(truth);
+  } // truth: truthVec
+
+  // Get a map of each true particle to the MC Truth index
+  // and count the primary daughters of each truth on the way
+  std::vector<TruthDaughters> truthDaughters;
+  fTrackTruth.clear();
   const sim::ParticleList &trueParticlesMap = particleInventory->ParticleList();
   for (auto const &[trackId, particle] : trueParticlesMap) {
-    particleTruthMap[trackId] = particleInventory->ParticleToMCTruth_P(particle);
+    int index            = truthIndex(particleInventory->ParticleToMCTruth_P(particle));
+    fTrackTruth[trackId] = index;
+    truthDaughters.resize(fTruths.size());
+
+    // We only want the primary daughters
+    if (particle->Process() != "primary")
+      continue;
+    // Apply 21MeV KE cut on protons
+    if (particle->PdgCode() == 2212 && (particle->E() - particle->Mass()) > 0.021) {
+      ++truthDaughters[index].numProtons;
+    } else if (std::abs(particle->PdgCode()) == 211) {
+      ++truthDaughters[index].numPi;
+    } else if (std::abs(particle->PdgCode()) == 111) {
+      ++truthDaughters[index].numPi0;
+    }
   } // [trackId, particle]: trueParticlesMap
   eventTrueNeutrinos = truthVec.size();
 
-  // Get reco stuff initialised
-  //std::vector<art::Handle<std::vector<recob::Hit>>> hitHandles;
-  //evt.getManyByType(hitHandles);
-  auto hitHandles = evt.getMany<std::vector<recob::Hit>>();
+  const unsigned int nTruths = fTruths.size();
+  truthDaughters.resize(nTruths);
 
   // Set the handles
   art::Handle<std::vector<recob::Hit>> hitHandle;
@@ -255,25 +317,29 @@ void ana::PFPSliceValidation::analyze(art::Event const &evt) {
   if (evt.getByLabel(fHitLabel, hitHandle))
     art::fill_ptr_vector(allHits, hitHandle);
 
-  // Get map of true primary particle to number of reco hits / energy in reco hits
+  // Backtrack every hit once, and count the number of reco hits from each truth
   auto const clockData = art::ServiceHandle<detinfo::DetectorClocksService const>()->DataFor(evt);
-  std::map<art::Ptr<simb::MCTruth>, int> truthHitMap =
-      GetTruthHitMap(clockData, trueParticlesMap, particleTruthMap, allHits);
+  fHitProductID = hitHandle.isValid() ? hitHandle.id() : art::ProductID();
+  fHitTruth.clear();
+  fOtherHitTruth.clear();
+  fTruthHits.assign(nTruths, 0);
+  for (const auto &hit : allHits) {
+    fHitTruth.push_back(BackTrackHit(clockData, hit));
+    if (fHitTruth.back() >= 0)
+      ++fTruthHits[fHitTruth.back()];
+  } // hit: allHits
+  fSliceTruthHits.assign(nTruths, 0);
 
-  // Create maps to store the best matched slice to each truth
-  std::map<std::string, std::map<art::Ptr<simb::MCTruth>, unsigned int>> pfpTruthNuCounterMap;
-  std::map<std::string, std::map<art::Ptr<simb::MCTruth>, unsigned int>> pfpTruthSliceCounterMap;
-  std::map<std::string, std::map<art::Ptr<simb::MCTruth>, SliceMatch>> pfpTruthSliceMatchMap;
+  // Flat tables of the counters and best matched slice for each [label][truth]
+  const unsigned int nLabels = fPFParticleLabels.size();
+  std::vector<unsigned int> pfpTruthNuCounter(nLabels * nTruths, 0);
+  std::vector<unsigned int> pfpTruthSliceCounter(nLabels * nTruths, 0);
+  std::vector<SliceMatch> pfpTruthSliceMatch(nLabels * nTruths);
 
-  // Initialise the counters in the maps
-  for (auto const &fPFParticleLabel : fPFParticleLabels) {
-    for (auto const &truth : truthVec) {
-      pfpTruthNuCounterMap[fPFParticleLabel][truth]    = 0;
-      pfpTruthSliceCounterMap[fPFParticleLabel][truth] = 0;
-    } // truth: truthVec
-  } // fPFParticleLabel: fPFParticleLabels
+  for (unsigned int label = 0; label < nLabels; ++label) {
 
-  for (auto const &fPFParticleLabel : fPFParticleLabels) {
+    const std::string &fPFParticleLabel = fPFParticleLabels[label];
+    LabelMetrics &metrics               = fLabelMetrics[label];
 
     if (fVerbose) {
       std::cout << "On PFParticleLabel: " << fPFParticleLabel << std::endl;
@@ -304,109 +370,100 @@ void ana::PFPSliceValidation::analyze(art::Event const &evt) {
       std::cout << "FindMany Slice PFPs not valid" << std::endl;
       return;
     }
-    // Create a map between PFParticles and their IDs
     art::FindManyP<larpandoraobj::PFParticleMetadata> fmpfpmd(pfps, evt, fPFParticleLabel);
     if (!fmpfpmd.isValid()) {
       std::cout << "PFP MetaData handle not valid" << std::endl;
       return;
     }
 
-    // Get maps of the pfp's Id to the pfp objects
-    // And for pfp neutrinos, get the slice id mva score
-    std::map<long unsigned int, art::Ptr<recob::PFParticle>> pfpMap;
-    std::map<long unsigned int, float> pfpNuScoreMap;
-    std::vector<art::Ptr<recob::PFParticle>> pfpNeutrinoVec;
+    // For pfp neutrinos, get the slice id mva score, indexed by the pfp key
+    std::vector<float> pfpNuScores(pfps.size(), -999);
+    unsigned int numPFPNeutrinos(0);
 
     for (auto const &pfp : pfps) {
 
-      long unsigned int pfpID = pfp->Self();
-      pfpMap[pfpID]           = pfp;
-
       // Select PFP neutrinos
       if (pfp->PdgCode() == 12 || pfp->PdgCode() == 14) {
-        pfpNeutrinoVec.push_back(pfp);
+        ++numPFPNeutrinos;
         if (fmpfpmd.size() == 0) {
           std::cout << "PFP neutrino has no metadata" << std::endl;
           return;
         } // fmpfpmd.size()
 
         // Get the pfparticle metadata to get the MVA score for each slice
-        const std::vector<art::Ptr<larpandoraobj::PFParticleMetadata>> pfpMetaVec =
-            fmpfpmd.at(pfpID);
-        for (auto const pfpMeta : pfpMetaVec) {
-          larpandoraobj::PFParticleMetadata::PropertiesMap propertiesMap =
-              pfpMeta->GetPropertiesMap();
-          pfpNuScoreMap[pfpID] = propertiesMap.at("NuScore");
+        const std::vector<art::Ptr<larpandoraobj::PFParticleMetadata>> &pfpMetaVec =
+            fmpfpmd.at(pfp.key());
+        for (auto const &pfpMeta : pfpMetaVec) {
+          pfpNuScores[pfp.key()] = pfpMeta->GetPropertiesMap().at("NuScore");
         } // pfpMeta: pfpMetaVec
       } // pfp->PdgCode()==12 || pfp->PdgCode()==14
     } // pfp: pfps
 
-    eventPFPSlices[fPFParticleLabel]    = pfpSliceVec.size();
-    eventPFPNeutrinos[fPFParticleLabel] = pfpNeutrinoVec.size();
+    metrics.eventPFPSlices    = pfpSliceVec.size();
+    metrics.eventPFPNeutrinos = numPFPNeutrinos;
+
+    unsigned int *sliceCounter = pfpTruthSliceCounter.data() + label * nTruths;
+    unsigned int *nuCounter    = pfpTruthNuCounter.data() + label * nTruths;
+    SliceMatch *sliceMatch     = pfpTruthSliceMatch.data() + label * nTruths;
 
     for (const auto &pfpSlice : pfpSliceVec) {
 
-      std::vector<art::Ptr<recob::Hit>> sliceHits        = fmSliceHits.at(pfpSlice.key());
-      std::vector<art::Ptr<recob::PFParticle>> slicePFPs = fmSlicePFPs.at(pfpSlice.key());
+      const std::vector<art::Ptr<recob::Hit>> &sliceHits        = fmSliceHits.at(pfpSlice.key());
+      const std::vector<art::Ptr<recob::PFParticle>> &slicePFPs = fmSlicePFPs.at(pfpSlice.key());
 
-      bool isNeutrinoSlice(false);
       float nuScore(-999);
-      long unsigned int pfpNu(-999);
+      art::Ptr<recob::PFParticle> pfpNeutrino;
       // Check if it is a neutrino slice, if so get some info from the pfp neutrino
       for (auto const &pfp : slicePFPs) {
         if (pfp->PdgCode() == 12 || pfp->PdgCode() == 14) {
-          pfpNu           = pfp->Self();
-          nuScore         = pfpNuScoreMap[pfpNu];
-          isNeutrinoSlice = true;
+          pfpNeutrino = pfp;
+          nuScore     = pfpNuScores[pfp.key()];
           break; // Should only be 1 neutrino per slice
         } // pfp->PdgCode()==12 || pfp->PdgCode()==14
       } // pfp:slicePFPs
+      const bool isNeutrinoSlice = pfpNeutrino.isNonnull();
 
       // Find the MCTruth that contains most of the hits from the slice
       float purity(-999), completeness(-999);
-      art::Ptr<simb::MCTruth> trueMatch = GetSliceTruthMatchHits(
-          clockData, sliceHits, particleTruthMap, truthHitMap, completeness, purity);
+      int trueMatch = GetSliceTruthMatchHits(clockData, sliceHits, completeness, purity);
 
       // Check if it matched to anything
-      if (trueMatch.isNull())
+      if (trueMatch < 0)
         continue;
 
       if (fVerbose && isNeutrinoSlice)
-        std::cout << "True Match: " << trueMatch << " with completeness: " << completeness
+        std::cout << "True Match: " << fTruths[trueMatch] << " with completeness: " << completeness
                   << " and purity: " << purity << " and score: " << nuScore << std::endl;
 
       // Increment the counters for the true match
-      ++pfpTruthSliceCounterMap[fPFParticleLabel][trueMatch];
+      ++sliceCounter[trueMatch];
       if (isNeutrinoSlice) {
-        ++pfpTruthNuCounterMap[fPFParticleLabel][trueMatch];
-        if (trueMatch->NeutrinoSet()) {
-          eventNeutrinoScores[fPFParticleLabel].push_back(nuScore);
+        ++nuCounter[trueMatch];
+        if (fTruths[trueMatch]->NeutrinoSet()) {
+          metrics.eventNeutrinoScores.push_back(nuScore);
         } else { // cosmicTruth
-          eventCosmicScores[fPFParticleLabel].push_back(nuScore);
+          metrics.eventCosmicScores.push_back(nuScore);
         } // trueMatch->NeutrinoSet()
       } // isNeutrinoSlice
 
       // Choose the best match slice, defined as the slice with the best completeness
-      if (completeness > pfpTruthSliceMatchMap[fPFParticleLabel][trueMatch].mComp) {
+      if (completeness > sliceMatch[trueMatch].mComp) {
         if (isNeutrinoSlice) {
 
-          art::Ptr<recob::PFParticle> pfpNeutrino = pfpMap.at(pfpNu);
-          art::Ptr<recob::Vertex> pfpVertex       = fopfv.at(pfpNeutrino.key());
-          double pfpVtx[3]                        = {-999, -999, -999};
+          art::Ptr<recob::Vertex> pfpVertex = fopfv.at(pfpNeutrino.key());
+          double pfpVtx[3]                  = {-999, -999, -999};
           pfpVertex->XYZ(pfpVtx);
 
-          SliceMatch match(pfpNu, pfpNeutrino->PdgCode(), completeness, purity, nuScore, pfpVtx);
-
-          pfpTruthSliceMatchMap[fPFParticleLabel][trueMatch] = match;
+          sliceMatch[trueMatch] = SliceMatch(pfpNeutrino->Self(), pfpNeutrino->PdgCode(),
+                                             completeness, purity, nuScore, pfpVtx);
 
         } else { // isNeutrinoSlice
-          double pfpVtx[3] = {-999, -999, -999};
-          SliceMatch match(-999, -999, completeness, purity, -999, pfpVtx);
-          pfpTruthSliceMatchMap[fPFParticleLabel][trueMatch] = match;
+          double pfpVtx[3]      = {-999, -999, -999};
+          sliceMatch[trueMatch] = SliceMatch(-999, -999, completeness, purity, -999, pfpVtx);
         } // else isNeutrinoSlice
       } // bestMatch
     } // pfpSlice:pfpSliceVec
-  } // auto const fPFParticleLabel: fPFParticleLabels
+  } // label: fPFParticleLabels
 
   eventTree->Fill();
 
@@ -419,6 +476,8 @@ void ana::PFPSliceValidation::analyze(art::Event const &evt) {
     if (!truth->NeutrinoSet())
       continue;
 
+    const int truthId = truthIndexMap.at(truth);
+
     // Get the truth interaction variables
     const simb::MCNeutrino neutrino = truth->GetNeutrino();
     const simb::MCParticle nu       = neutrino.Nu();
@@ -441,154 +500,137 @@ void ana::PFPSliceValidation::analyze(art::Event const &evt) {
     trueVertexZ = nu.Vz();
 
     // Number of true hits from the slice
-    numTrueHits = truthHitMap.at(truth);
+    numTrueHits = fTruthHits[truthId];
 
-    // Calculate the number of direct daughters
-    for (auto const &[particleId, truthIter] : particleTruthMap) {
-      if (truthIter != truth)
-        continue;
-      const simb::MCParticle *particle = trueParticlesMap.at(particleId);
-      // We only want the primary daughters
-      if (particle->Process() != "primary")
-        continue;
-      // Apply 21MeV KE cut on protons
-      if (particle->PdgCode() == 2212 && (particle->E() - particle->Mass()) > 0.021) {
-        ++numProtons;
-      } else if (std::abs(particle->PdgCode()) == 211) {
-        ++numPi;
-      } else if (std::abs(particle->PdgCode()) == 111) {
-        ++numPi0;
-      }
-    }
+    // Number of direct daughters
+    numProtons = truthDaughters[truthId].numProtons;
+    numPi      = truthDaughters[truthId].numPi;
+    numPi0     = truthDaughters[truthId].numPi0;
 
     if (fVerbose) {
       std::cout << "\nTruth: " << truth << std::endl;
     } // fVerbose
 
-    for (auto const &fPFParticleLabel : fPFParticleLabels) {
+    for (unsigned int label = 0; label < nLabels; ++label) {
+
+      LabelMetrics &metrics    = fLabelMetrics[label];
+      const unsigned int index = label * nTruths + truthId;
 
       // Check we actually match a slice to the truth
-      if (pfpTruthSliceCounterMap[fPFParticleLabel].at(truth)) {
+      if (pfpTruthSliceCounter[index]) {
 
-        SliceMatch match = pfpTruthSliceMatchMap[fPFParticleLabel][truth];
+        const SliceMatch &match = pfpTruthSliceMatch[index];
 
-        nuSlices[fPFParticleLabel]        = pfpTruthSliceCounterMap[fPFParticleLabel][truth];
-        nuNeutrinos[fPFParticleLabel]     = pfpTruthNuCounterMap[fPFParticleLabel][truth];
-        bestNuComp[fPFParticleLabel]      = match.mComp;
-        bestNuPurity[fPFParticleLabel]    = match.mPurity;
-        bestNuScore[fPFParticleLabel]     = match.mNuScore;
-        bestNuPdg[fPFParticleLabel]       = match.mRecoPdg;
-        nuMatchNeutrino[fPFParticleLabel] = (match.mRecoId != -999);
+        metrics.nuSlices        = pfpTruthSliceCounter[index];
+        metrics.nuNeutrinos     = pfpTruthNuCounter[index];
+        metrics.bestNuComp      = match.mComp;
+        metrics.bestNuPurity    = match.mPurity;
+        metrics.bestNuScore     = match.mNuScore;
+        metrics.bestNuPdg       = match.mRecoPdg;
+        metrics.nuMatchNeutrino = (match.mRecoId != -999);
 
         // If we matched a neutrino slice, get the vertex info
-        if (nuMatchNeutrino[fPFParticleLabel]) {
+        if (metrics.nuMatchNeutrino) {
 
-          pfpVertexX[fPFParticleLabel] = match.mVtxX;
-          pfpVertexY[fPFParticleLabel] = match.mVtxY;
-          pfpVertexZ[fPFParticleLabel] = match.mVtxZ;
+          metrics.pfpVertexX = match.mVtxX;
+          metrics.pfpVertexY = match.mVtxY;
+          metrics.pfpVertexZ = match.mVtxZ;
 
-          pfpVertexDistX[fPFParticleLabel] = pfpVertexX[fPFParticleLabel] - nu.Vx();
-          pfpVertexDistY[fPFParticleLabel] = pfpVertexY[fPFParticleLabel] - nu.Vy();
-          pfpVertexDistZ[fPFParticleLabel] = pfpVertexZ[fPFParticleLabel] - nu.Vz();
+          metrics.pfpVertexDistX = metrics.pfpVertexX - nu.Vx();
+          metrics.pfpVertexDistY = metrics.pfpVertexY - nu.Vy();
+          metrics.pfpVertexDistZ = metrics.pfpVertexZ - nu.Vz();
 
-          pfpVertexDistMag[fPFParticleLabel] =
-              std::hypot(pfpVertexDistX[fPFParticleLabel], pfpVertexDistY[fPFParticleLabel],
-                         pfpVertexDistZ[fPFParticleLabel]);
+          metrics.pfpVertexDistMag =
+              std::hypot(metrics.pfpVertexDistX, metrics.pfpVertexDistY, metrics.pfpVertexDistZ);
         } // nuMatchNeutrino
       } // pfpTruthSliceCounter
 
       if (fVerbose) {
-        std::cout << "PFParticleLabel: " << fPFParticleLabel << std::endl;
-
-        std::cout << "Nu Slices: " << nuSlices[fPFParticleLabel]
-                  << " and Nu Neutrinos: " << nuNeutrinos[fPFParticleLabel]
-                  << " with best Nu Pdg: " << bestNuPdg[fPFParticleLabel]
-                  << "\nCompleteness: " << bestNuComp[fPFParticleLabel]
-                  << " and purity: " << bestNuPurity[fPFParticleLabel]
-                  << " and score: " << bestNuScore[fPFParticleLabel] << std::endl;
+        std::cout << "PFParticleLabel: " << fPFParticleLabels[label] << std::endl;
+
+        std::cout << "Nu Slices: " << metrics.nuSlices
+                  << " and Nu Neutrinos: " << metrics.nuNeutrinos
+                  << " with best Nu Pdg: " << metrics.bestNuPdg
+                  << "\nCompleteness: " << metrics.bestNuComp
+                  << " and purity: " << metrics.bestNuPurity
+                  << " and score: " << metrics.bestNuScore << std::endl;
       } // fVerbose
-    } // fPFParticleLabel: fPFParticleLabels
+    } // label: fPFParticleLabels
     trueTree->Fill();
   } // truth: truthVec
   std::cout << "\n" << std::endl;
 } // analyze
 
-std::map<art::Ptr<simb::MCTruth>, int> ana::PFPSliceValidation::GetTruthHitMap(
-    const detinfo::DetectorClocksData &clockData, const sim::ParticleList &trueParticlesMap,
-    const std::map<int, art::Ptr<simb::MCTruth>> &particleTruthMap,
-    const std::vector<art::Ptr<recob::Hit>> &allHits) {
+int ana::PFPSliceValidation::BackTrackHit(const detinfo::DetectorClocksData &clockData,
+                                          const art::Ptr<recob::Hit> &hit) {
 
-  // Create a map of true particles to number of hits
-  std::map<int, int> trueParticleHits;
-  for (const auto &hit : allHits) {
-    int trackID     = 0;
-    float hitEnergy = 0;
-
-    // For each hit, chose the particle that contributed the most energy
-    std::vector<sim::TrackIDE> trackIDEs = bt_serv->HitToTrackIDEs(clockData, hit);
-    for (const auto &ide : trackIDEs) {
-      if (ide.energy > hitEnergy) {
-        hitEnergy = ide.energy;
-        trackID   = std::abs(ide.trackID);
-      } // ide.energy > hitEnergy
-    } // ide: trackIDEs
-    ++trueParticleHits[trackID];
-  } // hit: allHits
+  int trackID     = 0;
+  float hitEnergy = 0;
+
+  // For each hit, chose the particle that contributed the most energy
+  const std::vector<sim::TrackIDE> trackIDEs = bt_serv->HitToTrackIDEs(clockData, hit);
+  for (const auto &ide : trackIDEs) {
+    if (ide.energy > hitEnergy) {
+      hitEnergy = ide.energy;
+      trackID   = std::abs(ide.trackID);
+    } // ide.energy > hitEnergy
+  } // ide: trackIDEs
 
-  // Roll up the particles in their slices
-  std::map<art::Ptr<simb::MCTruth>, int> truthHitMap;
-  for (const auto &[trueParticle, truth] : particleTruthMap) {
-    truthHitMap[truth] += trueParticleHits[trueParticle];
-  } // [trueParticle, truth]: particleTruthMap
+  // Roll the particle up into its truth
+  auto const iter = fTrackTruth.find(trackID);
+  return iter == fTrackTruth.end() ? -1 : iter->second;
+} // BackTrackHit
 
-  return truthHitMap;
-} // GetTruthHitMap
+int ana::PFPSliceValidation::HitTruthIndex(const detinfo::DetectorClocksData &clockData,
+                                           const art::Ptr<recob::Hit> &hit) {
 
-art::Ptr<simb::MCTruth> ana::PFPSliceValidation::GetSliceTruthMatchHits(
+  // Hits from the event hit collection were all backtracked up front
+  if (hit.id() == fHitProductID && hit.key() < fHitTruth.size())
+    return fHitTruth[hit.key()];
+
+  // Anything else is backtracked the first time we see it
+  auto const hitId            = std::make_pair(hit.id(), hit.key());
+  auto const [iter, inserted] = fOtherHitTruth.emplace(hitId, -1);
+  if (inserted)
+    iter->second = BackTrackHit(clockData, hit);
+
+  return iter->second;
+} // HitTruthIndex
+
+int ana::PFPSliceValidation::GetSliceTruthMatchHits(
     const detinfo::DetectorClocksData &clockData,
-    const std::vector<art::Ptr<recob::Hit>> &sliceHits,
-    const std::map<int, art::Ptr<simb::MCTruth>> &particleTruthMap,
-    const std::map<art::Ptr<simb::MCTruth>, int> &truthHitMap, float &completeness, float &purity) {
+    const std::vector<art::Ptr<recob::Hit>> &sliceHits, float &completeness, float &purity) {
 
-  // Create a map of true particles to number of hits
-  std::map<int, int> trueParticleHits;
+  // Count the number of hits from each truth, remembering which truths we touched
+  fSliceTruths.clear();
   for (const auto &hit : sliceHits) {
-    int trackID     = 0;
-    float hitEnergy = 0;
-
-    // For each hit, chose the particle that contributed the most energy
-    std::vector<sim::TrackIDE> trackIDEs = bt_serv->HitToTrackIDEs(clockData, hit);
-    for (const auto &ide : trackIDEs) {
-      if (ide.energy > hitEnergy) {
-        hitEnergy = ide.energy;
-        trackID   = std::abs(ide.trackID);
-      } // ide.energy > hitEnergy
-    } // ide: trackIDEs
-    ++trueParticleHits[trackID];
+    int truth = HitTruthIndex(clockData, hit);
+    if (truth < 0)
+      continue;
+    if (fSliceTruthHits[truth]++ == 0)
+      fSliceTruths.push_back(truth);
   } // hit: sliceHits
 
-  // Roll up the particles in their slices
-  std::map<art::Ptr<simb::MCTruth>, int> sliceTruthHitMap;
-  for (const auto &[trueParticle, truth] : particleTruthMap) {
-    sliceTruthHitMap[truth] += trueParticleHits[trueParticle];
-  } // [trueParticle, truth]: particleTruthMap
-
-  // Choose the truth that contributed the most hits
-  int maxHits = 0;
-  art::Ptr<simb::MCTruth> bestTruthMatch;
-  for (const auto &[truth, truthHits] : sliceTruthHitMap) {
-    if (truthHits > maxHits) {
+  // Choose the truth that contributed the most hits, ties go to the lowest Ptr
+  // Reset the scratch counts as we go
+  int maxHits        = 0;
+  int bestTruthMatch = -1;
+  for (const int truth : fSliceTruths) {
+    const int truthHits = fSliceTruthHits[truth];
+    if (truthHits > maxHits ||
+        (truthHits == maxHits && fTruths[truth] < fTruths[bestTruthMatch])) {
       maxHits        = truthHits;
       bestTruthMatch = truth;
     } // truthHits > maxHuts
-  } // [truth, truthHits]: sliceTruthHitMap
+    fSliceTruthHits[truth] = 0;
+  } // truth: fSliceTruths
 
   // If we have truth matched the slice, calculate purtity and completeness
   // Note these are passed by referecne
-  if (!bestTruthMatch.isNull()) {
+  if (bestTruthMatch >= 0) {
     purity       = (float)maxHits / sliceHits.size();
-    completeness = (float)maxHits / truthHitMap.at(bestTruthMatch);
-  } // !bestTruthMatch.isNull()
+    completeness = (float)maxHits / fTruthHits[bestTruthMatch];
+  } // bestTruthMatch >= 0
 
   return bestTruthMatch;
 } // GetSliceTruthMatchHits
@@ -616,47 +658,46 @@ void ana::PFPSliceValidation::ClearTrueTree() {
   trueVertexY = -999;
   trueVertexZ = -999;
 
-  for (auto const &fPFParticleLabel : fPFParticleLabels) {
-
-    nuMatchNeutrino[fPFParticleLabel] = false;
-    nuSlices[fPFParticleLabel]        = -99999;
-    nuNeutrinos[fPFParticleLabel]     = -99999;
-    bestNuPurity[fPFParticleLabel]    = -99999;
-    bestNuComp[fPFParticleLabel]      = -99999;
-    bestNuScore[fPFParticleLabel]     = -99999;
-    bestNuPdg[fPFParticleLabel]       = -99999;
-
-    pfpVertexX[fPFParticleLabel] = -99999;
-    pfpVertexY[fPFParticleLabel] = -99999;
-    pfpVertexZ[fPFParticleLabel] = -99999;
-
-    pfpVertexDistX[fPFParticleLabel]   = -99999;
-    pfpVertexDistY[fPFParticleLabel]   = -99999;
-    pfpVertexDistZ[fPFParticleLabel]   = -99999;
-    pfpVertexDistMag[fPFParticleLabel] = -99999;
-  } // fPFParticleLabel: fPFParticleLabels
+  for (auto &metrics : fLabelMetrics) {
+
+    metrics.nuMatchNeutrino = false;
+    metrics.nuSlices        = -99999;
+    metrics.nuNeutrinos     = -99999;
+    metrics.bestNuPurity    = -99999;
+    metrics.bestNuComp      = -99999;
+    metrics.bestNuScore     = -99999;
+    metrics.bestNuPdg       = -99999;
+
+    metrics.pfpVertexX = -99999;
+    metrics.pfpVertexY = -99999;
+    metrics.pfpVertexZ = -99999;
+
+    metrics.pfpVertexDistX   = -99999;
+    metrics.pfpVertexDistY   = -99999;
+    metrics.pfpVertexDistZ   = -99999;
+    metrics.pfpVertexDistMag = -99999;
+  } // metrics: fLabelMetrics
 } // ClearTrueTree
 
 void ana::PFPSliceValidation::ClearEventTree() {
   eventTrueNeutrinos = -999;
-  for (auto const &fPFParticleLabel : fPFParticleLabels) {
-    eventPFPNeutrinos[fPFParticleLabel] = -999;
-    eventPFPSlices[fPFParticleLabel]    = -999;
-    eventCosmicScores[fPFParticleLabel].clear();
-    eventNeutrinoScores[fPFParticleLabel].clear();
-  } // fPFParticleLabel: fPFParticleLabels
+  for (auto &metrics : fLabelMetrics) {
+    metrics.eventPFPNeutrinos = -999;
+    metrics.eventPFPSlices    = -999;
+    metrics.eventCosmicScores.clear();
+    metrics.eventNeutrinoScores.clear();
+  } // metrics: fLabelMetrics
 } // ClearEventTree
 
 template <class T>
 void ana::PFPSliceValidation::initTree(TTree *Tree, std::string branchName,
-                                       std::map<std::string, T> &Metric,
-                                       std::vector<std::string> fPFParticleLabels) {
+                                       T LabelMetrics::*Metric) {
 
-  for (auto const &fPFParticleLabel : fPFParticleLabels) {
-    std::string branchString = branchName + "_" + fPFParticleLabel;
+  for (unsigned int label = 0; label < fPFParticleLabels.size(); ++label) {
+    std::string branchString = branchName + "_" + fPFParticleLabels[label];
     const char *branchChar   = branchString.c_str();
-    Tree->Branch(branchChar, &Metric[fPFParticleLabel], 32000, 0);
-  } // fPFParticleLabel: fPFParticleLabels
+    Tree->Branch(branchChar, &(fLabelMetrics[label].*Metric), 32000, 0);
+  } // label: fPFParticleLabels
 } // initTree
 
 DEFINE_ART_MODULE(ana::PFPSliceValidation)
@@ -104,10 +104,32 @@
 #include <iterator>
 #include <map>
 #include <memory>
+#include <algorithm>
 
 using namespace std;
 
 namespace sbnd{
+
+// (time, id) pairs sorted by time, answering coincidence window queries
+struct TimeIndex {
+  std::vector<std::pair<double, size_t>> entries;
+
+  void Add(double t, size_t id) { entries.emplace_back(t, id); }
+  void Sort() { std::sort(entries.begin(), entries.end()); }
+
+  // ids with a time around t +- window, in ascending id order so the callers'
+  // selection loops see them as in a full scan. The range is padded slightly
+  // and the exact coincidence test is left to the caller
+  void Query(double t, double window, std::vector<size_t>& ids) const {
+    constexpr double kSlack = 1e-3; // ns
+    ids.clear();
+    auto it = std::lower_bound(entries.begin(), entries.end(), t - window - kSlack,
+                               [](const std::pair<double, size_t>& e, double v){ return e.first < v; });
+    for(; it != entries.end() && it->first <= t + window + kSlack; ++it)
+      ids.push_back(it->second);
+    std::sort(ids.begin(), ids.end());
+  }
+};
 	
 class ToFProducer : public art::EDProducer {
 public:
@@ -216,22 +238,105 @@ void ToFProducer::produce(art::Event& evt)
  map<int, std::vector<art::Ptr<recob::OpFlash>> > tof_op_flashes;
  map<int, std::vector<int>> tof_op_tpc;
  
+ //==================================================================
+ 
+ // Optical hits and flashes are read, associated and time ordered once per event,
+ // each CRT space point then only looks at the entries inside its coincidence window
+ 
+ art::Handle< std::vector<recob::OpHit> > opHitListHandle;
+ std::vector< art::Ptr<recob::OpHit> >    opHitList;
+ if( evt.getByLabel(fOpHitModuleLabel,opHitListHandle) )
+     art::fill_ptr_vector(opHitList, opHitListHandle);
+ 
+ std::map<int, art::Handle< std::vector<recob::OpFlash> > > flashHandles;
+ std::map<int,std::vector< art::Ptr<recob::OpFlash> >> opFlashLists;
+ 
+ if(fLFlash || fCFlash || fLFlash_hit || fCFlash_hit){
+     for(int i=0; i<2; i++) {
+         if( evt.getByLabel(fFlashLabels[i],flashHandles[i]) )
+             art::fill_ptr_vector(opFlashLists[i], flashHandles[i]);
+     }
+ }
+ 
+ // (tpc, key) of every flash, in the order the flash lists are visited
+ std::vector<std::pair<int, size_t>> flashRefs;
+ for(auto const& flashList : opFlashLists){
+     for(size_t iflash=0; iflash<flashList.second.size(); iflash++)
+         flashRefs.push_back({flashList.first, iflash});
+ }
+ 
+ // earliest associated optical hit of each flash, -1 if it has none
+ std::vector<int> flashEarliestHit(flashRefs.size(), -1);
+ if(fLFlash_hit || fCFlash_hit){
+     size_t iref = 0;
+     for(auto const& flashList : opFlashLists){
+         art::FindManyP<recob::OpHit> findManyOpHits(flashHandles[flashList.first], evt, fFlashLabels[flashList.first]);
+         for(size_t iflash=0; iflash<flashList.second.size(); iflash++, iref++){
+             double flashMinHitT = DBL_MAX;
+             for(auto const& hit : findManyOpHits.at(flashList.second[iflash].key())){
+                 double tPmt = hit->PeakTime()*1e3-fOpDelay;
+                 if(tPmt < flashMinHitT){
+                    flashMinHitT = tPmt;
+                    flashEarliestHit[iref] = hit.key();
+                 } // getting the earliest hit
+             } // loop over associated ophits of the flash
+         }
+     }
+ }
+ 
+ TimeIndex hitIndex, flashIndex, flashAbsIndex;
+ if(fLhit || fChit){
+     for(auto const& hit : opHitList){
+         if(hit->PE()<fHitPeThresh) continue;
+         hitIndex.Add(hit->PeakTime()*1e3-fOpDelay, hit.key());
+     }
+     hitIndex.Sort();
+ }
+ for(size_t iref=0; iref<flashRefs.size(); iref++){
+     auto const& flash = opFlashLists[flashRefs[iref].first][flashRefs[iref].second];
+     if(flash->TotalPE()<fFlashPeThresh) continue;
+     flashIndex.Add(flash->Time()*1e3-fOpDelay, iref);
+     if(fLFlash_hit) flashAbsIndex.Add(flash->AbsTime()*1e3-fOpDelay, iref);
+ }
+ flashIndex.Sort();
+ flashAbsIndex.Sort();
+ 
+ // track space points ordered by time, then track, to find the first track holding a CRT space point
+ struct TrackSP {
+     double time;
+     size_t itrk;
+     size_t isp;
+ };
+ std::vector<TrackSP> trackSPs;
+ for(size_t itrk=0; itrk<tracksps.size(); itrk++){
+     for(size_t isp=0; isp<tracksps[itrk].size(); isp++)
+         trackSPs.push_back({tracksps[itrk][isp]->Time(), itrk, isp});
+ }
+ std::sort(trackSPs.begin(), trackSPs.end(),
+ [](const TrackSP& a, const TrackSP& b)->bool
+ {
+    if(a.time != b.time) return a.time < b.time;
+    if(a.itrk != b.itrk) return a.itrk < b.itrk;
+    return a.isp < b.isp;
+ });
+ 
+ std::vector<size_t> candidates;
+ 
  for(auto const& crt : crtSPList){	 
      if(!(crt->Time() >= fBeamLow &&  crt->Time()<= fBeamUp)) continue;
      if(crt->PE() < fCRTSpacePointThresh) continue;
      
      bool frm_trk=false;
-     int index=0;
+     int index=tracksps.size();
      
-     for(auto const& trksps: tracksps){
-	 for(size_t isp=0; isp<trksps.size(); isp++){
-	   if(SpacePointCompare(trksps[isp],crt)){
-		frm_trk=true;
-		break;
-	     }
-	  }
-	  if(frm_trk) break;
-	  index++;
+     auto trkSP = std::lower_bound(trackSPs.begin(), trackSPs.end(), crt->Time(),
+                                   [](const TrackSP& sp, double t){ return sp.time < t; });
+     for(; trkSP != trackSPs.end() && trkSP->time == crt->Time(); ++trkSP){
+	 if(SpacePointCompare(tracksps[trkSP->itrk][trkSP->isp],crt)){
+	      frm_trk=true;
+	      index=trkSP->itrk;
+	      break;
+	 }
      }
      
      // ================================== Calculatin ToF values using Largest optical hit method =========================
@@ -241,13 +346,9 @@ void ToFProducer::produce(art::Event& evt)
 	bool found_tof = false;
 	int ophit_index = -1;
 	
-	art::Handle< std::vector<recob::OpHit> > opHitListHandle;
-        std::vector< art::Ptr<recob::OpHit> >    opHitList;
-        if( evt.getByLabel(fOpHitModuleLabel,opHitListHandle) )
-            art::fill_ptr_vector(opHitList, opHitListHandle);
-	
-	for(auto const& hit : opHitList){
-	    if(hit->PE()<fHitPeThresh) continue;
+	hitIndex.Query(crt->Time(), fCoinWindow, candidates);
+	for(auto const ihit : candidates){
+	    auto const& hit = opHitList[ihit];
 	    double thit = hit->PeakTime()*1e3-fOpDelay;
 	    
 	    if(abs(crt->Time()-thit)<fCoinWindow && hit->PE()>pehit_max){
@@ -255,7 +356,7 @@ void ToFProducer::produce(art::Event& evt)
 	       ophit_index = hit.key();
 	       found_tof = true;
 	    }
-	} // loop over optical hit list
+	} // loop over optical hits in the window
 	
 	if(found_tof){	
 	    if(frm_trk){	    
@@ -287,13 +388,9 @@ void ToFProducer::produce(art::Event& evt)
 	bool found_tof = false;
 	int ophit_index = -1;
 	
-	art::Handle< std::vector<recob::OpHit> > opHitListHandle;
-        std::vector< art::Ptr<recob::OpHit> >    opHitList;
-        if( evt.getByLabel(fOpHitModuleLabel,opHitListHandle) )
-            art::fill_ptr_vector(opHitList, opHitListHandle);
-	
-	for(auto const& hit : opHitList){
-	    if(hit->PE()<fHitPeThresh) continue;
+	hitIndex.Query(crt->Time(), fCoinWindow, candidates);
+	for(auto const ihit : candidates){
+	    auto const& hit = opHitList[ihit];
 	    double thit = hit->PeakTime()*1e3-fOpDelay;
 	    
 	    if(abs(crt->Time()-thit)<fCoinWindow && abs(crt->Time()-thit)<ophit_minTOF){
@@ -301,7 +398,7 @@ void ToFProducer::produce(art::Event& evt)
 	       ophit_index = hit.key();
 	       found_tof = true;
 	    }
-	} // loop over optical hit list
+	} // loop over optical hits in the window
 	
 	if(found_tof){	
 	    if(frm_trk){	    
@@ -334,27 +431,17 @@ void ToFProducer::produce(art::Event& evt)
 	int opflash_index = -1;
 	int flash_tpc = -1;
 	
-	std::map<int, art::Handle< std::vector<recob::OpFlash> > > flashHandles;
-        std::map<int,std::vector< art::Ptr<recob::OpFlash> >> opFlashLists;
-	
-	for(int i=0; i<2; i++) {
-            if( evt.getByLabel(fFlashLabels[i],flashHandles[i]) )
-                art::fill_ptr_vector(opFlashLists[i], flashHandles[i]);
-        }
-	
-	for(auto const& flashList : opFlashLists){
-	    for(size_t iflash=0; iflash<flashList.second.size(); iflash++){
-	        auto const& flash = flashList.second[iflash];
-		if(flash->TotalPE()<fFlashPeThresh) continue;
-		double tflash = flash->Time()*1e3-fOpDelay;
-		if(abs(crt->Time()-tflash)<fCoinWindow && flash->TotalPE()>peflash_max){
-		   peflash_max=flash->TotalPE();
-		   opflash_index = flash.key();	
-		   found_tof = true;
-		   flash_tpc = flashList.first;
-		} // with in conincidence window and getting the largest flash
-	    } // loop over flash list
-	} // loop over flash list map
+	flashIndex.Query(crt->Time(), fCoinWindow, candidates);
+	for(auto const iref : candidates){
+	    auto const& flash = opFlashLists[flashRefs[iref].first][flashRefs[iref].second];
+	    double tflash = flash->Time()*1e3-fOpDelay;
+	    if(abs(crt->Time()-tflash)<fCoinWindow && flash->TotalPE()>peflash_max){
+	       peflash_max=flash->TotalPE();
+	       opflash_index = flash.key();	
+	       found_tof = true;
+	       flash_tpc = flashRefs[iref].first;
+	    } // with in conincidence window and getting the largest flash
+	} // loop over flashes in the window
 	
 	if(found_tof){
 	   if(frm_trk){	    
@@ -389,27 +476,17 @@ void ToFProducer::produce(art::Event& evt)
 	int opflash_index = -1;
 	int flash_tpc = -1;
 	
-	std::map<int, art::Handle< std::vector<recob::OpFlash> > > flashHandles;
-        std::map<int,std::vector< art::Ptr<recob::OpFlash> >> opFlashLists;
-	
-	for(int i=0; i<2; i++) {
-            if( evt.getByLabel(fFlashLabels[i],flashHandles[i]) )
-                art::fill_ptr_vector(opFlashLists[i], flashHandles[i]);
-        }
-	
-	for(auto const& flashList : opFlashLists){
-	    for(size_t iflash=0; iflash<flashList.second.size(); iflash++){
-	        auto const& flash = flashList.second[iflash];
-		if(flash->TotalPE()<fFlashPeThresh) continue;
-		double tflash = flash->Time()*1e3-fOpDelay;
-		if(abs(crt->Time()-tflash)<fCoinWindow && abs(crt->Time()-tflash)<flash_minTOF){
-		   flash_minTOF= abs(crt->Time()-tflash);
-		   opflash_index = flash.key();	
-		   found_tof = true;
-		   flash_tpc = flashList.first;
-		} // with in conincidence window and getting the largest flash
-	    } // loop over flash list
-	} // loop over flash list map
+	flashIndex.Query(crt->Time(), fCoinWindow, candidates);
+	for(auto const iref : candidates){
+	    auto const& flash = opFlashLists[flashRefs[iref].first][flashRefs[iref].second];
+	    double tflash = flash->Time()*1e3-fOpDelay;
+	    if(abs(crt->Time()-tflash)<fCoinWindow && abs(crt->Time()-tflash)<flash_minTOF){
+	       flash_minTOF= abs(crt->Time()-tflash);
+	       opflash_index = flash.key();	
+	       found_tof = true;
+	       flash_tpc = flashRefs[iref].first;
+	    } // with in conincidence window and getting the closest flash
+	} // loop over flashes in the window
 	
 	if(found_tof){
 	   if(frm_trk){	    
@@ -445,42 +522,18 @@ void ToFProducer::produce(art::Event& evt)
 	int flash_tpc = -1;
 	int ophit_index = -1;
 	
-	std::map<int, art::Handle< std::vector<recob::OpFlash> > > flashHandles;
-        std::map<int,std::vector< art::Ptr<recob::OpFlash> >> opFlashLists;
-	
-	for(int i=0; i<2; i++) {
-            if( evt.getByLabel(fFlashLabels[i],flashHandles[i]) )
-                art::fill_ptr_vector(opFlashLists[i], flashHandles[i]);
-        }
-	
-	art::Handle< std::vector<recob::OpHit> > opHitListHandle;
-        std::vector< art::Ptr<recob::OpHit> >    opHitList;
-        if( evt.getByLabel(fOpHitModuleLabel,opHitListHandle) )
-            art::fill_ptr_vector(opHitList, opHitListHandle);
-	
-	for(auto const& flashList : opFlashLists){	
-	    art::FindManyP<recob::OpHit> findManyOpHits(flashHandles[flashList.first], evt, fFlashLabels[flashList.first]);	
-	    for(size_t iflash=0; iflash<flashList.second.size(); iflash++){
-	        auto const& flash = flashList.second[iflash];
-		if(flash->TotalPE()<fFlashPeThresh) continue;
-		double tflash = flash->AbsTime()*1e3-fOpDelay;
-		if(abs(crt->Time()-tflash)<fCoinWindow && flash->TotalPE()>peflash_max){
-		   peflash_max=flash->TotalPE();
-		   opflash_index = flash.key();	
-		   found_tof = true;
-		   flash_tpc = flashList.first;
-		   vector<art::Ptr<recob::OpHit>> hits = findManyOpHits.at(flash.key());
-		   double flashMinHitT = DBL_MAX;
-		   for(auto const& hit : hits){
-		       double tPmt = hit->PeakTime()*1e3-fOpDelay; 
-		       if(tPmt < flashMinHitT){
-			  flashMinHitT = tPmt;
-			  ophit_index =  hit.key();    
-		       } // getting the earliest hit
-		   } // loop over associated ophits of the flash
-		} // with in conincidence window and getting the largest flash
-	    } // loop over flash list
-	} // loop over flash list map
+	flashAbsIndex.Query(crt->Time(), fCoinWindow, candidates);
+	for(auto const iref : candidates){
+	    auto const& flash = opFlashLists[flashRefs[iref].first][flashRefs[iref].second];
+	    double tflash = flash->AbsTime()*1e3-fOpDelay;
+	    if(abs(crt->Time()-tflash)<fCoinWindow && flash->TotalPE()>peflash_max){
+	       peflash_max=flash->TotalPE();
+	       opflash_index = flash.key();	
+	       found_tof = true;
+	       flash_tpc = flashRefs[iref].first;
+	       if(flashEarliestHit[iref] >= 0) ophit_index = flashEarliestHit[iref];
+	    } // with in conincidence window and getting the largest flash
+	} // loop over flashes in the window
 	
 	if(found_tof){
 	   if(frm_trk){	    
@@ -518,42 +571,18 @@ void ToFProducer::produce(art::Event& evt)
 	int flash_tpc = -1;
 	int ophit_index = -1;
 	
-	std::map<int, art::Handle< std::vector<recob::OpFlash> > > flashHandles;
-        std::map<int,std::vector< art::Ptr<recob::OpFlash> >> opFlashLists;
-	
-	for(int i=0; i<2; i++) {
-            if( evt.getByLabel(fFlashLabels[i],flashHandles[i]) )
-                art::fill_ptr_vector(opFlashLists[i], flashHandles[i]);
-        }
-	
-	art::Handle< std::vector<recob::OpHit> > opHitListHandle;
-        std::vector< art::Ptr<recob::OpHit> >    opHitList;
-        if( evt.getByLabel(fOpHitModuleLabel,opHitListHandle) )
-            art::fill_ptr_vector(opHitList, opHitListHandle);
-	
-	for(auto const& flashList : opFlashLists){	
-	    art::FindManyP<recob::OpHit> findManyOpHits(flashHandles[flashList.first], evt, fFlashLabels[flashList.first]);	
-	    for(size_t iflash=0; iflash<flashList.second.size(); iflash++){
-	        auto const& flash = flashList.second[iflash];
-		if(flash->TotalPE()<fFlashPeThresh) continue;
-		double tflash = flash->Time()*1e3-fOpDelay;
-		if(abs(crt->Time()-tflash)<fCoinWindow && abs(crt->Time()-tflash)<flash_minTOF){
-		   flash_minTOF= abs(crt->Time()-tflash);
-		   opflash_index = flash.key();	
-		   found_tof = true;
-		   flash_tpc = flashList.first;
-		   vector<art::Ptr<recob::OpHit>> hits = findManyOpHits.at(flash.key());
-		   double flashMinHitT = DBL_MAX;
-		   for(auto const& hit : hits){
-		       double tPmt = hit->PeakTime()*1e3-fOpDelay; 
-		       if(tPmt < flashMinHitT){
-			  flashMinHitT = tPmt;
-			  ophit_index =  hit.key();    
-		       } // getting the earliest hit
-		   } // loop over associated ophits of the flash
-		} // with in conincidence window and getting the largest flash
-	    } // loop over flash list
-	} // loop over flash list map
+	flashIndex.Query(crt->Time(), fCoinWindow, candidates);
+	for(auto const iref : candidates){
+	    auto const& flash = opFlashLists[flashRefs[iref].first][flashRefs[iref].second];
+	    double tflash = flash->Time()*1e3-fOpDelay;
+	    if(abs(crt->Time()-tflash)<fCoinWindow && abs(crt->Time()-tflash)<flash_minTOF){
+	       flash_minTOF= abs(crt->Time()-tflash);
+	       opflash_index = flash.key();	
+	       found_tof = true;
+	       flash_tpc = flashRefs[iref].first;
+	       if(flashEarliestHit[iref] >= 0) ophit_index = flashEarliestHit[iref];
+	    } // with in conincidence window and getting the closest flash
+	} // loop over flashes in the window
 	
 	if(found_tof){
 	   if(frm_trk){	    
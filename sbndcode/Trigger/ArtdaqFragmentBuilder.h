@@ -0,0 +1,96 @@
+#ifndef SBND_TRIGGER_ARTDAQFRAGMENTBUILDER_H
+#define SBND_TRIGGER_ARTDAQFRAGMENTBUILDER_H
+
+////////////////////////////////////////////////////////////////////////
+// ArtdaqFragmentBuilder.h
+//
+// Helpers for building artdaq fragments directly in the output vector
+// of the fragment producers. Fragments are emplaced in place and the
+// payloads written straight into the fragment buffer, avoiding the
+// temporary FragmentPtr and the copy into the vector.
+////////////////////////////////////////////////////////////////////////
+
+// artdaq includes
+#include "sbndaq-artdaq-core/Overlays/Common/CAENV1730Fragment.hh"
+#include "artdaq-core/Data/Fragment.hh"
+
+// C++ includes
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace sbnd {
+  namespace trigger {
+
+    // Emplace a fragment with a payload of payloadBytes at the back of frags
+    // Equivalent to artdaq::Fragment::FragmentBytes but without the copy
+    template<class Metadata>
+    artdaq::Fragment& EmplaceFragmentBytes(std::vector<artdaq::Fragment>& frags,
+                                           std::size_t payloadBytes,
+                                           artdaq::Fragment::sequence_id_t sequenceID,
+                                           artdaq::Fragment::fragment_id_t fragmentID,
+                                           artdaq::Fragment::type_t type,
+                                           Metadata const& metadata,
+                                           artdaq::Fragment::timestamp_t timestamp = artdaq::Fragment::InvalidTimestamp)
+    {
+      artdaq::Fragment& frag = frags.emplace_back(sequenceID, fragmentID, type, metadata, timestamp);
+      frag.resizeBytes(payloadBytes);
+      return frag;
+    }
+
+    // Typed pointer to the payload of a fragment, offsetBytes into it
+    template<class T>
+    T* FragmentPayload(artdaq::Fragment& frag, std::size_t offsetBytes = 0)
+    {
+      return reinterpret_cast<T*>(frag.dataBeginBytes() + offsetBytes);
+    }
+
+    // Writes the payload of a CAEN V1730 fragment in place: event header
+    // followed by nChannels blocks of nSamples 16 bit samples
+    class CAENV1730PayloadWriter {
+    public:
+
+      CAENV1730PayloadWriter(artdaq::Fragment& frag, std::size_t nSamples)
+        : fHeader(FragmentPayload<sbndaq::CAENV1730EventHeader>(frag))
+        , fData(FragmentPayload<uint16_t>(frag, sizeof(sbndaq::CAENV1730EventHeader)))
+        , fNSamples(nSamples)
+      {
+      }
+
+      sbndaq::CAENV1730EventHeader& Header() { return *fHeader; }
+
+      uint16_t* Channel(std::size_t channel) { return fData + channel*fNSamples; }
+
+      // Set every sample of a channel to value
+      void FillChannel(std::size_t channel, uint16_t value)
+      {
+        std::fill_n(Channel(channel), fNSamples, value);
+      }
+
+      // Add a span of n samples, whose first sample sits at index spanStart of the
+      // full readout, on top of a channel window starting at index windowStart.
+      // Samples are baseline subtracted so overlapping spans sum as in the readout
+      template<class Sample>
+      void AddSpan(std::size_t channel, long windowStart,
+                   Sample const* samples, std::size_t n, long spanStart, int baseline)
+      {
+        long begin = std::max(windowStart, spanStart);
+        long end = std::min(windowStart + (long)fNSamples, spanStart + (long)n);
+        uint16_t* dest = Channel(channel);
+        for (long i = begin; i < end; i++) {
+          dest[i - windowStart] = (uint16_t)(dest[i - windowStart] + (samples[i - spanStart] - baseline));
+        }
+      }
+
+    private:
+
+      sbndaq::CAENV1730EventHeader* fHeader;
+      uint16_t* fData;
+      std::size_t fNSamples;
+
+    };
+
+  }
+}
+
+#endif
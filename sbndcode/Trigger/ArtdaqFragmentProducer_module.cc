@@ -18,6 +18,7 @@
 #include "sbnobj/Common/CRT/CRTHit.hh"
 #include "sbnobj/Common/CRT/CRTTrack.hh"
 #include "sbndcode/CRT/CRTUtils/CRTCommonUtils.h"
+#include "sbndcode/Trigger/ArtdaqFragmentBuilder.h"
 #include "sbndcode/OpDetSim/sbndPDMapAlg.hh"
 #include "sbnobj/SBND/Trigger/pmtTrigger.hh"
 
@@ -74,6 +75,7 @@
 #include <string>
 #include <random>
 #include <iomanip>
+#include <cmath>
 
 namespace sbnd {
   namespace trigger {
@@ -117,13 +119,11 @@ private:
     num_channels = 32
   };
 
-  //arrays to store FEBinfo by module (want one fragment per module per event)
-  std::string taggers[num_febs];
-  uint16_t feb_hits_in_fragments[num_febs];
-  uint16_t ADCs[num_febs][max_hits_in_fragment][num_channels];
-  uint32_t T0s[num_febs][max_hits_in_fragment];
-  uint32_t T1s[num_febs][max_hits_in_fragment];
-  bool empty_fragment[num_febs];
+  //FEBData indices by module/mac5 (want one fragment per module per event)
+  std::vector<size_t> fFEBHitIndices[num_febs];
+
+  //fragment ID of each module from its tagger, indexed by mac5 - fFirstFEBMac5
+  std::vector<uint16_t> fFragmentIDs;
 
 
   // Other variables shared between different methods.
@@ -144,9 +144,10 @@ private:
   // PD information
   opdet::sbndPDMapAlg pdMap; // photon detector map
   std::vector<unsigned int> channelList;
+  std::vector<int> fChannelIndex; // position in channelList by channel number, -1 if not a PMT
 
-  // waveforms
-  std::vector<std::vector<short>> wvf_channel;
+  // waveforms of each PMT channel, with the index of their first sample in the readout window
+  std::vector<std::vector<std::pair<long, raw::OpDetWaveform const*>>> wvf_channel;
 
   // sampling rate
   double fSampling;
@@ -185,6 +186,13 @@ sbnd::trigger::ArtdaqFragmentProducer::ArtdaqFragmentProducer(fhicl::ParameterSe
   // Get a pointer to the fGeometryServiceetry service provider
   fGeometryService = lar::providerFrom<geo::Geometry>();
 
+  // fragment IDs only depend on the geometry, work them out once
+  for (size_t feb_i = fFirstFEBMac5; feb_i < fCrtGeo.NumModules()+fFirstFEBMac5; feb_i++){
+    std::string stripName = fCrtGeo.ChannelToStripName(feb_i * 32);
+    sbnd::crt::CRTTagger tagger_num = sbnd::crt::CRTCommonUtils::GetTaggerEnum(fCrtGeo.GetTaggerName(stripName));
+    fFragmentIDs.push_back(32768 + 12288 + (tagger_num * 256) + (uint16_t)feb_i);
+  }
+
   // get clock
   auto const clockData = art::ServiceHandle<detinfo::DetectorClocksService const>()->DataForJob();
   fSampling = clockData.OpticalClock().Frequency(); // MHz
@@ -196,6 +204,11 @@ sbnd::trigger::ArtdaqFragmentProducer::ArtdaqFragmentProducer(fhicl::ParameterSe
   for(auto const& i:pmtMap){
     channelList.push_back(i["channel"]);
   }
+  for (size_t i_ch = 0; i_ch < channelList.size(); i_ch++){
+    if (channelList[i_ch] >= fChannelIndex.size()) fChannelIndex.resize(channelList[i_ch]+1, -1);
+    fChannelIndex[channelList[i_ch]] = i_ch;
+  }
+  wvf_channel.resize(channelList.size());
 
 }
 
@@ -218,8 +231,6 @@ void sbnd::trigger::ArtdaqFragmentProducer::produce(art::Event& e)
     //                                          CRT
     //----------------------------------------------------------------------------------------------------------
 
-    for(int i=0; i<num_febs; i++){empty_fragment[i]=true;}
-
     int num_module = fCrtGeo.NumModules();
 
     //----------------------------------------------------------------------------------------------------------
@@ -235,16 +246,11 @@ void sbnd::trigger::ArtdaqFragmentProducer::produce(art::Event& e)
       throw art::Exception(art::errors::Configuration) << "could not locate FEBData." << std::endl;;
     }
 
-    std::vector<art::Ptr<sbnd::crt::FEBData>> feb_data_v;
-    art::fill_ptr_vector(feb_data_v, feb_data_h);
-
-    art::FindManyP<sim::AuxDetIDE, sbnd::crt::FEBTruthInfo> febdata_to_ides (feb_data_h, e, fFEBDataLabel);
+    std::vector<sbnd::crt::FEBData> const& feb_data_v = *feb_data_h;
 
-    //Fill arrays with default values
-    std::fill(feb_hits_in_fragments, feb_hits_in_fragments + sizeof(feb_hits_in_fragments), 0);
-
-    // fragments vector
+    // fragments vector, one fragment per module
     std::unique_ptr<std::vector<artdaq::Fragment>> vecFrag = std::make_unique<std::vector<artdaq::Fragment>>();
+    vecFrag->reserve(num_module);
 
     // set properties of fragment that are common to event
     //quantities in fragment
@@ -266,67 +272,30 @@ void sbnd::trigger::ArtdaqFragmentProducer::produce(art::Event& e)
 
     uint64_t temp_last_time = 0;
 
-    //random number generator to bu used to simulate pedestal
+    //random number generator to be used to simulate pedestal
     std::default_random_engine generator;
     std::normal_distribution<double> distribution(175.0,23.0);
 
-    //loop through FEBData product and sort by module/mac5
+    //sort FEBData by module/mac5, keeping the order within each module
+    for (auto& hits : fFEBHitIndices) hits.clear();
     for (size_t feb_i = 0; feb_i < feb_data_v.size(); feb_i++) {
 
-        auto const feb_data = feb_data_v[feb_i];
-
-        if(fVerbose){std::cout << "FEB " << feb_i << " with mac " << feb_data->Mac5() << std::endl;}
-
-        empty_fragment[feb_data->Mac5()] = false;
-
-        int channel = feb_data->Mac5() * 32;
-        std::string stripName = fCrtGeo.ChannelToStripName(channel);
-        std::string tagger = fCrtGeo.GetTaggerName(stripName);
-        taggers[feb_data->Mac5()] = tagger;
-
-        T0s[feb_data->Mac5()][feb_hits_in_fragments[feb_data->Mac5()]] = feb_data->Ts0();
-        T1s[feb_data->Mac5()][feb_hits_in_fragments[feb_data->Mac5()]] = feb_data->Ts1();
-        for (int i_adc = 0; i_adc<32; i_adc++){
-          uint16_t adc = 0;
-          if (feb_data->ADC()[i_adc] > 4089){
-            adc = 4089;
-          }else if (feb_data->ADC()[i_adc] == 0){
-            //pull from a normal distribution to simulate pedestal
-            adc = distribution(generator);
-          }else{
-            adc = feb_data->ADC()[i_adc];
-          }
-          ADCs[feb_data->Mac5()][feb_hits_in_fragments[feb_data->Mac5()]][i_adc] = adc;
-        }
+        if(fVerbose){std::cout << "FEB " << feb_i << " with mac " << feb_data_v[feb_i].Mac5() << std::endl;}
 
-        feb_hits_in_fragments[feb_data->Mac5()]++;
+        fFEBHitIndices[feb_data_v[feb_i].Mac5()].push_back(feb_i);
 
     }//FEBData loop
 
-    //make one fragment for every module
+    //make one fragment for every module, hits are written straight into the fragment
     for (size_t feb_i = fFirstFEBMac5; feb_i < num_module+fFirstFEBMac5; feb_i++){
-        //quantities in fragment
-        if (empty_fragment[feb_i]){
-          //if no hits for a module, make a simulated "T1 reset" event to avoid missing fragments
-          feb_hits_in_fragments[feb_i] = 1;
-          int channel = feb_i * 32;
-          std::string stripName = fCrtGeo.ChannelToStripName(channel);
-          std::string tagger = fCrtGeo.GetTaggerName(stripName);
-          taggers[feb_i] = tagger;
-
-          T0s[feb_i][0] = 0;
-          T1s[feb_i][0] = 0;
-          for (int i_adc = 0; i_adc<32; i_adc++){
-            uint16_t adc = distribution(generator);
-            ADCs[feb_i][0][i_adc] = adc;
-          }
-        }
+        std::vector<size_t> const& hit_indices = fFEBHitIndices[feb_i];
 
-        if (feb_hits_in_fragments[feb_i]==0) continue;
+        //if no hits for a module, make a simulated "T1 reset" event to avoid missing fragments
+        bool empty_fragment = hit_indices.empty();
 
       //metadata
         uint8_t  mac5 = (uint8_t)feb_i; //last 8 bits of FEB mac5 address
-        uint16_t feb_hits_in_fragment = feb_hits_in_fragments[feb_i];
+        uint16_t feb_hits_in_fragment = empty_fragment ? 1 : hit_indices.size();
 
         sbndaq::BernCRTFragmentMetadataV2 metadata;
 
@@ -337,32 +306,55 @@ void sbnd::trigger::ArtdaqFragmentProducer::produce(art::Event& e)
         metadata.set_run_start_time(run_start_time);
         metadata.update_poll_time(this_poll_start, this_poll_end);
 
-        uint64_t  timestamp = (uint64_t)(T0s[feb_i][feb_hits_in_fragments[feb_i]]/fClockSpeedCRT); //absolute timestamp
+        uint32_t  last_ts0 = empty_fragment ? 0 : feb_data_v[hit_indices.back()].Ts0();
+        uint64_t  timestamp = (uint64_t)(last_ts0/fClockSpeedCRT); //absolute timestamp
 
-        // create fragment
-        sbnd::crt::CRTTagger tagger_num = sbnd::crt::CRTCommonUtils::GetTaggerEnum(taggers[feb_i]);
-        uint16_t fragmentIDVal = 32768 + 12288 + (tagger_num * 256) + (uint16_t)mac5;
+        // create fragment in place
+        uint16_t fragmentIDVal = fFragmentIDs[feb_i - fFirstFEBMac5];
         if(fVerbose){std::cout<<"fragmentID: "<<std::bitset<16>{fragmentIDVal}<<std::endl;}
-        auto fragment_uptr = artdaq::Fragment::FragmentBytes(sizeof(sbndaq::BernCRTHitV2)*metadata.hits_in_fragment(), //payload_size
+        artdaq::Fragment& fragment = EmplaceFragmentBytes(*vecFrag,
+            sizeof(sbndaq::BernCRTHitV2)*metadata.hits_in_fragment(), //payload_size
             sequence_id,
             fragmentIDVal,
             sbndaq::detail::FragmentType::BERNCRTV2,
             metadata,
             timestamp
-          ); // unique pointer
+          );
 
         // populate fragment
-        std::vector<sbndaq::BernCRTHitV2> data_vec;
-        for (int i_frag = 0; i_frag<feb_hits_in_fragments[feb_i]; i_frag++){
-          sbndaq::BernCRTHitV2 hit;
+        sbndaq::BernCRTHitV2* hits = FragmentPayload<sbndaq::BernCRTHitV2>(fragment);
+        for (int i_frag = 0; i_frag<feb_hits_in_fragment; i_frag++){
+          sbndaq::BernCRTHitV2& hit = hits[i_frag];
 
-          uint8_t flags = 3;
-          uint32_t ts0 = T0s[feb_i][i_frag];
-          uint32_t ts1 = T1s[feb_i][i_frag];
+          uint32_t ts0 = 0;
+          uint32_t ts1 = 0;
+
+          if (empty_fragment){
+            for (int i_adc = 0; i_adc<num_channels; i_adc++){
+              hit.adc[i_adc] = (uint16_t)distribution(generator);
+            }
+          }else{
+            sbnd::crt::FEBData const& feb_data = feb_data_v[hit_indices[i_frag]];
+            ts0 = feb_data.Ts0();
+            ts1 = feb_data.Ts1();
+            for (int i_adc = 0; i_adc<num_channels; i_adc++){
+              uint16_t adc = 0;
+              if (feb_data.ADC()[i_adc] > 4089){
+                adc = 4089;
+              }else if (feb_data.ADC()[i_adc] == 0){
+                //pull from a normal distribution to simulate pedestal
+                adc = distribution(generator);
+              }else{
+                adc = feb_data.ADC()[i_adc];
+              }
+              hit.adc[i_adc] = adc;
+            }
+          }
 
+          uint8_t flags = 3;
           if (ts0==0){flags=7;}else if (ts1==0){flags=11;}
 
-          uint64_t  feb_hit_number = feb_hits_in_fragments[feb_i]; //hit counter for individual FEB, including hits lost in FEB or fragment generator
+          uint64_t  feb_hit_number = feb_hits_in_fragment; //hit counter for individual FEB, including hits lost in FEB or fragment generator
           timestamp = (uint64_t)ts0/fClockSpeedCRT; //absolute timestamp
           uint64_t  last_accepted_timestamp = temp_last_time; //timestamp of previous accepted hit
           temp_last_time = timestamp;
@@ -372,24 +364,13 @@ void sbnd::trigger::ArtdaqFragmentProducer::produce(art::Event& e)
           hit.lostfpga = (uint16_t)lostfpga;
           hit.ts0 = (uint32_t)ts0;
           hit.ts1 = (uint32_t)ts1;
-          for (int i_adc = 0; i_adc<32; i_adc++){
-            hit.adc[i_adc] = ADCs[feb_i][i_frag][i_adc];
-          }
           hit.coinc = (uint32_t)coinc;
           hit.feb_hit_number = (uint64_t)feb_hit_number;
           hit.timestamp = (uint64_t)timestamp;
           hit.last_accepted_timestamp = (uint64_t)last_accepted_timestamp;
           hit.lost_hits = (uint16_t)lost_hits;
-
-          data_vec.emplace_back(hit);
         }//bern crt hit vector
 
-        //copy data vector of hits into the fragment we made
-        std::memcpy(fragment_uptr->dataBeginBytes(), data_vec.data(), sizeof(sbndaq::BernCRTHitV2)*metadata.hits_in_fragment());
-
-        // add fragment to vector
-        vecFrag->push_back(*fragment_uptr);
-
     }//module (mac5) loop
 
     int num_crt_frags = vecFrag->size();
@@ -414,88 +395,43 @@ void sbnd::trigger::ArtdaqFragmentProducer::produce(art::Event& e)
           << "Could not find any PMT hardware trigger object, must run PMT trigger producer before running this module." << "\n";
   }
 
-  // create empty vectors to hold waveforms for each channel
+  // readout window covered by the PMT waveforms
   double fMinStartTime = -1510.0;//in us
   double fMaxEndTime = 1510.0;//in us
 
   for(auto const& wvf : (*wvfmHandle)) {
-    double fChNumber = wvf.ChannelNumber();
-    std::string opdetType = pdMap.pdType(fChNumber);
     // only look at pmts
-    if (opdetType != "pmt_coated" && opdetType != "pmt_uncoated") continue;
+    if (wvf.ChannelNumber() >= fChannelIndex.size() || fChannelIndex[wvf.ChannelNumber()] < 0) continue;
       if (wvf.TimeStamp() < fMinStartTime){ fMinStartTime = wvf.TimeStamp(); }
       if ((double(wvf.size()) / fSampling + wvf.TimeStamp()) > fMaxEndTime){ fMaxEndTime = double(wvf.size()) / fSampling + wvf.TimeStamp();}
   }
 
   if (fVerbose){std::cout<<"MinStartTime: "<<fMinStartTime<<" MaxEndTime: "<<fMaxEndTime<<std::endl;}
 
-  std::vector<short> wvf_0; wvf_0.reserve((int)(3020*1e6/2));
-  for (double i = fMinStartTime; i<fMaxEndTime+(1./fSampling); i+=(1./fSampling)){
-    wvf_0.push_back(fBaseline);
-  }
-  for (size_t i = 0; i < channelList.size(); i++){
-    wvf_channel.push_back(wvf_0);
-  }
+  // rather than expanding every channel to the full readout window, keep each waveform
+  // with its first sample index in that window and write the trigger windows straight
+  // from the waveforms into the fragments
+  for (auto& spans : wvf_channel) spans.clear();
 
   // counters
   int num_pmt_wvf = 0;
 
-  // loop through waveform handles
-  size_t wvf_id = -1;
-  size_t hist_id = -1;
   for(auto const& wvf : (*wvfmHandle)) {
-    wvf_id++;
-    double fChNumber = wvf.ChannelNumber();
-    std::string opdetType = pdMap.pdType(fChNumber);
-
     // only look at pmts
-    if (opdetType != "pmt_coated" && opdetType != "pmt_uncoated") continue;
+    if (wvf.ChannelNumber() >= fChannelIndex.size() || fChannelIndex[wvf.ChannelNumber()] < 0) continue;
 
     num_pmt_wvf++;
 
+    // number of baseline samples before the waveform starts
     double fStartTime = wvf.TimeStamp(); // in us
-    double fEndTime = double(wvf.size()) / fSampling + fStartTime; // in us
-
-    // create full waveform
-    std::vector<short> wvf_full; wvf_full.reserve((short)(3020*1e6/2));
-
-    if (fStartTime > fMinStartTime){
-      for (double i = fStartTime-fMinStartTime; i>0.; i-=(1./fSampling)){
-        wvf_full.push_back(fBaseline);
-      }
-    }
-
-    for(unsigned int i = 0; i < wvf.size(); i++) {
-      wvf_full.push_back(wvf[i]);
-    }
-
-    if (fEndTime < fMaxEndTime){
-      for (double i = fMaxEndTime-fEndTime; i>0.; i-=(1./fSampling)){
-        wvf_full.push_back(fBaseline);
-      }
-    }
-
-    // combine waveform with any other waveforms from same channel
-    int i_ch = -1.;
-    auto ich = std::find(channelList.begin(), channelList.end(), fChNumber);
-    if (ich != channelList.end()){
-      i_ch = ich - channelList.begin();
-    }
-    if (wvf_channel.at(i_ch).size() < wvf_full.size()){
-      if (fVerbose) std::cout<<"Full waveform -- Previous Channel" << fChNumber <<" Size: "<<wvf_channel.at(i_ch).size()<<"New Channel" << fChNumber <<" Size: "<<wvf_full.size()<<std::endl;
-      for(unsigned int i = wvf_channel.at(i_ch).size(); i < wvf_full.size(); i++) {
-        wvf_channel.at(i_ch).push_back(fBaseline);
-      }
-    }
-    for(unsigned int i = 0; i < wvf_full.size(); i++) {
-       wvf_channel.at(i_ch)[i] += (wvf_full[i] - fBaseline);
-    }
+    long startIdx = 0;
+    if (fStartTime > fMinStartTime) startIdx = (long)std::ceil((fStartTime-fMinStartTime)*fSampling - 1e-6);
 
-    hist_id++;
-
-    wvfmHandle.clear();
+    wvf_channel[fChannelIndex[wvf.ChannelNumber()]].push_back({startIdx, &wvf});
   } // waveform handle loop
 
+  if (fVerbose) std::cout << "Number of PMT waveforms: " << num_pmt_wvf << std::endl;
+
   // access hardware trigger information
   std::vector<size_t> triggerIndex;
   for(auto const& trigger : (*triggerHandle)) {
@@ -531,6 +467,8 @@ void sbnd::trigger::ArtdaqFragmentProducer::produce(art::Event& e)
   uint32_t triggerTimeTagVal = (uint32_t)CLHEP::RandFlat::shoot(&fTriggerTimeEngine, 0, 1e9);
   uint32_t eventSizeVal = ((wfm_length * (nChannelsFrag+1)) * sizeof(uint16_t) + sizeof(sbndaq::CAENV1730EventHeader)) / sizeof(uint32_t);
 
+  vecFrag->reserve(vecFrag->size() + triggerIndex.size()*nFrag);
+
   // loop over PMT hardware triggers
   for (auto wvfIdx : triggerIndex) {
 
@@ -550,54 +488,37 @@ void sbnd::trigger::ArtdaqFragmentProducer::produce(art::Event& e)
     // 15 PMTs stored per fragment, 120/15 = 8 fragments per trigger
     for (size_t counter = 0; counter < nFrag; counter++) {
 
-      // create fragment
+      // create fragment in place
       const auto fragment_datasize_bytes = metadata.ExpectedDataSize();
       uint32_t fragmentIDVal = counter;
-      auto fragment_uptr = artdaq::Fragment::FragmentBytes(fragment_datasize_bytes, sequenceIDVal, fragmentIDVal, sbndaq::detail::FragmentType::CAENV1730, metadata); // unique pointer
-      fragment_uptr->setTimestamp(timestampVal);
+      artdaq::Fragment& fragment = EmplaceFragmentBytes(*vecFrag, fragment_datasize_bytes, sequenceIDVal, fragmentIDVal, sbndaq::detail::FragmentType::CAENV1730, metadata);
+      fragment.setTimestamp(timestampVal);
 
       // populate fragment header
-      auto header_ptr = reinterpret_cast<sbndaq::CAENV1730EventHeader*>(fragment_uptr->dataBeginBytes());
+      CAENV1730PayloadWriter payload(fragment, wfm_length);
+      sbndaq::CAENV1730EventHeader& header = payload.Header();
 
-      header_ptr->eventCounter = eventCounterVal;
-      header_ptr->boardID = boardIDVal;
-      header_ptr->triggerTimeTag = triggerTimeTagVal;  // ns // set timetag as random value for event
-      header_ptr->eventSize = eventSizeVal;
+      header.eventCounter = eventCounterVal;
+      header.boardID = boardIDVal;
+      header.triggerTimeTag = triggerTimeTagVal;  // ns // set timetag as random value for event
+      header.eventSize = eventSizeVal;
 
-      // populate waveforms
-      // populate fragment with waveform
-      uint16_t* data_begin = reinterpret_cast<uint16_t*>(fragment_uptr->dataBeginBytes() + sizeof(sbndaq::CAENV1730EventHeader));
-      uint16_t* value_ptr = data_begin;
-      uint16_t value = 0;
-      size_t ch_offset = 0;
-
-      // loop over channels
+      // populate waveforms, summing any waveforms from the same channel on top of the baseline
       for (size_t i_ch = 0; i_ch < nChannelsFrag; i_ch++) {
-        ch_offset = (size_t)(i_ch*wfm_length);
-        // loop over waveform
-        for (size_t i_t = 0; i_t < wfm_length; i_t++) {
-          // set value
-          value = wvf_channel[counter*nChannelsFrag + i_ch][startIdx+i_t];
-          value_ptr = data_begin + ch_offset + i_t;
-          *value_ptr = value;
+        payload.FillChannel(i_ch, fBaseline);
+        for (auto const& span : wvf_channel[counter*nChannelsFrag + i_ch]) {
+          payload.AddSpan(i_ch, startIdx, span.second->data(), span.second->size(), span.first, fBaseline);
         }
       }
 
       // create add beam window trigger waveform
-      ch_offset = (size_t)(nChannelsFrag*wfm_length);
       size_t beamStartIdx = abs(fMinStartTime)*1000/2;
       size_t beamEndIdx = beamStartIdx + fBeamWindowLength*1000/2;
+      uint16_t* beam_ptr = payload.Channel(nChannelsFrag);
       // loop over waveform
       for (size_t i_t = 0; i_t < wfm_length; i_t++) {
-        // set value
-        if (startIdx + i_t >= beamStartIdx && startIdx + i_t <= beamEndIdx) value = 1;
-        else value = 0;
-        value_ptr = data_begin + ch_offset + i_t;
-        *value_ptr = value;
+        beam_ptr[i_t] = (startIdx + i_t >= beamStartIdx && startIdx + i_t <= beamEndIdx) ? 1 : 0;
       }
-
-      // add fragment to vector
-      vecFrag->push_back(*fragment_uptr);
     }
   }
 
@@ -607,10 +528,6 @@ void sbnd::trigger::ArtdaqFragmentProducer::produce(art::Event& e)
     //produce fragment vector
     e.put(std::move(vecFrag));
 
-    // clear variables
-    wvf_channel.clear();
-    wvf_channel.shrink_to_fit();
-
 } // ArtdaqFragmentProducer::produce()
 
 
@@ -18,6 +18,7 @@
 #include "sbnobj/Common/CRT/CRTHit.hh"
 #include "sbnobj/Common/CRT/CRTTrack.hh"
 #include "sbndcode/CRT/CRTUtils/CRTCommonUtils.h"
+#include "sbndcode/Trigger/ArtdaqFragmentBuilder.h"
 
 
 // LArSoft includes
@@ -112,13 +113,11 @@ private:
     num_channels = 32
   };
 
-  //arrays to store FEBinfo by module (want one fragment per module per event)
-  std::string taggers[num_febs];
-  uint16_t feb_hits_in_fragments[num_febs];
-  uint16_t ADCs[num_febs][max_hits_in_fragment][num_channels];
-  uint32_t T0s[num_febs][max_hits_in_fragment];
-  uint32_t T1s[num_febs][max_hits_in_fragment];
-  bool empty_fragment[num_febs];
+  //FEBData indices by module/mac5 (want one fragment per module per event)
+  std::vector<size_t> fFEBHitIndices[num_febs];
+
+  //fragment ID of each module from its tagger, indexed by mac5 - fFirstFEBMac5
+  std::vector<uint16_t> fFragmentIDs;
 
 
 
@@ -142,6 +141,13 @@ sbnd::trigger::CRTArtdaqFragmentProducer::CRTArtdaqFragmentProducer(fhicl::Param
   // Get a pointer to the fGeometryServiceetry service provider
   fGeometryService = lar::providerFrom<geo::Geometry>();
 
+  // fragment IDs only depend on the geometry, work them out once
+  for (size_t feb_i = fFirstFEBMac5; feb_i < fCrtGeo.NumModules()+fFirstFEBMac5; feb_i++){
+    std::string stripName = fCrtGeo.ChannelToStripName(feb_i * 32);
+    sbnd::crt::CRTTagger tagger_num = sbnd::crt::CRTCommonUtils::GetTaggerEnum(fCrtGeo.GetTaggerName(stripName));
+    fFragmentIDs.push_back(32768 + 12288 + (tagger_num * 256) + (uint16_t)feb_i);
+  }
+
 }
 
 
@@ -160,8 +166,6 @@ void sbnd::trigger::CRTArtdaqFragmentProducer::produce(art::Event& e)
     }
 
 
-    for(int i=0; i<num_febs; i++){empty_fragment[i]=true;}
-
     int num_module = fCrtGeo.NumModules();
 
     //----------------------------------------------------------------------------------------------------------
@@ -177,16 +181,11 @@ void sbnd::trigger::CRTArtdaqFragmentProducer::produce(art::Event& e)
       throw art::Exception(art::errors::Configuration) << "could not locate FEBData." << std::endl;;
     }
 
-    std::vector<art::Ptr<sbnd::crt::FEBData>> feb_data_v;
-    art::fill_ptr_vector(feb_data_v, feb_data_h);
-
-    art::FindManyP<sim::AuxDetIDE, sbnd::crt::FEBTruthInfo> febdata_to_ides (feb_data_h, e, fFEBDataLabel);
-
-    //Fill arrays with default values
-    std::fill(feb_hits_in_fragments, feb_hits_in_fragments + sizeof(feb_hits_in_fragments), 0);
+    std::vector<sbnd::crt::FEBData> const& feb_data_v = *feb_data_h;
 
-    // fragments vector
+    // fragments vector, one fragment per module
     std::unique_ptr<std::vector<artdaq::Fragment>> vecFrag = std::make_unique<std::vector<artdaq::Fragment>>();
+    vecFrag->reserve(num_module);
 
     // set properties of fragment that are common to event
     //quantities in fragment
@@ -219,63 +218,26 @@ void sbnd::trigger::CRTArtdaqFragmentProducer::produce(art::Event& e)
       if (fVerbose){std::cout << std::hex << (32768 + 12288 + (plane * 256) + (int)mod_i) << std::endl;}
     } */
 
-    //loop through FEBData product and sort by module/mac5
+    //sort FEBData by module/mac5, keeping the order within each module
+    for (auto& hits : fFEBHitIndices) hits.clear();
     for (size_t feb_i = 0; feb_i < feb_data_v.size(); feb_i++) {
 
-        auto const feb_data = feb_data_v[feb_i];
-
-        if(fVerbose){std::cout << "FEB " << feb_i << " with mac " << feb_data->Mac5() << std::endl;}
-
-        empty_fragment[feb_data->Mac5()] = false;
-
-        int channel = feb_data->Mac5() * 32;
-        std::string stripName = fCrtGeo.ChannelToStripName(channel);
-        std::string tagger = fCrtGeo.GetTaggerName(stripName);
-        taggers[feb_data->Mac5()] = tagger;
-
-        T0s[feb_data->Mac5()][feb_hits_in_fragments[feb_data->Mac5()]] = feb_data->Ts0();
-        T1s[feb_data->Mac5()][feb_hits_in_fragments[feb_data->Mac5()]] = feb_data->Ts1();
-        for (int i_adc = 0; i_adc<32; i_adc++){
-          uint16_t adc = 0;
-          if (feb_data->ADC()[i_adc] > 4089){
-            adc = 4089;
-          }else if (feb_data->ADC()[i_adc] == 0){
-            //pull from a normal distribution to simulate pedestal
-            adc = distribution(generator);
-          }else{
-            adc = feb_data->ADC()[i_adc];
-          }
-          ADCs[feb_data->Mac5()][feb_hits_in_fragments[feb_data->Mac5()]][i_adc] = adc;
-        }
+        if(fVerbose){std::cout << "FEB " << feb_i << " with mac " << feb_data_v[feb_i].Mac5() << std::endl;}
 
-        feb_hits_in_fragments[feb_data->Mac5()]++;
+        fFEBHitIndices[feb_data_v[feb_i].Mac5()].push_back(feb_i);
 
     }//FEBData loop
 
-    //make one fragment for every module
+    //make one fragment for every module, hits are written straight into the fragment
     for (size_t feb_i = fFirstFEBMac5; feb_i < num_module+fFirstFEBMac5; feb_i++){
-        //quantities in fragment
-        if (empty_fragment[feb_i]){
-          //if no hits for a module, make a simulated "T1 reset" event to avoid missing fragments
-          feb_hits_in_fragments[feb_i] = 1;
-          int channel = feb_i * 32;
-          std::string stripName = fCrtGeo.ChannelToStripName(channel);
-          std::string tagger = fCrtGeo.GetTaggerName(stripName);
-          taggers[feb_i] = tagger;
-
-          T0s[feb_i][0] = 0;
-          T1s[feb_i][0] = 0;
-          for (int i_adc = 0; i_adc<32; i_adc++){
-            uint16_t adc = distribution(generator);
-            ADCs[feb_i][0][i_adc] = adc;
-          }
-        }
+        std::vector<size_t> const& hit_indices = fFEBHitIndices[feb_i];
 
-        if (feb_hits_in_fragments[feb_i]==0) continue;
+        //if no hits for a module, make a simulated "T1 reset" event to avoid missing fragments
+        bool empty_fragment = hit_indices.empty();
 
       //metadata
         uint8_t  mac5 = (uint8_t)feb_i; //last 8 bits of FEB mac5 address
-        uint16_t feb_hits_in_fragment = feb_hits_in_fragments[feb_i];
+        uint16_t feb_hits_in_fragment = empty_fragment ? 1 : hit_indices.size();
 
         sbndaq::BernCRTFragmentMetadataV2 metadata;
 
@@ -286,32 +248,55 @@ void sbnd::trigger::CRTArtdaqFragmentProducer::produce(art::Event& e)
         metadata.set_run_start_time(run_start_time);
         metadata.update_poll_time(this_poll_start, this_poll_end);
 
-        uint64_t  timestamp = (uint64_t)(T0s[feb_i][feb_hits_in_fragments[feb_i]]/fClockSpeedCRT); //absolute timestamp
+        uint32_t  last_ts0 = empty_fragment ? 0 : feb_data_v[hit_indices.back()].Ts0();
+        uint64_t  timestamp = (uint64_t)(last_ts0/fClockSpeedCRT); //absolute timestamp
 
-        // create fragment
-        sbnd::crt::CRTTagger tagger_num = sbnd::crt::CRTCommonUtils::GetTaggerEnum(taggers[feb_i]);
-        uint16_t fragmentIDVal = 32768 + 12288 + (tagger_num * 256) + (uint16_t)mac5;
+        // create fragment in place
+        uint16_t fragmentIDVal = fFragmentIDs[feb_i - fFirstFEBMac5];
         if(fVerbose){std::cout<<"fragmentID: "<<std::bitset<16>{fragmentIDVal}<<std::endl;}
-        auto fragment_uptr = artdaq::Fragment::FragmentBytes(sizeof(sbndaq::BernCRTHitV2)*metadata.hits_in_fragment(), //payload_size
+        artdaq::Fragment& fragment = EmplaceFragmentBytes(*vecFrag,
+            sizeof(sbndaq::BernCRTHitV2)*metadata.hits_in_fragment(), //payload_size
             sequence_id,
             fragmentIDVal,
             sbndaq::detail::FragmentType::BERNCRTV2,
             metadata,
             timestamp
-          ); // unique pointer
+          );
 
         // populate fragment
-        std::vector<sbndaq::BernCRTHitV2> data_vec;
-        for (int i_frag = 0; i_frag<feb_hits_in_fragments[feb_i]; i_frag++){
-          sbndaq::BernCRTHitV2 hit;
+        sbndaq::BernCRTHitV2* hits = FragmentPayload<sbndaq::BernCRTHitV2>(fragment);
+        for (int i_frag = 0; i_frag<feb_hits_in_fragment; i_frag++){
+          sbndaq::BernCRTHitV2& hit = hits[i_frag];
 
-          uint8_t flags = 3;
-          uint32_t ts0 = T0s[feb_i][i_frag];
-          uint32_t ts1 = T1s[feb_i][i_frag];
+          uint32_t ts0 = 0;
+          uint32_t ts1 = 0;
+
+          if (empty_fragment){
+            for (int i_adc = 0; i_adc<num_channels; i_adc++){
+              hit.adc[i_adc] = (uint16_t)distribution(generator);
+            }
+          }else{
+            sbnd::crt::FEBData const& feb_data = feb_data_v[hit_indices[i_frag]];
+            ts0 = feb_data.Ts0();
+            ts1 = feb_data.Ts1();
+            for (int i_adc = 0; i_adc<num_channels; i_adc++){
+              uint16_t adc = 0;
+              if (feb_data.ADC()[i_adc] > 4089){
+                adc = 4089;
+              }else if (feb_data.ADC()[i_adc] == 0){
+                //pull from a normal distribution to simulate pedestal
+                adc = distribution(generator);
+              }else{
+                adc = feb_data.ADC()[i_adc];
+              }
+              hit.adc[i_adc] = adc;
+            }
+          }
 
+          uint8_t flags = 3;
           if (ts1==0){flags=11;}else if (ts0==0){flags=7;}
 
-          uint64_t  feb_hit_number = feb_hits_in_fragments[feb_i]; //hit counter for individual FEB, including hits lost in FEB or fragment generator
+          uint64_t  feb_hit_number = feb_hits_in_fragment; //hit counter for individual FEB, including hits lost in FEB or fragment generator
           timestamp = (uint64_t)ts0/fClockSpeedCRT; //absolute timestamp
           uint64_t  last_accepted_timestamp = temp_last_time; //timestamp of previous accepted hit
           temp_last_time = timestamp;
@@ -321,24 +306,13 @@ void sbnd::trigger::CRTArtdaqFragmentProducer::produce(art::Event& e)
           hit.lostfpga = (uint16_t)lostfpga;
           hit.ts0 = (uint32_t)ts0;
           hit.ts1 = (uint32_t)ts1;
-          for (int i_adc = 0; i_adc<32; i_adc++){
-            hit.adc[i_adc] = ADCs[feb_i][i_frag][i_adc];
-          }
           hit.coinc = (uint32_t)coinc;
           hit.feb_hit_number = (uint64_t)feb_hit_number;
           hit.timestamp = (uint64_t)timestamp;
           hit.last_accepted_timestamp = (uint64_t)last_accepted_timestamp;
           hit.lost_hits = (uint16_t)lost_hits;
-
-          data_vec.emplace_back(hit);
         }//bern crt hit vector
 
-        //copy data vector of hits into the fragment we made
-        std::memcpy(fragment_uptr->dataBeginBytes(), data_vec.data(), sizeof(sbndaq::BernCRTHitV2)*metadata.hits_in_fragment());
-
-        // add fragment to vector
-        vecFrag->push_back(*fragment_uptr);
-
     }//module (mac5) loop
 
     if(fVerbose) std::cout << "Fragments written: " << vecFrag->size() << std::endl;
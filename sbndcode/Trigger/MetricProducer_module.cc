@@ -25,6 +25,7 @@
 #include "artdaq-core/Data/ContainerFragment.hh"
 
 #include "sbndcode/OpDetSim/sbndPDMapAlg.hh"
+#include "sbndcode/Decoders/ArtdaqFragmentWalker.h"
 #include "sbnobj/SBND/Trigger/pmtSoftwareTrigger.hh"
 //#include "sbndaq-artdaq-core/Obj/SBND/pmtSoftwareTrigger.hh"
 //#include "sbndaq-artdaq-core/Obj/SBND/CRTmetric.hh"
@@ -111,8 +112,10 @@ private:
   int num_crt_frags;
   int num_pmt_frags;
 
+  daq::ArtdaqFragmentWalker fFragmentWalker;
 
-  void analyze_crt_fragment(artdaq::Fragment & frag);
+
+  void analyze_crt_fragment(const artdaq::Fragment & frag);
   void checkCAEN1730FragmentTimeStamp(const artdaq::Fragment &frag);
   void analyzeCAEN1730Fragment(const artdaq::Fragment &frag);
   void estimateBaseline(int i_ch);
@@ -218,25 +221,25 @@ void sbndaq::MetricProducer::produce(art::Event& evt)
   num_crt_frags = 0;
   num_pmt_frags = 0;
   // loop over fragment handles
-  for (auto handle : fragmentHandles) {
+  for (auto const& handle : fragmentHandles) {
     if (!handle.isValid() || handle->size() == 0) continue;
 
     if (handle->front().type() == artdaq::Fragment::ContainerFragmentType) {
       // container fragment
-      for (auto cont : *handle) {
-        artdaq::ContainerFragment contf(cont);
-        if (contf.fragment_type() == sbndaq::detail::FragmentType::BERNCRTV2){
-          if (fVerbose)     std::cout << "    Found " << contf.block_count() << " CRT Fragments in container " << std::endl;
-          if (fCalcCRTMetrics){
-              for (size_t ii = 0; ii < contf.block_count(); ++ii) analyze_crt_fragment(*contf[ii].get());
-          }
-        }
+      if (fCalcCRTMetrics){
+        size_t nCRTFrags = fFragmentWalker.Visit(*handle, sbndaq::detail::FragmentType::BERNCRTV2,
+                                                 [this](const artdaq::Fragment& frag){ analyze_crt_fragment(frag); });
+        if (fVerbose)     std::cout << "    Found " << nCRTFrags << " CRT Fragments in containers " << std::endl;
+      }
+      else if (fVerbose) {
+        std::cout << "    Found " << daq::ArtdaqFragmentWalker::Count(*handle, sbndaq::detail::FragmentType::BERNCRTV2)
+                  << " CRT Fragments in containers " << std::endl;
       }
     }
     else {
       // normal fragment
       size_t beamFragmentIdx = -1;
-      for (auto frag : *handle){
+      for (auto const& frag : *handle){
         beamFragmentIdx++;
         if (frag.type()==sbndaq::detail::FragmentType::BERNCRTV2) {
           num_crt_frags++;
@@ -390,7 +393,7 @@ void sbndaq::MetricProducer::produce(art::Event& evt)
 
 
 
-void sbndaq::MetricProducer::analyze_crt_fragment(artdaq::Fragment & frag)
+void sbndaq::MetricProducer::analyze_crt_fragment(const artdaq::Fragment & frag)
 {
 
   sbndaq::BernCRTFragmentV2 bern_fragment(frag);
@@ -32,6 +32,7 @@
 #include "artdaq-core/Data/ContainerFragment.hh"
 
 #include "sbndcode/OpDetSim/sbndPDMapAlg.hh"
+#include "sbndcode/Decoders/ArtdaqFragmentWalker.h"
 #include "sbnobj/SBND/Trigger/pmtSoftwareTrigger.hh"
 
 // ROOT includes
@@ -112,6 +113,8 @@ private:
   // pmt information 
   std::vector<sbnd::trigger::pmtInfo> fpmtInfoVec;
 
+  daq::ArtdaqFragmentWalker fFragmentWalker;
+
   void checkCAEN1730FragmentTimeStamp(const artdaq::Fragment &frag);
   void analyzeCAEN1730Fragment(const artdaq::Fragment &frag);
   void estimateBaseline(int i_ch);
@@ -233,30 +236,31 @@ void sbnd::trigger::pmtSoftwareTriggerProducer::produce(art::Event& e)
   std::vector<art::Handle<artdaq::Fragments>> fragmentHandles = e.getMany<std::vector<artdaq::Fragment>>();
 
   // loop over fragment handles
-  for (auto &handle : fragmentHandles) {
+  for (auto const& handle : fragmentHandles) {
     if (!handle.isValid() || handle->size() == 0) continue;
-    if (handle->front().type()==sbndaq::detail::FragmentType::CAENV1730) {
-      if (fVerbose)   std::cout << "Found " << handle->size() << " CAEN1730 fragments" << std::endl;
-      
-      // identify whether any fragments correspond to the beam spill
-      // loop over fragments, in steps of 8
-      size_t beamFragmentIdx = 9999;
-      for (size_t fragmentIdx = 0; fragmentIdx < handle->size(); fragmentIdx += 8) {
-        checkCAEN1730FragmentTimeStamp(handle->at(fragmentIdx));
-        if (foundBeamTrigger) {
-          beamFragmentIdx = fragmentIdx;
-          if (fVerbose) std::cout << "Found fragment in time with beam at index: " << beamFragmentIdx << std::endl;
-          break;
+
+    // CAEN1730 fragments, on their own or in containers, are walked in order
+    // identify whether any fragments correspond to the beam spill
+    // checking in steps of 8, then process the set of 8 from that fragment
+    size_t fragmentIdx = 0;
+    size_t beamFragmentIdx = 9999;
+    size_t nFragments = fFragmentWalker.Visit(*handle, sbndaq::detail::FragmentType::CAENV1730,
+      [&](const artdaq::Fragment& frag) {
+        if (beamFragmentIdx == 9999 && fragmentIdx%8 == 0) {
+          checkCAEN1730FragmentTimeStamp(frag);
+          if (foundBeamTrigger) {
+            beamFragmentIdx = fragmentIdx;
+            if (fVerbose) std::cout << "Found fragment in time with beam at index: " << beamFragmentIdx << std::endl;
+          }
         }
-      }
-      // if set of fragment in time with beam found, process waveforms
-      if (foundBeamTrigger && beamFragmentIdx != 9999) {
-        for (size_t fragmentIdx = beamFragmentIdx; fragmentIdx < beamFragmentIdx+8; fragmentIdx++) {
-          analyzeCAEN1730Fragment(handle->at(fragmentIdx));
+        // if set of fragment in time with beam found, process waveforms
+        if (beamFragmentIdx != 9999 && fragmentIdx < beamFragmentIdx+8) {
+          analyzeCAEN1730Fragment(frag);
+          fWvfmsFound = true;
         }
-        fWvfmsFound = true;
-      }
-    }
+        fragmentIdx++;
+      });
+    if (fVerbose && nFragments)   std::cout << "Found " << nFragments << " CAEN1730 fragments" << std::endl;
   } // end loop over handles
 
   // object to store trigger metrics in
@@ -29,6 +29,7 @@
 #ifndef SIGNALSHAPINGSERVICELARIAT_H
 #define SIGNALSHAPINGSERVICELARIAT_H
 
+#include <algorithm>
 #include <vector>
 
 #include "fhiclcpp/ParameterSet.h"
@@ -60,7 +61,7 @@ namespace util {
 
     void reconfigure(const fhicl::ParameterSet& pset);
 
-    std::vector<DoubleVec> GetNoiseFactVec()   {return fNoiseFactVec;};
+    const std::vector<DoubleVec>& GetNoiseFactVec() const {return fNoiseFactVec;};
     double GetASICGain(unsigned int const channel) const;
     //double GetShapingTime(unsigned int const channel) const;
     
@@ -110,9 +111,29 @@ namespace util {
     // Calculate view corresponding to channel
     geo::View_t GetView(unsigned int chan) const;
 
+    // Per-channel quantities, looked up once rather than through the
+    // geometry on every call. Only needs the configuration and the
+    // geometry, so it is filled independently of the kernels in init().
+    struct ChannelInfo {
+      bool valid = false;                          ///< false if the view can't be determined
+      const util::SignalShaping* shaping = nullptr; ///< convolution/deconvolution kernel
+      double asicGain = 0.;                        ///< ASIC gain in mV/fC
+      double rawNoise = 0.;                        ///< raw noise in ADC counts
+      double deconNoise = 0.;                      ///< deconvoluted noise
+      double tOffset = 0.;                         ///< field response time offset in ns
+    };
+
+    // Table lookup, filling the table if needed. Throws for channels without a valid view.
+    const ChannelInfo& GetChannelInfo(unsigned int channel) const;
+
+    // Fill fChannelInfo for every channel of the geometry.
+    void SetChannelInfo() const{const_cast<SignalShapingServiceSBND*>(this)->SetChannelInfo();}
+    void SetChannelInfo();
+
     // Attributes.
 
     bool fInit;               ///< Initialization flag.
+    bool fChannelInfoInit;    ///< Channel table initialization flag.
 
     void SetResponseSampling();
 
@@ -172,6 +193,10 @@ namespace util {
     std::vector<TComplex> fIndUFilter;
     std::vector<TComplex> fIndVFilter;
     std::vector<TComplex> fColFilter;
+
+    // Channel table, indexed by channel number.
+
+    std::vector<ChannelInfo> fChannelInfo;
   };
 }
 //----------------------------------------------------------------------
@@ -184,16 +209,11 @@ template <class T> inline void util::SignalShapingServiceSBND::Convolute(detinfo
   //negative number;
   int time_offset = FieldResponseTOffset(clockData, channel);
   
-  std::vector<T> temp;
-  if (time_offset <= 0) {
-    temp.assign(func.begin(),func.begin()-time_offset);
-    func.erase(func.begin(),func.begin()-time_offset);
-    func.insert(func.end(),temp.begin(),temp.end());
-  }else{
-    temp.assign(func.end()-time_offset,func.end());
-    func.erase(func.end()-time_offset,func.end());
-    func.insert(func.begin(),temp.begin(),temp.end());
-  }
+  // Shift by the time offset in place
+  if (time_offset <= 0)
+    std::rotate(func.begin(), func.begin()-time_offset, func.end());
+  else
+    std::rotate(func.begin(), func.end()-time_offset, func.end());
 }
 
 
@@ -207,16 +227,11 @@ template <class T> inline void util::SignalShapingServiceSBND::Deconvolute(detin
   //negative number;
   int time_offset = FieldResponseTOffset(clockData, channel);
   
-  std::vector<T> temp;
-  if (time_offset <= 0) {
-    temp.assign(func.end()+time_offset,func.end());
-    func.erase(func.end()+time_offset,func.end());
-    func.insert(func.begin(),temp.begin(),temp.end());
-  }else{
-    temp.assign(func.begin(),func.begin()+time_offset);
-    func.erase(func.begin(),func.begin()+time_offset);
-    func.insert(func.end(),temp.begin(),temp.end());
-  }
+  // Shift back by the time offset in place
+  if (time_offset <= 0)
+    std::rotate(func.begin(), func.end()+time_offset, func.end());
+  else
+    std::rotate(func.begin(), func.begin()+time_offset, func.end());
   
 }
 
@@ -21,6 +21,7 @@
 util::SignalShapingServiceSBND::SignalShapingServiceSBND(const fhicl::ParameterSet& pset,
 								    art::ActivityRegistry& /* reg */) 
   : fInit(false)
+  , fChannelInfoInit(false)
 {
   reconfigure(pset);
 }
@@ -39,6 +40,7 @@ void util::SignalShapingServiceSBND::reconfigure(const fhicl::ParameterSet& pset
   // Reset initialization flag.
 
   fInit = false;
+  fChannelInfoInit = false;
 
   // Reset kernels.
 
@@ -223,46 +225,13 @@ util::SignalShapingServiceSBND::SignalShaping(unsigned int channel) const
   if(!fInit)
     init();
 
-  //  art::ServiceHandle<geo::Geometry> geom;
-
-  // Figure out plane type.
-  // we need to distiguish the U and V planes
-  geo::View_t view = GetView(channel);
-
-  // Return appropriate shaper.
-  //geo::SigType_t sigtype = geom->SignalType(channel);
-
-  if (view == geo::kU)
-    return fIndUSignalShaping;
-  else if (view == geo::kV)
-    return fIndVSignalShaping;
-  else if (view == geo::kZ)
-    return fColSignalShaping;
-  else
-    throw cet::exception("SignalShapingServiceSBND")<< "1 can't determine"
-                                                          << " SignalType\n";  
-  
-
-  return fColSignalShaping;
+  return *GetChannelInfo(channel).shaping;
 }
 
 //---Give Gain Settings to SimWire ---//
 double util::SignalShapingServiceSBND::GetASICGain(unsigned int const channel) const
 {
-  // we need to distiguish the U and V planes
-  geo::View_t view = GetView(channel);
-
-  double gain = 0.0;
-  if(view == geo::kU)
-    gain = fASICGainInMVPerFC.at(0);
-  else if(view == geo::kV)
-     gain = fASICGainInMVPerFC.at(1);
-  else if(view == geo::kZ)
-    gain = fASICGainInMVPerFC.at(2);
-  else
-    throw cet::exception("SignalShapingServiceSBND")<< "2 can't determine"
-                                                    << " SignalType\n";
-  return gain;
+  return GetChannelInfo(channel).asicGain;
 } 
 
 // //---Give Shaping time Settings to SimWire ---//
@@ -286,82 +255,78 @@ double util::SignalShapingServiceSBND::GetASICGain(unsigned int const channel) c
 
 double util::SignalShapingServiceSBND::GetRawNoise(unsigned int const channel) const
 {
-  unsigned int plane;
-//  art::ServiceHandle<geo::Geometry> geom;
-  //geo::SigType_t sigtype = geom->SignalType(channel);
-
-  // we need to distiguish the U and V planes
-  geo::View_t view = GetView(channel);
-
-  if(view == geo::kU)
-    plane = 0;
-  else if(view == geo::kV)
-    plane = 1;
-  else if(view == geo::kZ)
-    plane = 2;
-  else
-    throw cet::exception("SignalShapingServiceSBND")<< "4 can't determine"
-                                                    << " SignalType\n";
-
-  double shapingtime = fShapeTimeConst.at(plane);
-  double gain = fASICGainInMVPerFC.at(plane);
-  int temp;
-  if (shapingtime == 0.5){
-    temp = 0;
-  }else if (shapingtime == 1.0){
-    temp = 1;
-  }else if (shapingtime == 2.0){
-    temp = 2;
-  }else{
-    temp = 3;
-  }
-  double rawNoise;
-  
-  auto tempNoise = fNoiseFactVec.at(plane);
-  rawNoise = tempNoise.at(temp);
-
-  rawNoise *= gain/4.7;
-  return rawNoise;
+  return GetChannelInfo(channel).rawNoise;
 }
 
 double util::SignalShapingServiceSBND::GetDeconNoise(unsigned int const channel) const
 {
-  unsigned int plane;
-//  art::ServiceHandle<geo::Geometry> geom;
-  //geo::SigType_t sigtype = geom->SignalType(channel);
-
-  // we need to distiguish the U and V planes
-  geo::View_t view = GetView(channel);
-
-  if(view == geo::kU)
-    plane = 0;
-  else if(view == geo::kV)
-    plane = 1;
-  else if(view == geo::kZ)
-    plane = 2;
-  else
-    throw cet::exception("SignalShapingServiceSBND")<< "5 can't determine"
-                                                    << " SignalType\n";
-
-  double shapingtime = fShapeTimeConst.at(plane);
-  int temp;
-  if (shapingtime == 0.5){
-    temp = 0;
-  }else if (shapingtime == 1.0){
-    temp = 1;
-  }else if (shapingtime == 2.0){
-    temp = 2;
-  }else{
-    temp = 3;
+  return GetChannelInfo(channel).deconNoise;
+}
+
+//----------------------------------------------------------------------
+// Channel table lookup.
+const util::SignalShapingServiceSBND::ChannelInfo&
+util::SignalShapingServiceSBND::GetChannelInfo(unsigned int channel) const
+{
+  if(!fChannelInfoInit)
+    SetChannelInfo();
+
+  if(channel >= fChannelInfo.size() || !fChannelInfo[channel].valid)
+    throw cet::exception("SignalShapingServiceSBND")<< "Channel " << channel
+                                                    << ": can't determine SignalType\n";
+
+  return fChannelInfo[channel];
+}
+
+//----------------------------------------------------------------------
+// Fill the channel table. The view, gain, noise and time offset only
+// depend on the plane, so they are worked out per plane first. The
+// kernels are only referenced here, they are built by init().
+void util::SignalShapingServiceSBND::SetChannelInfo()
+{
+  fChannelInfoInit = true;
+
+  art::ServiceHandle<geo::Geometry> geom;
+
+  constexpr unsigned int NPlanes = 3;
+  const util::SignalShaping* shaping[NPlanes] = {&fIndUSignalShaping, &fIndVSignalShaping, &fColSignalShaping};
+
+  ChannelInfo planeInfo[NPlanes];
+  for(unsigned int plane = 0; plane < NPlanes; ++plane) {
+    double shapingtime = fShapeTimeConst.at(plane);
+    int temp;
+    if (shapingtime == 0.5){
+      temp = 0;
+    }else if (shapingtime == 1.0){
+      temp = 1;
+    }else if (shapingtime == 2.0){
+      temp = 2;
+    }else{
+      temp = 3;
+    }
+    double noise = fNoiseFactVec.at(plane).at(temp);
+
+    ChannelInfo& info = planeInfo[plane];
+    info.valid = true;
+    info.shaping = shaping[plane];
+    info.asicGain = fASICGainInMVPerFC.at(plane);
+    info.rawNoise = noise * info.asicGain/4.7;
+    // replaced 2000 with fADCPerPCAtLowestASICGain/4.7 because 2000 V/ADC is specific to MicroBooNE
+    info.deconNoise = noise /4096.*(fADCPerPCAtLowestASICGain/4.7/4.7) *6.241*1000/fDeconNorm;
+    info.tOffset = fFieldResponseTOffset.at(plane);
   }
-  double deconNoise;
-  
-  auto tempNoise = fNoiseFactVec.at(plane);
-  deconNoise = tempNoise.at(temp);
 
-  // replaced 2000 with fADCPerPCAtLowestASICGain/4.7 because 2000 V/ADC is specific to MicroBooNE
-  deconNoise = deconNoise /4096.*(fADCPerPCAtLowestASICGain/4.7/4.7) *6.241*1000/fDeconNorm;
-  return deconNoise;
+  // Channels with a view other than U, V or Z are left invalid
+  fChannelInfo.assign(geom->Nchannels(), ChannelInfo());
+  for(unsigned int chan = 0; chan < fChannelInfo.size(); ++chan) {
+    geo::View_t view = GetView(chan);
+    if(view == geo::kU)
+      fChannelInfo[chan] = planeInfo[0];
+    else if(view == geo::kV)
+      fChannelInfo[chan] = planeInfo[1];
+    else if(view == geo::kZ)
+      fChannelInfo[chan] = planeInfo[2];
+  }
 }
 
 
@@ -868,20 +833,7 @@ void util::SignalShapingServiceSBND::SetResponseSampling()
 int util::SignalShapingServiceSBND::FieldResponseTOffset(detinfo::DetectorClocksData const& clockData,
                                                          unsigned int const channel) const
 {
-  //art::ServiceHandle<geo::Geometry> geom;
-  geo::View_t view = GetView(channel);
-
-  double time_offset = 0;
-  if(view == geo::kU)
-    time_offset = fFieldResponseTOffset.at(0);
-  else if(view == geo::kV)
-    time_offset = fFieldResponseTOffset.at(1);
-  else if(view == geo::kZ)
-    time_offset = fFieldResponseTOffset.at(2);
-  else
-    throw cet::exception("SignalShapingServiceSBND")<< "6 can't determine"
-                                                    << " SignalType\n";
-// std::cout << "TIME OFFSET" << 	time_offset << " " << view << std::endl;
+  double time_offset = GetChannelInfo(channel).tOffset;
 
   auto tpc_clock = clockData.TPCClock();
   return tpc_clock.Ticks(time_offset/1.e3);
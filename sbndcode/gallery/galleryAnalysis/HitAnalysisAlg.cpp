@@ -341,6 +341,48 @@ void HitAnalysisAlg::fillHistograms(const HitVec& hitVec) const
     return;
 }
     
+// Combine with the histograms filled by another instance, before endJob
+void HitAnalysisAlg::merge(const HitAnalysisAlg& other)
+{
+    auto add = [](auto& ours, const auto& theirs){ if (ours && theirs) ours->Add(theirs.get()); };
+    
+    for(int idx = 0; idx < 3; idx++)
+    {
+        add(fHitsByWire[idx],        other.fHitsByWire[idx]);
+        add(fDriftTimes[idx],        other.fDriftTimes[idx]);
+        add(fHitsByTime[idx],        other.fHitsByTime[idx]);
+        add(fPulseHeight[idx],       other.fPulseHeight[idx]);
+        add(fPulseHeightSingle[idx], other.fPulseHeightSingle[idx]);
+        add(fPulseHeightMulti[idx],  other.fPulseHeightMulti[idx]);
+        add(fChi2DOF[idx],           other.fChi2DOF[idx]);
+        add(fNumDegFree[idx],        other.fNumDegFree[idx]);
+        add(fChi2DOFSingle[idx],     other.fChi2DOFSingle[idx]);
+        add(fHitMult[idx],           other.fHitMult[idx]);
+        add(fHitCharge[idx],         other.fHitCharge[idx]);
+        add(fFitWidth[idx],          other.fFitWidth[idx]);
+        add(fHitSumADC[idx],         other.fHitSumADC[idx]);
+        add(fNDFVsChi2[idx],         other.fNDFVsChi2[idx]);
+        add(fPulseHVsWidth[idx],     other.fPulseHVsWidth[idx]);
+        add(fPulseHVsCharge[idx],    other.fPulseHVsCharge[idx]);
+        add(fPulseHVsHitNo[idx],     other.fPulseHVsHitNo[idx]);
+        add(fChargeVsHitNo[idx],     other.fChargeVsHitNo[idx]);
+        add(fChargeVsHitNoS[idx],    other.fChargeVsHitNoS[idx]);
+        
+        add(fSPHvsIdx[idx],          other.fSPHvsIdx[idx]);
+        add(fSWidVsIdx[idx],         other.fSWidVsIdx[idx]);
+        add(f1PPHvsWid[idx],         other.f1PPHvsWid[idx]);
+        add(fSPPHvsWid[idx],         other.fSPPHvsWid[idx]);
+        add(fSOPHvsWid[idx],         other.fSOPHvsWid[idx]);
+        add(fPHRatVsIdx[idx],        other.fPHRatVsIdx[idx]);
+    }
+    
+    add(fBadWPulseHeight,   other.fBadWPulseHeight);
+    add(fBadWPulseHVsWidth, other.fBadWPulseHVsWidth);
+    add(fBadWHitsByWire,    other.fBadWHitsByWire);
+    
+    return;
+}
+    
 // Useful for normalizing histograms
 void HitAnalysisAlg::endJob(int numEvents)
 {
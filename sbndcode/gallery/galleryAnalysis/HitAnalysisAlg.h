@@ -50,6 +50,9 @@ public:
     void setup(const geo::GeometryCore&, TDirectory*);
     void endJob(int numEvents);
     
+    // add the histograms of another instance (e.g. from another thread) to ours
+    void merge(const HitAnalysisAlg&);
+    
     void fillHistograms(const TrackPlaneHitMap&) const;
     void fillHistograms(const HitVec&)           const;
     
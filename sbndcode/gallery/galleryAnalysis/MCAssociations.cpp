@@ -21,7 +21,22 @@
 #include "TVector3.h"
 
 // C/C++ standard libraries
-#include <algorithm> // std::count_if()
+#include <algorithm> // std::count_if(), std::sort(), std::unique()
+#include <functional> // std::less<>
+#include <numeric> // std::partial_sum()
+
+namespace
+{
+    // Position of a hit in its collection, or the collection size if it comes from elsewhere
+    size_t hitIndex(const std::vector<recob::Hit>& hits, const recob::Hit* hit)
+    {
+        std::less<const recob::Hit*> before;
+        
+        if (hits.empty() || before(hit, hits.data()) || !before(hit, hits.data() + hits.size())) return hits.size();
+        
+        return size_t(hit - hits.data());
+    }
+}
 
 
 MCAssociations::MCAssociations(fhicl::ParameterSet const& config)
@@ -125,89 +140,81 @@ void MCAssociations::doTrackHitMCAssociations(gallery::Event& event)
     // Now see how many reco hits might be associated to this particle
     art::FindMany<recob::Hit, anab::BackTrackerHitMatchingData> hitsPerMCParticle(mcParticleHandle, event, fAssnsProducerLabel);
     
-    // Make maps, we really like to make maps
-    using HitToPartVecMap = std::map<const recob::Hit*,std::set<const simb::MCParticle*>>;
-    using PartToHitVecMap = std::map<const simb::MCParticle*, std::set<const recob::Hit*>>;
+    // Rather than maps keyed by pointer we build flat index tables keyed by the
+    // position of each particle and hit in its collection
+    const std::vector<recob::Hit>& hits = *hitHandle;
+    size_t nParticles = mcParticleHandle->size();
+    size_t nHits      = hits.size();
     
-    HitToPartVecMap hitToPartVecMap;
-    PartToHitVecMap partToHitVecMap;
+    fPartHitOffsets.assign(nParticles + 1, 0);
+    fPartHits.clear();
 
     // Loop through the particles
-    for(int mcIdx = 0; mcIdx < mcParticleHandle->size(); mcIdx++)
+    size_t mcIdx = 0;
+    
+    for(; mcIdx < nParticles; mcIdx++)
     {
         try
         {
-            const simb::MCParticle& mcParticle = mcParticleHandle->at(mcIdx);
+            const std::vector<const recob::Hit*>& hitsVec = hitsPerMCParticle.at(mcIdx);
             
-            std::vector<const recob::Hit*> hitsVec = hitsPerMCParticle.at(mcIdx);
+            size_t rowStart = fPartHits.size();
             
             for(const auto& hit : hitsVec)
             {
-                hitToPartVecMap[hit].insert(&mcParticle);
-                partToHitVecMap[&mcParticle].insert(hit);
+                size_t hitIdx = hitIndex(hits, hit);
+                
+                if (hitIdx < nHits) fPartHits.push_back(hitIdx);
             }
+            
+            std::sort(fPartHits.begin() + rowStart, fPartHits.end());
+            fPartHits.erase(std::unique(fPartHits.begin() + rowStart, fPartHits.end()), fPartHits.end());
+        }
+        catch(...)
+        {
+            fPartHits.resize(fPartHitOffsets[mcIdx]);
+            break;
         }
-        catch(...) {break;}
+        
+        fPartHitOffsets[mcIdx + 1] = fPartHits.size();
     }
     
-    // In this section try looking at tracking. Eventually we want to move this out of here...
-    // First step is to recover the MCTruth object vector...
-    const auto& trackHandle = event.getValidHandle<std::vector<recob::Track>>(fTrackProducerLabel);
+    // Particles after a failed lookup keep empty rows
+    for(; mcIdx < nParticles; mcIdx++) fPartHitOffsets[mcIdx + 1] = fPartHits.size();
     
-    // Now see how many reco hits might be associated to this particle
-    art::FindMany<recob::Hit> hitsPerTrack(trackHandle, event, fTrackProducerLabel);
+    // Invert to get the particles of each hit, filling in particle order keeps the rows sorted
+    fHitPartOffsets.assign(nHits + 1, 0);
     
-    // Define a mapping between tracks and associated MCParticles
-    using TrackToParticleSetMap  = std::map<const recob::Track*, std::set<const simb::MCParticle*>>;
-    using ParticleToTrackSetMap  = std::map<const simb::MCParticle*, std::set<const recob::Track*>>;
-    using ParticleToHitSetMap    = std::map<const simb::MCParticle*, std::set<const recob::Hit*>>;
-    using TrackToPartHitSetMap   = std::map<const recob::Track*, ParticleToHitSetMap>;
-    using TrackToHitsVecMap      = std::map<const recob::Track*, std::vector<const recob::Hit*>>;
+    for(const auto& hitIdx : fPartHits) fHitPartOffsets[hitIdx + 1]++;
     
-    TrackToParticleSetMap  trackToParticleSetMap;
-    ParticleToTrackSetMap  particleToTrackSetMap;
+    std::partial_sum(fHitPartOffsets.begin(), fHitPartOffsets.end(), fHitPartOffsets.begin());
     
-    TrackToPartHitSetMap   trackToPartHitSetMap;
-    TrackToHitsVecMap      trackToHitsVecMap;
-
-    // Loop through the tracks and associate via the hits to MCParticles
-    for(int trkIdx = 0; trkIdx < trackHandle->size(); trkIdx++)
+    fHitParts.resize(fPartHits.size());
+    fFillPos.assign(fHitPartOffsets.begin(), fHitPartOffsets.end() - 1);
+    
+    for(size_t partIdx = 0; partIdx < nParticles; partIdx++)
     {
-        const recob::Track& track = trackHandle->at(trkIdx);
-        
-        std::vector<const recob::Hit*> hitsVec = hitsPerTrack.at(trkIdx);
-        
-        trackToHitsVecMap[&track] = hitsVec;
-        
-        ParticleToHitSetMap& particleToHitSetMap = trackToPartHitSetMap[&track];
-        
-        for(const auto& hit : hitsVec)
-        {
-            HitToPartVecMap::iterator partItr = hitToPartVecMap.find(hit);
-            
-            if (partItr != hitToPartVecMap.end())
-            {
-                for(const auto& particle : partItr->second)
-                {
-                    particleToHitSetMap[particle].insert(hit);
-                    trackToParticleSetMap[&track].insert(particle);
-                    particleToTrackSetMap[particle].insert(&track);
-                }
-            }
-        }
+        for(size_t idx = fPartHitOffsets[partIdx]; idx < fPartHitOffsets[partIdx + 1]; idx++)
+            fHitParts[fFillPos[fPartHits[idx]]++] = partIdx;
     }
     
+    // In this section try looking at tracking. Eventually we want to move this out of here...
+    // First step is to recover the MCTruth object vector...
+    const auto& trackHandle = event.getValidHandle<std::vector<recob::Track>>(fTrackProducerLabel);
+    
+    // Now see how many reco hits might be associated to this particle
+    art::FindMany<recob::Hit> hitsPerTrack(trackHandle, event, fTrackProducerLabel);
+    
     // *****************************************************************************************
     // The bits below here should eventually be moved into their own analyzer algorithm
     // but we are in a hurry now so do it all here...
     // Ok, at this point we should be able to relate MCParticles to tracks and hits
     // Let's start by just looking at the primary particle
-    const simb::MCParticle& primaryParticle = mcParticleHandle->at(0);
-    
-    ParticleToTrackSetMap::iterator partTrackItr = particleToTrackSetMap.find(&primaryParticle);
+    const size_t            primaryIdx      = 0;
+    const simb::MCParticle& primaryParticle = mcParticleHandle->at(primaryIdx);
     
     // Define the parameters we want...
-    int   numPrimaryHitsTotal = partToHitVecMap[&primaryParticle].size();
+    int   numPrimaryHitsTotal = fPartHitOffsets[primaryIdx + 1] - fPartHitOffsets[primaryIdx];
     
     // If there are NO reconstructed hits associated to this particle then we don't count
     // But this should really be a check on fiducial volume I think...
@@ -218,32 +225,49 @@ void MCAssociations::doTrackHitMCAssociations(gallery::Event& event)
         float               completeness(0.);
         float               purity(0.);
         int                 numTrackHits(0);
+        int                 numTrackHitsTotal(0);
         
         // Here we find the best matched track to the MCParticle.
         // Nothing exciting, most hits wins sort of thing...
-        if (partTrackItr != particleToTrackSetMap.end())
+        for(size_t trkIdx = 0; trkIdx < trackHandle->size(); trkIdx++)
         {
-            // Recover the longest track...
-            for(const auto& track : partTrackItr->second)
+            const std::vector<const recob::Hit*>& hitsVec = hitsPerTrack.at(trkIdx);
+            
+            // Distinct hits on this track which belong to the primary
+            fTrackHits.clear();
+            
+            for(const auto& hit : hitsVec)
             {
-                if (trackToPartHitSetMap[track][partTrackItr->first].size() > numTrackHits)
-                {
-                    bestTrack    = track;
-                    numTrackHits = trackToPartHitSetMap[track][partTrackItr->first].size();
-                }
+                size_t hitIdx = hitIndex(hits, hit);
+                
+                if (hitIdx < nHits && std::binary_search(fHitParts.begin() + fHitPartOffsets[hitIdx],
+                                                         fHitParts.begin() + fHitPartOffsets[hitIdx + 1],
+                                                         primaryIdx))
+                    fTrackHits.push_back(hitIdx);
             }
-        
-            if (bestTrack)
+            
+            std::sort(fTrackHits.begin(), fTrackHits.end());
+            
+            int numMatched = std::unique(fTrackHits.begin(), fTrackHits.end()) - fTrackHits.begin();
+            
+            // Ties go to the first track in the collection
+            if (numMatched > numTrackHits)
             {
-                int numPrimaryHitsMatch = numTrackHits;
-                int numTrackHitsTotal   = trackToHitsVecMap[bestTrack].size();
-        
-                completeness = float(numPrimaryHitsMatch) / float(numPrimaryHitsTotal);
-                purity       = float(numPrimaryHitsMatch) / float(numTrackHitsTotal);
-                
-                if (completeness > 0.2) efficiency = 1.;
+                bestTrack         = &trackHandle->at(trkIdx);
+                numTrackHits      = numMatched;
+                numTrackHitsTotal = hitsVec.size();
             }
         }
+        
+        if (bestTrack)
+        {
+            int numPrimaryHitsMatch = numTrackHits;
+            
+            completeness = float(numPrimaryHitsMatch) / float(numPrimaryHitsTotal);
+            purity       = float(numPrimaryHitsMatch) / float(numTrackHitsTotal);
+            
+            if (completeness > 0.2) efficiency = 1.;
+        }
     
         // Calculate the length of this mc particle inside the fiducial volume.
         TVector3 mcstart;
@@ -258,35 +282,39 @@ void MCAssociations::doTrackHitMCAssociations(gallery::Event& event)
         
         if (bestTrack) trackLen = length(bestTrack);
     
-        fNTracks->Fill(partToHitVecMap.size(), 1.);
-        fNHitsPerPrimary->Fill(std::log10(double(partToHitVecMap[&primaryParticle].size())), 1.);
+        // Number of particles which left hits
+        int numParticlesWithHits(0);
+        
+        for(size_t partIdx = 0; partIdx < nParticles; partIdx++)
+            if (fPartHitOffsets[partIdx + 1] > fPartHitOffsets[partIdx]) numParticlesWithHits++;
+    
+        fNTracks->Fill(numParticlesWithHits, 1.);
+        fNHitsPerPrimary->Fill(std::log10(double(numPrimaryHitsTotal)), 1.);
         fPrimaryLength->Fill(mcTrackLen, 1.);
-        fPrimaryLenVsHits->Fill(mcTrackLen, partToHitVecMap[&primaryParticle].size(), 1.);
+        fPrimaryLenVsHits->Fill(mcTrackLen, numPrimaryHitsTotal, 1.);
         
         fPrimaryRecoLength->Fill(trackLen, 1.);
         fDeltaTrackLen->Fill(trackLen-mcTrackLen, 1.);
         
         fNHitsPerReco->Fill(std::log10(numTrackHits), 1.);
-        fDeltaNHits->Fill(numTrackHits - int(partToHitVecMap[&primaryParticle].size()), 1.);
+        fDeltaNHits->Fill(numTrackHits - numPrimaryHitsTotal, 1.);
 
         // Loop through the particles again to histogram some secondary info...
-        for(int mcIdx = 0; mcIdx < mcParticleHandle->size(); mcIdx++)
+        for(size_t partIdx = 0; partIdx < nParticles; partIdx++)
         {
-            try
-            {
-                const simb::MCParticle& mcParticle = mcParticleHandle->at(mcIdx);
+            size_t numPartHits = fPartHitOffsets[partIdx + 1] - fPartHitOffsets[partIdx];
             
-                if (!partToHitVecMap[&mcParticle].empty())
-                {
-                    // Calculate the length of this mc particle inside the fiducial volume.
-                    double secTrackLen = length(mcParticle, xOffset, mcstart, mcend, mcstartmom, mcendmom);
+            if (numPartHits > 0)
+            {
+                const simb::MCParticle& mcParticle = mcParticleHandle->at(partIdx);
                 
-                    fNHitsPerTrack->Fill(partToHitVecMap[&mcParticle].size(), 1.);
-                    fTrackLength->Fill(secTrackLen, 1.);
-                    fTrackLenVsHits->Fill(secTrackLen, partToHitVecMap[&mcParticle].size(), 1.);
-                }
+                // Calculate the length of this mc particle inside the fiducial volume.
+                double secTrackLen = length(mcParticle, xOffset, mcstart, mcend, mcstartmom, mcendmom);
+                
+                fNHitsPerTrack->Fill(numPartHits, 1.);
+                fTrackLength->Fill(secTrackLen, 1.);
+                fTrackLenVsHits->Fill(secTrackLen, numPartHits, 1.);
             }
-            catch(...) {break;}
         }
     
         // Final sets of plots
@@ -350,6 +378,29 @@ void MCAssociations::finish()
     }
 } // MCAssociations::finish()
 
+void MCAssociations::merge(const MCAssociations& other)
+{
+    std::vector<TH1*> ours   = histograms();
+    std::vector<TH1*> theirs = other.histograms();
+    
+    for(size_t idx = 0; idx < ours.size(); idx++)
+    {
+        if (ours[idx] && theirs[idx]) ours[idx]->Add(theirs[idx]);
+    }
+} // MCAssociations::merge()
+
+std::vector<TH1*> MCAssociations::histograms() const
+{
+    return { fNTracks.get(), fNHitsPerTrack.get(), fTrackLength.get(), fTrackLenVsHits.get(),
+             fNHitsPerPrimary.get(), fPrimaryLength.get(), fPrimaryLenVsHits.get(),
+             fNHitsPerReco.get(), fDeltaNHits.get(), fPrimaryRecoLength.get(), fDeltaTrackLen.get(),
+             fPrimaryEfficiency.get(), fPrimaryCompleteness.get(), fPrimaryPurity.get(),
+             fPrimaryEffVsMom.get(), fPrimaryCompVsMom.get(), fPrimaryPurityVsMom.get(),
+             fPrimaryEffVsLen.get(), fPrimaryCompVsLen.get(), fPrimaryPurityVsLen.get(),
+             fPrimaryEffVsHits.get(), fPrimaryCompVsHits.get(), fPrimaryPurityVsHits.get(),
+             fPrimaryEffVsLogHits.get(), fPrimaryCompVsLogHits.get(), fPrimaryPurityVsLogHits.get() };
+} // MCAssociations::histograms()
+
 // Length of reconstructed track.
 //----------------------------------------------------------------------------
 double MCAssociations::length(const recob::Track* track) const
@@ -52,8 +52,13 @@ public:
   
     void prepare();
   
+    /// Matches hits and tracks to MCParticles through index tables keyed by
+    /// the position of each object in its collection
     void doTrackHitMCAssociations(gallery::Event&);
   
+    /// Adds the histograms of another instance (e.g. from another thread) to ours
+    void merge(const MCAssociations&);
+  
     void finish();
     
 private:
@@ -62,6 +67,9 @@ private:
                   TVector3& start, TVector3& end, TVector3& startmom, TVector3& endmom,
                   unsigned int tpc = 0, unsigned int cstat = 0) const;
     
+    /// All histograms booked by prepare(), in a fixed order
+    std::vector<TH1*> histograms() const;
+    
     art::InputTag            fHitProducerLabel;
     art::InputTag            fMCTruthProducerLabel;
     art::InputTag            fAssnsProducerLabel;
@@ -73,6 +81,16 @@ private:
     const detinfo::DetectorPropertiesData* fDetectorProperties = nullptr;
     TDirectory*                        fDir                = nullptr;
     
+    // Index tables rebuilt each event, kept to reuse their storage.
+    // Hits of particle i are fPartHits[fPartHitOffsets[i]..fPartHitOffsets[i+1]),
+    // sorted and unique, and fHitParts holds the inverse sorted by particle index
+    std::vector<size_t>                fPartHitOffsets;
+    std::vector<size_t>                fPartHits;
+    std::vector<size_t>                fHitPartOffsets;
+    std::vector<size_t>                fHitParts;
+    std::vector<size_t>                fFillPos;
+    std::vector<size_t>                fTrackHits;
+    
     std::unique_ptr<TH1>      fNTracks;
     std::unique_ptr<TH1>      fNHitsPerTrack;
     std::unique_ptr<TH1>      fTrackLength;
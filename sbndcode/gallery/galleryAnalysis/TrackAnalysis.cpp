@@ -45,6 +45,11 @@ void TrackAnalysis::processTracks(std::vector<recob::Track> const& tracks) {
 } // TrackAnalysis::processTracks()
 
 
+void TrackAnalysis::merge(TrackAnalysis const& other) {
+  if (fHNTracks && other.fHNTracks) fHNTracks->Add(other.fHNTracks.get());
+} // TrackAnalysis::merge()
+
+
 void TrackAnalysis::finish() {
   if (fHNTracks) {
     fDir->cd();
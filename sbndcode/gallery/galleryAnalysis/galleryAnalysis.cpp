@@ -51,12 +51,16 @@
 
 // ROOT
 #include "TFile.h"
+#include "TMemFile.h"
+#include "TROOT.h" // ROOT::EnableThreadSafety()
 
 // C/C++ standard libraries
 #include <string>
 #include <vector>
 #include <memory> // std::make_unique()
 #include <iostream> // std::cerr
+#include <future> // std::async()
+#include <algorithm> // std::min()
 
 
 #if !defined(__CLING__)
@@ -151,32 +155,97 @@ int galleryAnalysis(std::string const& configFile, std::vector<std::string> cons
     mcAssociations.setup(*geom, det_prop_data, pHistFile.get());
     mcAssociations.prepare();
     
-    int numEvents(0);
-  
     /*
-     * the event loop
+     * the input files are shared out between threads, each with its own copy of
+     * the algorithms filling histograms in memory which are merged at the end
      */
-    for (gallery::Event event(allInputFiles); !event.atEnd(); event.next())
-    {
-        // *************************************************************************
-        // ***  SINGLE EVENT PROCESSING BEGIN  *************************************
-        // *************************************************************************
+    size_t nThreads = std::max(1u, analysisConfig.get<unsigned int>("NThreads", 1));
+    nThreads = std::max<size_t>(1, std::min(nThreads, allInputFiles.size()));
+    
+    std::vector<std::vector<std::string>> threadInputFiles(nThreads);
+    for (size_t i = 0; i < allInputFiles.size(); ++i)
+        threadInputFiles[i % nThreads].push_back(allInputFiles[i]);
     
-        mf::LogVerbatim("galleryAnalysis") << "This is event " << event.fileEntry() << "-" << event.eventEntry();
+    // the memory files must outlive the algorithms owning their histograms
+    std::vector<std::unique_ptr<TMemFile>>                    threadHistFiles;
+    std::vector<std::unique_ptr<TrackAnalysis>>               threadTrackAnalysis;
+    std::vector<std::unique_ptr<HitAnalysis::HitAnalysisAlg>> threadHitAnalysisAlg;
+    std::vector<std::unique_ptr<MCAssociations>>              threadMCAssociations;
     
-        trackAnalysis.processTracks(*(event.getValidHandle<std::vector<recob::Track>>(trackTag)));
+    if (nThreads > 1) ROOT::EnableThreadSafety();
+    
+    for (size_t i = 1; i < nThreads; ++i)
+    {
+        std::string fileName = "galleryAnalysisThread" + std::to_string(i) + ".root";
+        threadHistFiles.push_back(std::make_unique<TMemFile>(fileName.c_str(), "RECREATE"));
+        TDirectory* threadDir = threadHistFiles.back().get();
+        
+        threadTrackAnalysis.push_back(std::make_unique<TrackAnalysis>(analysisConfig.get<fhicl::ParameterSet>("trackAnalysis")));
+        threadTrackAnalysis.back()->setup(*geom, threadDir);
+        threadTrackAnalysis.back()->prepare();
         
-        hitAnalysisAlg.fillHistograms(*(event.getValidHandle<std::vector<recob::Hit>>(hitsTag)));
+        threadHitAnalysisAlg.push_back(std::make_unique<HitAnalysis::HitAnalysisAlg>(analysisConfig.get<fhicl::ParameterSet>("hitAnalysisAlg")));
+        threadHitAnalysisAlg.back()->setup(*geom, threadDir);
+        
+        threadMCAssociations.push_back(std::make_unique<MCAssociations>(analysisConfig.get<fhicl::ParameterSet>("mcAssociations")));
+        threadMCAssociations.back()->setup(*geom, det_prop_data, threadDir);
+        threadMCAssociations.back()->prepare();
+    }
+  
+    /*
+     * the event loop over one list of files, returning the number of events
+     */
+    auto processFiles = [&trackTag, &hitsTag](std::vector<std::string> const& files,
+                                              TrackAnalysis&               trackAna,
+                                              HitAnalysis::HitAnalysisAlg& hitAna,
+                                              MCAssociations&              mcAssns)
+    {
+        int numEvents(0);
         
-        mcAssociations.doTrackHitMCAssociations(event);
+        for (gallery::Event event(files); !event.atEnd(); event.next())
+        {
+            // *************************************************************************
+            // ***  SINGLE EVENT PROCESSING BEGIN  *************************************
+            // *************************************************************************
+        
+            mf::LogVerbatim("galleryAnalysis") << "This is event " << event.fileEntry() << "-" << event.eventEntry();
+        
+            trackAna.processTracks(*(event.getValidHandle<std::vector<recob::Track>>(trackTag)));
+            
+            hitAna.fillHistograms(*(event.getValidHandle<std::vector<recob::Hit>>(hitsTag)));
+            
+            mcAssns.doTrackHitMCAssociations(event);
 
-        numEvents++;
+            numEvents++;
+        
+            // *************************************************************************
+            // ***  SINGLE EVENT PROCESSING END    *************************************
+            // *************************************************************************
+        
+        } // for
+        
+        return numEvents;
+    };
     
-        // *************************************************************************
-        // ***  SINGLE EVENT PROCESSING END    *************************************
-        // *************************************************************************
+    std::vector<std::future<int>> futures;
+    for (size_t i = 1; i < nThreads; ++i)
+    {
+        futures.push_back(std::async(std::launch::async, processFiles, std::cref(threadInputFiles[i]),
+                                     std::ref(*threadTrackAnalysis[i-1]),
+                                     std::ref(*threadHitAnalysisAlg[i-1]),
+                                     std::ref(*threadMCAssociations[i-1])));
+    }
+    
+    int numEvents = processFiles(threadInputFiles[0], trackAnalysis, hitAnalysisAlg, mcAssociations);
     
-    } // for
+    for (size_t i = 1; i < nThreads; ++i)
+    {
+        numEvents += futures[i-1].get();
+        
+        trackAnalysis.merge(*threadTrackAnalysis[i-1]);
+        hitAnalysisAlg.merge(*threadHitAnalysisAlg[i-1]);
+        mcAssociations.merge(*threadMCAssociations[i-1]);
+    }
   
     trackAnalysis.finish();
     mcAssociations.finish();
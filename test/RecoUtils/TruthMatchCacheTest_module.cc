@@ -0,0 +1,110 @@
+/**
+ * \brief Checks RecoUtils::TruthMatchCache against the uncached
+ *        RecoUtils truth matching functions
+ *
+ * Every track is matched three ways: with the free functions, with a
+ * fresh (cold) cache, and with a cache shared by all the tracks of the
+ * event, so hits shared between tracks are served from the cache.
+ * Any disagreement throws.
+ */
+
+#include "art/Framework/Core/EDAnalyzer.h"
+#include "art/Framework/Core/ModuleMacros.h"
+#include "art/Framework/Principal/Event.h"
+#include "art/Framework/Principal/Handle.h"
+#include "art/Framework/Services/Registry/ServiceHandle.h"
+#include "canvas/Persistency/Common/FindManyP.h"
+#include "canvas/Utilities/InputTag.h"
+#include "cetlib_except/exception.h"
+#include "fhiclcpp/ParameterSet.h"
+#include "messagefacility/MessageLogger/MessageLogger.h"
+
+#include "lardata/DetectorInfoServices/DetectorClocksService.h"
+#include "lardataobj/RecoBase/Hit.h"
+#include "lardataobj/RecoBase/Track.h"
+
+#include "sbndcode/RecoUtils/RecoUtils.h"
+
+#include <string>
+#include <vector>
+
+
+class TruthMatchCacheTest : public art::EDAnalyzer {
+public:
+  explicit TruthMatchCacheTest(fhicl::ParameterSet const& p);
+
+  // Plugins should not be copied or assigned.
+  TruthMatchCacheTest(TruthMatchCacheTest const&) = delete;
+  TruthMatchCacheTest(TruthMatchCacheTest&&) = delete;
+  TruthMatchCacheTest& operator=(TruthMatchCacheTest const&) = delete;
+  TruthMatchCacheTest& operator=(TruthMatchCacheTest&&) = delete;
+
+  // Required functions.
+  void analyze(art::Event const& e) override;
+
+private:
+
+  void Compare(std::string const& what, size_t track, int expected, int cold, int shared) const;
+
+  art::InputTag fTrackModuleLabel;
+  bool fRollup;
+
+};
+
+
+TruthMatchCacheTest::TruthMatchCacheTest(fhicl::ParameterSet const& p)
+  : EDAnalyzer{p}
+  , fTrackModuleLabel(p.get<art::InputTag>("TrackModuleLabel"))
+  , fRollup(p.get<bool>("RollupUnsavedIDs", true))
+{}
+
+void TruthMatchCacheTest::Compare(std::string const& what, size_t track, int expected, int cold, int shared) const
+{
+  if (cold == expected && shared == expected) return;
+
+  throw cet::exception("TruthMatchCacheTest")
+    << what << " of track " << track << ": uncached " << expected
+    << ", cold cache " << cold << ", shared cache " << shared << "\n";
+}
+
+void TruthMatchCacheTest::analyze(art::Event const& e)
+{
+  auto const clockData = art::ServiceHandle<detinfo::DetectorClocksService const>()->DataFor(e);
+
+  auto const& tracks = e.getProduct<std::vector<recob::Track>>(fTrackModuleLabel);
+  art::FindManyP<recob::Hit> fmh(e.getValidHandle<std::vector<recob::Track>>(fTrackModuleLabel), e, fTrackModuleLabel);
+
+  RecoUtils::TruthMatchCache shared(clockData, fRollup);
+
+  size_t nHits = 0;
+  for (size_t i = 0; i < tracks.size(); ++i) {
+    std::vector<art::Ptr<recob::Hit>> const& hits = fmh.at(i);
+    nHits += hits.size();
+
+    Compare("TrueParticleIDFromTotalTrueEnergy", i,
+            RecoUtils::TrueParticleIDFromTotalTrueEnergy(clockData, hits, fRollup),
+            RecoUtils::TruthMatchCache(clockData, fRollup).TrueParticleIDFromTotalTrueEnergy(hits),
+            shared.TrueParticleIDFromTotalTrueEnergy(hits));
+
+    Compare("TrueParticleIDFromTotalRecoCharge", i,
+            RecoUtils::TrueParticleIDFromTotalRecoCharge(clockData, hits, fRollup),
+            RecoUtils::TruthMatchCache(clockData, fRollup).TrueParticleIDFromTotalRecoCharge(hits),
+            shared.TrueParticleIDFromTotalRecoCharge(hits));
+
+    Compare("TrueParticleIDFromTotalRecoHits", i,
+            RecoUtils::TrueParticleIDFromTotalRecoHits(clockData, hits, fRollup),
+            RecoUtils::TruthMatchCache(clockData, fRollup).TrueParticleIDFromTotalRecoHits(hits),
+            shared.TrueParticleIDFromTotalRecoHits(hits));
+
+    for (auto const& hit : hits) {
+      Compare("TrueParticleID of hit " + std::to_string(hit.key()), i,
+              RecoUtils::TrueParticleID(clockData, hit, fRollup),
+              RecoUtils::TruthMatchCache(clockData, fRollup).TrueParticleID(hit),
+              shared.TrueParticleID(hit));
+    }
+  }
+
+  mf::LogInfo("TruthMatchCacheTest") << "Checked " << tracks.size() << " tracks with " << nHits << " hits";
+}
+
+DEFINE_ART_MODULE(TruthMatchCacheTest)